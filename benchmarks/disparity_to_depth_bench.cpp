@@ -0,0 +1,175 @@
+// 视差转深度：reprojectImageTo3D + split 与单遍 disparityToDepth 的对比基准
+//
+// 对比三条路径（每帧）：
+//   原实现：reprojectImageTo3D(handleMissingValues=true) -> split -> clone Z -> patchNaNs -> setTo(0, <= 0)；
+//   disparityToDepth：只输出 Z（zero_invalid = true，对应上面的语义）；
+//   disparityToDepth + points3D：同一遍输出 Z 与 XYZ（点云场景）。
+// 校验（与原实现比较）：
+//   深度相对误差 <= kMaxRelativeError（有限值），缺失/置 0 的像素集合完全一致；
+//   points3D 与 reprojectImageTo3D 的 XYZ 相对误差同样 <= kMaxRelativeError。
+// 视差为 SGBM 风格的合成数据：斜面 + 噪声，约 10% 像素为无效值 (minDisparity - 1)，另含 0 视差。
+// 任一校验失败时返回非 0。
+//
+// 构建：cmake -DSMARTSCOPE_BUILD_BENCHMARKS=ON ... && ./bin/disparity_to_depth_bench [iterations]
+// 无 Qt/RKNN 环境直接编译：
+//   g++ -O2 -std=c++17 -Ireference_code/SmartScope/src/stereo_depth/include $(pkg-config --cflags opencv4)
+//       -o disparity_to_depth_bench benchmarks/disparity_to_depth_bench.cpp
+//       reference_code/SmartScope/src/stereo_depth/src/disparity_to_depth.cpp $(pkg-config --libs opencv4)
+
+#include "stereo_depth/disparity_to_depth.hpp"
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using stereo_depth::DisparityToDepthOptions;
+using stereo_depth::disparityToDepth;
+
+namespace {
+
+const double kMaxRelativeError = 1e-5;
+
+// 与 stereoRectify 输出同形式的 Q：f = 1000 px，基线 4 mm（内窥镜双目量级）
+cv::Mat make_q(const cv::Size &size)
+{
+    const double f = 1000.0;
+    const double tx = -4.0;
+    const double cx = size.width / 2.0;
+    const double cy = size.height / 2.0;
+    const double cx2 = cx + 3.5;
+    return (cv::Mat_<double>(4, 4) << 1, 0, 0, -cx,
+                                      0, 1, 0, -cy,
+                                      0, 0, 0, f,
+                                      0, 0, -1.0 / tx, (cx - cx2) / tx);
+}
+
+cv::Mat make_disparity(const cv::Size &size)
+{
+    cv::RNG rng(2024);
+    cv::Mat disp(size, CV_32F);
+    for (int y = 0; y < size.height; y++)
+    {
+        float *row = disp.ptr<float>(y);
+        for (int x = 0; x < size.width; x++)
+        {
+            const double u = rng.uniform(0.0, 1.0);
+            if (u < 0.1)
+            {
+                row[x] = -1.0f; // SGBM 无效值 (minDisparity - 1) * 16 / 16
+            }
+            else if (u < 0.11)
+            {
+                row[x] = 0.0f;
+            }
+            else
+            {
+                row[x] = 20.0f + 80.0f * y / size.height + (float)rng.gaussian(0.5);
+                row[x] = std::round(row[x] * 16.0f) / 16.0f; // SGBM 的 1/16 像素精度
+            }
+        }
+    }
+    return disp;
+}
+
+void reference_depth(const cv::Mat &disp, const cv::Mat &Q, cv::Mat &depth)
+{
+    cv::Mat xyz;
+    cv::reprojectImageTo3D(disp, xyz, Q, true);
+    std::vector<cv::Mat> ch;
+    cv::split(xyz, ch);
+    depth = ch[2].clone();
+    cv::patchNaNs(depth, 0.0);
+    depth.setTo(0, depth <= 0);
+}
+
+// 相对误差最大值；一边为 0（无效）另一边不为 0 时记为无穷
+double max_relative_error(const cv::Mat &reference, const cv::Mat &test)
+{
+    const cv::Mat r = reference.reshape(1);
+    const cv::Mat t = test.reshape(1);
+    double worst = 0.0;
+    for (int y = 0; y < r.rows; y++)
+    {
+        const float *rp = r.ptr<float>(y);
+        const float *tp = t.ptr<float>(y);
+        for (int x = 0; x < r.cols; x++)
+        {
+            if (!std::isfinite(rp[x]) || !std::isfinite(tp[x]))
+            {
+                if (std::isfinite(rp[x]) != std::isfinite(tp[x]))
+                {
+                    return INFINITY;
+                }
+                continue;
+            }
+            if ((rp[x] == 0.0f) != (tp[x] == 0.0f))
+            {
+                return INFINITY;
+            }
+            const double err = std::fabs(rp[x] - tp[x]) / std::max(1.0, (double)std::fabs(rp[x]));
+            worst = std::max(worst, err);
+        }
+    }
+    return worst;
+}
+
+template <typename Fn>
+double time_ms(int iterations, Fn fn)
+{
+    fn(); // 预热（分配输出缓冲）
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        fn();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 50;
+    if (iterations <= 0)
+    {
+        fprintf(stderr, "用法: disparity_to_depth_bench [iterations]\n");
+        return 1;
+    }
+
+    DisparityToDepthOptions options;
+    options.zero_invalid = true;
+
+    printf("OpenCV %s, %d threads, %d iterations\n", CV_VERSION, cv::getNumThreads(), iterations);
+    printf("%-12s %12s %10s %12s %8s %12s %12s %6s\n", "size", "reproject ms", "fused ms", "fused+xyz ms", "speedup",
+           "depth relerr", "xyz relerr", "ok");
+
+    bool ok = true;
+    const cv::Size sizes[] = {cv::Size(1280, 720), cv::Size(1920, 1080)};
+    for (const cv::Size &size : sizes)
+    {
+        const cv::Mat disp = make_disparity(size);
+        const cv::Mat Q = make_q(size);
+
+        cv::Mat reference, fused, fused_xyz_depth, xyz, reference_xyz;
+        const double reference_ms = time_ms(iterations, [&]() { reference_depth(disp, Q, reference); });
+        const double fused_ms = time_ms(iterations, [&]() { disparityToDepth(disp, Q, fused, options); });
+        const double xyz_ms = time_ms(iterations, [&]() { disparityToDepth(disp, Q, fused_xyz_depth, options, &xyz); });
+        cv::reprojectImageTo3D(disp, reference_xyz, Q, true);
+
+        const double depth_err = std::max(max_relative_error(reference, fused),
+                                          max_relative_error(reference, fused_xyz_depth));
+        const double xyz_err = max_relative_error(reference_xyz, xyz);
+        const bool size_ok = depth_err <= kMaxRelativeError && xyz_err <= kMaxRelativeError;
+        ok = ok && size_ok;
+
+        printf("%4dx%-7d %12.3f %10.3f %12.3f %7.2fx %12.2e %12.2e %6s\n", size.width, size.height, reference_ms,
+               fused_ms, xyz_ms, fused_ms > 0.0 ? reference_ms / fused_ms : 0.0, depth_err, xyz_err,
+               size_ok ? "yes" : "NO");
+    }
+
+    return ok ? 0 : 2;
+}
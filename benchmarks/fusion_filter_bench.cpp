@@ -0,0 +1,176 @@
+// MonoSmoothStereo 融合：保边滤波器的质量/耗时对比
+//
+// 1. 对齐校验：FusionFilterGraph（Bilateral）与原实现（三次 bilateralFilter + 逐矩阵运算）的融合结果
+//    最大绝对误差 <= kMaxParityErrorMm；
+// 2. 对比：compareFusionFilters 依次跑 Bilateral / Guided / DomainTransform(3 次迭代) / DomainTransform(1 次)，
+//    输出整个融合与其中滤波部分的耗时，以及相对 Bilateral 结果的 RMSE / 平均 / 最大绝对误差（mm），
+//    用于为各性能模式挑选滤波器；
+// 3. 非有限输入：双目深度中再撒入少量 +inf / NaN 像素，所有候选的融合输出必须全为有限值；
+//    直接对其做引导滤波（applyEdgeAwareFilter）的输出同样必须全为有限值。
+// 输入为合成深度：斜面 + 台阶边缘 + 噪声，双目深度含 0（无效）与 10000（reprojectImageTo3D 的缺失值）的空洞，
+// 单目深度为平滑且带比例/偏移误差的同一场景。任一校验失败时返回非 0。
+//
+// 构建：cmake -DSMARTSCOPE_BUILD_BENCHMARKS=ON ... && ./bin/fusion_filter_bench [iterations]
+// 无 Qt/RKNN 环境直接编译：
+//   g++ -O2 -std=c++17 -Ireference_code/SmartScope/src/stereo_depth/include $(pkg-config --cflags opencv4)
+//       -o fusion_filter_bench benchmarks/fusion_filter_bench.cpp
+//       reference_code/SmartScope/src/stereo_depth/src/fusion_filter_graph.cpp $(pkg-config --libs opencv4)
+
+#include "stereo_depth/fusion_filter_graph.hpp"
+
+#include <stdlib.h>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using stereo_depth::EdgeAwareFilterParams;
+using stereo_depth::EdgeAwareFilterType;
+using stereo_depth::FusionFilterGraph;
+using stereo_depth::FusionFilterReport;
+using stereo_depth::FusionGraphOptions;
+
+namespace {
+
+const double kMaxParityErrorMm = 1e-2; // 10000 mm 附近单精度的几个 ulp
+
+void synthesize_depth(const cv::Size &size, cv::Mat &stereo, cv::Mat &mono)
+{
+    cv::RNG rng(7);
+    stereo.create(size, CV_32F);
+    mono.create(size, CV_32F);
+    const cv::Rect step(size.width / 4, size.height / 4, size.width / 3, size.height / 2);
+    for (int y = 0; y < size.height; y++)
+    {
+        float *s = stereo.ptr<float>(y);
+        float *m = mono.ptr<float>(y);
+        for (int x = 0; x < size.width; x++)
+        {
+            float z = 40.0f + 60.0f * y / size.height + 10.0f * x / size.width;
+            if (step.contains(cv::Point(x, y)))
+            {
+                z -= 15.0f; // 凸起物体，边缘处 15 mm 台阶
+            }
+            m[x] = 1.1f * z + 3.0f;
+            s[x] = z + (float)rng.gaussian(0.8);
+            const double u = rng.uniform(0.0, 1.0);
+            if (u < 0.05)
+            {
+                s[x] = 0.0f;
+            }
+            else if (u < 0.08)
+            {
+                s[x] = 10000.0f;
+            }
+        }
+    }
+    cv::GaussianBlur(mono, mono, cv::Size(9, 9), 0);
+}
+
+// 每隔 step 个像素交替写入 +inf 与 NaN（对齐校验与耗时对比仍用原输入）
+cv::Mat with_non_finite(const cv::Mat &stereo, int step)
+{
+    cv::Mat out = stereo.clone();
+    float *p = out.ptr<float>(0);
+    const size_t total = out.total();
+    for (size_t i = step / 2, n = 0; i < total; i += step, n++)
+    {
+        p[i] = (n % 2 == 0) ? INFINITY : NAN;
+    }
+    return out;
+}
+
+// 原实现：三次 bilateralFilter（Zbase 与 Zbase2 重复），逐矩阵运算
+cv::Mat legacy_fuse(const cv::Mat &stereo, const cv::Mat &mono, const FusionGraphOptions &options)
+{
+    const EdgeAwareFilterParams &f = options.filter;
+    cv::Mat stereo_conf = (stereo > 0);
+    stereo_conf.convertTo(stereo_conf, CV_32F, 1.0 / 255.0);
+    cv::Mat Lmono, Zbase, Zbase2;
+    cv::bilateralFilter(mono, Lmono, f.diameter, f.sigma_range, f.sigma_space);
+    cv::bilateralFilter(stereo, Zbase, f.diameter, f.sigma_range, f.sigma_space);
+    cv::bilateralFilter(stereo, Zbase2, f.diameter, f.sigma_range, f.sigma_space);
+    cv::Mat Hstereo = stereo - Zbase2;
+    cv::Mat alpha;
+    cv::pow(stereo_conf, options.confidence_gamma, alpha);
+    cv::Mat oneMinusAlpha = 1.0 - alpha;
+    cv::Mat fused = alpha.mul(Zbase) + oneMinusAlpha.mul(Lmono);
+    return fused + Hstereo;
+}
+
+EdgeAwareFilterParams make_filter(EdgeAwareFilterType type, int iterations)
+{
+    EdgeAwareFilterParams params;
+    params.type = type;
+    params.iterations = iterations;
+    return params;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 10;
+    if (iterations <= 0)
+    {
+        fprintf(stderr, "用法: fusion_filter_bench [iterations]\n");
+        return 1;
+    }
+
+    const std::vector<EdgeAwareFilterParams> candidates = {
+        make_filter(EdgeAwareFilterType::Bilateral, 3),
+        make_filter(EdgeAwareFilterType::Guided, 3),
+        make_filter(EdgeAwareFilterType::DomainTransform, 3),
+        make_filter(EdgeAwareFilterType::DomainTransform, 1),
+    };
+
+    printf("OpenCV %s, %d threads, %d iterations\n", CV_VERSION, cv::getNumThreads(), iterations);
+
+    bool ok = true;
+    const cv::Size sizes[] = {cv::Size(1280, 720), cv::Size(1920, 1080)};
+    for (const cv::Size &size : sizes)
+    {
+        cv::Mat stereo, mono;
+        synthesize_depth(size, stereo, mono);
+        const cv::Mat stereo_non_finite = with_non_finite(stereo, 9973);
+        FusionGraphOptions options;
+
+        // 1. 对齐校验
+        const cv::Mat legacy = legacy_fuse(stereo, mono, options);
+        FusionFilterGraph graph(options);
+        graph.setInputs(stereo, mono);
+        const double parity = cv::norm(legacy, graph.get(FusionFilterGraph::Fused), cv::NORM_INF);
+        const bool parity_ok = parity <= kMaxParityErrorMm;
+        ok = ok && parity_ok;
+
+        // 2. 质量/耗时对比
+        const std::vector<FusionFilterReport> reports =
+            stereo_depth::compareFusionFilters(stereo, mono, options, candidates, iterations);
+
+        // 3. 引导滤波直接处理含 inf/NaN 的输入（不经过滤波图的置 0）
+        cv::Mat guided;
+        stereo_depth::applyEdgeAwareFilter(stereo_non_finite, guided, make_filter(EdgeAwareFilterType::Guided, 3));
+        const bool guided_ok = cv::checkRange(guided);
+        ok = ok && guided_ok;
+
+        printf("\n%dx%d: graph vs legacy max |diff| %.2e mm %s\n", size.width, size.height, parity,
+               parity_ok ? "ok" : "FAIL");
+        printf("  guided filter on inf/NaN input: finite %s\n", guided_ok ? "ok" : "FAIL");
+        printf("  %-18s %5s %10s %10s %10s %10s %10s %6s\n", "filter", "iters", "fuse ms", "filter ms", "rmse mm",
+               "mean mm", "max mm", "finite");
+        for (const FusionFilterReport &r : reports)
+        {
+            FusionGraphOptions candidate_options = options;
+            candidate_options.filter = r.filter;
+            FusionFilterGraph candidate(candidate_options);
+            candidate.setInputs(stereo_non_finite, mono);
+            const bool finite = cv::checkRange(candidate.get(FusionFilterGraph::Fused));
+            ok = ok && finite;
+            printf("  %-18s %5d %10.2f %10.2f %10.3f %10.3f %10.3f %6s\n", stereo_depth::edgeAwareFilterName(r.filter.type),
+                   r.filter.type == EdgeAwareFilterType::DomainTransform ? r.filter.iterations : 0, r.fuse_ms,
+                   r.filter_ms, r.rmse_mm, r.mean_abs_mm, r.max_abs_mm, finite ? "yes" : "NO");
+        }
+    }
+
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,279 @@
+// 无 RGA 的 letterbox 预处理微基准
+//
+// 对比原 image_utils.cpp 的 CPU 路径（整图 memset + 逐像素浮点双线性 crop_and_scale_image_c，此处保留副本）
+// 与 yolov8_letterbox_resize（定点双线性 + 仅写边框），letterbox 几何与 convert_image_with_letterbox 相同。
+// 校验：填充区域逐字节一致；缩放区域与浮点实现的差值不超过 kMaxDiff（原实现截断取整、新实现四舍五入）。
+// 采样点落在最后一列/行源像素上时，原实现与左/上邻像素混合（镜像），新实现复制边缘像素，
+// 这些像素单独计数、不参与差值校验。
+// 不需要 RGA/NPU，可在 x86 CI 上运行；任一校验失败时返回非 0。
+//
+// 构建：cmake -DSMARTSCOPE_BUILD_BENCHMARKS=ON ... && ./bin/letterbox_bench [iterations]
+// 无 Qt/RKNN 环境（x86 CI）直接编译：
+//   g++ -O2 -std=c++11 -Icrates/rknn-inference/include -o letterbox_bench
+//       benchmarks/letterbox_bench.cpp crates/rknn-inference/csrc/yolov8_letterbox.cc
+
+#include "yolov8_letterbox.h"
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int kModelSize = 640;
+const uint8_t kPadColor = 114;
+const int kMaxDiff = 2;
+
+struct Geometry {
+    int box_x = 0;
+    int box_y = 0;
+    int box_w = 0;
+    int box_h = 0;
+};
+
+// convert_image_with_letterbox 的目标区域计算（宽取 4 的倍数、高取 2 的倍数、偏移取偶数）
+Geometry letterbox_geometry(int src_w, int src_h, int dst_w, int dst_h)
+{
+    Geometry g;
+    int resize_w = dst_w;
+    int resize_h = dst_h;
+    const float scale_w = (float)dst_w / src_w;
+    const float scale_h = (float)dst_h / src_h;
+    if (scale_w < scale_h)
+    {
+        resize_h = (int)(src_h * scale_w);
+    }
+    else
+    {
+        resize_w = (int)(src_w * scale_h);
+    }
+    resize_w -= resize_w % 4;
+    resize_h -= resize_h % 2;
+    if (scale_w < scale_h)
+    {
+        g.box_y = (dst_h - resize_h) / 2;
+        g.box_y -= g.box_y % 2;
+    }
+    else
+    {
+        g.box_x = (dst_w - resize_w) / 2;
+        g.box_x -= g.box_x % 2;
+    }
+    g.box_w = resize_w;
+    g.box_h = resize_h;
+    return g;
+}
+
+// ---- 基线：原 convert_image_cpu（memset + crop_and_scale_image_c） ----
+
+int baseline_crop_and_scale(int channel, const unsigned char *src, int src_width, int src_height,
+                            int crop_x, int crop_y, int crop_width, int crop_height,
+                            unsigned char *dst, int dst_width, int /* dst_height */,
+                            int dst_box_x, int dst_box_y, int dst_box_width, int dst_box_height)
+{
+    float x_ratio = (float)crop_width / (float)dst_box_width;
+    float y_ratio = (float)crop_height / (float)dst_box_height;
+
+    for (int dst_y = dst_box_y; dst_y < dst_box_y + dst_box_height; dst_y++) {
+        for (int dst_x = dst_box_x; dst_x < dst_box_x + dst_box_width; dst_x++) {
+            int dst_x_offset = dst_x - dst_box_x;
+            int dst_y_offset = dst_y - dst_box_y;
+
+            int src_x = (int)(dst_x_offset * x_ratio) + crop_x;
+            int src_y = (int)(dst_y_offset * y_ratio) + crop_y;
+
+            float x_diff = (dst_x_offset * x_ratio) - (src_x - crop_x);
+            float y_diff = (dst_y_offset * y_ratio) - (src_y - crop_y);
+
+            int index1 = src_y * src_width * channel + src_x * channel;
+            int index2 = index1 + src_width * channel;
+            if (src_y == src_height - 1) {
+                index2 = index1 - src_width * channel;
+            }
+            int index3 = index1 + 1 * channel;
+            int index4 = index2 + 1 * channel;
+            if (src_x == src_width - 1) {
+                index3 = index1 - 1 * channel;
+                index4 = index2 - 1 * channel;
+            }
+
+            for (int c = 0; c < channel; c++) {
+                unsigned char A = src[index1+c];
+                unsigned char B = src[index3+c];
+                unsigned char C = src[index2+c];
+                unsigned char D = src[index4+c];
+
+                unsigned char pixel = (unsigned char)(
+                    A * (1 - x_diff) * (1 - y_diff) +
+                    B * x_diff * (1 - y_diff) +
+                    C * y_diff * (1 - x_diff) +
+                    D * x_diff * y_diff
+                );
+
+                dst[(dst_y * dst_width  + dst_x) * channel + c] = pixel;
+            }
+        }
+    }
+    return 0;
+}
+
+void run_baseline(const std::vector<uint8_t> &src, int src_w, int src_h, int channels, const Geometry &g,
+                  std::vector<uint8_t> &dst)
+{
+    if (g.box_w != kModelSize || g.box_h != kModelSize)
+    {
+        memset(dst.data(), kPadColor, dst.size());
+    }
+    baseline_crop_and_scale(channels, src.data(), src_w, src_h, 0, 0, src_w, src_h, dst.data(), kModelSize, kModelSize,
+                            g.box_x, g.box_y, g.box_w, g.box_h);
+}
+
+int run_fused(const std::vector<uint8_t> &src, int src_w, int src_h, int channels, const Geometry &g,
+              std::vector<uint8_t> &dst)
+{
+    return yolov8_letterbox_resize(src.data(), src_w, src_h, src_w * channels, 0, 0, src_w, src_h, channels,
+                                   dst.data(), kModelSize, kModelSize, kModelSize * channels,
+                                   g.box_x, g.box_y, g.box_w, g.box_h, kPadColor);
+}
+
+// 平滑渐变叠加噪声，接近相机画面的局部相关性
+std::vector<uint8_t> synthesize_image(int w, int h, int channels)
+{
+    std::vector<uint8_t> img((size_t)w * h * channels);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> noise(-12, 12);
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            for (int c = 0; c < channels; c++)
+            {
+                const int base = (x * 255 / w + y * 255 / h + c * 80) % 256;
+                const int v = base + noise(rng);
+                img[((size_t)y * w + x) * channels + c] = (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+            }
+        }
+    }
+    return img;
+}
+
+template <typename Fn>
+double time_us(int iterations, Fn fn)
+{
+    fn(); // 预热
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        fn();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+const char *simd_name()
+{
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return "NEON";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+struct Case {
+    int w;
+    int h;
+    int channels;
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 50;
+    if (iterations <= 0)
+    {
+        fprintf(stderr, "用法: letterbox_bench [iterations]\n");
+        return 1;
+    }
+
+    // 1000 / 1001 宽不满足 RGA 的 16 对齐，正是实际走 CPU 回退的尺寸
+    const Case cases[] = {
+        {1280, 720, 3}, {1920, 1080, 3}, {1000, 750, 3}, {1001, 563, 3}, {480, 360, 3}, {1280, 720, 4}, {1280, 720, 1},
+    };
+
+    printf("SIMD: %s, dst %dx%d, %d iterations\n", simd_name(), kModelSize, kModelSize, iterations);
+    printf("%-16s %4s %12s %12s %9s %9s %10s %10s\n", "input", "ch", "baseline us", "fused us", "speedup", "max diff",
+           "mean diff", "edge px");
+
+    bool ok = true;
+    for (const Case &c : cases)
+    {
+        const std::vector<uint8_t> src = synthesize_image(c.w, c.h, c.channels);
+        const Geometry g = letterbox_geometry(c.w, c.h, kModelSize, kModelSize);
+        std::vector<uint8_t> base((size_t)kModelSize * kModelSize * c.channels);
+        // 新实现的目标缓冲先填垃圾，确认边框确实被写过
+        std::vector<uint8_t> fused(base.size(), 0xA5);
+
+        if (run_fused(src, c.w, c.h, c.channels, g, fused) != 0)
+        {
+            printf("%dx%d: yolov8_letterbox_resize 失败\n", c.w, c.h);
+            ok = false;
+            continue;
+        }
+        run_baseline(src, c.w, c.h, c.channels, g, base);
+
+        int max_diff = 0;
+        double sum_diff = 0.0;
+        long compared = 0;
+        long edge = 0;
+        bool pad_ok = true;
+        const float x_ratio = (float)c.w / (float)g.box_w;
+        const float y_ratio = (float)c.h / (float)g.box_h;
+        for (int y = 0; y < kModelSize; y++)
+        {
+            for (int x = 0; x < kModelSize; x++)
+            {
+                const bool inside = x >= g.box_x && x < g.box_x + g.box_w && y >= g.box_y && y < g.box_y + g.box_h;
+                const bool on_edge = inside && ((int)((x - g.box_x) * x_ratio) == c.w - 1 ||
+                                                (int)((y - g.box_y) * y_ratio) == c.h - 1);
+                edge += on_edge ? 1 : 0;
+                for (int ch = 0; ch < c.channels; ch++)
+                {
+                    const size_t i = ((size_t)y * kModelSize + x) * c.channels + ch;
+                    const int d = abs((int)base[i] - (int)fused[i]);
+                    if (!inside)
+                    {
+                        pad_ok = pad_ok && d == 0;
+                        continue;
+                    }
+                    if (on_edge)
+                    {
+                        continue;
+                    }
+                    max_diff = d > max_diff ? d : max_diff;
+                    sum_diff += d;
+                    compared++;
+                }
+            }
+        }
+        const double mean_diff = compared > 0 ? sum_diff / compared : 0.0;
+
+        const double base_us = time_us(iterations, [&]() { run_baseline(src, c.w, c.h, c.channels, g, base); });
+        const double fused_us = time_us(iterations, [&]() { run_fused(src, c.w, c.h, c.channels, g, fused); });
+
+        const bool case_ok = pad_ok && max_diff <= kMaxDiff;
+        ok = ok && case_ok;
+        const std::string name = std::to_string(c.w) + "x" + std::to_string(c.h);
+        printf("%-16s %4d %12.1f %12.1f %8.2fx %9d %10.3f %10ld%s%s\n", name.c_str(), c.channels, base_us, fused_us,
+               base_us / fused_us, max_diff, mean_diff, edge, pad_ok ? "" : "  PAD MISMATCH",
+               max_diff <= kMaxDiff ? "" : "  DIFF TOO LARGE");
+    }
+    return ok ? 0 : 2;
+}
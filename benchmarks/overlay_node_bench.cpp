@@ -0,0 +1,235 @@
+// 检测框叠加层场景图更新微基准
+//
+// 对比旧的逐帧 QPainter 绘制路径（每帧解析 QVariantMap、每次新建 QFont/QFontMetrics、
+// 逐框 drawRoundedRect）与 QmlVideoItem 实际使用的 DetectionBoxesNode 更新路径
+// 在 N 个检测框下的每次更新耗时：
+//   node-cold：新建节点树（创建 BoxNode 与标签纹理）
+//   node-warm：检测结果变化、框数不变，复用已有节点与纹理，只修改矩形与颜色
+// 每次更新后校验子节点数与标签纹理数，不符时返回非零。
+//
+// 场景图节点需要已初始化的场景图，这里使用 offscreen 平台 + software 后端的 QQuickWindow。
+//
+// 构建：cmake -DSMARTSCOPE_BUILD_BENCHMARKS=ON ... && ./bin/overlay_node_bench [iterations]
+
+#include "detection_overlay.h"
+
+#include <QElapsedTimer>
+#include <QFont>
+#include <QFontMetrics>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <QQuickWindow>
+#include <QRandomGenerator>
+#include <QSGRendererInterface>
+#include <QSet>
+#include <QVariantList>
+#include <QVariantMap>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+const QSize kTargetSize(1920, 1080);
+const QSize kFrameSize(1280, 720);
+const int kModelInputSize = 640;
+const int kInitTimeoutMs = 5000;
+
+const char* const kLabels[] = {"person", "bicycle", "car", "motorcycle", "bus",
+                               "truck", "bird", "cat", "dog", "bottle"};
+
+QVector<OverlayBox> makeBoxes(int count, quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    QVector<OverlayBox> boxes;
+    boxes.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        OverlayBox box;
+        box.left = rng.bounded(560);
+        box.top = 80 + rng.bounded(400);
+        box.right = box.left + 20 + rng.bounded(60);
+        box.bottom = box.top + 20 + rng.bounded(60);
+        box.confidence = 0.5f + float(rng.bounded(0.5));
+        box.classId = rng.bounded(10);
+        boxes.push_back(box);
+    }
+    return boxes;
+}
+
+// 旧路径的输入：每个检测框一个 QVariantMap
+QVariantList toVariantList(const QVector<OverlayBox>& boxes)
+{
+    QVariantList list;
+    for (const OverlayBox& box : boxes) {
+        QVariantMap m;
+        m.insert("left", box.left);
+        m.insert("top", box.top);
+        m.insert("right", box.right);
+        m.insert("bottom", box.bottom);
+        m.insert("confidence", box.confidence);
+        m.insert("class_id", box.classId);
+        m.insert("label", QString::fromLatin1(kLabels[box.classId]));
+        list.push_back(m);
+    }
+    return list;
+}
+
+int distinctClasses(const QVector<OverlayBox>& boxes)
+{
+    QSet<int> classes;
+    for (const OverlayBox& box : boxes) {
+        classes.insert(box.classId);
+    }
+    return classes.size();
+}
+
+// 旧 QmlVideoItem::paint 中的逐框绘制逻辑
+void paintLegacy(QPainter* painter, const QVariantList& dets, const QRectF& destRect)
+{
+    static const QColor colors[] = {
+        QColor(255,59,48), QColor(52,199,89), QColor(0,122,255), QColor(255,149,0),
+        QColor(175,82,222), QColor(90,200,250), QColor(255,204,0), QColor(255,45,85),
+        QColor(48,209,88), QColor(100,210,255)
+    };
+    const qreal ow = kFrameSize.width();
+    const qreal oh = kFrameSize.height();
+    const qreal modelW = kModelInputSize;
+    const qreal scale = qMin(modelW / ow, modelW / oh);
+    const qreal xOff = (modelW - ow * scale) / 2.0;
+    const qreal yOff = (modelW - oh * scale) / 2.0;
+    const qreal sx = destRect.width() / ow;
+    const qreal sy = destRect.height() / oh;
+
+    painter->setRenderHint(QPainter::Antialiasing, true);
+    for (const QVariant& v : dets) {
+        const QVariantMap m = v.toMap();
+        const qreal xl = qBound<qreal>(0.0, (m.value("left").toDouble() - xOff) / scale, ow);
+        const qreal xr = qBound<qreal>(0.0, (m.value("right").toDouble() - xOff) / scale, ow);
+        const qreal yt = qBound<qreal>(0.0, (m.value("top").toDouble() - yOff) / scale, oh);
+        const qreal yb = qBound<qreal>(0.0, (m.value("bottom").toDouble() - yOff) / scale, oh);
+        const QRectF r(destRect.left() + xl * sx, destRect.top() + yt * sy, (xr - xl) * sx, (yb - yt) * sy);
+        const int cls = m.value("class_id").toInt();
+        const QColor base = colors[qAbs(cls) % 10];
+
+        QColor glow = base; glow.setAlpha(90);
+        painter->setPen(QPen(glow, 8));
+        painter->setBrush(Qt::NoBrush);
+        painter->drawRoundedRect(r, 6, 6);
+        QColor edge = base; edge.setAlpha(220);
+        painter->setPen(QPen(edge, 3));
+        painter->drawRoundedRect(r, 6, 6);
+
+        const QString text = m.value("label").toString();
+        QFont f;
+        f.setPixelSize(36);
+        f.setBold(true);
+        QFontMetrics fm(f);
+        const QRectF tb(r.topLeft() + QPointF(2, 2), QSizeF(fm.horizontalAdvance(text) + 12, fm.height() + 6));
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(QColor(0, 0, 0, 160));
+        painter->drawRoundedRect(tb, 4, 4);
+        painter->setFont(f);
+        painter->setPen(Qt::white);
+        painter->drawText(tb.adjusted(6, 2, -6, -2), Qt::AlignVCenter | Qt::AlignLeft, text);
+    }
+}
+
+template <typename Fn>
+double timePerIteration(int iterations, Fn&& fn)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return timer.nsecsElapsed() / 1e6 / iterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QQuickWindow::setSceneGraphBackend(QSGRendererInterface::Software);
+    QGuiApplication app(argc, argv);
+
+    // 节点与纹理的创建依赖已初始化的场景图
+    QQuickWindow window;
+    window.resize(kTargetSize);
+    window.show();
+    QElapsedTimer initTimer;
+    initTimer.start();
+    while (!window.isSceneGraphInitialized() && initTimer.elapsed() < kInitTimeoutMs) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+    }
+    if (!window.isSceneGraphInitialized()) {
+        std::fprintf(stderr, "scene graph not initialized after %d ms\n", kInitTimeoutMs);
+        return 1;
+    }
+
+    const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 50;
+    const QRectF destRect(QPointF(0, 0), QSizeF(kTargetSize));
+    QImage target(kTargetSize, QImage::Format_ARGB32_Premultiplied);
+
+    std::printf("overlay node benchmark: %dx%d target, %d iterations (ms/update)\n",
+                kTargetSize.width(), kTargetSize.height(), iterations);
+    std::printf("%6s %10s %10s %10s\n", "boxes", "legacy", "node-cold", "node-warm");
+
+    bool ok = true;
+    // 子节点数应等于框数；标签纹理按文本缓存，数量应等于该节点见过的不同类别数
+    auto check = [&](const DetectionBoxesNode& node, int boxes, int textures, const char* stage) {
+        if (node.childCount() != boxes || node.labelTextureCount() != textures) {
+            std::fprintf(stderr, "%s: expected %d nodes / %d label textures, got %d / %d\n",
+                         stage, boxes, textures, node.childCount(), node.labelTextureCount());
+            ok = false;
+        }
+    };
+
+    for (int count : {10, 50, 100, 200}) {
+        // 两组框数相同、位置与类别不同的检测结果，交替更新以模拟逐帧变化
+        const QVector<OverlayBox> boxesA = makeBoxes(count, 42);
+        const QVector<OverlayBox> boxesB = makeBoxes(count, 43);
+        const QVariantList dets = toVariantList(boxesA);
+
+        DetectionOverlayRenderer overlay;
+        overlay.setFrameGeometry(kFrameSize, kModelInputSize);
+        for (int cls = 0; cls < 10; ++cls) {
+            overlay.setClassLabel(cls, QString::fromLatin1(kLabels[cls]));
+        }
+
+        const double legacy = timePerIteration(iterations, [&]() {
+            target.fill(Qt::transparent);
+            QPainter p(&target);
+            paintLegacy(&p, dets, destRect);
+        });
+
+        // 冷路径：每次新建节点树，包含 BoxNode 创建与标签纹理光栅化
+        overlay.setBoxes(boxesA);
+        const double cold = timePerIteration(iterations, [&]() {
+            DetectionBoxesNode node;
+            node.update(&window, overlay, destRect);
+        });
+        {
+            DetectionBoxesNode node;
+            node.update(&window, overlay, destRect);
+            check(node, count, distinctClasses(boxesA), "cold");
+        }
+
+        // 热路径：同一节点树，检测结果逐次变化
+        DetectionBoxesNode node;
+        node.update(&window, overlay, destRect);
+        int frame = 0;
+        const double warm = timePerIteration(iterations, [&]() {
+            overlay.setBoxes((++frame & 1) ? boxesB : boxesA);
+            node.update(&window, overlay, destRect);
+        });
+        check(node, count, distinctClasses(boxesA + boxesB), "warm");
+
+        std::printf("%6d %10.3f %10.3f %10.3f\n", count, legacy, cold, warm);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+// 由粗到细视差搜索（PyramidSgbm）与整帧完整搜索的对比评估
+//
+// 对每一对双目图分别做整帧完整搜索（原实现，作为基准结果）与 PyramidSgbm，输出：
+//   耗时与加速比；各块全分辨率搜索范围的平均宽度、退回完整范围的块比例；
+//   误差直方图：两边都有效的像素按 |Δd| 分桶（<=0.5、<=1、<=2、<=4、<=8、>8 像素），
+//   以及只有一边有效的像素比例。
+// 校验：|Δd| > 2 像素的比例 <= kMaxBadPixels，有效性不一致 <= kMaxValidityMismatch，否则返回非 0。
+// 双目对来自拍照目录（left_processed.png + right_processed.png，即已校正的保存结果），
+// 不给目录时用合成的近距离场景（大视差斜面 + 凸起台阶）。
+//
+// 构建：cmake -DSMARTSCOPE_BUILD_BENCHMARKS=ON ... &&
+//   ./bin/pyramid_sgbm_bench [iterations] [num_disparities] [levels] [capture_dir ...]
+// 无 Qt/RKNN 环境直接编译：
+//   g++ -O2 -std=c++17 -Ireference_code/SmartScope/src/stereo_depth/include $(pkg-config --cflags opencv4)
+//       -o pyramid_sgbm_bench benchmarks/pyramid_sgbm_bench.cpp
+//       reference_code/SmartScope/src/stereo_depth/src/sgbm_matcher_cache.cpp
+//       reference_code/SmartScope/src/stereo_depth/src/strip_sgbm_engine.cpp
+//       reference_code/SmartScope/src/stereo_depth/src/pyramid_sgbm.cpp $(pkg-config --libs opencv4)
+
+#include "stereo_depth/comprehensive_depth_processor.hpp"
+#include "stereo_depth/pyramid_sgbm.hpp"
+#include "stereo_depth/sgbm_matcher_cache.hpp"
+#include "stereo_bench_common.h"
+
+#include <stdlib.h>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using stereo_depth::ComprehensiveDepthOptions;
+using stereo_depth::PyramidSgbm;
+using stereo_depth::PyramidSgbmOptions;
+using stereo_depth::SgbmMatcherKey;
+using stereo_bench::StereoPair;
+using stereo_bench::load_pair;
+using stereo_bench::synthesize_pair;
+using stereo_bench::time_ms;
+
+namespace {
+
+const double kMaxBadPixels = 0.02;
+const double kMaxValidityMismatch = 0.05;
+
+const float kBucketEdges[] = {0.5f, 1.0f, 2.0f, 4.0f, 8.0f};
+const int kBuckets = sizeof(kBucketEdges) / sizeof(kBucketEdges[0]) + 1;
+
+// 近距离场景：视差从上到下 60 -> 200 的斜面，中间一块凸起再加 24 像素
+StereoPair synthesize_near_pair(int w, int h)
+{
+    const cv::Rect bump(w / 3, h / 3, w / 3, h / 3);
+    return synthesize_pair(w, h, 240, [&](int x, int y) {
+        return 60 + 140 * y / h + (bump.contains(cv::Point(x, y)) ? 24 : 0);
+    });
+}
+
+struct ErrorHistogram {
+    long buckets[kBuckets] = {};
+    long both = 0;
+    long only_reference = 0;
+    long only_test = 0;
+    long total = 0;
+
+    double bucket_fraction(int i) const { return both > 0 ? (double)buckets[i] / both : 0.0; }
+    double bad_fraction() const
+    {
+        long bad = 0;
+        for (int i = 3; i < kBuckets; i++) // > 2 像素
+        {
+            bad += buckets[i];
+        }
+        return both > 0 ? (double)bad / both : 0.0;
+    }
+    double mismatch_fraction() const { return total > 0 ? (double)(only_reference + only_test) / total : 0.0; }
+};
+
+ErrorHistogram histogram(const cv::Mat &reference, const cv::Mat &test, float invalid)
+{
+    ErrorHistogram h;
+    for (int y = 0; y < reference.rows; y++)
+    {
+        const float *r = reference.ptr<float>(y);
+        const float *t = test.ptr<float>(y);
+        for (int x = 0; x < reference.cols; x++)
+        {
+            const bool rv = r[x] > invalid;
+            const bool tv = t[x] > invalid;
+            h.total++;
+            if (rv && tv)
+            {
+                const float diff = std::fabs(r[x] - t[x]);
+                int b = 0;
+                while (b < kBuckets - 1 && diff > kBucketEdges[b])
+                {
+                    b++;
+                }
+                h.buckets[b]++;
+                h.both++;
+            }
+            else if (rv)
+            {
+                h.only_reference++;
+            }
+            else if (tv)
+            {
+                h.only_test++;
+            }
+        }
+    }
+    return h;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 5;
+    const int num_disparities = argc > 2 ? atoi(argv[2]) : 256;
+    const int levels = argc > 3 ? atoi(argv[3]) : 1;
+    if (iterations <= 0 || num_disparities <= 0 || num_disparities % 16 != 0 || levels < 1 || levels > 3)
+    {
+        fprintf(stderr, "用法: pyramid_sgbm_bench [iterations] [num_disparities(16 的倍数)] [levels 1-3] [capture_dir ...]\n");
+        return 1;
+    }
+
+    std::vector<StereoPair> pairs;
+    for (int i = 4; i < argc; i++)
+    {
+        StereoPair pair;
+        if (!load_pair(argv[i], pair))
+        {
+            fprintf(stderr, "%s: 读取 left_processed.png / right_processed.png 失败\n", argv[i]);
+            return 1;
+        }
+        pairs.push_back(pair);
+    }
+    if (pairs.empty())
+    {
+        pairs.push_back(synthesize_near_pair(1280, 720));
+        pairs.push_back(synthesize_near_pair(1920, 1080));
+    }
+
+    ComprehensiveDepthOptions options;
+    options.num_disparities = num_disparities;
+    const SgbmMatcherKey key = SgbmMatcherKey::fromOptions(options);
+    const float invalid = (float)(key.min_disparity - 1);
+
+    PyramidSgbmOptions pyramid_options;
+    pyramid_options.levels = levels;
+    pyramid_options.tile_width = options.pyramid_tile_size;
+    pyramid_options.tile_height = options.pyramid_tile_size;
+    pyramid_options.disparity_margin = options.pyramid_disparity_margin;
+    PyramidSgbm pyramid(pyramid_options);
+
+    printf("OpenCV %s, %d threads, num_disparities %d, coarse 1/%d, tile %d, margin %d, %d iterations\n", CV_VERSION,
+           cv::getNumThreads(), num_disparities, 1 << levels, pyramid_options.tile_width,
+           pyramid_options.disparity_margin, iterations);
+
+    bool ok = true;
+    for (const StereoPair &pair : pairs)
+    {
+        cv::Ptr<cv::StereoSGBM> matcher = key.createMatcher();
+        cv::Mat disp16S, reference, result;
+        const double full_ms = time_ms(iterations, [&]() {
+            matcher->compute(pair.left, pair.right, disp16S);
+            disp16S.convertTo(reference, CV_32F, 1.0 / 16.0);
+        });
+        const double pyramid_ms = time_ms(iterations, [&]() { pyramid.compute(key, pair.left, pair.right, result); });
+
+        const std::vector<PyramidSgbm::TileRange> tiles = pyramid.lastTiles();
+        double range_sum = 0.0;
+        int full_range = 0;
+        for (const PyramidSgbm::TileRange &t : tiles)
+        {
+            range_sum += t.num_disparities;
+            full_range += t.full_range ? 1 : 0;
+        }
+
+        const ErrorHistogram h = histogram(reference, result, invalid);
+        const bool pair_ok = h.bad_fraction() <= kMaxBadPixels && h.mismatch_fraction() <= kMaxValidityMismatch;
+        ok = ok && pair_ok;
+
+        printf("\n%s: full %.2f ms, pyramid %.2f ms (%.2fx)\n", pair.name.c_str(), full_ms, pyramid_ms,
+               pyramid_ms > 0.0 ? full_ms / pyramid_ms : 0.0);
+        printf("  tiles %zu, mean search range %.1f / %d, full-range tiles %d\n", tiles.size(),
+               tiles.empty() ? 0.0 : range_sum / tiles.size(), num_disparities, full_range);
+        printf("  |Δd| px   ");
+        for (int i = 0; i < kBuckets - 1; i++)
+        {
+            printf("  <=%-5.1f", kBucketEdges[i]);
+        }
+        printf("  >%-5.1f\n  fraction  ", kBucketEdges[kBuckets - 2]);
+        for (int i = 0; i < kBuckets; i++)
+        {
+            printf("  %6.3f%%", h.bucket_fraction(i) * 100.0);
+        }
+        printf("\n  only full valid %.3f%%, only pyramid valid %.3f%%, >2px %.3f%%  %s\n",
+               h.total > 0 ? h.only_reference * 100.0 / h.total : 0.0,
+               h.total > 0 ? h.only_test * 100.0 / h.total : 0.0, h.bad_fraction() * 100.0, pair_ok ? "ok" : "FAIL");
+    }
+
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,183 @@
+// SGBM 匹配器缓存的重复拍摄延迟基准
+//
+// 模拟连续多次深度拍摄，每次计算左视图视差 + 一致性检查用的右视图视差：
+//   原实现：每次重新 cv::StereoSGBM::create 并逐个 setter 配置（updateOptions / refineDisparity 的做法），
+//           视差输出写入新分配的 Mat；
+//   缓存：  SgbmMatcherCache 按参数复用匹配器与 16 位视差缓冲。
+// 两种方式的视差逐像素比较，必须完全一致；并校验整个过程只创建了两个匹配器。
+// 输入为合成的带纹理双目对（右图按已知视差平移），无需相机或标定文件；任一校验失败时返回非 0。
+//
+// 构建：cmake -DSMARTSCOPE_BUILD_BENCHMARKS=ON ... && ./bin/sgbm_matcher_cache_bench [captures] [width] [height]
+// 无 Qt/RKNN 环境直接编译：
+//   g++ -O2 -std=c++17 -Ireference_code/SmartScope/src/stereo_depth/include $(pkg-config --cflags opencv4)
+//       -o sgbm_matcher_cache_bench benchmarks/sgbm_matcher_cache_bench.cpp
+//       reference_code/SmartScope/src/stereo_depth/src/sgbm_matcher_cache.cpp $(pkg-config --libs opencv4)
+
+#include "stereo_depth/comprehensive_depth_processor.hpp"
+#include "stereo_depth/sgbm_matcher_cache.hpp"
+#include "stereo_bench_common.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using stereo_depth::ComprehensiveDepthOptions;
+using stereo_depth::SgbmMatcherCache;
+using stereo_depth::SgbmMatcherKey;
+using stereo_bench::StereoPair;
+using stereo_bench::synthesize_pair;
+
+namespace {
+
+const int kShift = 24;
+
+// 视差恒为 kShift 的平面
+StereoPair synthesize_plane_pair(int w, int h)
+{
+    return synthesize_pair(w, h, kShift, [](int, int) { return kShift; });
+}
+
+// 原实现的匹配器构建方式（create 后逐个 setter）
+cv::Ptr<cv::StereoSGBM> create_like_before(const ComprehensiveDepthOptions &o)
+{
+    cv::Ptr<cv::StereoSGBM> sgbm = cv::StereoSGBM::create(o.min_disparity, o.num_disparities, o.block_size);
+    sgbm->setP1(8 * o.block_size * o.block_size);
+    sgbm->setP2(32 * o.block_size * o.block_size);
+    sgbm->setDisp12MaxDiff(o.disp12_max_diff);
+    sgbm->setUniquenessRatio(o.uniqueness_ratio);
+    sgbm->setSpeckleWindowSize(o.speckle_window);
+    sgbm->setSpeckleRange(o.speckle_range);
+    sgbm->setPreFilterCap(o.prefilter_cap);
+    sgbm->setMode(cv::StereoSGBM::MODE_SGBM_3WAY);
+    return sgbm;
+}
+
+// 原 refineDisparity 的右视图匹配器
+cv::Ptr<cv::StereoSGBM> create_right_like_before()
+{
+    cv::Ptr<cv::StereoSGBM> sgbm = cv::StereoSGBM::create(0, 128, 5);
+    sgbm->setP1(8 * 5 * 5);
+    sgbm->setP2(32 * 5 * 5);
+    sgbm->setMode(cv::StereoSGBM::MODE_SGBM_3WAY);
+    return sgbm;
+}
+
+SgbmMatcherKey right_view_key()
+{
+    SgbmMatcherKey key;
+    key.num_disparities = 128;
+    key.block_size = 5;
+    key.p1 = 8 * 5 * 5;
+    key.p2 = 32 * 5 * 5;
+    key.mode = cv::StereoSGBM::MODE_SGBM_3WAY;
+    return key;
+}
+
+struct Timing {
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+Timing summarize(std::vector<double> samples)
+{
+    Timing t;
+    if (samples.empty())
+    {
+        return t;
+    }
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (double s : samples)
+    {
+        sum += s;
+    }
+    t.mean_ms = sum / samples.size();
+    t.p50_ms = samples[samples.size() / 2];
+    t.max_ms = samples.back();
+    return t;
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool same_disparity(const cv::Mat &a, const cv::Mat &b)
+{
+    return a.size() == b.size() && a.type() == b.type() && cv::norm(a, b, cv::NORM_INF) == 0.0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int captures = argc > 1 ? atoi(argv[1]) : 20;
+    const int width = argc > 2 ? atoi(argv[2]) : 1280;
+    const int height = argc > 3 ? atoi(argv[3]) : 720;
+    if (captures <= 0 || width <= kShift || height <= 0)
+    {
+        fprintf(stderr, "用法: sgbm_matcher_cache_bench [captures] [width] [height]\n");
+        return 1;
+    }
+
+    const ComprehensiveDepthOptions options;
+    const SgbmMatcherKey left_key = SgbmMatcherKey::fromOptions(options);
+    const SgbmMatcherKey right_key = right_view_key();
+    const StereoPair pair = synthesize_plane_pair(width, height);
+
+    printf("%dx%d, %d captures, OpenCV %s, %d threads\n", width, height, captures, CV_VERSION,
+           cv::getNumThreads());
+
+    std::vector<double> before_ms;
+    std::vector<double> before_setup_ms;
+    cv::Mat before_left, before_right;
+    for (int i = 0; i < captures; i++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        cv::Ptr<cv::StereoSGBM> sgbm = create_like_before(options);
+        cv::Ptr<cv::StereoSGBM> sgbm_right = create_right_like_before();
+        before_setup_ms.push_back(elapsed_ms(start));
+
+        cv::Mat disp16S, disp32F, disp16S_right, disp32F_right;
+        sgbm->compute(pair.left, pair.right, disp16S);
+        disp16S.convertTo(disp32F, CV_32F, 1.0 / 16.0);
+        sgbm_right->compute(pair.right, pair.left, disp16S_right);
+        disp16S_right.convertTo(disp32F_right, CV_32F, 1.0 / 16.0);
+        before_ms.push_back(elapsed_ms(start));
+
+        before_left = disp32F;
+        before_right = disp32F_right;
+    }
+
+    SgbmMatcherCache cache;
+    std::vector<double> cached_ms;
+    cv::Mat cached_left, cached_right;
+    for (int i = 0; i < captures; i++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        cache.computeDisparity(left_key, pair.left, pair.right, cached_left);
+        cache.computeDisparity(right_key, pair.right, pair.left, cached_right);
+        cached_ms.push_back(elapsed_ms(start));
+    }
+
+    const bool left_ok = same_disparity(before_left, cached_left);
+    const bool right_ok = same_disparity(before_right, cached_right);
+    const bool created_ok = cache.createdCount() == 2;
+
+    const Timing before = summarize(before_ms);
+    const Timing setup = summarize(before_setup_ms);
+    const Timing cached = summarize(cached_ms);
+    printf("%-24s %10s %10s %10s\n", "per capture", "mean ms", "p50 ms", "max ms");
+    printf("%-24s %10.2f %10.2f %10.2f\n", "create per capture", before.mean_ms, before.p50_ms, before.max_ms);
+    printf("%-24s %10.3f %10.3f %10.3f\n", "  (create + setters)", setup.mean_ms, setup.p50_ms, setup.max_ms);
+    printf("%-24s %10.2f %10.2f %10.2f\n", "cached matchers", cached.mean_ms, cached.p50_ms, cached.max_ms);
+    printf("speedup (mean): %.2fx\n", cached.mean_ms > 0.0 ? before.mean_ms / cached.mean_ms : 0.0);
+    printf("视差一致: 左 %s，右 %s；创建匹配器 %llu 个（期望 2）\n", left_ok ? "是" : "否", right_ok ? "是" : "否",
+           (unsigned long long)cache.createdCount());
+
+    return left_ok && right_ok && created_ok ? 0 : 2;
+}
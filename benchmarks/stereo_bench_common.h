@@ -0,0 +1,71 @@
+// 双目深度基准共用的输入构造与计时工具（只含头文件，随各基准一起编译）
+//
+// StereoPair：已校正的灰度双目对，来自拍照目录（load_pair）或合成（synthesize_pair）；
+// time_ms：预热一次后取 iterations 次的平均耗时。
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <stdint.h>
+
+#include <chrono>
+#include <string>
+
+namespace stereo_bench {
+
+struct StereoPair {
+    std::string name;
+    cv::Mat left;
+    cv::Mat right;
+};
+
+// 随机纹理（轻微模糊）的合成双目对：right(x, y) = T(x + max_shift, y)，left(x, y) = right(x - d, y)，
+// d = disparity(x, y)，取值须在 [0, max_shift] 内。纹理种子固定，同样的参数每次生成同样的图像。
+template <typename DisparityFn>
+StereoPair synthesize_pair(int w, int h, int max_shift, DisparityFn disparity)
+{
+    cv::RNG rng(12345);
+    cv::Mat texture(h, w + max_shift, CV_8UC1);
+    rng.fill(texture, cv::RNG::UNIFORM, 0, 256);
+    cv::GaussianBlur(texture, texture, cv::Size(3, 3), 0);
+
+    StereoPair pair;
+    pair.name = "synthetic " + std::to_string(w) + "x" + std::to_string(h);
+    pair.right = texture(cv::Rect(max_shift, 0, w, h)).clone();
+    pair.left.create(h, w, CV_8UC1);
+    for (int y = 0; y < h; y++)
+    {
+        const uint8_t *src = texture.ptr<uint8_t>(y);
+        uint8_t *dst = pair.left.ptr<uint8_t>(y);
+        for (int x = 0; x < w; x++)
+        {
+            dst[x] = src[x + max_shift - disparity(x, y)];
+        }
+    }
+    return pair;
+}
+
+// 拍照目录中保存的已校正图像（left_processed.png + right_processed.png）
+inline bool load_pair(const std::string &dir, StereoPair &pair)
+{
+    pair.name = dir;
+    pair.left = cv::imread(dir + "/left_processed.png", cv::IMREAD_GRAYSCALE);
+    pair.right = cv::imread(dir + "/right_processed.png", cv::IMREAD_GRAYSCALE);
+    return !pair.left.empty() && pair.left.size() == pair.right.size();
+}
+
+template <typename Fn>
+double time_ms(int iterations, Fn fn)
+{
+    fn(); // 预热（创建匹配器、分配缓冲）
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        fn();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+} // namespace stereo_bench
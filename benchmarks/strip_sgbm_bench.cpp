@@ -0,0 +1,187 @@
+// 条带并行 / ROI SGBM 的精度对齐与吞吐基准
+//
+// 对每一对双目图：
+//   整帧：单个匹配器整帧计算（原实现，作为基准结果）；
+//   条带：StripSgbmEngine 按 OpenCV 线程数切条带并行计算；
+//   ROI： 只算图像中央 1/4 面积的矩形。
+// 精度校验（与整帧结果比较）：
+//   有效性不一致的像素比例 <= kMaxValidityMismatch，两边都有效且相差 > 1px 的比例 <= kMaxBadPixels；
+//   ROI 只统计 ROI 内部，ROI 外必须全部为无效视差；
+//   strips = 1 时必须与整帧逐像素一致。
+// 双目对来自拍照目录（left_processed.png + right_processed.png，即已校正的保存结果），
+// 不给目录时用合成的带纹理双目对（视差随行变化的斜面）。任一校验失败时返回非 0。
+//
+// 构建：cmake -DSMARTSCOPE_BUILD_BENCHMARKS=ON ... && ./bin/strip_sgbm_bench [iterations] [capture_dir ...]
+// 无 Qt/RKNN 环境直接编译：
+//   g++ -O2 -std=c++17 -Ireference_code/SmartScope/src/stereo_depth/include $(pkg-config --cflags opencv4)
+//       -o strip_sgbm_bench benchmarks/strip_sgbm_bench.cpp
+//       reference_code/SmartScope/src/stereo_depth/src/sgbm_matcher_cache.cpp
+//       reference_code/SmartScope/src/stereo_depth/src/strip_sgbm_engine.cpp $(pkg-config --libs opencv4)
+
+#include "stereo_depth/comprehensive_depth_processor.hpp"
+#include "stereo_depth/sgbm_matcher_cache.hpp"
+#include "stereo_depth/strip_sgbm_engine.hpp"
+#include "stereo_bench_common.h"
+
+#include <stdlib.h>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using stereo_depth::ComprehensiveDepthOptions;
+using stereo_depth::SgbmMatcherKey;
+using stereo_depth::StripSgbmEngine;
+using stereo_depth::StripSgbmOptions;
+using stereo_bench::StereoPair;
+using stereo_bench::load_pair;
+using stereo_bench::synthesize_pair;
+using stereo_bench::time_ms;
+
+namespace {
+
+const double kMaxValidityMismatch = 0.02;
+const double kMaxBadPixels = 0.01;
+
+// 斜面：d(y) = 16 + 32 * y / h
+StereoPair synthesize_slope_pair(int w, int h)
+{
+    return synthesize_pair(w, h, 48, [h](int, int y) { return 16 + 32 * y / h; });
+}
+
+struct Parity {
+    double validity_mismatch = 0.0;
+    double bad_pixels = 0.0;
+    bool outside_invalid = true;
+};
+
+// 只比较 region 内部；region 外要求 test 全为无效视差
+Parity compare(const cv::Mat &reference, const cv::Mat &test, const cv::Rect &region, float invalid)
+{
+    Parity p;
+    long total = 0;
+    long mismatch = 0;
+    long both = 0;
+    long bad = 0;
+    for (int y = 0; y < reference.rows; y++)
+    {
+        const float *r = reference.ptr<float>(y);
+        const float *t = test.ptr<float>(y);
+        for (int x = 0; x < reference.cols; x++)
+        {
+            if (!region.contains(cv::Point(x, y)))
+            {
+                if (t[x] != invalid)
+                {
+                    p.outside_invalid = false;
+                }
+                continue;
+            }
+            const bool rv = r[x] > invalid;
+            const bool tv = t[x] > invalid;
+            total++;
+            if (rv != tv)
+            {
+                mismatch++;
+            }
+            else if (rv)
+            {
+                both++;
+                if (std::fabs(r[x] - t[x]) > 1.0f)
+                {
+                    bad++;
+                }
+            }
+        }
+    }
+    p.validity_mismatch = total > 0 ? (double)mismatch / total : 0.0;
+    p.bad_pixels = both > 0 ? (double)bad / both : 0.0;
+    return p;
+}
+
+bool parity_ok(const Parity &p)
+{
+    return p.outside_invalid && p.validity_mismatch <= kMaxValidityMismatch && p.bad_pixels <= kMaxBadPixels;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 10;
+    if (iterations <= 0)
+    {
+        fprintf(stderr, "用法: strip_sgbm_bench [iterations] [capture_dir ...]\n");
+        return 1;
+    }
+
+    std::vector<StereoPair> pairs;
+    for (int i = 2; i < argc; i++)
+    {
+        StereoPair pair;
+        if (!load_pair(argv[i], pair))
+        {
+            fprintf(stderr, "%s: 读取 left_processed.png / right_processed.png 失败\n", argv[i]);
+            return 1;
+        }
+        pairs.push_back(pair);
+    }
+    if (pairs.empty())
+    {
+        pairs.push_back(synthesize_slope_pair(1280, 720));
+        pairs.push_back(synthesize_slope_pair(1920, 1080));
+    }
+
+    const ComprehensiveDepthOptions options;
+    const SgbmMatcherKey key = SgbmMatcherKey::fromOptions(options);
+    const float invalid = (float)(key.min_disparity - 1);
+
+    StripSgbmOptions strip_options;
+    strip_options.path_margin = options.sgbm_path_margin;
+    StripSgbmEngine engine(strip_options);
+    StripSgbmOptions single_options = strip_options;
+    single_options.strips = 1;
+    StripSgbmEngine single(single_options);
+
+    printf("OpenCV %s, %d threads, path margin %d, %d iterations\n", CV_VERSION, cv::getNumThreads(),
+           strip_options.path_margin, iterations);
+    printf("%-28s %6s %10s %10s %10s %8s %10s %10s %6s\n", "pair", "strips", "full ms", "strip ms", "roi ms",
+           "speedup", "mismatch", "bad >1px", "ok");
+
+    bool ok = true;
+    for (const StereoPair &pair : pairs)
+    {
+        const cv::Size size = pair.left.size();
+        const cv::Rect full(0, 0, size.width, size.height);
+        const cv::Rect roi(size.width * 3 / 8, size.height * 3 / 8, size.width / 4, size.height / 4);
+
+        cv::Ptr<cv::StereoSGBM> matcher = key.createMatcher();
+        cv::Mat disp16S, reference, strips, roi_disp, single_disp;
+        const double full_ms = time_ms(iterations, [&]() {
+            matcher->compute(pair.left, pair.right, disp16S);
+            disp16S.convertTo(reference, CV_32F, 1.0 / 16.0);
+        });
+        const double strip_ms = time_ms(iterations, [&]() { engine.compute(key, pair.left, pair.right, strips); });
+        const double roi_ms = time_ms(iterations, [&]() { engine.computeRoi(key, pair.left, pair.right, roi, roi_disp); });
+        single.compute(key, pair.left, pair.right, single_disp);
+
+        const Parity strip_parity = compare(reference, strips, full, invalid);
+        const Parity roi_parity = compare(reference, roi_disp, roi, invalid);
+        const bool single_ok = cv::norm(reference, single_disp, cv::NORM_INF) == 0.0;
+        const bool pair_ok = parity_ok(strip_parity) && parity_ok(roi_parity) && single_ok;
+        ok = ok && pair_ok;
+
+        printf("%-28s %6d %10.2f %10.2f %10.2f %7.2fx %9.3f%% %9.3f%% %6s\n", pair.name.c_str(),
+               engine.stripCount(size.height), full_ms, strip_ms, roi_ms, strip_ms > 0.0 ? full_ms / strip_ms : 0.0,
+               strip_parity.validity_mismatch * 100.0, strip_parity.bad_pixels * 100.0, pair_ok ? "yes" : "NO");
+        printf("%-28s %6s %10s %10s %10s %8s %9.3f%% %9.3f%% %6s\n", "  roi (center 1/4 area)", "", "", "", "", "",
+               roi_parity.validity_mismatch * 100.0, roi_parity.bad_pixels * 100.0,
+               roi_parity.outside_invalid ? "" : "leak");
+        if (!single_ok)
+        {
+            printf("  strips = 1 与整帧结果不一致\n");
+        }
+    }
+
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,357 @@
+// 张量后端（拷贝 / zero copy）与原生布局解码微基准
+//
+// 用主机回放后端（yolov8_tensor.h）模拟两种 NPU 输出方式，每帧 run -> outputs -> 解码 -> NMS：
+//   copy      每帧把 NCHW 输出拷进后端缓冲（对应 rknn_outputs_get），NCHW 解码
+//   zero copy 视图直接指向常驻输出，分别以 NCHW、NC1HWC2（c2=16，RK3588 原生）、
+//             NHWC（c2=C，RV1106 原生）布局解码
+// 逐帧校验各方式的候选与 NMS 结果与 copy/NCHW 逐位一致（含类别过滤），并校验稳态下工作区没有分配。
+// 输入为推理时录制的 .yv8t（SMARTSCOPE_RKNN_DUMP_DIR，任意布局），未提供时合成有/无 score_sum
+// 两组各 4 帧的 640x640 int8 输出；不需要 NPU，可在 x86 CI 上运行；任一校验失败时返回非 0。
+//
+// 构建：cmake -DSMARTSCOPE_BUILD_BENCHMARKS=ON ... && ./bin/yolov8_backend_bench [iterations] [outputs.yv8t ...]
+// 无 Qt/RKNN 环境（x86 CI）直接编译：
+//   g++ -O2 -std=c++11 -Icrates/rknn-inference/include -o yolov8_backend_bench
+//       benchmarks/yolov8_backend_bench.cpp crates/rknn-inference/csrc/yolov8_tensor.cc
+//       crates/rknn-inference/csrc/yolov8_decode.cc crates/rknn-inference/csrc/yolov8_nms.cc
+//       crates/rknn-inference/csrc/yolov8_arena.cc
+
+#include "yolov8_arena.h"
+#include "yolov8_tensor.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int kMaxDetections = 128;
+const int kMaxOutputs = 9;
+const int kFilterClasses[] = {0, 2, 7}; // COCO person / car / truck
+
+// 合成一帧 640x640 模型三分支 int8 输出（NCHW，box / score [/ score_sum]），约 1% 的格子有目标
+yolov8_tensor_frame synthesize_frame(unsigned seed, bool with_score_sum)
+{
+    const int kClasses = 80;
+    const int kDfl = 16;
+    const int kGrids[3] = {80, 40, 20};
+
+    yolov8_tensor_frame f;
+    f.model_width = 640;
+    f.model_height = 640;
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> box_q(-60, 60);
+    std::uniform_int_distribution<int> low_q(-128, -100);
+    std::uniform_int_distribution<int> hot_q(-40, 127);
+    std::uniform_int_distribution<int> cls_pick(0, kClasses - 1);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+    for (int g : kGrids)
+    {
+        const int grid_len = g * g;
+        yolov8_tensor_record box;
+        memset(&box, 0, sizeof(box));
+        box.type = YOLOV8_TENSOR_INT8;
+        box.scale = 0.08f;
+        box.dims[0] = 1; box.dims[1] = 4 * kDfl; box.dims[2] = g; box.dims[3] = g;
+        box.w_stride = g;
+        box.size = 4 * kDfl * grid_len;
+        std::vector<uint8_t> box_data(box.size);
+        for (auto &v : box_data)
+        {
+            v = (uint8_t)(int8_t)box_q(rng);
+        }
+
+        yolov8_tensor_record score = box;
+        score.zp = -128;
+        score.scale = 1.0f / 255.0f;
+        score.dims[1] = kClasses;
+        score.size = kClasses * grid_len;
+        std::vector<uint8_t> score_data(score.size);
+        for (auto &v : score_data)
+        {
+            v = (uint8_t)(int8_t)low_q(rng);
+        }
+
+        yolov8_tensor_record sum = score;
+        sum.dims[1] = 1;
+        sum.size = grid_len;
+        std::vector<uint8_t> sum_data(grid_len, (uint8_t)(int8_t)-128);
+
+        for (int cell = 0; cell < grid_len; cell++)
+        {
+            if (chance(rng) > 0.01f)
+            {
+                continue;
+            }
+            int best = -128;
+            const int hot = 1 + (int)(chance(rng) * 3);
+            const int tie = hot_q(rng);
+            for (int h = 0; h < hot; h++)
+            {
+                const int v = h < 2 ? tie : hot_q(rng);
+                score_data[(size_t)cls_pick(rng) * grid_len + cell] = (uint8_t)(int8_t)v;
+                best = v > best ? v : best;
+            }
+            sum_data[cell] = (uint8_t)(int8_t)best;
+        }
+
+        f.records.push_back(box);
+        f.data.push_back(std::move(box_data));
+        f.records.push_back(score);
+        f.data.push_back(std::move(score_data));
+        if (with_score_sum)
+        {
+            f.records.push_back(sum);
+            f.data.push_back(std::move(sum_data));
+        }
+    }
+    return f;
+}
+
+struct Mode {
+    const char *name;
+    uint32_t layout;
+    uint32_t c2;     // 0 表示 NHWC（c2 取各张量通道数）
+    bool copy_outputs;
+};
+
+// 每帧结果：候选与 NMS 保留下标
+struct FrameResult {
+    std::vector<float> boxes;
+    std::vector<float> probs;
+    std::vector<int> classes;
+    std::vector<int> keep;
+
+    bool operator==(const FrameResult &o) const
+    {
+        return boxes == o.boxes && probs == o.probs && classes == o.classes && keep == o.keep;
+    }
+};
+
+// 按模式重排：NHWC 为每个张量单独取 c2 = C
+bool repack_frames(const std::vector<yolov8_tensor_frame> &in, const Mode &mode, std::vector<yolov8_tensor_frame> &out)
+{
+    out.clear();
+    for (const yolov8_tensor_frame &f : in)
+    {
+        yolov8_tensor_frame packed;
+        if (mode.layout == YOLOV8_LAYOUT_NC1HWC2 && mode.c2 == 0)
+        {
+            packed.model_width = f.model_width;
+            packed.model_height = f.model_height;
+            for (size_t i = 0; i < f.records.size(); i++)
+            {
+                yolov8_tensor_frame one;
+                yolov8_tensor_frame one_packed;
+                one.records.push_back(f.records[i]);
+                one.data.push_back(f.data[i]);
+                if (yolov8_tensor_frame_repack(&one, YOLOV8_LAYOUT_NC1HWC2, f.records[i].dims[1], &one_packed) != 0)
+                {
+                    return false;
+                }
+                packed.records.push_back(one_packed.records[0]);
+                packed.data.push_back(std::move(one_packed.data[0]));
+            }
+        }
+        else if (yolov8_tensor_frame_repack(&f, mode.layout, mode.c2, &packed) != 0)
+        {
+            return false;
+        }
+        out.push_back(std::move(packed));
+    }
+    return true;
+}
+
+// 与 post_process_views 相同的一帧：run -> outputs -> 解码 -> NMS
+int run_frame(yolov8_tensor_backend *backend, yolov8_postprocess_arena *arena, int model_height, FrameResult *result)
+{
+    yolov8_tensor_view views[kMaxOutputs];
+    if (backend->run() != 0)
+    {
+        return -1;
+    }
+    const int n = backend->outputs(views, kMaxOutputs);
+    if (n < 0)
+    {
+        return -1;
+    }
+    yolov8_candidates *c = yolov8_arena_begin(arena);
+    int num_classes = 0;
+    const int *classes = yolov8_arena_classes(arena, &num_classes);
+    if (yolov8_decode_outputs(views, n, model_height, classes, num_classes, c, arena->config.conf_threshold) < 0)
+    {
+        return -1;
+    }
+    yolov8_nms_config config;
+    config.nms_threshold = arena->config.nms_threshold;
+    config.max_detections = arena->config.max_detections;
+    config.class_batched = 0;
+    const int kept = yolov8_nms(c->boxes, c->probs, c->class_ids, c->count, &config, arena->keep.data(), &arena->nms);
+    if (result != nullptr)
+    {
+        result->boxes.assign(c->boxes, c->boxes + (size_t)c->count * 4);
+        result->probs.assign(c->probs, c->probs + c->count);
+        result->classes.assign(c->class_ids, c->class_ids + c->count);
+        result->keep.assign(arena->keep.data(), arena->keep.data() + kept);
+    }
+    backend->release_outputs();
+    return c->count;
+}
+
+const char *simd_name()
+{
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return "NEON";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+// 对一组帧跑全部模式：逐帧校验与 copy / NCHW 一致，并计时（全类别 / 类别过滤）
+bool run_table(const char *label, const std::vector<yolov8_tensor_frame> &frames, int iterations)
+{
+    bool ok = true;
+    const int n_frames = (int)frames.size();
+    const int model_height = frames[0].model_height;
+    const int input_size = frames[0].model_width * frames[0].model_height * 3;
+
+    int max_candidates = 0;
+    for (size_t i = 0; i < frames[0].records.size(); i += frames[0].records.size() / 3)
+    {
+        max_candidates += frames[0].records[i].dims[2] * frames[0].records[i].dims[3];
+    }
+    const int num_classes = frames[0].records[1].dims[1];
+
+    const Mode modes[] = {
+        {"copy / NCHW", YOLOV8_LAYOUT_NCHW, 0, true},
+        {"zero copy / NCHW", YOLOV8_LAYOUT_NCHW, 0, false},
+        {"zero copy / NC1HWC2 c2=16", YOLOV8_LAYOUT_NC1HWC2, 16, false},
+        {"zero copy / NHWC", YOLOV8_LAYOUT_NC1HWC2, 0, false},
+    };
+
+    yolov8_postprocess_config filtered;
+    yolov8_postprocess_default_config(&filtered, kMaxDetections);
+    for (int c : kFilterClasses)
+    {
+        filtered.class_mask[c / 64] |= 1ull << (c % 64);
+    }
+
+    printf("%s: %d frames\n", label, n_frames);
+
+    std::vector<FrameResult> reference[2];
+    double reference_us = 0.0;
+    for (const Mode &mode : modes)
+    {
+        std::vector<yolov8_tensor_frame> packed;
+        if (!repack_frames(frames, mode, packed))
+        {
+            printf("%-28s 重排失败\n", mode.name);
+            ok = false;
+            continue;
+        }
+        yolov8_tensor_backend *backend = yolov8_host_backend_create(packed, input_size, mode.copy_outputs);
+        yolov8_postprocess_arena *arena = yolov8_arena_create(max_candidates, num_classes, kMaxDetections);
+
+        // 校验：第 0 项为全类别，第 1 项为类别过滤；以 copy / NCHW 为参照
+        bool same = true;
+        int candidates = 0;
+        for (int pass = 0; pass < 2; pass++)
+        {
+            yolov8_postprocess_config config;
+            yolov8_postprocess_default_config(&config, kMaxDetections);
+            yolov8_arena_configure(arena, pass == 0 ? &config : &filtered);
+            std::vector<FrameResult> results(n_frames);
+            for (int f = 0; f < n_frames; f++)
+            {
+                const int n = run_frame(backend, arena, model_height, &results[f]);
+                same = same && n >= 0;
+                candidates += pass == 0 && n > 0 ? n : 0;
+            }
+            if (reference[pass].empty())
+            {
+                reference[pass] = results;
+            }
+            same = same && results == reference[pass];
+        }
+
+        double us[2];
+        uint64_t arena_allocs = 0;
+        for (int pass = 0; pass < 2; pass++)
+        {
+            yolov8_postprocess_config config;
+            yolov8_postprocess_default_config(&config, kMaxDetections);
+            yolov8_arena_configure(arena, pass == 0 ? &config : &filtered);
+            run_frame(backend, arena, model_height, nullptr);
+            const uint64_t before = yolov8_arena_allocations(arena);
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations * n_frames; i++)
+            {
+                run_frame(backend, arena, model_height, nullptr);
+            }
+            const auto end = std::chrono::steady_clock::now();
+            us[pass] = std::chrono::duration<double, std::micro>(end - start).count() / (iterations * n_frames);
+            arena_allocs += yolov8_arena_allocations(arena) - before;
+        }
+        if (reference_us == 0.0)
+        {
+            reference_us = us[0];
+        }
+
+        ok = ok && same && arena_allocs == 0;
+        printf("%-28s %12.1f %14.1f %12d %12llu  %.2fx%s\n", mode.name, us[0], us[1], candidates / n_frames,
+               (unsigned long long)arena_allocs, reference_us / us[0], same ? "" : "  MISMATCH");
+        yolov8_arena_destroy(arena);
+        yolov8_tensor_backend_destroy(backend);
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 200;
+    if (iterations <= 0)
+    {
+        fprintf(stderr, "用法: yolov8_backend_bench [iterations] [outputs.yv8t ...]\n");
+        return 1;
+    }
+
+    // 统一先转成 NCHW 作为参照，各模式再从它重排
+    std::vector<yolov8_tensor_frame> frames;
+    for (int i = 2; i < argc; i++)
+    {
+        yolov8_tensor_frame f;
+        if (yolov8_tensor_file_read(argv[i], &f) != 0 || f.records.size() % 3 != 0 ||
+            yolov8_tensor_frame_repack(&f, YOLOV8_LAYOUT_NCHW, 0, &f) != 0)
+        {
+            fprintf(stderr, "%s 不是有效的 .yv8t 文件\n", argv[i]);
+            return 1;
+        }
+        frames.push_back(std::move(f));
+    }
+
+    printf("SIMD: %s, %d iterations\n", simd_name(), iterations);
+    printf("%-28s %12s %14s %12s %12s\n", "backend / layout", "us/frame", "classes{0,2,7}", "candidates", "arena allocs");
+    if (!frames.empty())
+    {
+        return run_table("recorded", frames, iterations) ? 0 : 2;
+    }
+    bool ok = true;
+    for (int with_sum = 1; with_sum >= 0; with_sum--)
+    {
+        std::vector<yolov8_tensor_frame> synthetic;
+        for (unsigned seed = 0; seed < 4; seed++)
+        {
+            synthetic.push_back(synthesize_frame(1234 + seed, with_sum != 0));
+        }
+        ok = run_table(with_sum ? "synthetic int8, with score_sum" : "synthetic int8, no score_sum", synthetic, iterations) && ok;
+    }
+    return ok ? 0 : 2;
+}
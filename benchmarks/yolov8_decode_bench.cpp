@@ -0,0 +1,562 @@
+// YOLOv8 候选解码微基准
+//
+// 对比原 postprocess.cc 中逐格子、逐类别跨步扫描的标量解码（此处保留一份副本作为基线）
+// 与 yolov8_decode 的 SIMD 类别最大值 + 幸存格子解码，并逐位校验两者输出一致。
+// 输入为推理时录制的输出张量（SMARTSCOPE_RKNN_DUMP_DIR 生成的 .yv8t），
+// 未提供时合成 640x640 模型的三分支 int8 输出；不需要 NPU，可在 x86 CI 上运行。
+// 同时以工作区（yolov8_arena）跑解码 + NMS，校验稳态下没有任何堆分配（operator new 计数为 0）；
+// 并测只保留少数类别（类别位图）时的解码耗时，对照全类别解码逐位校验。
+//
+// 构建：cmake -DSMARTSCOPE_BUILD_BENCHMARKS=ON ... && ./bin/yolov8_decode_bench [iterations] [outputs.yv8t ...]
+// 无 Qt/RKNN 环境（x86 CI）直接编译：
+//   g++ -O2 -std=c++11 -Icrates/rknn-inference/include -o yolov8_decode_bench
+//       benchmarks/yolov8_decode_bench.cpp crates/rknn-inference/csrc/yolov8_decode.cc
+//       crates/rknn-inference/csrc/yolov8_nms.cc crates/rknn-inference/csrc/yolov8_arena.cc
+//       crates/rknn-inference/csrc/yolov8_tensor.cc
+
+#include "yolov8_arena.h"
+#include "yolov8_tensor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// 统计全进程 operator new 次数，用于校验稳态后处理零分配。
+// 工作区的 allocations 计数由代码自行累加（只记录已知的预留点），不能证明没有其他分配；
+// 零分配以这里的计数为准。
+static std::atomic<uint64_t> g_heap_allocations(0);
+
+void *operator new(std::size_t size)
+{
+    g_heap_allocations++;
+    void *p = malloc(size ? size : 1);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+// 不内联：否则 GCC 在调用点把 free 与 operator new 配对检查，误报 -Wmismatched-new-delete
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+// C++14 起编译器对已知大小的对象调用带大小的版本；一并替换，-Wsized-deallocation 下不告警
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void operator delete(void *p, std::size_t) noexcept
+{
+    free(p);
+}
+
+namespace {
+
+const float kThreshold = 0.25f;
+const int kMaxDetections = 128;
+const int kFilterClasses[] = {0, 2, 7}; // COCO person / car / truck
+
+struct Tensor {
+    uint32_t type = YOLOV8_TENSOR_INT8;
+    int32_t zp = 0;
+    float scale = 1.0f;
+    uint32_t dims[4] = {0, 0, 0, 0};
+    std::vector<uint8_t> data;
+};
+
+struct Branch {
+    const Tensor *box = nullptr;
+    const Tensor *score = nullptr;
+    const Tensor *score_sum = nullptr;
+    int grid_h = 0;
+    int grid_w = 0;
+    int stride = 0;
+    int dfl_len = 0;
+    int num_classes = 0;
+};
+
+struct Outputs {
+    std::string name;
+    int model_height = 640;
+    std::vector<Tensor> tensors;
+    std::vector<Branch> branches;
+};
+
+struct Candidates {
+    std::vector<float> boxes;
+    std::vector<float> probs;
+    std::vector<int> classes;
+    int count = 0;
+
+    void clear()
+    {
+        boxes.clear();
+        probs.clear();
+        classes.clear();
+        count = 0;
+    }
+};
+
+// ---- 基线：原 process_i8 / process_u8 / process_fp32 ----
+
+template <typename T>
+float baseline_deqnt(T q, int32_t zp, float scale) { return ((float)q - (float)zp) * scale; }
+
+template <typename T>
+int baseline_process(const T *box_tensor, int32_t box_zp, float box_scale,
+                     const T *score_tensor, int32_t score_zp, float score_scale,
+                     const T *score_sum_tensor, T score_sum_thres, T score_thres, T max_init, bool quantized,
+                     int grid_h, int grid_w, int stride, int dfl_len, int num_classes, Candidates &out)
+{
+    int validCount = 0;
+    int grid_len = grid_h * grid_w;
+    for (int i = 0; i < grid_h; i++)
+    {
+        for (int j = 0; j < grid_w; j++)
+        {
+            int offset = i * grid_w + j;
+            int max_class_id = -1;
+
+            if (score_sum_tensor != nullptr)
+            {
+                if (score_sum_tensor[offset] < score_sum_thres)
+                {
+                    continue;
+                }
+            }
+
+            T max_score = max_init;
+            for (int c = 0; c < num_classes; c++)
+            {
+                if ((score_tensor[offset] > score_thres) && (score_tensor[offset] > max_score))
+                {
+                    max_score = score_tensor[offset];
+                    max_class_id = c;
+                }
+                offset += grid_len;
+            }
+
+            if (max_score > score_thres)
+            {
+                offset = i * grid_w + j;
+                float box[4];
+                std::vector<float> before_dfl(dfl_len * 4);
+                for (int k = 0; k < dfl_len * 4; k++)
+                {
+                    before_dfl[k] = quantized ? baseline_deqnt(box_tensor[offset], box_zp, box_scale) : (float)box_tensor[offset];
+                    offset += grid_len;
+                }
+                yolov8_compute_dfl(before_dfl.data(), dfl_len, box);
+
+                float x1, y1, x2, y2, w, h;
+                x1 = (-box[0] + j + 0.5) * stride;
+                y1 = (-box[1] + i + 0.5) * stride;
+                x2 = (box[2] + j + 0.5) * stride;
+                y2 = (box[3] + i + 0.5) * stride;
+                w = x2 - x1;
+                h = y2 - y1;
+                out.boxes.push_back(x1);
+                out.boxes.push_back(y1);
+                out.boxes.push_back(w);
+                out.boxes.push_back(h);
+
+                out.probs.push_back(quantized ? baseline_deqnt(max_score, score_zp, score_scale) : (float)max_score);
+                out.classes.push_back(max_class_id);
+                validCount++;
+            }
+        }
+    }
+    return validCount;
+}
+
+int run_baseline(const Branch &b, Candidates &out)
+{
+    const Tensor &box = *b.box;
+    const Tensor &score = *b.score;
+    const Tensor *sum = b.score_sum;
+    const int32_t sum_zp = sum ? sum->zp : 0;
+    const float sum_scale = sum ? sum->scale : 1.0f;
+    switch (score.type)
+    {
+    case YOLOV8_TENSOR_INT8:
+        return baseline_process<int8_t>(
+            (const int8_t *)box.data.data(), box.zp, box.scale, (const int8_t *)score.data.data(), score.zp, score.scale,
+            sum ? (const int8_t *)sum->data.data() : nullptr, yolov8_qnt_f32_to_i8(kThreshold, sum_zp, sum_scale),
+            yolov8_qnt_f32_to_i8(kThreshold, score.zp, score.scale), (int8_t)(-score.zp), true,
+            b.grid_h, b.grid_w, b.stride, b.dfl_len, b.num_classes, out);
+    case YOLOV8_TENSOR_UINT8:
+        return baseline_process<uint8_t>(
+            box.data.data(), box.zp, box.scale, score.data.data(), score.zp, score.scale,
+            sum ? sum->data.data() : nullptr, yolov8_qnt_f32_to_u8(kThreshold, sum_zp, sum_scale),
+            yolov8_qnt_f32_to_u8(kThreshold, score.zp, score.scale), (uint8_t)(-score.zp), true,
+            b.grid_h, b.grid_w, b.stride, b.dfl_len, b.num_classes, out);
+    default:
+        return baseline_process<float>(
+            (const float *)box.data.data(), 0, 1.0f, (const float *)score.data.data(), 0, 1.0f,
+            sum ? (const float *)sum->data.data() : nullptr, kThreshold, kThreshold, 0.0f, false,
+            b.grid_h, b.grid_w, b.stride, b.dfl_len, b.num_classes, out);
+    }
+}
+
+int run_decode(const Branch &b, const int *classes, int num_classes, yolov8_candidates *out)
+{
+    const Tensor &box = *b.box;
+    const Tensor &score = *b.score;
+    const Tensor *sum = b.score_sum;
+    const int32_t sum_zp = sum ? sum->zp : 0;
+    const float sum_scale = sum ? sum->scale : 1.0f;
+    switch (score.type)
+    {
+    case YOLOV8_TENSOR_INT8:
+        return yolov8_decode_branch_i8(
+            (const int8_t *)box.data.data(), box.zp, box.scale, (const int8_t *)score.data.data(), score.zp, score.scale,
+            sum ? (const int8_t *)sum->data.data() : nullptr, sum_zp, sum_scale,
+            b.grid_h, b.grid_w, b.stride, b.dfl_len, classes, num_classes, out, kThreshold);
+    case YOLOV8_TENSOR_UINT8:
+        return yolov8_decode_branch_u8(
+            box.data.data(), box.zp, box.scale, score.data.data(), score.zp, score.scale,
+            sum ? sum->data.data() : nullptr, sum_zp, sum_scale,
+            b.grid_h, b.grid_w, b.stride, b.dfl_len, classes, num_classes, out, kThreshold);
+    default:
+        return yolov8_decode_branch_fp32(
+            (const float *)box.data.data(), (const float *)score.data.data(), sum ? (const float *)sum->data.data() : nullptr,
+            b.grid_h, b.grid_w, b.stride, b.dfl_len, classes, num_classes, out, kThreshold);
+    }
+}
+
+// ---- 输入 ----
+
+void build_branches(Outputs &o)
+{
+    const int per_branch = (int)o.tensors.size() / 3;
+    for (int i = 0; i < 3; i++)
+    {
+        Branch b;
+        b.box = &o.tensors[i * per_branch];
+        b.score = &o.tensors[i * per_branch + 1];
+        b.score_sum = per_branch == 3 ? &o.tensors[i * per_branch + 2] : nullptr;
+        b.dfl_len = b.box->dims[1] / 4;
+        b.grid_h = b.box->dims[2];
+        b.grid_w = b.box->dims[3];
+        b.num_classes = b.score->dims[1];
+        b.stride = o.model_height / b.grid_h;
+        o.branches.push_back(b);
+    }
+}
+
+// 读入 .yv8t；原生布局的录制（zero copy 后端）先重排为 NCHW，基线解码只认 NCHW
+bool load_outputs(const char *path, Outputs &o)
+{
+    yolov8_tensor_frame frame;
+    if (yolov8_tensor_file_read(path, &frame) != 0 || frame.records.size() % 3 != 0 ||
+        yolov8_tensor_frame_repack(&frame, YOLOV8_LAYOUT_NCHW, 0, &frame) != 0)
+    {
+        fprintf(stderr, "%s 不是有效的 .yv8t 文件\n", path);
+        return false;
+    }
+    for (size_t i = 0; i < frame.records.size(); i++)
+    {
+        const yolov8_tensor_record &record = frame.records[i];
+        Tensor t;
+        t.type = record.type;
+        t.zp = record.zp;
+        t.scale = record.scale;
+        memcpy(t.dims, record.dims, sizeof(t.dims));
+        t.data = std::move(frame.data[i]);
+        o.tensors.push_back(std::move(t));
+    }
+    o.name = path;
+    o.model_height = frame.model_height;
+    build_branches(o);
+    return true;
+}
+
+// 合成 640x640 模型三分支 int8 输出（box / score [/ score_sum]），少量格子有目标
+Outputs synthesize_outputs(bool with_score_sum)
+{
+    const int kClasses = 80;
+    const int kDfl = 16;
+    const int kGrids[3] = {80, 40, 20};
+    const float kScoreScale = 1.0f / 255.0f;
+
+    Outputs o;
+    o.name = with_score_sum ? "synthetic int8, with score_sum" : "synthetic int8, no score_sum";
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> box_q(-60, 60);
+    std::uniform_int_distribution<int> low_q(-128, -100);
+    std::uniform_int_distribution<int> hot_q(-40, 127);
+    std::uniform_int_distribution<int> cls_pick(0, kClasses - 1);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+    for (int g : kGrids)
+    {
+        const int grid_len = g * g;
+
+        Tensor box;
+        box.type = YOLOV8_TENSOR_INT8;
+        box.zp = 0;
+        box.scale = 0.08f;
+        box.dims[0] = 1; box.dims[1] = 4 * kDfl; box.dims[2] = g; box.dims[3] = g;
+        box.data.resize((size_t)4 * kDfl * grid_len);
+        for (auto &v : box.data)
+        {
+            v = (uint8_t)(int8_t)box_q(rng);
+        }
+
+        Tensor score;
+        score.type = YOLOV8_TENSOR_INT8;
+        score.zp = -128;
+        score.scale = kScoreScale;
+        score.dims[0] = 1; score.dims[1] = kClasses; score.dims[2] = g; score.dims[3] = g;
+        score.data.resize((size_t)kClasses * grid_len);
+        for (auto &v : score.data)
+        {
+            v = (uint8_t)(int8_t)low_q(rng);
+        }
+
+        Tensor sum = score;
+        sum.dims[1] = 1;
+        sum.data.assign(grid_len, (uint8_t)(int8_t)-128);
+
+        // 约 1% 的格子有 1~3 个类别得分较高（含同分，用于校验取较小类别号）
+        for (int cell = 0; cell < grid_len; cell++)
+        {
+            if (chance(rng) > 0.01f)
+            {
+                continue;
+            }
+            int best = -128;
+            const int hot = 1 + (int)(chance(rng) * 3);
+            const int tie = hot_q(rng);
+            for (int h = 0; h < hot; h++)
+            {
+                const int v = h < 2 ? tie : hot_q(rng);
+                score.data[(size_t)cls_pick(rng) * grid_len + cell] = (uint8_t)(int8_t)v;
+                best = v > best ? v : best;
+            }
+            sum.data[cell] = (uint8_t)(int8_t)best;
+        }
+
+        o.tensors.push_back(std::move(box));
+        o.tensors.push_back(std::move(score));
+        if (with_score_sum)
+        {
+            o.tensors.push_back(std::move(sum));
+        }
+    }
+    build_branches(o);
+    return o;
+}
+
+// ---- 计时与校验 ----
+
+int run_all_baseline(const Outputs &o, Candidates &out)
+{
+    out.clear();
+    for (const Branch &b : o.branches)
+    {
+        out.count += run_baseline(b, out);
+    }
+    return out.count;
+}
+
+yolov8_candidates *run_all_decode(const Outputs &o, yolov8_postprocess_arena *arena)
+{
+    yolov8_candidates *out = yolov8_arena_begin(arena);
+    int num_classes = 0;
+    const int *classes = yolov8_arena_classes(arena, &num_classes);
+    for (const Branch &b : o.branches)
+    {
+        run_decode(b, classes, num_classes, out);
+    }
+    return out;
+}
+
+// 解码 + NMS，与 post_process 使用工作区的方式相同
+int run_postprocess(const Outputs &o, yolov8_postprocess_arena *arena)
+{
+    yolov8_candidates *c = run_all_decode(o, arena);
+    yolov8_nms_config config;
+    config.nms_threshold = arena->config.nms_threshold;
+    config.max_detections = arena->config.max_detections;
+    config.class_batched = 0;
+    return yolov8_nms(c->boxes, c->probs, c->class_ids, c->count, &config, arena->keep.data(), &arena->nms);
+}
+
+yolov8_postprocess_arena *create_arena(const Outputs &o)
+{
+    int max_candidates = 0;
+    int num_classes = 0;
+    for (const Branch &b : o.branches)
+    {
+        max_candidates += b.grid_h * b.grid_w;
+        num_classes = std::max(num_classes, b.num_classes);
+    }
+    return yolov8_arena_create(max_candidates, num_classes, kMaxDetections);
+}
+
+// 参考输入：把未允许类别的分数行压到最低量化值（不可能超过阈值），
+// 其余不变；对它做不过滤的解码应与对原输入做过滤解码逐位一致
+Outputs mask_classes(const Outputs &o, const std::vector<int> &allowed)
+{
+    Outputs m;
+    m.name = o.name;
+    m.model_height = o.model_height;
+    for (const Tensor &t : o.tensors)
+    {
+        m.tensors.push_back(t);
+    }
+    const int per_branch = (int)o.tensors.size() / 3;
+    for (int i = 0; i < 3; i++)
+    {
+        Tensor &score = m.tensors[i * per_branch + 1];
+        const size_t elem = score.type == YOLOV8_TENSOR_FLOAT32 ? sizeof(float) : 1;
+        const size_t row = score.data.size() / score.dims[1];
+        for (uint32_t c = 0; c < score.dims[1]; c++)
+        {
+            if (std::find(allowed.begin(), allowed.end(), (int)c) != allowed.end())
+            {
+                continue;
+            }
+            uint8_t *p = score.data.data() + c * row;
+            if (score.type == YOLOV8_TENSOR_FLOAT32)
+            {
+                std::fill((float *)p, (float *)p + row / elem, 0.0f);
+            }
+            else
+            {
+                std::fill(p, p + row, score.type == YOLOV8_TENSOR_INT8 ? (uint8_t)0x80 : (uint8_t)0);
+            }
+        }
+    }
+    build_branches(m);
+    return m;
+}
+
+bool same_candidates(const yolov8_candidates &a, const yolov8_candidates &b)
+{
+    return a.count == b.count && a.dropped == b.dropped &&
+           memcmp(a.class_ids, b.class_ids, a.count * sizeof(int)) == 0 &&
+           memcmp(a.boxes, b.boxes, a.count * 4 * sizeof(float)) == 0 &&
+           memcmp(a.probs, b.probs, a.count * sizeof(float)) == 0;
+}
+
+bool same_output(const Candidates &a, const yolov8_candidates &b)
+{
+    return a.count == b.count && b.dropped == 0 &&
+           memcmp(a.classes.data(), b.class_ids, a.classes.size() * sizeof(int)) == 0 &&
+           memcmp(a.boxes.data(), b.boxes, a.boxes.size() * sizeof(float)) == 0 &&
+           memcmp(a.probs.data(), b.probs, a.probs.size() * sizeof(float)) == 0;
+}
+
+template <typename Fn>
+double time_us(int iterations, Fn fn)
+{
+    fn(); // 预热
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        fn();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+const char *simd_name()
+{
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return "NEON";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 200;
+    if (iterations <= 0)
+    {
+        fprintf(stderr, "用法: yolov8_decode_bench [iterations] [outputs.yv8t ...]\n");
+        return 1;
+    }
+
+    std::vector<Outputs> inputs;
+    for (int i = 2; i < argc; i++)
+    {
+        Outputs o;
+        if (!load_outputs(argv[i], o))
+        {
+            return 1;
+        }
+        inputs.push_back(std::move(o));
+    }
+    if (inputs.empty())
+    {
+        inputs.push_back(synthesize_outputs(true));
+        inputs.push_back(synthesize_outputs(false));
+    }
+
+    printf("SIMD: %s, threshold %.2f, %d iterations\n", simd_name(), kThreshold, iterations);
+    printf("%-40s %10s %12s %12s %8s %12s %12s\n", "input", "candidates", "baseline us", "decode us", "speedup",
+           "+nms us", "heap allocs");
+
+    bool ok = true;
+    for (const Outputs &o : inputs)
+    {
+        Candidates base;
+        yolov8_postprocess_arena *arena = create_arena(o);
+        const double base_us = time_us(iterations, [&]() { run_all_baseline(o, base); });
+        const double fast_us = time_us(iterations, [&]() { run_all_decode(o, arena); });
+        const bool same = same_output(base, arena->candidates);
+
+        // 稳态下解码 + NMS 不应有任何堆分配：既看全局 operator new 计数，也看工作区自身的计数
+        run_postprocess(o, arena);
+        const uint64_t heap_before = g_heap_allocations.load();
+        const uint64_t arena_before = yolov8_arena_allocations(arena);
+        const double post_us = time_us(iterations, [&]() { run_postprocess(o, arena); });
+        const uint64_t heap_allocs = g_heap_allocations.load() - heap_before;
+        const bool alloc_free = heap_allocs == 0 && yolov8_arena_allocations(arena) == arena_before;
+
+        ok = ok && same && alloc_free;
+        printf("%-40s %10d %12.1f %12.1f %7.2fx %12.1f %12llu%s%s\n", o.name.c_str(), arena->candidates.count, base_us,
+               fast_us, base_us / fast_us, post_us, (unsigned long long)heap_allocs, same ? "" : "  MISMATCH",
+               alloc_free ? "" : "  ALLOCATES");
+
+        // 类别过滤：只解码 kFilterClasses，对照把其余类别压到最低分的输入做全类别解码
+        yolov8_postprocess_config config;
+        yolov8_postprocess_default_config(&config, kMaxDetections);
+        for (int c : kFilterClasses)
+        {
+            config.class_mask[c / 64] |= 1ull << (c % 64);
+        }
+        const std::vector<int> allowed(kFilterClasses, kFilterClasses + sizeof(kFilterClasses) / sizeof(kFilterClasses[0]));
+        const Outputs masked = mask_classes(o, allowed);
+        yolov8_postprocess_arena *ref_arena = create_arena(masked);
+        run_all_decode(masked, ref_arena);
+        const bool configured = yolov8_arena_configure(arena, &config) == 0;
+        const double filtered_us = time_us(iterations, [&]() { run_all_decode(o, arena); });
+        const bool same_filtered = configured && same_candidates(ref_arena->candidates, arena->candidates);
+        ok = ok && same_filtered;
+        printf("%-40s %10d %12s %12.1f %7.2fx%s\n", ("  classes {0,2,7} of " + std::to_string(arena->num_classes)).c_str(),
+               arena->candidates.count, "", filtered_us, fast_us / filtered_us, same_filtered ? "" : "  MISMATCH");
+        yolov8_arena_destroy(ref_arena);
+        yolov8_arena_destroy(arena);
+    }
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,343 @@
+// YOLOv8 NMS 性质校验与微基准
+//
+// 保留一份原 post_process 的排序 + NMS（递归快排 quick_sort_indice_inverse、std::set 枚举类别、
+// 每类扫描全部候选的 nms()）作为参照，随机生成候选集逐项校验 yolov8_nms：
+//   1. 分数互不相同：输出（下标与次序）与原实现完全一致
+//   2. 量化分数（大量同分）：与原 nms() 在 (score 降序, 下标升序) 次序上的结果一致
+//      （原快排对同分的次序不确定，新实现固定为下标升序）
+//   3. 整数坐标：class_batched 模式与逐类模式一致
+//   4. 复用 scratch 与每次临时分配结果一致
+// 随后在拥挤场景下对比两者耗时。任一性质不满足时返回非 0。
+//
+// 构建：cmake -DSMARTSCOPE_BUILD_BENCHMARKS=ON ... && ./bin/yolov8_nms_bench [cases] [iterations]
+// 无 Qt/RKNN 环境（x86 CI）直接编译：
+//   g++ -O2 -std=c++11 -Icrates/rknn-inference/include -o yolov8_nms_bench
+//       benchmarks/yolov8_nms_bench.cpp crates/rknn-inference/csrc/yolov8_nms.cc
+
+#include "yolov8_nms.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+const int kMaxDetections = 128;
+const float kNmsThreshold = 0.45f;
+
+struct Candidates {
+    std::vector<float> boxes; // (x, y, w, h)
+    std::vector<float> scores;
+    std::vector<int> classes;
+    int count() const { return (int)scores.size(); }
+};
+
+// ---- 参照：原 postprocess.cc 实现 ----
+
+float CalculateOverlap(float xmin0, float ymin0, float xmax0, float ymax0, float xmin1, float ymin1, float xmax1,
+                       float ymax1)
+{
+    float w = fmax(0.f, fmin(xmax0, xmax1) - fmax(xmin0, xmin1) + 1.0);
+    float h = fmax(0.f, fmin(ymax0, ymax1) - fmax(ymin0, ymin1) + 1.0);
+    float i = w * h;
+    float u = (xmax0 - xmin0 + 1.0) * (ymax0 - ymin0 + 1.0) + (xmax1 - xmin1 + 1.0) * (ymax1 - ymin1 + 1.0) - i;
+    return u <= 0.f ? 0.f : (i / u);
+}
+
+int nms(int validCount, std::vector<float> &outputLocations, std::vector<int> classIds, std::vector<int> &order,
+        int filterId, float threshold)
+{
+    for (int i = 0; i < validCount; ++i)
+    {
+        int n = order[i];
+        if (n == -1 || classIds[n] != filterId)
+        {
+            continue;
+        }
+        for (int j = i + 1; j < validCount; ++j)
+        {
+            int m = order[j];
+            if (m == -1 || classIds[m] != filterId)
+            {
+                continue;
+            }
+            float xmin0 = outputLocations[n * 4 + 0];
+            float ymin0 = outputLocations[n * 4 + 1];
+            float xmax0 = outputLocations[n * 4 + 0] + outputLocations[n * 4 + 2];
+            float ymax0 = outputLocations[n * 4 + 1] + outputLocations[n * 4 + 3];
+
+            float xmin1 = outputLocations[m * 4 + 0];
+            float ymin1 = outputLocations[m * 4 + 1];
+            float xmax1 = outputLocations[m * 4 + 0] + outputLocations[m * 4 + 2];
+            float ymax1 = outputLocations[m * 4 + 1] + outputLocations[m * 4 + 3];
+
+            float iou = CalculateOverlap(xmin0, ymin0, xmax0, ymax0, xmin1, ymin1, xmax1, ymax1);
+
+            if (iou > threshold)
+            {
+                order[j] = -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int quick_sort_indice_inverse(std::vector<float> &input, int left, int right, std::vector<int> &indices)
+{
+    float key;
+    int key_index;
+    int low = left;
+    int high = right;
+    if (left < right)
+    {
+        key_index = indices[left];
+        key = input[left];
+        while (low < high)
+        {
+            while (low < high && input[high] <= key)
+            {
+                high--;
+            }
+            input[low] = input[high];
+            indices[low] = indices[high];
+            while (low < high && input[low] >= key)
+            {
+                low++;
+            }
+            input[high] = input[low];
+            indices[high] = indices[low];
+        }
+        input[low] = key;
+        indices[low] = key_index;
+        quick_sort_indice_inverse(input, left, low - 1, indices);
+        quick_sort_indice_inverse(input, low + 1, right, indices);
+    }
+    return low;
+}
+
+// 按给定次序执行原逐类 nms()，返回输出的候选下标
+std::vector<int> reference_nms_over(Candidates c, std::vector<int> indexArray)
+{
+    const int validCount = c.count();
+    std::set<int> class_set(std::begin(c.classes), std::end(c.classes));
+    for (auto cls : class_set)
+    {
+        nms(validCount, c.boxes, c.classes, indexArray, cls, kNmsThreshold);
+    }
+    std::vector<int> out;
+    for (int i = 0; i < validCount; ++i)
+    {
+        if (indexArray[i] == -1 || (int)out.size() >= kMaxDetections)
+        {
+            continue;
+        }
+        out.push_back(indexArray[i]);
+    }
+    return out;
+}
+
+// 原 post_process 的完整流程：快排 + 逐类 nms
+std::vector<int> reference_post_process(const Candidates &c)
+{
+    if (c.count() <= 0)
+    {
+        return std::vector<int>();
+    }
+    std::vector<float> probs = c.scores;
+    std::vector<int> indexArray;
+    for (int i = 0; i < c.count(); ++i)
+    {
+        indexArray.push_back(i);
+    }
+    quick_sort_indice_inverse(probs, 0, c.count() - 1, indexArray);
+    return reference_nms_over(c, indexArray);
+}
+
+std::vector<int> stable_score_order(const Candidates &c)
+{
+    std::vector<int> order(c.count());
+    for (int i = 0; i < c.count(); i++)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return c.scores[a] > c.scores[b]; });
+    return order;
+}
+
+// ---- 被测实现 ----
+
+std::vector<int> run_nms(const Candidates &c, bool batched, yolov8_nms_scratch *scratch)
+{
+    yolov8_nms_config config;
+    config.nms_threshold = kNmsThreshold;
+    config.max_detections = kMaxDetections;
+    config.class_batched = batched ? 1 : 0;
+    std::vector<int> keep(kMaxDetections);
+    const int n = yolov8_nms(c.boxes.data(), c.scores.data(), c.classes.data(), c.count(), &config, keep.data(), scratch);
+    keep.resize(n);
+    return keep;
+}
+
+// ---- 随机候选集 ----
+
+enum ScoreKind { DISTINCT_SCORES, QUANTIZED_SCORES };
+
+// 围绕若干中心聚簇的候选框（模拟同一目标在相邻格子/分支上的重复检测）
+Candidates make_candidates(std::mt19937 &rng, int count, int num_classes, int clusters, ScoreKind kind,
+                           bool integer_coords)
+{
+    std::uniform_real_distribution<float> pos(0.f, 600.f);
+    std::uniform_real_distribution<float> size(8.f, 160.f);
+    std::uniform_real_distribution<float> jitter(-12.f, 12.f);
+    std::uniform_int_distribution<int> cls(num_classes > 1 ? -1 : 0, num_classes - 1);
+    std::uniform_int_distribution<int> pick(0, clusters - 1);
+    std::uniform_int_distribution<int> q(-120, -30);
+
+    std::vector<float> cx(clusters), cy(clusters), cw(clusters), ch(clusters);
+    for (int k = 0; k < clusters; k++)
+    {
+        cx[k] = pos(rng);
+        cy[k] = pos(rng);
+        cw[k] = size(rng);
+        ch[k] = size(rng);
+    }
+
+    Candidates c;
+    std::vector<float> distinct(count);
+    for (int i = 0; i < count; i++)
+    {
+        distinct[i] = 0.25f + 0.75f * (float)(i + 1) / (float)(count + 1);
+    }
+    std::shuffle(distinct.begin(), distinct.end(), rng);
+
+    for (int i = 0; i < count; i++)
+    {
+        const int k = pick(rng);
+        float x = cx[k] + jitter(rng);
+        float y = cy[k] + jitter(rng);
+        float w = cw[k] + jitter(rng);
+        float h = ch[k] + jitter(rng);
+        if (integer_coords)
+        {
+            x = floorf(x);
+            y = floorf(y);
+            w = floorf(w);
+            h = floorf(h);
+        }
+        c.boxes.push_back(x);
+        c.boxes.push_back(y);
+        c.boxes.push_back(w);
+        c.boxes.push_back(h);
+        c.scores.push_back(kind == DISTINCT_SCORES ? distinct[i] : ((float)q(rng) + 128.f) * (1.f / 255.f));
+        // 同一簇多数是同一类别
+        c.classes.push_back(rng() % 4 == 0 ? cls(rng) : k % num_classes);
+    }
+    return c;
+}
+
+int check_properties(int cases)
+{
+    std::mt19937 rng(20240611);
+    yolov8_nms_scratch scratch;
+    int failures = 0;
+
+    for (int t = 0; t < cases; t++)
+    {
+        const int count = 1 + (int)(rng() % 600);
+        const int num_classes = 1 + (int)(rng() % 12);
+        const int clusters = 1 + (int)(rng() % 40);
+
+        Candidates distinct = make_candidates(rng, count, num_classes, clusters, DISTINCT_SCORES, false);
+        if (run_nms(distinct, false, &scratch) != reference_post_process(distinct))
+        {
+            fprintf(stderr, "case %d: 分数互不相同时与原实现不一致 (count=%d)\n", t, count);
+            failures++;
+        }
+
+        Candidates quantized = make_candidates(rng, count, num_classes, clusters, QUANTIZED_SCORES, false);
+        const std::vector<int> fast = run_nms(quantized, false, &scratch);
+        if (fast != reference_nms_over(quantized, stable_score_order(quantized)))
+        {
+            fprintf(stderr, "case %d: 同分候选与原 nms() 不一致 (count=%d)\n", t, count);
+            failures++;
+        }
+        if (fast != run_nms(quantized, false, nullptr))
+        {
+            fprintf(stderr, "case %d: 复用 scratch 结果不同\n", t);
+            failures++;
+        }
+
+        Candidates integral = make_candidates(rng, count, num_classes, clusters, QUANTIZED_SCORES, true);
+        if (run_nms(integral, true, &scratch) != run_nms(integral, false, &scratch))
+        {
+            fprintf(stderr, "case %d: class_batched 与逐类模式不一致 (count=%d)\n", t, count);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+template <typename Fn>
+double time_us(int iterations, Fn fn)
+{
+    fn();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        fn();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+void benchmark(int iterations)
+{
+    struct Scene {
+        const char *name;
+        int count;
+        int num_classes;
+        int clusters;
+    };
+    const Scene scenes[] = {
+        {"typical (200 candidates, 6 classes)", 200, 6, 12},
+        {"crowded (2000 candidates, 20 classes)", 2000, 20, 150},
+        {"crowded, low threshold (8000, 80)", 8000, 80, 400},
+    };
+
+    printf("%-40s %12s %12s %12s\n", "scene", "original us", "per-class us", "batched us");
+    std::mt19937 rng(7);
+    for (const Scene &scene : scenes)
+    {
+        const Candidates c = make_candidates(rng, scene.count, scene.num_classes, scene.clusters, QUANTIZED_SCORES, false);
+        yolov8_nms_scratch scratch;
+        const int ref_iterations = scene.count > 2000 ? std::max(1, iterations / 20) : iterations;
+        const double ref_us = time_us(ref_iterations, [&]() { reference_post_process(c); });
+        const double fast_us = time_us(iterations, [&]() { run_nms(c, false, &scratch); });
+        const double batched_us = time_us(iterations, [&]() { run_nms(c, true, &scratch); });
+        printf("%-40s %12.1f %12.1f %12.1f\n", scene.name, ref_us, fast_us, batched_us);
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int cases = argc > 1 ? atoi(argv[1]) : 500;
+    const int iterations = argc > 2 ? atoi(argv[2]) : 200;
+    if (cases < 0 || iterations <= 0)
+    {
+        fprintf(stderr, "用法: yolov8_nms_bench [cases] [iterations]\n");
+        return 1;
+    }
+
+    const int failures = check_properties(cases);
+    printf("性质校验: %d 组随机候选，%d 项失败\n", cases, failures);
+    benchmark(iterations);
+    return failures == 0 ? 0 : 2;
+}
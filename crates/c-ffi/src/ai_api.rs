@@ -1,28 +1,261 @@
+use std::collections::VecDeque;
 use std::ffi::CStr;
 use std::os::raw::{c_char, c_int};
-use std::sync::Mutex as StdMutex;
+use std::sync::{Arc, Condvar, Mutex as StdMutex};
 use std::sync::atomic::{AtomicBool, Ordering};
+use std::thread::{self, JoinHandle};
 
-use crate::types::{CDetection, ErrorCode};
+use crate::state::get_app_state;
+use crate::types::{CAiPostprocessConfig, CAiStageStats, CAiStats, CDetection, ErrorCode};
 
-use rknn_inference::MultiDetectorInferenceService;
+use rknn_inference::{
+    DetectionMode, FrameRect, ImageBuffer, PipelineServiceConfig, PipelinedInferenceService, PostprocessConfig,
+    StageStats, TilingConfig,
+};
+use smartscope_core::frame_trace::{self, TraceStage};
+use smartscope_core::config::{AiConfig, AiDetectionMode, SmartScopeConfig};
+use smartscope_core::FrameTap;
 
 lazy_static! {
-    static ref AI_SERVICE: StdMutex<Option<MultiDetectorInferenceService>> = StdMutex::new(None);
+    static ref AI_SERVICE: StdMutex<Option<PipelinedInferenceService>> = StdMutex::new(None);
     static ref AI_ENABLED: AtomicBool = AtomicBool::new(false);
+    static ref AI_FEEDER: StdMutex<Option<AiFeeder>> = StdMutex::new(None);
+    static ref AI_INFLIGHT: StdMutex<VecDeque<InflightTask>> = StdMutex::new(VecDeque::new());
 }
 
 const MAX_DETECTIONS: usize = 128;
+/// 等待结果的已提交任务上限（超出时丢弃最旧的追踪记录）
+const MAX_INFLIGHT_TRACES: usize = 32;
 
-/// 初始化AI推理服务（RKNN YOLOv8）
+/// 已提交、尚未取到结果的推理任务，用于把结果关联回帧号
+struct InflightTask {
+    task_id: usize,
+    frame_id: u64,
+    submitted_ns: u64,
+}
+
+fn trace_submitted(task_id: usize, frame_id: u64, start_ns: u64) {
+    let now = frame_trace::now_ns();
+    frame_trace::record(frame_id, TraceStage::AiSubmit, start_ns, now);
+    let mut inflight = AI_INFLIGHT.lock().unwrap();
+    if inflight.len() >= MAX_INFLIGHT_TRACES {
+        inflight.pop_front();
+    }
+    inflight.push_back(InflightTask { task_id, frame_id, submitted_ns: now });
+}
+
+/// 结果首次被取走时记录“提交 → 取到结果”；同一结果重复读取不再记录
+fn trace_result(task_id: usize) {
+    let mut inflight = AI_INFLIGHT.lock().unwrap();
+    if let Some(pos) = inflight.iter().position(|t| t.task_id == task_id) {
+        let task = inflight.remove(pos).unwrap();
+        // 更早提交但结果已被覆盖的任务不会再出现
+        inflight.drain(..pos);
+        frame_trace::record(task.frame_id, TraceStage::AiResult, task.submitted_ns, frame_trace::now_ns());
+    }
+}
+
+/// 管道旁路投递给推理线程的最新一帧（只保留最新，旧帧直接覆盖）
+#[derive(Default)]
+struct FeederMailbox {
+    data: Vec<u8>,
+    width: u32,
+    height: u32,
+    frame_id: u64,
+    pending: bool,
+    stop: bool,
+}
+
+/// 核心管道 → AI 推理的投递线程
+///
+/// 管道线程上的旁路回调只把帧拷进邮箱缓冲区；本线程把帧交给推理流水线，
+/// letterbox 在流水线的预处理池里完成，不占用取帧/显示路径。
+struct AiFeeder {
+    mailbox: Arc<(StdMutex<FeederMailbox>, Condvar)>,
+    handle: Option<JoinHandle<()>>,
+}
+
+impl AiFeeder {
+    fn start() -> Self {
+        let mailbox = Arc::new((StdMutex::new(FeederMailbox::default()), Condvar::new()));
+        let thread_mailbox = Arc::clone(&mailbox);
+        let handle = thread::spawn(move || {
+            loop {
+                let (frame, width, height, frame_id) = {
+                    let (lock, cond) = &*thread_mailbox;
+                    let mut mb = lock.lock().unwrap();
+                    while !mb.pending && !mb.stop {
+                        mb = cond.wait(mb).unwrap();
+                    }
+                    if mb.stop {
+                        break;
+                    }
+                    mb.pending = false;
+                    // 帧数据连同所有权交给流水线，邮箱下次重新分配
+                    (std::mem::take(&mut mb.data), mb.width, mb.height, mb.frame_id)
+                };
+
+                if !AI_ENABLED.load(Ordering::Relaxed) {
+                    continue;
+                }
+                let start_ns = frame_trace::now_ns();
+                let image = ImageBuffer::from_rgb888(width as i32, height as i32, frame);
+                let guard = AI_SERVICE.lock().unwrap();
+                if let Some(service) = guard.as_ref() {
+                    let task_id = service.submit(image);
+                    trace_submitted(task_id, frame_id, start_ns);
+                }
+            }
+        });
+        Self { mailbox, handle: Some(handle) }
+    }
+
+    /// 生成安装到图像管道上的旁路回调
+    fn tap(&self) -> FrameTap {
+        let mailbox = Arc::clone(&self.mailbox);
+        Arc::new(move |data: &[u8], width: u32, height: u32, frame_id: u64| {
+            if !AI_ENABLED.load(Ordering::Relaxed) {
+                return;
+            }
+            let (lock, cond) = &*mailbox;
+            let mut mb = lock.lock().unwrap();
+            mb.data.clear();
+            mb.data.extend_from_slice(data);
+            mb.width = width;
+            mb.height = height;
+            mb.frame_id = frame_id;
+            mb.pending = true;
+            cond.notify_one();
+        })
+    }
+
+    fn stop(mut self) {
+        {
+            let (lock, cond) = &*self.mailbox;
+            lock.lock().unwrap().stop = true;
+            cond.notify_all();
+        }
+        if let Some(h) = self.handle.take() {
+            let _ = h.join();
+        }
+    }
+}
+
+/// 安装核心管道旁路（重复调用会替换旧的投递线程）
+fn install_pipeline_feeder() {
+    let feeder = AiFeeder::start();
+    let installed = match get_app_state() {
+        Ok(state) => state.set_frame_tap(Some(feeder.tap())),
+        Err(_) => false,
+    };
+    if !installed {
+        tracing::warn!("图像管道不可用，AI 仅能通过 smartscope_ai_submit_rgb888 提交帧");
+    }
+    if let Some(old) = AI_FEEDER.lock().unwrap().replace(feeder) {
+        old.stop();
+    }
+}
+
+fn remove_pipeline_feeder() {
+    if let Ok(state) = get_app_state() {
+        state.set_frame_tap(None);
+    }
+    if let Some(feeder) = AI_FEEDER.lock().unwrap().take() {
+        feeder.stop();
+    }
+}
+
+fn postprocess_from_c(config: &CAiPostprocessConfig) -> PostprocessConfig {
+    let mut allowed_classes = Vec::new();
+    for (word, bits) in config.class_mask.iter().enumerate() {
+        for bit in 0..64 {
+            if bits & (1u64 << bit) != 0 {
+                allowed_classes.push((word * 64 + bit) as u32);
+            }
+        }
+    }
+    PostprocessConfig {
+        conf_threshold: config.conf_threshold,
+        nms_threshold: config.nms_threshold,
+        max_detections: config.max_detections.max(0) as usize,
+        allowed_classes,
+    }
+}
+
+fn postprocess_from_ai_config(ai: &AiConfig) -> PostprocessConfig {
+    PostprocessConfig {
+        conf_threshold: ai.conf_threshold,
+        nms_threshold: ai.nms_threshold,
+        max_detections: ai.max_detections as usize,
+        allowed_classes: ai.classes.clone(),
+    }
+}
+
+fn tiling_from_ai_config(ai: &AiConfig) -> TilingConfig {
+    TilingConfig {
+        mode: match ai.detection_mode {
+            AiDetectionMode::Full => DetectionMode::Full,
+            AiDetectionMode::Tiled => DetectionMode::Tiled,
+            AiDetectionMode::Adaptive => DetectionMode::Adaptive,
+        },
+        overlap: ai.tile_overlap,
+        low_confidence: ai.tile_low_confidence,
+        max_consecutive_tiled: ai.tile_max_consecutive,
+        ..Default::default()
+    }
+}
+
+/// smartscope.toml 的 [ai] 段（核心未初始化时直接读文件）
+fn configured_ai() -> AiConfig {
+    match get_app_state() {
+        Ok(state) => state.get_config().ai,
+        Err(_) => SmartScopeConfig::load_with_fallback().ai,
+    }
+}
+
+/// 未显式传入配置时取 smartscope.toml 的 [ai] 段
+fn configured_postprocess() -> PostprocessConfig {
+    postprocess_from_ai_config(&configured_ai())
+}
+
+/// 填充默认的后处理配置（conf 0.25、NMS 0.45、最多 128 个、不过滤类别）
+#[no_mangle]
+pub extern "C" fn smartscope_ai_default_postprocess_config(config_out: *mut CAiPostprocessConfig) -> c_int {
+    if config_out.is_null() {
+        return ErrorCode::Error as c_int;
+    }
+    let defaults = AiConfig::default();
+    unsafe {
+        *config_out = CAiPostprocessConfig {
+            conf_threshold: defaults.conf_threshold,
+            nms_threshold: defaults.nms_threshold,
+            max_detections: defaults.max_detections as i32,
+            class_mask: [0; 4],
+        };
+    }
+    ErrorCode::Success as c_int
+}
+
+/// 初始化AI推理服务（RKNN YOLOv8 三级流水线）
 /// model_path: RKNN模型路径，如 "models/yolov8m.rknn"
-/// num_workers: 工作线程数量，建议6
+/// num_workers: 模型实例（上下文）总数，建议6；分到 [ai] npu_cores 个 NPU 核心上（余数给前面的核心）
+/// config: 后处理配置，可为NULL（使用 smartscope.toml 的 [ai] 段或默认值）
 #[no_mangle]
-pub extern "C" fn smartscope_ai_init(model_path: *const c_char, num_workers: i32) -> c_int {
+pub extern "C" fn smartscope_ai_init(
+    model_path: *const c_char,
+    num_workers: i32,
+    config: *const CAiPostprocessConfig,
+) -> c_int {
     if model_path.is_null() || num_workers <= 0 {
         return ErrorCode::Error as c_int;
     }
 
+    let postprocess = if config.is_null() {
+        configured_postprocess()
+    } else {
+        postprocess_from_c(unsafe { &*config })
+    };
+
     let path_str = unsafe {
         match CStr::from_ptr(model_path).to_str() {
             Ok(s) => s,
@@ -30,15 +263,34 @@ pub extern "C" fn smartscope_ai_init(model_path: *const c_char, num_workers: i32
         }
     };
 
+    let ai = configured_ai();
+    let npu_cores = ai.npu_cores.min(3) as usize;
+    let mut pipeline = PipelineServiceConfig::with_contexts(npu_cores, num_workers as usize);
+    pipeline.tiling = tiling_from_ai_config(&ai);
+    let detection_mode = pipeline.tiling.mode;
+
     let mut guard = AI_SERVICE.lock().unwrap();
-    match MultiDetectorInferenceService::new(path_str, num_workers as usize) {
+    // 先释放旧服务的上下文再创建新的
+    *guard = None;
+    match PipelinedInferenceService::new(path_str, pipeline, postprocess.clone()) {
         Ok(service) => {
+            tracing::info!("{}", service.startup_report());
+            let (contexts, cores) = (service.context_count(), service.core_count());
             *guard = Some(service);
+            drop(guard);
             AI_ENABLED.store(false, Ordering::Relaxed);
+            // 左相机/主显示帧由核心管道直接投递，前端只需切换启用状态
+            install_pipeline_feeder();
             tracing::info!(
-                "AI inference service initialized: {} workers, model: {}",
-                num_workers,
-                path_str
+                "AI inference pipeline initialized: {} contexts on {} NPU core group(s), model: {}, mode {:?}, conf {:.2}, nms {:.2}, max {}, classes {:?}",
+                contexts,
+                cores,
+                path_str,
+                detection_mode,
+                postprocess.conf_threshold,
+                postprocess.nms_threshold,
+                postprocess.max_detections,
+                postprocess.allowed_classes
             );
             ErrorCode::Success as c_int
         }
@@ -52,9 +304,11 @@ pub extern "C" fn smartscope_ai_init(model_path: *const c_char, num_workers: i32
 /// 关闭AI推理服务
 #[no_mangle]
 pub extern "C" fn smartscope_ai_shutdown() {
+    remove_pipeline_feeder();
     let mut guard = AI_SERVICE.lock().unwrap();
     *guard = None;
     AI_ENABLED.store(false, Ordering::Relaxed);
+    AI_INFLIGHT.lock().unwrap().clear();
     tracing::info!("AI inference service shutdown");
 }
 
@@ -93,26 +347,15 @@ pub extern "C" fn smartscope_ai_submit_rgb888(
         None => return ErrorCode::Error as c_int,
     };
 
-    let data_slice = unsafe {
-        std::slice::from_raw_parts(data, len.min((width as usize) * (height as usize) * 3))
-    };
-
-    // 使用预处理器进行letterbox+缩放
-    let rgb_image = match image::RgbImage::from_raw(width as u32, height as u32, data_slice.to_vec()) {
-        Some(img) => img,
-        None => return ErrorCode::Error as c_int,
-    };
-
-    let preprocessor = rknn_inference::ImagePreprocessor::new();
-    let image_buffer = preprocessor.preprocess(&rgb_image);
-
-    match service.submit_inference(&image_buffer) {
-        Ok(_) => ErrorCode::Success as c_int,
-        Err(e) => {
-            tracing::error!("AI submit failed: {:?}", e);
-            ErrorCode::Error as c_int
-        }
+    let frame_len = (width as usize) * (height as usize) * 3;
+    if len < frame_len {
+        return ErrorCode::Error as c_int;
     }
+    let data_slice = unsafe { std::slice::from_raw_parts(data, frame_len) };
+
+    // 拷贝一份交给流水线，letterbox 在预处理池里完成
+    service.submit(ImageBuffer::from_rgb888(width, height, data_slice.to_vec()));
+    ErrorCode::Success as c_int
 }
 
 /// 尝试获取最新推理结果
@@ -136,7 +379,8 @@ pub extern "C" fn smartscope_ai_try_get_latest_result(
         None => return -1,
     };
 
-    if let Some((_task_id, result)) = service.try_get_latest_result() {
+    if let Some((task_id, result)) = service.try_get_latest_result() {
+        trace_result(task_id);
         match result {
             Ok(dets) => {
                 let count = dets.len().min(max_results as usize).min(MAX_DETECTIONS);
@@ -161,3 +405,121 @@ pub extern "C" fn smartscope_ai_try_get_latest_result(
     }
 }
 
+fn stage_to_c(stage: &StageStats) -> CAiStageStats {
+    let ms = |us: u64| us as f64 / 1000.0;
+    CAiStageStats {
+        count: stage.count,
+        mean_ms: stage.mean_us() / 1000.0,
+        p50_ms: ms(stage.percentile_us(0.50)),
+        p95_ms: ms(stage.percentile_us(0.95)),
+        max_ms: ms(stage.max_us),
+        last_ms: ms(stage.last_us),
+    }
+}
+
+/// 获取 AI 推理统计（各阶段耗时、候选数、流水线计数）；服务未初始化时返回错误
+#[no_mangle]
+pub extern "C" fn smartscope_ai_get_stats(stats_out: *mut CAiStats) -> c_int {
+    if stats_out.is_null() {
+        return ErrorCode::Error as c_int;
+    }
+    let guard = AI_SERVICE.lock().unwrap();
+    let service = match guard.as_ref() {
+        Some(s) => s,
+        None => return ErrorCode::Error as c_int,
+    };
+
+    let inference = service.inference_stats();
+    let pipeline = service.stats();
+    let mean = |total: u64| if inference.frames == 0 { 0.0 } else { total as f64 / inference.frames as f64 };
+    let mut out = CAiStats {
+        frames: inference.frames,
+        errors: inference.errors,
+        candidates_mean: mean(inference.candidates_total),
+        candidates_max: inference.candidates_max,
+        candidates_last: inference.candidates_last,
+        candidates_dropped: inference.candidates_dropped,
+        detections_mean: mean(inference.detections_total),
+        detections_last: inference.detections_last,
+        submitted: pipeline.submitted as u64,
+        dropped: pipeline.dropped as u64,
+        completed: pipeline.completed as u64,
+        failed: pipeline.failed as u64,
+        in_flight: pipeline.in_flight as u64,
+        contexts: service.context_count() as u32,
+        cores: service.core_count() as u32,
+        ..Default::default()
+    };
+    for (dst, (_, stage)) in out.stages.iter_mut().zip(inference.stages().iter()) {
+        *dst = stage_to_c(stage);
+    }
+    unsafe {
+        *stats_out = out;
+    }
+    ErrorCode::Success as c_int
+}
+
+/// 清零 AI 推理统计（阶段耗时与候选数；流水线计数不清零）
+#[no_mangle]
+pub extern "C" fn smartscope_ai_reset_stats() -> c_int {
+    let guard = AI_SERVICE.lock().unwrap();
+    match guard.as_ref() {
+        Some(service) => {
+            service.reset_inference_stats();
+            ErrorCode::Success as c_int
+        }
+        None => ErrorCode::Error as c_int,
+    }
+}
+
+/// 设置检测方式：0 整幅，1 每帧分块，2 自适应（上一帧有低置信度检测时分块）；对之后提交的帧生效
+#[no_mangle]
+pub extern "C" fn smartscope_ai_set_detection_mode(mode: c_int) -> c_int {
+    let mode = match mode {
+        0 => DetectionMode::Full,
+        1 => DetectionMode::Tiled,
+        2 => DetectionMode::Adaptive,
+        _ => return ErrorCode::Error as c_int,
+    };
+    let guard = AI_SERVICE.lock().unwrap();
+    let service = match guard.as_ref() {
+        Some(s) => s,
+        None => return ErrorCode::Error as c_int,
+    };
+    let config = TilingConfig { mode, ..service.tiling_config() };
+    match service.set_tiling_config(config) {
+        Ok(()) => ErrorCode::Success as c_int,
+        Err(_) => ErrorCode::Error as c_int,
+    }
+}
+
+/// 当前检测方式（见 smartscope_ai_set_detection_mode）；服务未初始化返回-1
+#[no_mangle]
+pub extern "C" fn smartscope_ai_get_detection_mode() -> c_int {
+    let guard = AI_SERVICE.lock().unwrap();
+    match guard.as_ref().map(|s| s.tiling_config().mode) {
+        Some(DetectionMode::Full) => 0,
+        Some(DetectionMode::Tiled) => 1,
+        Some(DetectionMode::Adaptive) => 2,
+        None => -1,
+    }
+}
+
+/// 设置检测区域（源帧像素，如放大时的可见区域）；width 或 height <= 0 时恢复整帧
+///
+/// 检测框仍是整帧的模型输入坐标，前端叠加层不需要改换算
+#[no_mangle]
+pub extern "C" fn smartscope_ai_set_roi(x: i32, y: i32, width: i32, height: i32) -> c_int {
+    let guard = AI_SERVICE.lock().unwrap();
+    let service = match guard.as_ref() {
+        Some(s) => s,
+        None => return ErrorCode::Error as c_int,
+    };
+    let roi = if width > 0 && height > 0 {
+        Some(FrameRect::new(x.max(0) as u32, y.max(0) as u32, width as u32, height as u32))
+    } else {
+        None
+    };
+    service.set_roi(roi);
+    ErrorCode::Success as c_int
+}
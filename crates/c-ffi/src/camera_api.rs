@@ -114,6 +114,7 @@ pub extern "C" fn smartscope_get_left_frame(frame_out: *mut CCameraFrame) -> c_i
                 format: frame.format,
                 timestamp_sec: timestamp.as_secs(),
                 timestamp_nsec: timestamp.subsec_nanos(),
+                frame_id: frame.frame_id,
             };
         }
         ErrorCode::Success as c_int
@@ -161,6 +162,7 @@ pub extern "C" fn smartscope_get_right_frame(frame_out: *mut CCameraFrame) -> c_
                 format: frame.format,
                 timestamp_sec: timestamp.as_secs(),
                 timestamp_nsec: timestamp.subsec_nanos(),
+                frame_id: frame.frame_id,
             };
         }
         ErrorCode::Success as c_int
@@ -208,6 +210,7 @@ pub extern "C" fn smartscope_get_single_frame(frame_out: *mut CCameraFrame) -> c
                 format: frame.format,
                 timestamp_sec: timestamp.as_secs(),
                 timestamp_nsec: timestamp.subsec_nanos(),
+                frame_id: frame.frame_id,
             };
         }
         ErrorCode::Success as c_int
@@ -315,7 +318,7 @@ fn process_and_save(dir: &Path, name: &str, raw: &smartscope_core::camera::Video
         if let Ok(mut pipeline) = p.lock() {
             let distortion_enabled = *app_state.distortion_correction_enabled.read().unwrap();
             pipeline.set_distortion_correction_enabled(distortion_enabled);
-            match pipeline.process_mjpeg_frame(&raw.data, is_left) {
+            match pipeline.process_mjpeg_frame(&raw.data, is_left, raw.frame_id) {
                 Ok((rgb, w, h)) => {
                     return save_rgb_png(dir, name, w, h, &rgb);
                 }
@@ -469,6 +472,7 @@ pub extern "C" fn smartscope_stereo_snapshot(left_out: *mut CCameraFrame, right_
             format: left.format,
             timestamp_sec: lts.as_secs(),
             timestamp_nsec: lts.subsec_nanos(),
+            frame_id: left.frame_id,
         };
         (*right_out) = CCameraFrame {
             data: rb.as_ptr(),
@@ -478,6 +482,7 @@ pub extern "C" fn smartscope_stereo_snapshot(left_out: *mut CCameraFrame, right_
             format: right.format,
             timestamp_sec: rts.as_secs(),
             timestamp_nsec: rts.subsec_nanos(),
+            frame_id: right.frame_id,
         };
     }
 
@@ -531,6 +536,7 @@ pub extern "C" fn smartscope_stereo_raw_snapshot(left_out: *mut CCameraFrame, ri
             format: left.format,
             timestamp_sec: lts.as_secs(),
             timestamp_nsec: lts.subsec_nanos(),
+            frame_id: left.frame_id,
         };
         (*right_out) = CCameraFrame {
             data: rb.as_ptr(),
@@ -540,6 +546,7 @@ pub extern "C" fn smartscope_stereo_raw_snapshot(left_out: *mut CCameraFrame, ri
             format: right.format,
             timestamp_sec: rts.as_secs(),
             timestamp_nsec: rts.subsec_nanos(),
+            frame_id: right.frame_id,
         };
     }
 
@@ -0,0 +1,52 @@
+use std::ffi::CStr;
+use std::os::raw::{c_char, c_int};
+
+use crate::state::get_app_state;
+use crate::types::ErrorCode;
+
+/// 开始把原始相机帧（双目左右/单目）转储到文件
+///
+/// 生成的 .ssdump 文件可通过 smartscope.toml 的 `[camera] source = "replay"` 回放
+#[no_mangle]
+pub extern "C" fn smartscope_camera_dump_start(output_path: *const c_char) -> c_int {
+    if output_path.is_null() {
+        return ErrorCode::Error as c_int;
+    }
+    let app_state = match get_app_state() {
+        Ok(state) => state,
+        Err(_) => return ErrorCode::Error as c_int,
+    };
+
+    let path = unsafe {
+        match CStr::from_ptr(output_path).to_str() {
+            Ok(s) => s,
+            Err(_) => return ErrorCode::Error as c_int,
+        }
+    };
+
+    match app_state.start_frame_dump(path) {
+        Ok(()) => ErrorCode::Success as c_int,
+        Err(e) => {
+            tracing::error!("开始帧转储失败: {}", e);
+            ErrorCode::Error as c_int
+        }
+    }
+}
+
+/// 停止帧转储（等待剩余帧写盘）
+#[no_mangle]
+pub extern "C" fn smartscope_camera_dump_stop() -> c_int {
+    let app_state = match get_app_state() {
+        Ok(state) => state,
+        Err(_) => return ErrorCode::Error as c_int,
+    };
+
+    match app_state.stop_frame_dump() {
+        Ok(Some(_)) => ErrorCode::Success as c_int,
+        Ok(None) => ErrorCode::Error as c_int,
+        Err(e) => {
+            tracing::error!("停止帧转储失败: {}", e);
+            ErrorCode::Error as c_int
+        }
+    }
+}
@@ -0,0 +1,78 @@
+use std::os::raw::{c_int, c_void};
+use std::sync::{Arc, Mutex};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::thread::{self, JoinHandle};
+use std::time::Duration;
+
+use crate::state::get_app_state;
+use crate::types::ErrorCode;
+
+/// 新帧回调：ctx, 帧序号, 驱动交付时刻（UNIX 纪元纳秒）
+///
+/// 在 Rust 通知线程中调用；若等待超时（无新帧）则以 seq = 0 调用一次，
+/// 便于前端照常推进相机状态机（例如模式切换处理）。
+type FrameCb = extern "C" fn(*mut c_void, u64, u64);
+
+/// 等待新帧的超时时间
+const FRAME_WAIT_TIMEOUT: Duration = Duration::from_millis(100);
+
+struct FrameMonitor {
+    stop: Arc<AtomicBool>,
+    handle: Option<JoinHandle<()>>,
+}
+
+lazy_static::lazy_static! {
+    static ref FRAME_MON: Mutex<Option<FrameMonitor>> = Mutex::new(None);
+}
+
+/// 注册新帧回调（替代前端定时轮询）；已有注册会先被取消
+#[no_mangle]
+pub extern "C" fn smartscope_register_frame_callback(ctx: *mut c_void, cb: Option<FrameCb>) -> c_int {
+    smartscope_unregister_frame_callback(std::ptr::null_mut());
+
+    let cb_fn = match cb {
+        Some(f) => f,
+        None => return ErrorCode::Error as c_int,
+    };
+    let signal = match get_app_state().ok().and_then(|s| s.frame_signal()) {
+        Some(s) => s,
+        None => {
+            tracing::warn!("注册帧回调失败：相机管理器未初始化");
+            return ErrorCode::Error as c_int;
+        }
+    };
+
+    let stop = Arc::new(AtomicBool::new(false));
+    let stop_clone = stop.clone();
+    let ctx_u = ctx as usize;
+
+    let handle = thread::spawn(move || {
+        let (mut last_seq, _) = signal.latest();
+        while !stop_clone.load(Ordering::Relaxed) {
+            match signal.wait_newer(last_seq, FRAME_WAIT_TIMEOUT) {
+                Some((seq, capture_ns)) => {
+                    last_seq = seq;
+                    if stop_clone.load(Ordering::Relaxed) { break; }
+                    cb_fn(ctx_u as *mut c_void, seq, capture_ns);
+                }
+                None => {
+                    if stop_clone.load(Ordering::Relaxed) { break; }
+                    cb_fn(ctx_u as *mut c_void, 0, 0);
+                }
+            }
+        }
+    });
+
+    *FRAME_MON.lock().unwrap() = Some(FrameMonitor { stop, handle: Some(handle) });
+    tracing::info!("帧回调已注册");
+    ErrorCode::Success as c_int
+}
+
+/// 取消新帧回调并等待通知线程退出（返回后不会再有回调）
+#[no_mangle]
+pub extern "C" fn smartscope_unregister_frame_callback(_ctx: *mut c_void) {
+    if let Some(m) = FRAME_MON.lock().unwrap().take() {
+        m.stop.store(true, Ordering::Relaxed);
+        if let Some(h) = m.handle { let _ = h.join(); }
+    }
+}
@@ -0,0 +1,151 @@
+//! 零拷贝取帧接口
+//!
+//! 与 `smartscope_get_*_frame` 不同，这里不会把帧拷贝到静态缓冲区：
+//! 处理好的帧被移动进 Rust 持有的共享帧环，C++ 借用槽内数据直接构造 QImage，
+//! 显示完成后通过 `smartscope_release_frame(handle)` 归还槽位。
+
+use std::os::raw::{c_int, c_void};
+
+use smartscope_core::camera::VideoFrame;
+use smartscope_core::frame_trace::{self, TraceStage};
+use smartscope_core::frame_ring::{FrameRing, FrameSlot, SlotFrame, DEFAULT_FRAME_RING_SLOTS};
+
+use crate::state::get_app_state;
+use crate::types::{CCameraFrame, ErrorCode};
+
+lazy_static! {
+    static ref LEFT_FRAME_RING: FrameRing = FrameRing::new(DEFAULT_FRAME_RING_SLOTS);
+    static ref RIGHT_FRAME_RING: FrameRing = FrameRing::new(DEFAULT_FRAME_RING_SLOTS);
+    static ref SINGLE_FRAME_RING: FrameRing = FrameRing::new(DEFAULT_FRAME_RING_SLOTS);
+}
+
+/// 把新帧发布进帧环并借出最新槽
+fn publish_and_acquire(
+    ring: &'static FrameRing,
+    frame: Option<VideoFrame>,
+    frame_out: *mut CCameraFrame,
+    handle_out: *mut *mut c_void,
+) -> c_int {
+    let frame = match frame {
+        Some(f) => f,
+        None => return ErrorCode::Error as c_int,
+    };
+    let start_ns = frame_trace::now_ns();
+    let frame_id = frame.frame_id;
+
+    let slot_frame = SlotFrame {
+        data: frame.data,
+        width: frame.width,
+        height: frame.height,
+        format: frame.format,
+        timestamp: frame.timestamp,
+        frame_id: frame.frame_id,
+    };
+    if ring.publish(slot_frame).is_err() {
+        // 所有槽都被前端占用：丢弃本帧，前端继续显示上一帧
+        tracing::debug!("FFI: 帧环已满，丢弃一帧 (dropped={})", ring.stats().dropped);
+        return ErrorCode::Error as c_int;
+    }
+
+    let slot = match ring.acquire_latest() {
+        Some(s) => s,
+        None => return ErrorCode::Error as c_int,
+    };
+    // SAFETY: 已持有槽引用，直到 C++ 调用 smartscope_release_frame
+    let f = unsafe { slot.frame() };
+    let timestamp = f
+        .timestamp
+        .duration_since(std::time::UNIX_EPOCH)
+        .unwrap_or_default();
+
+    unsafe {
+        (*frame_out) = CCameraFrame {
+            data: f.data.as_ptr(),
+            data_len: f.data.len(),
+            width: f.width,
+            height: f.height,
+            format: f.format,
+            timestamp_sec: timestamp.as_secs(),
+            timestamp_nsec: timestamp.subsec_nanos(),
+            frame_id: f.frame_id,
+        };
+        (*handle_out) = slot as *const FrameSlot as *mut c_void;
+    }
+    frame_trace::record(frame_id, TraceStage::FfiCopy, start_ns, frame_trace::now_ns());
+    ErrorCode::Success as c_int
+}
+
+/// 借用左相机最新帧（已处理，RGB888），无拷贝
+///
+/// 成功时 `handle_out` 返回槽句柄，用完后必须调用 `smartscope_release_frame`
+#[no_mangle]
+pub extern "C" fn smartscope_acquire_left_frame(
+    frame_out: *mut CCameraFrame,
+    handle_out: *mut *mut c_void,
+) -> c_int {
+    if frame_out.is_null() || handle_out.is_null() {
+        return ErrorCode::Error as c_int;
+    }
+    let app_state = match get_app_state() {
+        Ok(state) => state,
+        Err(_) => return ErrorCode::Error as c_int,
+    };
+    publish_and_acquire(&LEFT_FRAME_RING, app_state.get_processed_left_frame(), frame_out, handle_out)
+}
+
+/// 借用右相机最新帧（已处理，RGB888），无拷贝
+#[no_mangle]
+pub extern "C" fn smartscope_acquire_right_frame(
+    frame_out: *mut CCameraFrame,
+    handle_out: *mut *mut c_void,
+) -> c_int {
+    if frame_out.is_null() || handle_out.is_null() {
+        return ErrorCode::Error as c_int;
+    }
+    let app_state = match get_app_state() {
+        Ok(state) => state,
+        Err(_) => return ErrorCode::Error as c_int,
+    };
+    publish_and_acquire(&RIGHT_FRAME_RING, app_state.get_processed_right_frame(), frame_out, handle_out)
+}
+
+/// 借用单相机最新帧（原始数据），无拷贝
+#[no_mangle]
+pub extern "C" fn smartscope_acquire_single_frame(
+    frame_out: *mut CCameraFrame,
+    handle_out: *mut *mut c_void,
+) -> c_int {
+    if frame_out.is_null() || handle_out.is_null() {
+        return ErrorCode::Error as c_int;
+    }
+    let app_state = match get_app_state() {
+        Ok(state) => state,
+        Err(_) => return ErrorCode::Error as c_int,
+    };
+    publish_and_acquire(&SINGLE_FRAME_RING, app_state.get_single_camera_frame(), frame_out, handle_out)
+}
+
+/// 归还 `smartscope_acquire_*_frame` 借出的帧槽
+///
+/// 签名与 `QImageCleanupFunction` 兼容，可直接作为 QImage 的清理回调
+#[no_mangle]
+pub extern "C" fn smartscope_release_frame(handle: *mut c_void) {
+    if handle.is_null() {
+        return;
+    }
+    let slot_ptr = handle as *const FrameSlot;
+    for ring in [&*LEFT_FRAME_RING, &*RIGHT_FRAME_RING, &*SINGLE_FRAME_RING] {
+        if ring.owns(slot_ptr) {
+            // SAFETY: 指针属于静态帧环，生命周期为整个进程
+            ring.release(unsafe { &*slot_ptr });
+            return;
+        }
+    }
+    tracing::warn!("FFI: smartscope_release_frame 收到未知句柄 {:p}", handle);
+}
+
+/// 帧环统计（左/单相机显示路径）
+#[no_mangle]
+pub extern "C" fn smartscope_frame_ring_dropped_count() -> u64 {
+    LEFT_FRAME_RING.stats().dropped + SINGLE_FRAME_RING.stats().dropped
+}
@@ -13,6 +13,11 @@ mod init;           // smartscope_init / smartscope_shutdown
 mod config_api;     // 配置加载/保存/热重载与工具函数
 mod logging_api;    // 日志 FFI
 mod camera_api;     // 相机启动/停止/取帧/状态
+mod frame_ring_api; // 零拷贝取帧（共享帧环 acquire/release）
+mod frame_events_api; // 新帧推送回调（替代定时轮询）
+mod recorder_api;   // 相机视频录制（MJPEG 直通 / 软件 H.264）
+mod dump_api;       // 原始帧转储（供回放源使用）
+mod trace_api;      // 逐帧流水线追踪（分位数统计 / Chrome Trace 导出）
 mod ai_api;         // AI 推理接口
 mod ai_events_api;  // AI 结果推送回调
 mod video_api;      // 视频变换与畸变校正接口
@@ -0,0 +1,97 @@
+use std::ffi::CStr;
+use std::os::raw::{c_char, c_int};
+
+use smartscope_core::RecordingCodec;
+
+use crate::state::get_app_state;
+use crate::types::{CRecorderStats, ErrorCode};
+
+/// 开始录制相机视频
+///
+/// - `output_path`: 输出文件，`.avi` 写 AVI，其余写 MKV
+/// - `codec`: 0 = MJPEG 直通（不重新编码），1 = 软件 H.264（需要 ffmpeg/libx264）
+#[no_mangle]
+pub extern "C" fn smartscope_recorder_start(output_path: *const c_char, codec: c_int) -> c_int {
+    if output_path.is_null() {
+        return ErrorCode::Error as c_int;
+    }
+    let app_state = match get_app_state() {
+        Ok(state) => state,
+        Err(_) => return ErrorCode::Error as c_int,
+    };
+
+    let path = unsafe {
+        match CStr::from_ptr(output_path).to_str() {
+            Ok(s) => s,
+            Err(_) => return ErrorCode::Error as c_int,
+        }
+    };
+    let codec = match codec {
+        1 => RecordingCodec::H264Software,
+        _ => RecordingCodec::MjpegPassthrough,
+    };
+
+    match app_state.start_recording(path, codec) {
+        Ok(()) => ErrorCode::Success as c_int,
+        Err(e) => {
+            tracing::error!("开始录制失败: {}", e);
+            ErrorCode::Error as c_int
+        }
+    }
+}
+
+/// 停止录制（排空编码队列并完成容器写入，可能阻塞片刻）
+#[no_mangle]
+pub extern "C" fn smartscope_recorder_stop() -> c_int {
+    let app_state = match get_app_state() {
+        Ok(state) => state,
+        Err(_) => return ErrorCode::Error as c_int,
+    };
+
+    match app_state.stop_recording() {
+        Ok(Some(_)) => ErrorCode::Success as c_int,
+        Ok(None) => ErrorCode::Error as c_int,
+        Err(e) => {
+            tracing::error!("停止录制失败: {}", e);
+            ErrorCode::Error as c_int
+        }
+    }
+}
+
+/// 是否正在录制
+#[no_mangle]
+pub extern "C" fn smartscope_recorder_is_recording() -> bool {
+    match get_app_state() {
+        Ok(state) => state.is_recording(),
+        Err(_) => false,
+    }
+}
+
+/// 获取录制统计（未在录制时返回错误）
+#[no_mangle]
+pub extern "C" fn smartscope_recorder_get_stats(stats_out: *mut CRecorderStats) -> c_int {
+    if stats_out.is_null() {
+        return ErrorCode::Error as c_int;
+    }
+    let app_state = match get_app_state() {
+        Ok(state) => state,
+        Err(_) => return ErrorCode::Error as c_int,
+    };
+
+    match app_state.recorder_stats() {
+        Some(stats) => {
+            unsafe {
+                *stats_out = CRecorderStats {
+                    frames_written: stats.frames_written,
+                    frames_dropped: stats.frames_dropped,
+                    bytes_written: stats.bytes_written,
+                    queue_depth: stats.queue_depth as u32,
+                    elapsed_ms: stats.elapsed_ms,
+                    write_bytes_per_sec: stats.write_bytes_per_sec,
+                };
+            }
+            ErrorCode::Success as c_int
+        }
+        None => ErrorCode::Error as c_int,
+    }
+}
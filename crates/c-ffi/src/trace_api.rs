@@ -0,0 +1,96 @@
+//! 逐帧流水线追踪接口
+//!
+//! Rust 侧阶段（采集、解码、校正、变换、FFI、AI）在核心内部自动打点；
+//! 前端阶段（QImage、绘制、端到端）通过 `smartscope_trace_record` 使用同一时钟记录。
+
+use std::ffi::CStr;
+use std::os::raw::{c_char, c_int};
+use std::time::{Duration, UNIX_EPOCH};
+
+use smartscope_core::frame_trace::{self, TraceStage};
+
+use crate::types::{CTraceStageStats, ErrorCode};
+
+/// 启用/停用追踪（默认启用）
+#[no_mangle]
+pub extern "C" fn smartscope_trace_set_enabled(enabled: bool) {
+    frame_trace::tracer().set_enabled(enabled);
+}
+
+#[no_mangle]
+pub extern "C" fn smartscope_trace_is_enabled() -> bool {
+    frame_trace::tracer().is_enabled()
+}
+
+/// 追踪时钟（进程内单调纳秒），前端打点必须使用此时钟
+#[no_mangle]
+pub extern "C" fn smartscope_trace_now_ns() -> u64 {
+    frame_trace::now_ns()
+}
+
+/// 把 Unix 纪元纳秒（如 CCameraFrame 的采集时间戳）换算到追踪时钟
+#[no_mangle]
+pub extern "C" fn smartscope_trace_from_unix_ns(unix_ns: u64) -> u64 {
+    frame_trace::system_time_to_ns(UNIX_EPOCH + Duration::from_nanos(unix_ns))
+}
+
+/// 记录一段阶段耗时；`stage` 非法时返回错误
+#[no_mangle]
+pub extern "C" fn smartscope_trace_record(frame_id: u64, stage: u32, start_ns: u64, end_ns: u64) -> c_int {
+    match u8::try_from(stage).ok().and_then(TraceStage::from_u8) {
+        Some(stage) => {
+            frame_trace::record(frame_id, stage, start_ns, end_ns);
+            ErrorCode::Success as c_int
+        }
+        None => ErrorCode::Error as c_int,
+    }
+}
+
+/// 获取各阶段滚动分位数
+///
+/// 最多写入 `max_stages` 项，返回实际写入数；只包含有样本的阶段，出错返回 -1
+#[no_mangle]
+pub extern "C" fn smartscope_trace_get_stage_stats(stats_out: *mut CTraceStageStats, max_stages: c_int) -> c_int {
+    if stats_out.is_null() || max_stages <= 0 {
+        return -1;
+    }
+    let stats = frame_trace::tracer().stage_stats();
+    let count = stats.len().min(max_stages as usize);
+    for (i, s) in stats.iter().take(count).enumerate() {
+        unsafe {
+            (*stats_out.add(i)) = CTraceStageStats {
+                stage: s.stage as u32,
+                count: s.count,
+                p50_ms: s.p50_ms,
+                p95_ms: s.p95_ms,
+                p99_ms: s.p99_ms,
+                max_ms: s.max_ms,
+            };
+        }
+    }
+    count as c_int
+}
+
+/// 把追踪缓冲导出为 Chrome Trace JSON，返回导出的事件数，出错返回 -1
+#[no_mangle]
+pub extern "C" fn smartscope_trace_export_chrome(output_path: *const c_char) -> c_int {
+    if output_path.is_null() {
+        return -1;
+    }
+    let path = unsafe {
+        match CStr::from_ptr(output_path).to_str() {
+            Ok(s) => s,
+            Err(_) => return -1,
+        }
+    };
+    match frame_trace::tracer().export_chrome_trace(path) {
+        Ok(n) => {
+            tracing::info!("导出追踪 {} 条事件 -> {}", n, path);
+            n as c_int
+        }
+        Err(e) => {
+            tracing::error!("导出追踪失败: {}", e);
+            -1
+        }
+    }
+}
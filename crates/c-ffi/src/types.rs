@@ -81,6 +81,8 @@ pub struct CCameraFrame {
     pub format: u32,
     pub timestamp_sec: u64,
     pub timestamp_nsec: u32,
+    /// 相机帧号（逐帧追踪用，同一相机内递增）
+    pub frame_id: u64,
 }
 
 #[repr(C)]
@@ -93,6 +95,35 @@ pub struct CCameraStatus {
     pub last_right_frame_sec: u64,
 }
 
+// =========================
+// 视频录制
+// =========================
+
+#[repr(C)]
+pub struct CRecorderStats {
+    pub frames_written: u64,
+    pub frames_dropped: u64,
+    pub bytes_written: u64,
+    pub queue_depth: u32,
+    pub elapsed_ms: u64,
+    pub write_bytes_per_sec: f64,
+}
+
+// =========================
+// 逐帧追踪
+// =========================
+
+/// 单阶段滚动耗时统计（毫秒）；`stage` 取值见 `TraceStage`
+#[repr(C)]
+pub struct CTraceStageStats {
+    pub stage: u32,
+    pub count: u32,
+    pub p50_ms: f64,
+    pub p95_ms: f64,
+    pub p99_ms: f64,
+    pub max_ms: f64,
+}
+
 // =========================
 // AI 检测
 // =========================
@@ -107,6 +138,55 @@ pub struct CDetection {
     pub class_id: i32,
 }
 
+/// AI 后处理配置（与 smartscope_CAiPostprocessConfig 对应）
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct CAiPostprocessConfig {
+    pub conf_threshold: f32,
+    pub nms_threshold: f32,
+    /// <= 0 表示取结果表容量（128）
+    pub max_detections: i32,
+    /// 允许类别位图：类别 c 对应 class_mask[c / 64] 的第 c % 64 位；全 0 表示不过滤
+    pub class_mask: [u64; 4],
+}
+
+/// AI 推理单阶段耗时（毫秒，分位数按 2 的幂直方图桶上界估计）
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct CAiStageStats {
+    pub count: u64,
+    pub mean_ms: f64,
+    pub p50_ms: f64,
+    pub p95_ms: f64,
+    pub max_ms: f64,
+    pub last_ms: f64,
+}
+
+/// AI 推理统计（所有上下文汇总，与 smartscope_CAiStats 对应）
+///
+/// stages 依次为 preprocess / run / outputs / decode / nms（smartscope_AiStage）
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct CAiStats {
+    pub stages: [CAiStageStats; 5],
+    pub frames: u64,
+    pub errors: u64,
+    pub candidates_mean: f64,
+    pub candidates_max: u64,
+    pub candidates_last: u64,
+    pub candidates_dropped: u64,
+    pub detections_mean: f64,
+    pub detections_last: u64,
+    // 流水线计数
+    pub submitted: u64,
+    pub dropped: u64,
+    pub completed: u64,
+    pub failed: u64,
+    pub in_flight: u64,
+    pub contexts: u32,
+    pub cores: u32,
+}
+
 // =========================
 // 相机参数
 // =========================
@@ -17,6 +17,14 @@ fn main() {
         .cpp(true)
         .file("csrc/yolov8.cc")
         .file("csrc/postprocess.cc")
+        .file("csrc/yolov8_decode.cc")
+        .file("csrc/yolov8_nms.cc")
+        .file("csrc/yolov8_arena.cc")
+        .file("csrc/yolov8_letterbox.cc")
+        .file("csrc/yolov8_tensor.cc")
+        .file("csrc/yolov8_backend.cc")
+        .file("csrc/yolov8_model.cc")
+        .file("csrc/yolov8_stats.cc")
         .file("csrc/image_utils.cpp")  // Changed from .c to .cpp
         .file("csrc/file_utils.cpp")    // Changed from .c to .cpp
         .file("csrc/rknn_wrapper.cpp")
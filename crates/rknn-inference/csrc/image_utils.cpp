@@ -13,6 +13,7 @@
 
 #include "image_utils.h"
 #include "file_utils.h"
+#include "yolov8_letterbox.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -192,30 +193,21 @@ static int convert_image_cpu(image_buffer_t *src, image_buffer_t *dst, image_rec
         dst_box_h = dst_box->bottom - dst_box->top + 1;
     }
 
-    // fill pad color
-    if (dst_box_w != dst->width || dst_box_h != dst->height) {
-        int dst_size = get_image_size(dst);
-        memset(dst->virt_addr, color, dst_size);
-    }
-
     int need_release_dst_buffer = 0;
     int reti = 0;
-    if (src->format == IMAGE_FORMAT_RGB888) {
-        reti = crop_and_scale_image_c(3, src->virt_addr, src->width, src->height,
-            src_box_x, src_box_y, src_box_w, src_box_h,
-            dst->virt_addr, dst->width, dst->height,
-            dst_box_x, dst_box_y, dst_box_w, dst_box_h);
-    } else if (src->format == IMAGE_FORMAT_RGBA8888) {
-        reti = crop_and_scale_image_c(4, src->virt_addr, src->width, src->height,
-            src_box_x, src_box_y, src_box_w, src_box_h,
-            dst->virt_addr, dst->width, dst->height,
-            dst_box_x, dst_box_y, dst_box_w, dst_box_h);
-    } else if (src->format == IMAGE_FORMAT_GRAY8) {
-        reti = crop_and_scale_image_c(1, src->virt_addr, src->width, src->height,
-            src_box_x, src_box_y, src_box_w, src_box_h,
-            dst->virt_addr, dst->width, dst->height,
-            dst_box_x, dst_box_y, dst_box_w, dst_box_h);
+    if (src->format == IMAGE_FORMAT_RGB888 || src->format == IMAGE_FORMAT_RGBA8888 || src->format == IMAGE_FORMAT_GRAY8) {
+        // 定点双线性缩放，填充色只写 dst_box 以外的边框，一趟完成
+        int channel = src->format == IMAGE_FORMAT_RGB888 ? 3 : (src->format == IMAGE_FORMAT_RGBA8888 ? 4 : 1);
+        reti = yolov8_letterbox_resize(src->virt_addr, src->width, src->height, src->width * channel,
+            src_box_x, src_box_y, src_box_w, src_box_h, channel,
+            dst->virt_addr, dst->width, dst->height, dst->width * channel,
+            dst_box_x, dst_box_y, dst_box_w, dst_box_h, (uint8_t)color);
     } else if (src->format == IMAGE_FORMAT_YUV420SP_NV12 || src->format == IMAGE_FORMAT_YUV420SP_NV21) {
+        // fill pad color
+        if (dst_box_w != dst->width || dst_box_h != dst->height) {
+            int dst_size = get_image_size(dst);
+            memset(dst->virt_addr, color, dst_size);
+        }
         reti = crop_and_scale_image_yuv420sp(src->virt_addr, src->width, src->height,
             src_box_x, src_box_y, src_box_w, src_box_h,
             dst->virt_addr, dst->width, dst->height,
@@ -227,7 +219,6 @@ static int convert_image_cpu(image_buffer_t *src, image_buffer_t *dst, image_rec
         printf("convert_image_cpu fail %d\n", reti);
         return -1;
     }
-    printf("finish\n");
     return 0;
 }
 
@@ -409,8 +400,6 @@ static int convert_image_rga(image_buffer_t* src_img, image_buffer_t* dst_img, i
         p_imcolor[1] = color;
         p_imcolor[2] = color;
         p_imcolor[3] = color;
-        printf("fill dst image (x y w h)=(%d %d %d %d) with color=0x%x\n",
-            dst_whole_rect.x, dst_whole_rect.y, dst_whole_rect.width, dst_whole_rect.height, imcolor);
         ret_rga = imfill(rga_buf_dst, dst_whole_rect, imcolor);
         if (ret_rga <= 0) {
             if (dst != NULL) {
@@ -447,7 +436,6 @@ int convert_image(image_buffer_t* src_img, image_buffer_t* dst_img, image_rect_t
 {
     int ret;
 #if defined(DISABLE_RGA) 
-    printf("convert image use cpu\n");
     ret = convert_image_cpu(src_img, dst_img, src_box, dst_box, color);
 #else
 
@@ -458,11 +446,11 @@ int convert_image(image_buffer_t* src_img, image_buffer_t* dst_img, image_rect_t
 #endif
         ret = convert_image_rga(src_img, dst_img, src_box, dst_box, color);
         if (ret != 0) {
-            printf("try convert image use cpu\n");
+            // RGA 失败时退回 CPU
             ret = convert_image_cpu(src_img, dst_img, src_box, dst_box, color);
         }
     } else {
-        printf("src width is not 4/16-aligned, convert image use cpu\n");
+        // src width is not 4/16-aligned, convert image use cpu
         ret = convert_image_cpu(src_img, dst_img, src_box, dst_box, color);
     }
 #endif
@@ -540,10 +528,6 @@ int convert_image_with_letterbox(image_buffer_t* src_image, image_buffer_t* dst_
         dst_box.right = dst_box.left + resize_w - 1;
         _left_offset = dst_box.left;
     }
-    printf("scale=%f dst_box=(%d %d %d %d) allow_slight_change=%d _left_offset=%d _top_offset=%d padding_w=%d padding_h=%d\n",
-        scale, dst_box.left, dst_box.top, dst_box.right, dst_box.bottom, allow_slight_change,
-        _left_offset, _top_offset, padding_w, padding_h);
-
     //set offset and scale
     if(letterbox != NULL){
         letterbox->scale = scale;
@@ -2,6 +2,7 @@
 
 #include "../include/yolov8.h"
 #include "../include/postprocess.h"
+#include "../include/yolov8_model.h"
 
 extern "C" {
 
@@ -9,6 +10,20 @@ int init_yolov8_model_wrapper(const char* model_path, rknn_app_context_t* app_ct
     return init_yolov8_model(model_path, app_ctx);
 }
 
+int yolov8_init_model_ex_wrapper(const char* model_path, const rknn_app_context_t* src, rknn_app_context_t* app_ctx,
+                                 yolov8_init_timing* timing) {
+    return yolov8_init_model_ex(model_path, src, app_ctx, timing);
+}
+
+int yolov8_model_acquire_wrapper(const char* model_path) {
+    yolov8_model_blob blob;
+    return yolov8_model_acquire(model_path, &blob, NULL);
+}
+
+void yolov8_model_release_wrapper(const char* model_path) {
+    yolov8_model_release(model_path);
+}
+
 int release_yolov8_model_wrapper(rknn_app_context_t* app_ctx) {
     return release_yolov8_model(app_ctx);
 }
@@ -17,6 +32,10 @@ int inference_yolov8_model_wrapper(rknn_app_context_t* app_ctx, image_buffer_t*
     return inference_yolov8_model(app_ctx, img, od_results);
 }
 
+int yolov8_set_npu_core_wrapper(rknn_app_context_t* app_ctx, int core) {
+    return yolov8_set_npu_core(app_ctx, core);
+}
+
 int init_post_process_wrapper() {
     return init_post_process();
 }
@@ -29,6 +48,27 @@ char* coco_cls_to_name_wrapper(int cls_id) {
     return coco_cls_to_name(cls_id);
 }
 
+uint64_t post_process_allocation_count_wrapper(rknn_app_context_t* app_ctx) {
+    return post_process_allocation_count(app_ctx);
+}
+
+int set_post_process_config_wrapper(rknn_app_context_t* app_ctx, const yolov8_postprocess_config* config) {
+    return set_post_process_config(app_ctx, config);
+}
+
+int post_process_num_classes_wrapper(rknn_app_context_t* app_ctx) {
+    return post_process_num_classes(app_ctx);
+}
+
+// 统计句柄为 app_ctx->stats（上下文存续期间不变，内部带锁，可在推理线程之外调用）
+void yolov8_stats_snapshot_wrapper(yolov8_stats* stats, yolov8_inference_stats* out) {
+    yolov8_stats_snapshot(stats, out);
+}
+
+void yolov8_stats_reset_wrapper(yolov8_stats* stats) {
+    yolov8_stats_reset(stats);
+}
+
 // Separate step wrappers for benchmarking
 int yolov8_preprocess_wrapper(rknn_app_context_t* app_ctx, image_buffer_t* img, image_buffer_t* dst_img, letterbox_t* letter_box) {
     return yolov8_preprocess(app_ctx, img, dst_img, letter_box);
@@ -20,7 +20,12 @@
 #include <math.h>
 #include <sys/time.h>
 
+#include <atomic>
+#include <mutex>
+
 #include "yolov8.h"
+#include "yolov8_tensor.h"
+#include "yolov8_model.h"
 #include "common.h"
 #include "file_utils.h"
 #include "image_utils.h"
@@ -42,75 +47,141 @@ static void dump_tensor_attr(rknn_tensor_attr *attr)
            get_qnt_type_string(attr->qnt_type), attr->zp, attr->scale);
 }
 
-int init_yolov8_model(const char *model_path, rknn_app_context_t *app_ctx)
+// 录制输出张量：设置 SMARTSCOPE_RKNN_DUMP_DIR 后，前若干次推理的输出
+// 写为 yolov8_outputs_<n>.yv8t（按后端的实际布局），供 benchmarks/yolov8_decode_bench 离线回放
+#define YOLOV8_DUMP_MAX_FILES 8
+
+static void maybe_dump_outputs(rknn_app_context_t *app_ctx, const yolov8_tensor_view *views)
 {
-    int ret;
-    int model_len = 0;
-    char *model;
-    rknn_context ctx = 0;
+    static std::atomic<int> dump_count(0);
+    const char *dir = getenv("SMARTSCOPE_RKNN_DUMP_DIR");
+    if (dir == NULL || dir[0] == '\0' || dump_count.load() >= YOLOV8_DUMP_MAX_FILES)
+    {
+        return;
+    }
+    int n = dump_count.fetch_add(1);
+    if (n >= YOLOV8_DUMP_MAX_FILES)
+    {
+        return;
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/yolov8_outputs_%d.yv8t", dir, n);
+    if (yolov8_tensor_file_write(path, views, app_ctx->io_num.n_output, app_ctx->model_width, app_ctx->model_height) < 0)
+    {
+        printf("dump outputs: write %s fail!\n", path);
+        return;
+    }
+    printf("dump outputs: %s\n", path);
+}
 
-    // Load RKNN Model
-    model_len = read_data_from_file(model_path, &model);
-    if (model == NULL)
+// 从模型文件创建 rknn 上下文（文件经映射缓存共享，不再逐个上下文读入 malloc 的缓冲）
+static int load_rknn_context(const char *model_path, rknn_context *ctx, yolov8_init_timing *timing)
+{
+    double t0 = get_current_time_ms();
+    yolov8_model_blob blob;
+    if (yolov8_model_acquire(model_path, &blob, NULL) < 0)
     {
         printf("load_model fail!\n");
         return -1;
     }
+    double t1 = get_current_time_ms();
 
-    ret = rknn_init(&ctx, model, model_len, 0, NULL);
-    free(model);
+    int ret = rknn_init(ctx, blob.data, (uint32_t)blob.size, 0, NULL);
+    yolov8_model_release(model_path);
+    timing->load_ms = t1 - t0;
+    timing->init_ms = get_current_time_ms() - t1;
     if (ret < 0)
     {
         printf("rknn_init fail! ret=%d\n", ret);
+        *ctx = 0;
+        return -1;
+    }
+    return 0;
+}
+
+// 复制 src 的 rknn 上下文（共享权重）；平台不支持或复制失败返回 -1
+static int dup_rknn_context(const rknn_app_context_t *src, rknn_context *ctx, yolov8_init_timing *timing)
+{
+#if defined(RKNPU1) || defined(RV1106_1103)
+    return -1;
+#else
+    // 多个线程可能同时从同一个源复制，复制本身串行执行
+    static std::mutex dup_mutex;
+    double t0 = get_current_time_ms();
+    rknn_context in = src->rknn_ctx;
+    int ret;
+    {
+        std::lock_guard<std::mutex> lock(dup_mutex);
+        ret = rknn_dup_context(&in, ctx);
+    }
+    timing->init_ms = get_current_time_ms() - t0;
+    if (ret < 0)
+    {
+        printf("rknn_dup_context fail! ret=%d, fall back to rknn_init\n", ret);
+        *ctx = 0;
         return -1;
     }
+    timing->duplicated = 1;
+    return 0;
+#endif
+}
 
-    // Get Model Input Output Number
-    rknn_input_output_num io_num;
-    ret = rknn_query(ctx, RKNN_QUERY_IN_OUT_NUM, &io_num, sizeof(io_num));
+// 查询输入输出个数与属性
+static int query_model_attrs(rknn_app_context_t *app_ctx)
+{
+    rknn_context ctx = app_ctx->rknn_ctx;
+    int ret = rknn_query(ctx, RKNN_QUERY_IN_OUT_NUM, &app_ctx->io_num, sizeof(app_ctx->io_num));
     if (ret != RKNN_SUCC)
     {
         printf("rknn_query fail! ret=%d\n", ret);
         return -1;
     }
+    rknn_input_output_num io_num = app_ctx->io_num;
     printf("model input num: %d, output num: %d\n", io_num.n_input, io_num.n_output);
+    if (io_num.n_output == 0 || io_num.n_output > YOLOV8_MAX_OUTPUTS)
+    {
+        printf("unsupported output num %d (max %d)\n", io_num.n_output, YOLOV8_MAX_OUTPUTS);
+        return -1;
+    }
+
+    app_ctx->input_attrs = (rknn_tensor_attr *)calloc(io_num.n_input, sizeof(rknn_tensor_attr));
+    app_ctx->output_attrs = (rknn_tensor_attr *)calloc(io_num.n_output, sizeof(rknn_tensor_attr));
+    if (app_ctx->input_attrs == NULL || app_ctx->output_attrs == NULL)
+    {
+        return -1;
+    }
 
     // Get Model Input Info
     printf("input tensors:\n");
-    rknn_tensor_attr input_attrs[io_num.n_input];
-    memset(input_attrs, 0, sizeof(input_attrs));
     for (int i = 0; i < io_num.n_input; i++)
     {
-        input_attrs[i].index = i;
-        ret = rknn_query(ctx, RKNN_QUERY_INPUT_ATTR, &(input_attrs[i]), sizeof(rknn_tensor_attr));
+        app_ctx->input_attrs[i].index = i;
+        ret = rknn_query(ctx, RKNN_QUERY_INPUT_ATTR, &(app_ctx->input_attrs[i]), sizeof(rknn_tensor_attr));
         if (ret != RKNN_SUCC)
         {
             printf("rknn_query fail! ret=%d\n", ret);
             return -1;
         }
-        dump_tensor_attr(&(input_attrs[i]));
+        dump_tensor_attr(&(app_ctx->input_attrs[i]));
     }
 
     // Get Model Output Info
     printf("output tensors:\n");
-    rknn_tensor_attr output_attrs[io_num.n_output];
-    memset(output_attrs, 0, sizeof(output_attrs));
     for (int i = 0; i < io_num.n_output; i++)
     {
-        output_attrs[i].index = i;
-        ret = rknn_query(ctx, RKNN_QUERY_OUTPUT_ATTR, &(output_attrs[i]), sizeof(rknn_tensor_attr));
+        app_ctx->output_attrs[i].index = i;
+        ret = rknn_query(ctx, RKNN_QUERY_OUTPUT_ATTR, &(app_ctx->output_attrs[i]), sizeof(rknn_tensor_attr));
         if (ret != RKNN_SUCC)
         {
             printf("rknn_query fail! ret=%d\n", ret);
             return -1;
         }
-        dump_tensor_attr(&(output_attrs[i]));
+        dump_tensor_attr(&(app_ctx->output_attrs[i]));
     }
 
-    // Set to context
-    app_ctx->rknn_ctx = ctx;
-
     // TODO
+    rknn_tensor_attr *output_attrs = app_ctx->output_attrs;
     if (output_attrs[0].qnt_type == RKNN_TENSOR_QNT_AFFINE_ASYMMETRIC && output_attrs[0].type == RKNN_TENSOR_INT8)
     {
         app_ctx->is_quant = true;
@@ -120,12 +191,7 @@ int init_yolov8_model(const char *model_path, rknn_app_context_t *app_ctx)
         app_ctx->is_quant = false;
     }
 
-    app_ctx->io_num = io_num;
-    app_ctx->input_attrs = (rknn_tensor_attr *)malloc(io_num.n_input * sizeof(rknn_tensor_attr));
-    memcpy(app_ctx->input_attrs, input_attrs, io_num.n_input * sizeof(rknn_tensor_attr));
-    app_ctx->output_attrs = (rknn_tensor_attr *)malloc(io_num.n_output * sizeof(rknn_tensor_attr));
-    memcpy(app_ctx->output_attrs, output_attrs, io_num.n_output * sizeof(rknn_tensor_attr));
-
+    rknn_tensor_attr *input_attrs = app_ctx->input_attrs;
     if (input_attrs[0].fmt == RKNN_TENSOR_NCHW)
     {
         printf("model is NCHW input fmt\n");
@@ -142,12 +208,104 @@ int init_yolov8_model(const char *model_path, rknn_app_context_t *app_ctx)
     }
     printf("model input height=%d, width=%d, channel=%d\n",
            app_ctx->model_height, app_ctx->model_width, app_ctx->model_channel);
+    return 0;
+}
 
+// 复制上下文与源模型相同，属性直接拷贝，不再逐个查询
+static int copy_model_attrs(const rknn_app_context_t *src, rknn_app_context_t *app_ctx)
+{
+    app_ctx->io_num = src->io_num;
+    app_ctx->input_attrs = (rknn_tensor_attr *)malloc(src->io_num.n_input * sizeof(rknn_tensor_attr));
+    app_ctx->output_attrs = (rknn_tensor_attr *)malloc(src->io_num.n_output * sizeof(rknn_tensor_attr));
+    if (app_ctx->input_attrs == NULL || app_ctx->output_attrs == NULL)
+    {
+        return -1;
+    }
+    memcpy(app_ctx->input_attrs, src->input_attrs, src->io_num.n_input * sizeof(rknn_tensor_attr));
+    memcpy(app_ctx->output_attrs, src->output_attrs, src->io_num.n_output * sizeof(rknn_tensor_attr));
+    app_ctx->model_channel = src->model_channel;
+    app_ctx->model_width = src->model_width;
+    app_ctx->model_height = src->model_height;
+    app_ctx->is_quant = src->is_quant;
     return 0;
 }
 
+int yolov8_init_model_ex(const char *model_path, const rknn_app_context_t *src, rknn_app_context_t *app_ctx,
+                         yolov8_init_timing *timing)
+{
+    yolov8_init_timing local_timing;
+    if (timing == NULL)
+    {
+        timing = &local_timing;
+    }
+    memset(timing, 0, sizeof(*timing));
+    if (app_ctx == NULL || (model_path == NULL && src == NULL))
+    {
+        return -1;
+    }
+    memset(app_ctx, 0, sizeof(*app_ctx));
+
+    // 优先复制已初始化的上下文：权重共享，跳过模型加载与属性查询
+    rknn_context ctx = 0;
+    bool duplicated = src != NULL && src->rknn_ctx != 0 && dup_rknn_context(src, &ctx, timing) == 0;
+    if (!duplicated)
+    {
+        if (model_path == NULL || load_rknn_context(model_path, &ctx, timing) < 0)
+        {
+            return -1;
+        }
+    }
+    app_ctx->rknn_ctx = ctx;
+
+    double t0 = get_current_time_ms();
+    int ret = duplicated ? copy_model_attrs(src, app_ctx) : query_model_attrs(app_ctx);
+    double t1 = get_current_time_ms();
+    timing->query_ms = t1 - t0;
+    if (ret < 0)
+    {
+        release_yolov8_model(app_ctx);
+        return -1;
+    }
+
+    if (init_post_process_arena(app_ctx) < 0)
+    {
+        release_yolov8_model(app_ctx);
+        return -1;
+    }
+
+    // 输入/输出张量内存：letterbox 每帧直接写入后端的输入缓冲，不再逐帧 malloc/free
+    app_ctx->backend = yolov8_create_rknn_backend(app_ctx, yolov8_io_mode_from_env());
+    app_ctx->stats = yolov8_stats_create();
+    timing->setup_ms = get_current_time_ms() - t1;
+    if (app_ctx->backend == NULL)
+    {
+        printf("create rknn backend fail!\n");
+        release_yolov8_model(app_ctx);
+        return -1;
+    }
+
+    return 0;
+}
+
+int init_yolov8_model(const char *model_path, rknn_app_context_t *app_ctx)
+{
+    return yolov8_init_model_ex(model_path, NULL, app_ctx, NULL);
+}
+
 int release_yolov8_model(rknn_app_context_t *app_ctx)
 {
+    release_post_process_arena(app_ctx);
+    // 后端持有的 rknn mem 须在 rknn_destroy 之前释放
+    if (app_ctx->backend != NULL)
+    {
+        yolov8_tensor_backend_destroy(app_ctx->backend);
+        app_ctx->backend = NULL;
+    }
+    if (app_ctx->stats != NULL)
+    {
+        yolov8_stats_destroy(app_ctx->stats);
+        app_ctx->stats = NULL;
+    }
     if (app_ctx->input_attrs != NULL)
     {
         free(app_ctx->input_attrs);
@@ -166,116 +324,107 @@ int release_yolov8_model(rknn_app_context_t *app_ctx)
     return 0;
 }
 
-int inference_yolov8_model(rknn_app_context_t *app_ctx, image_buffer_t *img, object_detect_result_list *od_results)
+int yolov8_set_npu_core(rknn_app_context_t *app_ctx, int core)
 {
-    int ret;
-    image_buffer_t dst_img;
-    letterbox_t letter_box;
-    rknn_input inputs[app_ctx->io_num.n_input];
-    rknn_output outputs[app_ctx->io_num.n_output];
-    const float nms_threshold = NMS_THRESH;      // 默认的NMS阈值
-    const float box_conf_threshold = BOX_THRESH; // 默认的置信度阈值
-    int bg_color = 114;
-
-    if ((!app_ctx) || !(img) || (!od_results))
+    if (app_ctx == NULL || app_ctx->rknn_ctx == 0 || core < -1 || core > 2)
     {
         return -1;
     }
-
-    memset(od_results, 0x00, sizeof(*od_results));
-    memset(&letter_box, 0, sizeof(letterbox_t));
-    memset(&dst_img, 0, sizeof(image_buffer_t));
-    memset(inputs, 0, sizeof(inputs));
-    memset(outputs, 0, sizeof(outputs));
-
-    // Pre Process
-    double t0 = get_current_time_ms();
-    dst_img.width = app_ctx->model_width;
-    dst_img.height = app_ctx->model_height;
-    dst_img.format = IMAGE_FORMAT_RGB888;
-    dst_img.size = get_image_size(&dst_img);
-    dst_img.virt_addr = (unsigned char *)malloc(dst_img.size);
-    if (dst_img.virt_addr == NULL)
-    {
-        printf("malloc buffer size:%d fail!\n", dst_img.size);
-        return -1;
-    }
-
-    // letterbox
-    ret = convert_image_with_letterbox(img, &dst_img, &letter_box, bg_color);
+#if defined(RKNPU1) || defined(RV1106_1103)
+    return core == -1 ? 0 : -1;
+#else
+    rknn_core_mask mask = core < 0 ? RKNN_NPU_CORE_AUTO : (rknn_core_mask)(RKNN_NPU_CORE_0 << core);
+    int ret = rknn_set_core_mask(app_ctx->rknn_ctx, mask);
     if (ret < 0)
     {
-        printf("convert_image_with_letterbox fail! ret=%d\n", ret);
+        printf("rknn_set_core_mask(%d) fail! ret=%d\n", core, ret);
         return -1;
     }
-    double t1 = get_current_time_ms();
-
-    // Set Input Data
-    inputs[0].index = 0;
-    inputs[0].type = RKNN_TENSOR_UINT8;
-    inputs[0].fmt = RKNN_TENSOR_NHWC;
-    inputs[0].size = app_ctx->model_width * app_ctx->model_height * app_ctx->model_channel;
-    inputs[0].buf = dst_img.virt_addr;
+    return 0;
+#endif
+}
 
-    ret = rknn_inputs_set(app_ctx->rknn_ctx, app_ctx->io_num.n_input, inputs);
-    if (ret < 0)
+// 把 dst_img 指向后端的常驻输入缓冲（RGB888，模型输入尺寸；zero copy 时即 NPU 输入 mem）
+static int bind_input_buffer(rknn_app_context_t *app_ctx, image_buffer_t *dst_img)
+{
+    dst_img->width = app_ctx->model_width;
+    dst_img->height = app_ctx->model_height;
+    dst_img->format = IMAGE_FORMAT_RGB888;
+    dst_img->size = get_image_size(dst_img);
+    int input_size = 0;
+    unsigned char *input = app_ctx->backend != NULL ? app_ctx->backend->input(&input_size) : NULL;
+    if (input == NULL || input_size < dst_img->size)
     {
-        printf("rknn_input_set fail! ret=%d\n", ret);
+        printf("input buffer size:%d too small for %d!\n", input_size, dst_img->size);
         return -1;
     }
+    dst_img->virt_addr = input;
+    return 0;
+}
 
-    // Run
-    double t2 = get_current_time_ms();
-    ret = rknn_run(app_ctx->rknn_ctx, nullptr);
-    if (ret < 0)
+// rknn_run 与取输出分开计时（拷贝后端在第一次 outputs() 时才 rknn_outputs_get）；
+// start_us 为 run 阶段的起点（调用方可把输入拷贝计入 run）。失败时归还输出并记一次错误
+static int run_and_get_outputs(rknn_app_context_t *app_ctx, yolov8_tensor_view *views, uint64_t start_us = 0)
+{
+    uint64_t t0 = start_us != 0 ? start_us : yolov8_stats_now_us();
+    if (app_ctx->backend->run() < 0)
     {
-        printf("rknn_run fail! ret=%d\n", ret);
+        yolov8_stats_record_error(app_ctx->stats);
         return -1;
     }
-    double t3 = get_current_time_ms();
+    uint64_t t1 = yolov8_stats_now_us();
+    yolov8_stats_record_stage(app_ctx->stats, YOLOV8_STAGE_RUN, t1 - t0);
 
-    // Get Output
-    memset(outputs, 0, sizeof(outputs));
-    for (int i = 0; i < app_ctx->io_num.n_output; i++)
+    if (app_ctx->backend->outputs(views, app_ctx->io_num.n_output) < 0)
     {
-        outputs[i].index = i;
-        outputs[i].want_float = (!app_ctx->is_quant);
+        app_ctx->backend->release_outputs();
+        yolov8_stats_record_error(app_ctx->stats);
+        return -1;
     }
-    ret = rknn_outputs_get(app_ctx->rknn_ctx, app_ctx->io_num.n_output, outputs, NULL);
-    if (ret < 0)
+    yolov8_stats_record_stage(app_ctx->stats, YOLOV8_STAGE_OUTPUTS, yolov8_stats_now_us() - t1);
+    return 0;
+}
+
+int inference_yolov8_model(rknn_app_context_t *app_ctx, image_buffer_t *img, object_detect_result_list *od_results)
+{
+    int ret;
+    image_buffer_t dst_img;
+    letterbox_t letter_box;
+    int bg_color = 114;
+
+    if ((!app_ctx) || !(img) || (!od_results))
     {
-        printf("rknn_outputs_get fail! ret=%d\n", ret);
-        goto out;
+        return -1;
     }
+    yolov8_tensor_view views[YOLOV8_MAX_OUTPUTS];
 
-    // Post Process
+    memset(od_results, 0x00, sizeof(*od_results));
+    memset(&letter_box, 0, sizeof(letterbox_t));
+    memset(&dst_img, 0, sizeof(image_buffer_t));
+
+    // Pre Process（letterbox 直接写进后端输入缓冲）
+    uint64_t t0 = yolov8_stats_now_us();
+    if (bind_input_buffer(app_ctx, &dst_img) < 0 ||
+        convert_image_with_letterbox(img, &dst_img, &letter_box, bg_color) < 0)
     {
-        double t4 = get_current_time_ms();
-        post_process(app_ctx, outputs, &letter_box, box_conf_threshold, nms_threshold, od_results);
-        double t5 = get_current_time_ms();
-
-        // Print timing breakdown (only for first iteration to avoid spam)
-        static int first_time = 1;
-        if (first_time) {
-            printf("[TIMING] Preprocess (RGA):  %.2fms\n", t1 - t0);
-            printf("[TIMING] Input setup:       %.2fms\n", t2 - t1);
-            printf("[TIMING] rknn_run (NPU):    %.2fms\n", t3 - t2);
-            printf("[TIMING] Output get:        %.2fms\n", t4 - t3);
-            printf("[TIMING] Postprocess (NMS): %.2fms\n", t5 - t4);
-            printf("[TIMING] Total:             %.2fms\n", t5 - t0);
-            first_time = 0;
-        }
+        yolov8_stats_record_error(app_ctx->stats);
+        return -1;
     }
+    uint64_t t1 = yolov8_stats_now_us();
+    yolov8_stats_record_stage(app_ctx->stats, YOLOV8_STAGE_PREPROCESS, t1 - t0);
 
-    // Remeber to release rknn output
-    rknn_outputs_release(app_ctx->rknn_ctx, app_ctx->io_num.n_output, outputs);
-
-out:
-    if (dst_img.virt_addr != NULL)
+    // 各阶段耗时记入 app_ctx->stats，解码与 NMS 在 post_process_views 内计时
+    if (run_and_get_outputs(app_ctx, views) < 0)
     {
-        free(dst_img.virt_addr);
+        return -1;
     }
+    maybe_dump_outputs(app_ctx, views);
 
+    // Post Process
+    ret = post_process_views(app_ctx, views, &letter_box, od_results);
+
+    // Remeber to release rknn output
+    app_ctx->backend->release_outputs();
     return ret;
 }
 
@@ -293,15 +442,11 @@ int yolov8_preprocess(rknn_app_context_t *app_ctx, image_buffer_t *img, image_bu
     memset(letter_box, 0, sizeof(letterbox_t));
     memset(dst_img, 0, sizeof(image_buffer_t));
 
-    // Allocate destination buffer
-    dst_img->width = app_ctx->model_width;
-    dst_img->height = app_ctx->model_height;
-    dst_img->format = IMAGE_FORMAT_RGB888;
-    dst_img->size = get_image_size(dst_img);
-    dst_img->virt_addr = (unsigned char *)malloc(dst_img->size);
-    if (dst_img->virt_addr == NULL)
+    // Destination is the context's persistent input buffer
+    uint64_t t0 = yolov8_stats_now_us();
+    if (bind_input_buffer(app_ctx, dst_img) < 0)
     {
-        printf("malloc buffer size:%d fail!\n", dst_img->size);
+        yolov8_stats_record_error(app_ctx->stats);
         return -1;
     }
 
@@ -309,61 +454,48 @@ int yolov8_preprocess(rknn_app_context_t *app_ctx, image_buffer_t *img, image_bu
     ret = convert_image_with_letterbox(img, dst_img, letter_box, bg_color);
     if (ret < 0)
     {
-        printf("convert_image_with_letterbox fail! ret=%d\n", ret);
-        free(dst_img->virt_addr);
-        dst_img->virt_addr = NULL;
+        yolov8_stats_record_error(app_ctx->stats);
         return -1;
     }
+    yolov8_stats_record_stage(app_ctx->stats, YOLOV8_STAGE_PREPROCESS, yolov8_stats_now_us() - t0);
 
     return 0;
 }
 
 int yolov8_inference(rknn_app_context_t *app_ctx, image_buffer_t *dst_img, rknn_output *outputs)
 {
-    int ret;
-    rknn_input inputs[app_ctx->io_num.n_input];
-
-    if ((!app_ctx) || (!dst_img) || (!outputs))
+    if ((!app_ctx) || (!dst_img) || (!outputs) || (!app_ctx->backend))
     {
         return -1;
     }
+    yolov8_tensor_view views[YOLOV8_MAX_OUTPUTS];
 
-    memset(inputs, 0, sizeof(inputs));
-
-    // Set Input Data
-    inputs[0].index = 0;
-    inputs[0].type = RKNN_TENSOR_UINT8;
-    inputs[0].fmt = RKNN_TENSOR_NHWC;
-    inputs[0].size = app_ctx->model_width * app_ctx->model_height * app_ctx->model_channel;
-    inputs[0].buf = dst_img->virt_addr;
-
-    ret = rknn_inputs_set(app_ctx->rknn_ctx, app_ctx->io_num.n_input, inputs);
-    if (ret < 0)
+    // 输入不在后端缓冲里（调用方自备图像）时拷进去，计入 run 阶段
+    uint64_t t0 = yolov8_stats_now_us();
+    int input_size = 0;
+    unsigned char *input = app_ctx->backend->input(&input_size);
+    if (dst_img->virt_addr != input)
     {
-        printf("rknn_input_set fail! ret=%d\n", ret);
-        return -1;
+        if (dst_img->virt_addr == NULL || dst_img->size < input_size)
+        {
+            yolov8_stats_record_error(app_ctx->stats);
+            return -1;
+        }
+        memcpy(input, dst_img->virt_addr, input_size);
     }
 
-    // Run inference
-    ret = rknn_run(app_ctx->rknn_ctx, nullptr);
-    if (ret < 0)
+    // 输出句柄：指向后端内存，数据以后端视图为准
+    if (run_and_get_outputs(app_ctx, views, t0) < 0)
     {
-        printf("rknn_run fail! ret=%d\n", ret);
         return -1;
     }
-
-    // Get Output
     memset(outputs, 0, app_ctx->io_num.n_output * sizeof(rknn_output));
     for (int i = 0; i < app_ctx->io_num.n_output; i++)
     {
         outputs[i].index = i;
-        outputs[i].want_float = (!app_ctx->is_quant);
-    }
-    ret = rknn_outputs_get(app_ctx->rknn_ctx, app_ctx->io_num.n_output, outputs, NULL);
-    if (ret < 0)
-    {
-        printf("rknn_outputs_get fail! ret=%d\n", ret);
-        return -1;
+        outputs[i].want_float = views[i].type == YOLOV8_TENSOR_FLOAT32;
+        outputs[i].buf = (void *)views[i].data;
+        outputs[i].size = views[i].size;
     }
 
     return 0;
@@ -371,26 +503,27 @@ int yolov8_inference(rknn_app_context_t *app_ctx, image_buffer_t *dst_img, rknn_
 
 int yolov8_postprocess(rknn_app_context_t *app_ctx, rknn_output *outputs, letterbox_t *letter_box, object_detect_result_list *od_results)
 {
-    const float nms_threshold = NMS_THRESH;
-    const float box_conf_threshold = BOX_THRESH;
-
-    if ((!app_ctx) || (!outputs) || (!letter_box) || (!od_results))
+    if ((!app_ctx) || (!outputs) || (!letter_box) || (!od_results) || (!app_ctx->backend))
     {
         return -1;
     }
+    yolov8_tensor_view views[YOLOV8_MAX_OUTPUTS];
 
     memset(od_results, 0x00, sizeof(*od_results));
+    if (app_ctx->backend->outputs(views, app_ctx->io_num.n_output) < 0)
+    {
+        yolov8_stats_record_error(app_ctx->stats);
+        return -1;
+    }
 
     // Post Process
-    post_process(app_ctx, outputs, letter_box, box_conf_threshold, nms_threshold, od_results);
-
-    return 0;
+    return post_process_views(app_ctx, views, letter_box, od_results);
 }
 
 void yolov8_release_outputs(rknn_app_context_t *app_ctx, rknn_output *outputs)
 {
-    if (app_ctx && outputs)
+    if (app_ctx && outputs && app_ctx->backend)
     {
-        rknn_outputs_release(app_ctx->rknn_ctx, app_ctx->io_num.n_output, outputs);
+        app_ctx->backend->release_outputs();
     }
-}
\ No newline at end of file
+}
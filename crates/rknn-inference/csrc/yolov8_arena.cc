@@ -0,0 +1,124 @@
+// 后处理工作区
+
+#include "yolov8_arena.h"
+
+#include <string.h>
+
+yolov8_postprocess_arena *yolov8_arena_create(int max_candidates, int num_classes, int max_detections)
+{
+    if (max_candidates <= 0 || num_classes <= 0 || num_classes > YOLOV8_MAX_CLASSES || max_detections <= 0)
+    {
+        return nullptr;
+    }
+
+    yolov8_postprocess_arena *arena = new yolov8_postprocess_arena();
+    arena->allocations = 1;
+
+    arena->boxes.resize((size_t)max_candidates * 4);
+    arena->probs.resize(max_candidates);
+    arena->class_ids.resize(max_candidates);
+    arena->keep.resize(max_detections);
+    arena->classes.reserve(num_classes);
+    arena->allocations += 5; // 上面 5 个缓冲各一次（手动记账，须与上面的预留保持同步）
+
+    arena->candidates.boxes = arena->boxes.data();
+    arena->candidates.probs = arena->probs.data();
+    arena->candidates.class_ids = arena->class_ids.data();
+    arena->candidates.count = 0;
+    arena->candidates.capacity = max_candidates;
+    arena->candidates.dropped = 0;
+
+    // 类别号范围含 -1（没有任何类别超过阈值但仍被保留的格子）
+    yolov8_nms_reserve(&arena->nms, max_candidates, num_classes + 1);
+
+    arena->max_candidates = max_candidates;
+    arena->num_classes = num_classes;
+    arena->max_detections = max_detections;
+    yolov8_postprocess_default_config(&arena->config, max_detections);
+    arena->filter_classes = 0;
+    return arena;
+}
+
+void yolov8_arena_destroy(yolov8_postprocess_arena *arena)
+{
+    delete arena;
+}
+
+static inline bool class_allowed(const yolov8_postprocess_config *config, int c)
+{
+    return ((config->class_mask[c / 64] >> (c % 64)) & 1) != 0;
+}
+
+void yolov8_postprocess_default_config(yolov8_postprocess_config *config, int max_detections)
+{
+    memset(config, 0, sizeof(*config));
+    config->conf_threshold = YOLOV8_DEFAULT_CONF_THRESH;
+    config->nms_threshold = YOLOV8_DEFAULT_NMS_THRESH;
+    config->max_detections = max_detections;
+}
+
+int yolov8_arena_configure(yolov8_postprocess_arena *arena, const yolov8_postprocess_config *config)
+{
+    if (!(config->conf_threshold >= 0.f && config->conf_threshold <= 1.f) ||
+        !(config->nms_threshold >= 0.f && config->nms_threshold <= 1.f))
+    {
+        return -1;
+    }
+
+    bool any_bit = false;
+    for (int w = 0; w < YOLOV8_MAX_CLASSES / 64; w++)
+    {
+        any_bit = any_bit || config->class_mask[w] != 0;
+    }
+
+    int allowed = 0;
+    for (int c = 0; c < arena->num_classes; c++)
+    {
+        allowed += !any_bit || class_allowed(config, c) ? 1 : 0;
+    }
+    if (allowed == 0)
+    {
+        return -1;
+    }
+
+    // 容量在创建时已按类别数预留，这里的 clear/push_back 不会分配
+    arena->classes.clear();
+    for (int c = 0; c < arena->num_classes; c++)
+    {
+        if (!any_bit || class_allowed(config, c))
+        {
+            arena->classes.push_back(c);
+        }
+    }
+    arena->filter_classes = allowed < arena->num_classes ? 1 : 0;
+
+    arena->config = *config;
+    if (arena->config.max_detections <= 0 || arena->config.max_detections > arena->max_detections)
+    {
+        arena->config.max_detections = arena->max_detections;
+    }
+    return 0;
+}
+
+const int *yolov8_arena_classes(const yolov8_postprocess_arena *arena, int *count)
+{
+    if (arena->filter_classes)
+    {
+        *count = (int)arena->classes.size();
+        return arena->classes.data();
+    }
+    *count = arena->num_classes;
+    return nullptr;
+}
+
+yolov8_candidates *yolov8_arena_begin(yolov8_postprocess_arena *arena)
+{
+    arena->candidates.count = 0;
+    arena->candidates.dropped = 0;
+    return &arena->candidates;
+}
+
+uint64_t yolov8_arena_allocations(const yolov8_postprocess_arena *arena)
+{
+    return arena->allocations + arena->nms.allocations;
+}
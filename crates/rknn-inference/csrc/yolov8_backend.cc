@@ -0,0 +1,403 @@
+// rknn 推理后端：拷贝（rknn_inputs_set / rknn_outputs_get）与 zero copy（rknn_create_mem / rknn_set_io_mem）
+
+#include "silent_printf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "yolov8.h"
+#include "yolov8_tensor.h"
+
+int yolov8_view_from_attr(const rknn_tensor_attr *logical, const rknn_tensor_attr *native, const void *data,
+                          uint32_t size, bool is_float, yolov8_tensor_view *view)
+{
+    uint32_t c, h, w;
+#if defined(RKNPU1)
+    // RKNPU1 的 dims 为倒序（W, H, C, N）
+    w = logical->dims[0];
+    h = logical->dims[1];
+    c = logical->dims[2];
+#else
+    if (logical->fmt == RKNN_TENSOR_NHWC)
+    {
+        h = logical->dims[1];
+        w = logical->dims[2];
+        c = logical->dims[3];
+    }
+    else
+    {
+        c = logical->dims[1];
+        h = logical->dims[2];
+        w = logical->dims[3];
+    }
+#endif
+
+    memset(view, 0, sizeof(*view));
+    view->data = data;
+    view->size = size;
+    view->dims[0] = 1;
+    view->dims[1] = c;
+    view->dims[2] = h;
+    view->dims[3] = w;
+    view->w_stride = native->w_stride > w ? native->w_stride : w;
+    if (is_float)
+    {
+        view->type = YOLOV8_TENSOR_FLOAT32;
+        view->zp = 0;
+        view->scale = 1.0f;
+    }
+    else
+    {
+#ifdef RKNPU1
+        view->type = YOLOV8_TENSOR_UINT8;
+#else
+        view->type = YOLOV8_TENSOR_INT8;
+#endif
+        view->zp = native->zp;
+        view->scale = native->scale;
+    }
+
+    switch (native->fmt)
+    {
+    case RKNN_TENSOR_NC1HWC2:
+        if (native->n_dims != 5 || native->dims[4] == 0)
+        {
+            return -1;
+        }
+        view->layout = YOLOV8_LAYOUT_NC1HWC2;
+        view->c2 = native->dims[4];
+        break;
+    case RKNN_TENSOR_NHWC:
+        view->layout = YOLOV8_LAYOUT_NC1HWC2;
+        view->c2 = c;
+        break;
+    default:
+        view->layout = YOLOV8_LAYOUT_NCHW;
+        view->w_stride = w;
+        break;
+    }
+
+    yolov8_tensor_record record;
+    yolov8_tensor_view_to_record(view, &record);
+    const uint32_t required = yolov8_tensor_required_size(&record);
+    return required > 0 && required <= size ? 0 : -1;
+}
+
+namespace {
+
+class RknnCopyBackend : public yolov8_tensor_backend {
+public:
+    explicit RknnCopyBackend(rknn_app_context_t *app_ctx)
+        : app_ctx_(app_ctx),
+          input_(app_ctx->model_width * app_ctx->model_height * app_ctx->model_channel),
+          outputs_(app_ctx->io_num.n_output),
+          views_(app_ctx->io_num.n_output)
+    {
+    }
+
+    ~RknnCopyBackend() override { release_outputs(); }
+
+    const char *name() const override { return "rknn-copy"; }
+
+    uint8_t *input(int *size) override
+    {
+        if (size != nullptr)
+        {
+            *size = (int)input_.size();
+        }
+        return input_.data();
+    }
+
+    int run() override
+    {
+        release_outputs();
+
+        rknn_input inputs[1];
+        memset(inputs, 0, sizeof(inputs));
+        inputs[0].index = 0;
+        inputs[0].type = RKNN_TENSOR_UINT8;
+        inputs[0].fmt = RKNN_TENSOR_NHWC;
+        inputs[0].size = input_.size();
+        inputs[0].buf = input_.data();
+        int ret = rknn_inputs_set(app_ctx_->rknn_ctx, 1, inputs);
+        if (ret < 0)
+        {
+            printf("rknn_input_set fail! ret=%d\n", ret);
+            return -1;
+        }
+
+        ret = rknn_run(app_ctx_->rknn_ctx, nullptr);
+        if (ret < 0)
+        {
+            printf("rknn_run fail! ret=%d\n", ret);
+            return -1;
+        }
+        ran_ = true;
+        return 0;
+    }
+
+    // 输出在第一次 outputs() 时才 rknn_outputs_get，使取输出与 rknn_run 可以分开计时
+    int outputs(yolov8_tensor_view *views, int max_views) override
+    {
+        if ((int)views_.size() > max_views || (!held_ && fetch_outputs() < 0))
+        {
+            return -1;
+        }
+        memcpy(views, views_.data(), views_.size() * sizeof(yolov8_tensor_view));
+        return (int)views_.size();
+    }
+
+    void release_outputs() override
+    {
+        if (held_)
+        {
+            rknn_outputs_release(app_ctx_->rknn_ctx, app_ctx_->io_num.n_output, outputs_.data());
+            held_ = false;
+        }
+        ran_ = false;
+    }
+
+private:
+    int fetch_outputs()
+    {
+        if (!ran_)
+        {
+            return -1;
+        }
+
+        // 非量化模型由运行时转换为 float；量化模型取原始量化值，由后处理按阈值量化后直接比较
+        const uint32_t n_output = app_ctx_->io_num.n_output;
+        memset(outputs_.data(), 0, n_output * sizeof(rknn_output));
+        for (uint32_t i = 0; i < n_output; i++)
+        {
+            outputs_[i].index = i;
+            outputs_[i].want_float = (!app_ctx_->is_quant);
+        }
+        int ret = rknn_outputs_get(app_ctx_->rknn_ctx, n_output, outputs_.data(), NULL);
+        if (ret < 0)
+        {
+            printf("rknn_outputs_get fail! ret=%d\n", ret);
+            return -1;
+        }
+        held_ = true;
+
+        for (uint32_t i = 0; i < n_output; i++)
+        {
+            const rknn_tensor_attr *attr = &app_ctx_->output_attrs[i];
+            if (yolov8_view_from_attr(attr, attr, outputs_[i].buf, outputs_[i].size, outputs_[i].want_float, &views_[i]) < 0)
+            {
+                printf("unexpected output %u size %u\n", i, outputs_[i].size);
+                release_outputs();
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    rknn_app_context_t *app_ctx_;
+    std::vector<uint8_t> input_;
+    std::vector<rknn_output> outputs_;
+    std::vector<yolov8_tensor_view> views_;
+    bool ran_ = false;  // 本帧已 rknn_run，输出可取
+    bool held_ = false; // 持有 rknn_outputs_get 的缓冲
+};
+
+#if !defined(RKNPU1)
+// 输入输出张量常驻 NPU 内存：letterbox 直接写进输入 mem，后处理直接读原生布局的输出 mem，
+// 每帧只有 rknn_run。rknn_init 未设置 RKNN_FLAG_DISABLE_FLUSH_*_MEM_CACHE，
+// 运行时在 rknn_run 前后自动刷新输入缓存、失效输出缓存，无需手动 rknn_mem_sync
+class RknnZeroCopyBackend : public yolov8_tensor_backend {
+public:
+    explicit RknnZeroCopyBackend(rknn_app_context_t *app_ctx) : app_ctx_(app_ctx) {}
+
+    ~RknnZeroCopyBackend() override
+    {
+        if (input_mem_ != nullptr)
+        {
+            rknn_destroy_mem(app_ctx_->rknn_ctx, input_mem_);
+        }
+        for (rknn_tensor_mem *mem : output_mems_)
+        {
+            if (mem != nullptr)
+            {
+                rknn_destroy_mem(app_ctx_->rknn_ctx, mem);
+            }
+        }
+    }
+
+    // 查询原生属性并分配全部 mem，任一步失败返回 -1 且尚未绑定到上下文（可退回拷贝后端）；
+    // 绑定时失败 *bound 置为真，此时上下文已部分切换为 zero copy，不能再退回
+    int init(bool *bound)
+    {
+        *bound = false;
+        rknn_context ctx = app_ctx_->rknn_ctx;
+        const uint32_t n_output = app_ctx_->io_num.n_output;
+
+        memset(&input_attr_, 0, sizeof(input_attr_));
+        input_attr_.index = 0;
+        if (rknn_query(ctx, RKNN_QUERY_NATIVE_INPUT_ATTR, &input_attr_, sizeof(input_attr_)) != RKNN_SUCC)
+        {
+            return -1;
+        }
+        input_attr_.type = RKNN_TENSOR_UINT8;
+        input_attr_.fmt = RKNN_TENSOR_NHWC;
+        // letterbox 按紧密行写入，行跨度不等于模型宽度时不能直接作为输入缓冲
+        if (input_attr_.w_stride != 0 && (int)input_attr_.w_stride != app_ctx_->model_width)
+        {
+            printf("zero copy: input w_stride %u != width %d\n", input_attr_.w_stride, app_ctx_->model_width);
+            return -1;
+        }
+        input_size_ = app_ctx_->model_width * app_ctx_->model_height * app_ctx_->model_channel;
+        if (input_attr_.size_with_stride < (uint32_t)input_size_)
+        {
+            return -1;
+        }
+        input_mem_ = rknn_create_mem(ctx, input_attr_.size_with_stride);
+        if (input_mem_ == nullptr)
+        {
+            return -1;
+        }
+
+        output_attrs_.resize(n_output);
+        output_mems_.assign(n_output, nullptr);
+        views_.resize(n_output);
+        for (uint32_t i = 0; i < n_output; i++)
+        {
+            rknn_tensor_attr &attr = output_attrs_[i];
+            memset(&attr, 0, sizeof(attr));
+            attr.index = i;
+            if (rknn_query(ctx, RKNN_QUERY_NATIVE_OUTPUT_ATTR, &attr, sizeof(attr)) != RKNN_SUCC)
+            {
+                return -1;
+            }
+            // 原生 float 输出为 fp16，后处理只解码 int8 原生布局
+            if (attr.type != RKNN_TENSOR_INT8)
+            {
+                printf("zero copy: output %u type %s unsupported\n", i, get_type_string(attr.type));
+                return -1;
+            }
+            output_mems_[i] = rknn_create_mem(ctx, attr.size_with_stride);
+            if (output_mems_[i] == nullptr ||
+                yolov8_view_from_attr(&app_ctx_->output_attrs[i], &attr, output_mems_[i]->virt_addr,
+                                      attr.size_with_stride, false, &views_[i]) < 0)
+            {
+                return -1;
+            }
+        }
+
+        *bound = true;
+        if (rknn_set_io_mem(ctx, input_mem_, &input_attr_) < 0)
+        {
+            return -1;
+        }
+        for (uint32_t i = 0; i < n_output; i++)
+        {
+            if (rknn_set_io_mem(ctx, output_mems_[i], &output_attrs_[i]) < 0)
+            {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    const char *name() const override { return "rknn-zero-copy"; }
+
+    uint8_t *input(int *size) override
+    {
+        if (size != nullptr)
+        {
+            *size = input_size_;
+        }
+        return (uint8_t *)input_mem_->virt_addr;
+    }
+
+    int run() override
+    {
+        int ret = rknn_run(app_ctx_->rknn_ctx, nullptr);
+        if (ret < 0)
+        {
+            printf("rknn_run fail! ret=%d\n", ret);
+            return -1;
+        }
+        ran_ = true;
+        return 0;
+    }
+
+    int outputs(yolov8_tensor_view *views, int max_views) override
+    {
+        if (!ran_ || (int)views_.size() > max_views)
+        {
+            return -1;
+        }
+        memcpy(views, views_.data(), views_.size() * sizeof(yolov8_tensor_view));
+        return (int)views_.size();
+    }
+
+private:
+    rknn_app_context_t *app_ctx_;
+    rknn_tensor_attr input_attr_;
+    int input_size_ = 0;
+    rknn_tensor_mem *input_mem_ = nullptr;
+    std::vector<rknn_tensor_attr> output_attrs_;
+    std::vector<rknn_tensor_mem *> output_mems_;
+    std::vector<yolov8_tensor_view> views_;
+    bool ran_ = false;
+};
+#endif
+
+} // namespace
+
+yolov8_io_mode yolov8_io_mode_from_env()
+{
+    const char *mode = getenv("SMARTSCOPE_RKNN_IO");
+    if (mode == NULL || mode[0] == '\0')
+    {
+        return YOLOV8_IO_AUTO;
+    }
+    if (strcmp(mode, "copy") == 0)
+    {
+        return YOLOV8_IO_COPY;
+    }
+    if (strcmp(mode, "zero_copy") == 0)
+    {
+        return YOLOV8_IO_ZERO_COPY;
+    }
+    printf("unknown SMARTSCOPE_RKNN_IO=%s, using auto\n", mode);
+    return YOLOV8_IO_AUTO;
+}
+
+yolov8_tensor_backend *yolov8_create_rknn_backend(rknn_app_context_t *app_ctx, yolov8_io_mode mode)
+{
+#if !defined(RKNPU1)
+    // 非量化模型的原生输出是 fp16，auto 时只对量化模型启用 zero copy
+    if (mode == YOLOV8_IO_ZERO_COPY || (mode == YOLOV8_IO_AUTO && app_ctx->is_quant))
+    {
+        RknnZeroCopyBackend *backend = new RknnZeroCopyBackend(app_ctx);
+        bool bound = false;
+        if (backend->init(&bound) == 0)
+        {
+            printf("rknn backend: %s\n", backend->name());
+            return backend;
+        }
+        delete backend;
+        if (bound || mode == YOLOV8_IO_ZERO_COPY)
+        {
+            printf("zero copy backend init fail!\n");
+            return nullptr;
+        }
+        printf("zero copy unavailable, falling back to copy backend\n");
+    }
+#else
+    if (mode == YOLOV8_IO_ZERO_COPY)
+    {
+        printf("zero copy backend is not supported on RKNPU1\n");
+        return nullptr;
+    }
+#endif
+    yolov8_tensor_backend *backend = new RknnCopyBackend(app_ctx);
+    printf("rknn backend: %s\n", backend->name());
+    return backend;
+}
@@ -0,0 +1,702 @@
+// YOLOv8 检测头解码：SIMD 类别最大值 + 幸存格子框解码
+//
+// 原实现对每个格子沿类别维度按 grid_len 跨步访问 80 次（约 8400 x 80 次标量比较/帧）。
+// 这里按块处理：每次取一个类别行上连续的 16 个格子做向量比较与选择，
+// 块内所有类别扫描完后才逐个检查幸存格子，DFL/框解码只对它们执行。
+// 有 score_sum 输出时先向量比较得到通过位图，只扫描含通过格子的向量组；此时通过的格子很稀疏，
+// 耗时主要是这些格子按类别行跨步加载，相对原实现的提升有限（x86 SSE2 合成数据约 1.2~1.4x）。
+// 原生布局（NC1HWC2）下同一格子的类别分数本来就连续，改为逐格子扫描，每 16 个类别先做一次向量比较。
+
+#include "yolov8_decode.h"
+
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define YOLOV8_DECODE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define YOLOV8_DECODE_SSE2 1
+#endif
+
+// 8 位向量通道里用 0xFF 表示“无类别”，因此扫描的最大类别号需小于 255（否则退回标量）
+#define YOLOV8_MAX_SIMD_CLASSES_8BIT 255
+
+// 一次向量比较覆盖的格子数（score_sum 过滤的粒度）
+#if defined(YOLOV8_DECODE_NEON) || defined(YOLOV8_DECODE_SSE2)
+#define YOLOV8_LANES_8BIT 16
+#define YOLOV8_LANES_FP32 4
+#else
+#define YOLOV8_LANES_8BIT 1
+#define YOLOV8_LANES_FP32 1
+#endif
+
+void yolov8_compute_dfl(const float *tensor, int dfl_len, float *box)
+{
+    for (int b = 0; b < 4; b++)
+    {
+        float exp_t[YOLOV8_MAX_DFL_LEN];
+        float exp_sum = 0;
+        float acc_sum = 0;
+        for (int i = 0; i < dfl_len; i++)
+        {
+            exp_t[i] = exp(tensor[i + b * dfl_len]);
+            exp_sum += exp_t[i];
+        }
+
+        for (int i = 0; i < dfl_len; i++)
+        {
+            acc_sum += exp_t[i] / exp_sum * i;
+        }
+        box[b] = acc_sum;
+    }
+}
+
+// classes 为空时扫描 0..num_classes-1，否则只扫描列表中的类别（升序，同分取较小类别号）
+static inline int class_row(const int *classes, int ci) { return classes != nullptr ? classes[ci] : ci; }
+
+template <typename T>
+static void class_max_scalar(const T *scores, int grid_len, int cell, int count, const int *classes, int num_classes,
+                             T thresh, T init, T *max_score, int *max_class)
+{
+    for (int k = 0; k < count; k++)
+    {
+        const T *p = scores + cell + k;
+        T best = init;
+        int best_class = -1;
+        for (int ci = 0; ci < num_classes; ci++)
+        {
+            const int c = class_row(classes, ci);
+            const T s = p[(size_t)c * grid_len];
+            if (s > thresh && s > best)
+            {
+                best = s;
+                best_class = c;
+            }
+        }
+        max_score[k] = best;
+        max_class[k] = best_class;
+    }
+}
+
+static inline void widen_class_ids(const uint8_t *ids, int *max_class)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        max_class[i] = ids[i] == 0xFF ? -1 : ids[i];
+    }
+}
+
+void yolov8_class_max_i8(const int8_t *scores, int grid_len, int cell, int count, const int *classes, int num_classes,
+                         int8_t thresh, int8_t init, int8_t *max_score, int *max_class)
+{
+    int k = 0;
+#if defined(YOLOV8_DECODE_NEON) || defined(YOLOV8_DECODE_SSE2)
+    if (num_classes > 0 && class_row(classes, num_classes - 1) < YOLOV8_MAX_SIMD_CLASSES_8BIT)
+    {
+        uint8_t ids[16];
+        for (; k + 16 <= count; k += 16)
+        {
+            const int8_t *base = scores + cell + k;
+#if defined(YOLOV8_DECODE_NEON)
+            const int8x16_t vthr = vdupq_n_s8(thresh);
+            int8x16_t vmax = vdupq_n_s8(init);
+            uint8x16_t vcls = vdupq_n_u8(0xFF);
+            for (int ci = 0; ci < num_classes; ci++)
+            {
+                const int c = class_row(classes, ci);
+                const int8x16_t s = vld1q_s8(base + (size_t)c * grid_len);
+                const uint8x16_t take = vandq_u8(vcgtq_s8(s, vthr), vcgtq_s8(s, vmax));
+                vmax = vbslq_s8(take, s, vmax);
+                vcls = vbslq_u8(take, vdupq_n_u8((uint8_t)c), vcls);
+            }
+            vst1q_s8(max_score + k, vmax);
+            vst1q_u8(ids, vcls);
+#else
+            const __m128i vthr = _mm_set1_epi8((char)thresh);
+            __m128i vmax = _mm_set1_epi8((char)init);
+            __m128i vcls = _mm_set1_epi8((char)0xFF);
+            for (int ci = 0; ci < num_classes; ci++)
+            {
+                const int c = class_row(classes, ci);
+                const __m128i s = _mm_loadu_si128((const __m128i *)(base + (size_t)c * grid_len));
+                const __m128i take = _mm_and_si128(_mm_cmpgt_epi8(s, vthr), _mm_cmpgt_epi8(s, vmax));
+                vmax = _mm_or_si128(_mm_and_si128(take, s), _mm_andnot_si128(take, vmax));
+                vcls = _mm_or_si128(_mm_and_si128(take, _mm_set1_epi8((char)c)), _mm_andnot_si128(take, vcls));
+            }
+            _mm_storeu_si128((__m128i *)(max_score + k), vmax);
+            _mm_storeu_si128((__m128i *)ids, vcls);
+#endif
+            widen_class_ids(ids, max_class + k);
+        }
+    }
+#endif
+    class_max_scalar(scores, grid_len, cell + k, count - k, classes, num_classes, thresh, init, max_score + k, max_class + k);
+}
+
+void yolov8_class_max_u8(const uint8_t *scores, int grid_len, int cell, int count, const int *classes, int num_classes,
+                         uint8_t thresh, uint8_t init, uint8_t *max_score, int *max_class)
+{
+    int k = 0;
+#if defined(YOLOV8_DECODE_NEON) || defined(YOLOV8_DECODE_SSE2)
+    if (num_classes > 0 && class_row(classes, num_classes - 1) < YOLOV8_MAX_SIMD_CLASSES_8BIT)
+    {
+        uint8_t ids[16];
+        for (; k + 16 <= count; k += 16)
+        {
+            const uint8_t *base = scores + cell + k;
+#if defined(YOLOV8_DECODE_NEON)
+            const uint8x16_t vthr = vdupq_n_u8(thresh);
+            uint8x16_t vmax = vdupq_n_u8(init);
+            uint8x16_t vcls = vdupq_n_u8(0xFF);
+            for (int ci = 0; ci < num_classes; ci++)
+            {
+                const int c = class_row(classes, ci);
+                const uint8x16_t s = vld1q_u8(base + (size_t)c * grid_len);
+                const uint8x16_t take = vandq_u8(vcgtq_u8(s, vthr), vcgtq_u8(s, vmax));
+                vmax = vbslq_u8(take, s, vmax);
+                vcls = vbslq_u8(take, vdupq_n_u8((uint8_t)c), vcls);
+            }
+            vst1q_u8(max_score + k, vmax);
+            vst1q_u8(ids, vcls);
+#else
+            // SSE2 只有有符号字节比较：翻转符号位后比较等价于无符号比较
+            const __m128i bias = _mm_set1_epi8((char)0x80);
+            const __m128i vthr = _mm_xor_si128(_mm_set1_epi8((char)thresh), bias);
+            __m128i vmax = _mm_xor_si128(_mm_set1_epi8((char)init), bias);
+            __m128i vcls = _mm_set1_epi8((char)0xFF);
+            for (int ci = 0; ci < num_classes; ci++)
+            {
+                const int c = class_row(classes, ci);
+                const __m128i s = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(base + (size_t)c * grid_len)), bias);
+                const __m128i take = _mm_and_si128(_mm_cmpgt_epi8(s, vthr), _mm_cmpgt_epi8(s, vmax));
+                vmax = _mm_or_si128(_mm_and_si128(take, s), _mm_andnot_si128(take, vmax));
+                vcls = _mm_or_si128(_mm_and_si128(take, _mm_set1_epi8((char)c)), _mm_andnot_si128(take, vcls));
+            }
+            _mm_storeu_si128((__m128i *)(max_score + k), _mm_xor_si128(vmax, bias));
+            _mm_storeu_si128((__m128i *)ids, vcls);
+#endif
+            widen_class_ids(ids, max_class + k);
+        }
+    }
+#endif
+    class_max_scalar(scores, grid_len, cell + k, count - k, classes, num_classes, thresh, init, max_score + k, max_class + k);
+}
+
+void yolov8_class_max_fp32(const float *scores, int grid_len, int cell, int count, const int *classes, int num_classes,
+                           float thresh, float init, float *max_score, int *max_class)
+{
+    int k = 0;
+#if defined(YOLOV8_DECODE_NEON)
+    for (; k + 4 <= count; k += 4)
+    {
+        const float *base = scores + cell + k;
+        const float32x4_t vthr = vdupq_n_f32(thresh);
+        float32x4_t vmax = vdupq_n_f32(init);
+        int32x4_t vcls = vdupq_n_s32(-1);
+        for (int ci = 0; ci < num_classes; ci++)
+        {
+            const int c = class_row(classes, ci);
+            const float32x4_t s = vld1q_f32(base + (size_t)c * grid_len);
+            const uint32x4_t take = vandq_u32(vcgtq_f32(s, vthr), vcgtq_f32(s, vmax));
+            vmax = vbslq_f32(take, s, vmax);
+            vcls = vbslq_s32(take, vdupq_n_s32(c), vcls);
+        }
+        vst1q_f32(max_score + k, vmax);
+        vst1q_s32(max_class + k, vcls);
+    }
+#elif defined(YOLOV8_DECODE_SSE2)
+    for (; k + 4 <= count; k += 4)
+    {
+        const float *base = scores + cell + k;
+        const __m128 vthr = _mm_set1_ps(thresh);
+        __m128 vmax = _mm_set1_ps(init);
+        __m128i vcls = _mm_set1_epi32(-1);
+        for (int ci = 0; ci < num_classes; ci++)
+        {
+            const int c = class_row(classes, ci);
+            const __m128 s = _mm_loadu_ps(base + (size_t)c * grid_len);
+            const __m128 take = _mm_and_ps(_mm_cmpgt_ps(s, vthr), _mm_cmpgt_ps(s, vmax));
+            vmax = _mm_or_ps(_mm_and_ps(take, s), _mm_andnot_ps(take, vmax));
+            const __m128i take_i = _mm_castps_si128(take);
+            vcls = _mm_or_si128(_mm_and_si128(take_i, _mm_set1_epi32(c)), _mm_andnot_si128(take_i, vcls));
+        }
+        _mm_storeu_ps(max_score + k, vmax);
+        _mm_storeu_si128((__m128i *)(max_class + k), vcls);
+    }
+#endif
+    class_max_scalar(scores, grid_len, cell + k, count - k, classes, num_classes, thresh, init, max_score + k, max_class + k);
+}
+
+template <typename T>
+static inline float dequantize(T q, int32_t zp, float scale) { return ((float)q - (float)zp) * scale; }
+
+// DFL 之后按格子 (i, j) 还原框并追加候选；各布局共用，保证输出逐位一致
+static inline bool emit_candidate(const float *before_dfl, int dfl_len, int i, int j, int stride, float prob,
+                                  int class_id, yolov8_candidates *out)
+{
+    float box[4];
+    yolov8_compute_dfl(before_dfl, dfl_len, box);
+
+    float x1, y1, x2, y2, w, h;
+    x1 = (-box[0] + j + 0.5) * stride;
+    y1 = (-box[1] + i + 0.5) * stride;
+    x2 = (box[2] + j + 0.5) * stride;
+    y2 = (box[3] + i + 0.5) * stride;
+    w = x2 - x1;
+    h = y2 - y1;
+    return yolov8_candidates_push(out, x1, y1, w, h, prob, class_id);
+}
+
+template <>
+inline float dequantize<float>(float q, int32_t, float) { return q; }
+
+static_assert(YOLOV8_DECODE_BLOCK <= 64, "块内存活格子用 64 位位图表示");
+
+// score sum 预过滤位图：bit k 表示格子 sum[k] 不低于阈值（与原实现的 !(sum < thres) 一致）
+template <typename T>
+static uint64_t score_sum_mask_scalar(const T *sum, int begin, int count, T thres)
+{
+    uint64_t mask = 0;
+    for (int k = begin; k < count; k++)
+    {
+        if (!(sum[k] < thres))
+        {
+            mask |= 1ull << k;
+        }
+    }
+    return mask;
+}
+
+#if defined(YOLOV8_DECODE_NEON)
+// NEON 没有 movemask：按位权相与后两两相加，得到 16 个通道的位图
+static inline uint64_t neon_movemask_u8(uint8x16_t cmp)
+{
+    static const uint8_t kWeights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t m = vandq_u8(cmp, vld1q_u8(kWeights));
+    uint8x8_t p = vpadd_u8(vget_low_u8(m), vget_high_u8(m));
+    p = vpadd_u8(p, p);
+    p = vpadd_u8(p, p);
+    return vget_lane_u16(vreinterpret_u16_u8(p), 0);
+}
+#endif
+
+static uint64_t score_sum_mask(const int8_t *sum, int count, int8_t thres)
+{
+    uint64_t mask = 0;
+    int k = 0;
+#if defined(YOLOV8_DECODE_NEON)
+    const int8x16_t vthr = vdupq_n_s8(thres);
+    for (; k + 16 <= count; k += 16)
+    {
+        mask |= neon_movemask_u8(vcgeq_s8(vld1q_s8(sum + k), vthr)) << k;
+    }
+#elif defined(YOLOV8_DECODE_SSE2)
+    const __m128i vthr = _mm_set1_epi8((char)thres);
+    for (; k + 16 <= count; k += 16)
+    {
+        const __m128i below = _mm_cmpgt_epi8(vthr, _mm_loadu_si128((const __m128i *)(sum + k)));
+        mask |= (uint64_t)(~_mm_movemask_epi8(below) & 0xFFFF) << k;
+    }
+#endif
+    return mask | score_sum_mask_scalar(sum, k, count, thres);
+}
+
+static uint64_t score_sum_mask(const uint8_t *sum, int count, uint8_t thres)
+{
+    uint64_t mask = 0;
+    int k = 0;
+#if defined(YOLOV8_DECODE_NEON)
+    const uint8x16_t vthr = vdupq_n_u8(thres);
+    for (; k + 16 <= count; k += 16)
+    {
+        mask |= neon_movemask_u8(vcgeq_u8(vld1q_u8(sum + k), vthr)) << k;
+    }
+#elif defined(YOLOV8_DECODE_SSE2)
+    // SSE2 没有无符号比较：max(s, thr) == s 即 s >= thr
+    const __m128i vthr = _mm_set1_epi8((char)thres);
+    for (; k + 16 <= count; k += 16)
+    {
+        const __m128i s = _mm_loadu_si128((const __m128i *)(sum + k));
+        mask |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(s, vthr), s)) << k;
+    }
+#endif
+    return mask | score_sum_mask_scalar(sum, k, count, thres);
+}
+
+static uint64_t score_sum_mask(const float *sum, int count, float thres)
+{
+    return score_sum_mask_scalar(sum, 0, count, thres);
+}
+
+// 位图中 [begin, begin + n) 的位
+static inline uint64_t mask_range(int begin, int n)
+{
+    return (n >= 64 ? ~0ull : (1ull << n) - 1) << begin;
+}
+
+template <typename T>
+struct ClassMaxKernel;
+
+template <>
+struct ClassMaxKernel<int8_t> {
+    static const int lanes = YOLOV8_LANES_8BIT;
+    static void run(const int8_t *s, int gl, int cell, int n, const int *cls, int nc, int8_t t, int8_t init, int8_t *m, int *c)
+    {
+        yolov8_class_max_i8(s, gl, cell, n, cls, nc, t, init, m, c);
+    }
+};
+
+template <>
+struct ClassMaxKernel<uint8_t> {
+    static const int lanes = YOLOV8_LANES_8BIT;
+    static void run(const uint8_t *s, int gl, int cell, int n, const int *cls, int nc, uint8_t t, uint8_t init, uint8_t *m, int *c)
+    {
+        yolov8_class_max_u8(s, gl, cell, n, cls, nc, t, init, m, c);
+    }
+};
+
+template <>
+struct ClassMaxKernel<float> {
+    static const int lanes = YOLOV8_LANES_FP32;
+    static void run(const float *s, int gl, int cell, int n, const int *cls, int nc, float t, float init, float *m, int *c)
+    {
+        yolov8_class_max_fp32(s, gl, cell, n, cls, nc, t, init, m, c);
+    }
+};
+
+template <typename T>
+static int decode_branch(const T *box_tensor, int32_t box_zp, float box_scale,
+                         const T *score_tensor, int32_t score_zp, float score_scale,
+                         const T *score_sum_tensor, T score_sum_thres,
+                         T score_thres, T score_init,
+                         int grid_h, int grid_w, int stride, int dfl_len, const int *classes, int num_classes,
+                         yolov8_candidates *out)
+{
+    if (dfl_len <= 0 || dfl_len > YOLOV8_MAX_DFL_LEN)
+    {
+        return -1;
+    }
+    const int grid_len = grid_h * grid_w;
+    int validCount = 0;
+    T max_score[YOLOV8_DECODE_BLOCK];
+    int max_class[YOLOV8_DECODE_BLOCK];
+
+    for (int base = 0; base < grid_len; base += YOLOV8_DECODE_BLOCK)
+    {
+        const int count = grid_len - base < YOLOV8_DECODE_BLOCK ? grid_len - base : YOLOV8_DECODE_BLOCK;
+        uint64_t live = mask_range(0, count);
+
+        if (score_sum_tensor == nullptr)
+        {
+            ClassMaxKernel<T>::run(score_tensor, grid_len, base, count, classes, num_classes, score_thres, score_init,
+                                   max_score, max_class);
+        }
+        else
+        {
+            // score sum 快速过滤：向量比较得到通过位图，只对含通过格子的向量组做类别扫描，
+            // 相邻的这类向量组合并为一次内核调用
+            live = score_sum_mask(score_sum_tensor + base, count, score_sum_thres);
+            const int lanes = ClassMaxKernel<T>::lanes;
+            int g = 0;
+            while (live != 0 && g < count)
+            {
+                const int n = count - g < lanes ? count - g : lanes;
+                if ((live & mask_range(g, n)) == 0)
+                {
+                    g += n;
+                    continue;
+                }
+                int end = g + n;
+                while (end < count)
+                {
+                    const int m = count - end < lanes ? count - end : lanes;
+                    if ((live & mask_range(end, m)) == 0)
+                    {
+                        break;
+                    }
+                    end += m;
+                }
+                ClassMaxKernel<T>::run(score_tensor, grid_len, base + g, end - g, classes, num_classes, score_thres,
+                                       score_init, max_score + g, max_class + g);
+                g = end;
+            }
+        }
+
+        // 只检查位图中的格子（未扫描的向量组不在位图中）
+        for (; live != 0; live &= live - 1)
+        {
+            const int k = __builtin_ctzll(live);
+            const int cell = base + k;
+            if (!(max_score[k] > score_thres))
+            {
+                continue;
+            }
+            const int i = cell / grid_w;
+            const int j = cell % grid_w;
+
+            float before_dfl[YOLOV8_MAX_DFL_LEN * 4];
+            const T *p = box_tensor + cell;
+            for (int n = 0; n < dfl_len * 4; n++)
+            {
+                before_dfl[n] = dequantize<T>(p[(size_t)n * grid_len], box_zp, box_scale);
+            }
+            if (emit_candidate(before_dfl, dfl_len, i, j, stride, dequantize<T>(max_score[k], score_zp, score_scale),
+                               max_class[k], out))
+            {
+                validCount++;
+            }
+        }
+    }
+    return validCount;
+}
+
+int yolov8_decode_branch_i8(const int8_t *box_tensor, int32_t box_zp, float box_scale,
+                            const int8_t *score_tensor, int32_t score_zp, float score_scale,
+                            const int8_t *score_sum_tensor, int32_t score_sum_zp, float score_sum_scale,
+                            int grid_h, int grid_w, int stride, int dfl_len, const int *classes, int num_classes,
+                            yolov8_candidates *out, float threshold)
+{
+    const int8_t score_thres = yolov8_qnt_f32_to_i8(threshold, score_zp, score_scale);
+    const int8_t score_sum_thres = yolov8_qnt_f32_to_i8(threshold, score_sum_zp, score_sum_scale);
+    return decode_branch<int8_t>(box_tensor, box_zp, box_scale, score_tensor, score_zp, score_scale,
+                                 score_sum_tensor, score_sum_thres, score_thres, (int8_t)(-score_zp),
+                                 grid_h, grid_w, stride, dfl_len, classes, num_classes, out);
+}
+
+int yolov8_decode_branch_u8(const uint8_t *box_tensor, int32_t box_zp, float box_scale,
+                            const uint8_t *score_tensor, int32_t score_zp, float score_scale,
+                            const uint8_t *score_sum_tensor, int32_t score_sum_zp, float score_sum_scale,
+                            int grid_h, int grid_w, int stride, int dfl_len, const int *classes, int num_classes,
+                            yolov8_candidates *out, float threshold)
+{
+    const uint8_t score_thres = yolov8_qnt_f32_to_u8(threshold, score_zp, score_scale);
+    const uint8_t score_sum_thres = yolov8_qnt_f32_to_u8(threshold, score_sum_zp, score_sum_scale);
+    return decode_branch<uint8_t>(box_tensor, box_zp, box_scale, score_tensor, score_zp, score_scale,
+                                  score_sum_tensor, score_sum_thres, score_thres, (uint8_t)(-score_zp),
+                                  grid_h, grid_w, stride, dfl_len, classes, num_classes, out);
+}
+
+int yolov8_decode_branch_fp32(const float *box_tensor, const float *score_tensor, const float *score_sum_tensor,
+                              int grid_h, int grid_w, int stride, int dfl_len, const int *classes, int num_classes,
+                              yolov8_candidates *out, float threshold)
+{
+    return decode_branch<float>(box_tensor, 0, 1.0f, score_tensor, 0, 1.0f,
+                                score_sum_tensor, threshold, threshold, 0.0f,
+                                grid_h, grid_w, stride, dfl_len, classes, num_classes, out);
+}
+
+// ---- 原生布局（NC1HWC2 / NHWC）----
+
+// 连续 16 个 int8 中是否有大于阈值的；全都不超过阈值时这一段不可能更新最大值，整段跳过
+static inline bool any_above_i8(const int8_t *p, int8_t thresh)
+{
+#if defined(YOLOV8_DECODE_NEON)
+    const uint8x16_t gt = vcgtq_s8(vld1q_s8(p), vdupq_n_s8(thresh));
+    const uint8x8_t folded = vorr_u8(vget_low_u8(gt), vget_high_u8(gt));
+    return vget_lane_u64(vreinterpret_u64_u8(folded), 0) != 0;
+#elif defined(YOLOV8_DECODE_SSE2)
+    return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_loadu_si128((const __m128i *)p), _mm_set1_epi8((char)thresh))) != 0;
+#else
+    for (int k = 0; k < 16; k++)
+    {
+        if (p[k] > thresh)
+        {
+            return true;
+        }
+    }
+    return false;
+#endif
+}
+
+// 格子 (i, j) 在 NC1HWC2 张量第 0 组中的元素偏移；第 g 组再加 g * native_group(view)
+static inline size_t native_cell(const yolov8_tensor_view *view, int i, int j)
+{
+    return ((size_t)i * view->w_stride + j) * view->c2;
+}
+
+static inline size_t native_group(const yolov8_tensor_view *view)
+{
+    return (size_t)view->dims[2] * view->w_stride * view->c2;
+}
+
+int yolov8_decode_branch_native_i8(const yolov8_tensor_view *box, const yolov8_tensor_view *score,
+                                   const yolov8_tensor_view *score_sum, int stride, int dfl_len,
+                                   const int *classes, int num_classes, yolov8_candidates *out, float threshold)
+{
+    if (dfl_len <= 0 || dfl_len > YOLOV8_MAX_DFL_LEN || box->c2 == 0 || score->c2 == 0 ||
+        (score_sum != nullptr && score_sum->c2 == 0))
+    {
+        return -1;
+    }
+    const int grid_h = score->dims[2];
+    const int grid_w = score->dims[3];
+    const int8_t *box_data = (const int8_t *)box->data;
+    const int8_t *score_data = (const int8_t *)score->data;
+    const int8_t *sum_data = score_sum != nullptr ? (const int8_t *)score_sum->data : nullptr;
+    const int8_t score_thres = yolov8_qnt_f32_to_i8(threshold, score->zp, score->scale);
+    const int8_t sum_thres = score_sum != nullptr ? yolov8_qnt_f32_to_i8(threshold, score_sum->zp, score_sum->scale) : 0;
+    const int8_t score_init = (int8_t)(-score->zp);
+    const int score_c2 = score->c2;
+    const int box_c2 = box->c2;
+    const size_t score_group = native_group(score);
+    const size_t box_group = native_group(box);
+    int validCount = 0;
+
+    for (int i = 0; i < grid_h; i++)
+    {
+        for (int j = 0; j < grid_w; j++)
+        {
+            if (sum_data != nullptr && sum_data[native_cell(score_sum, i, j)] < sum_thres)
+            {
+                continue;
+            }
+
+            // 同一格子的类别分数在每组内连续：按组顺序扫描，同分保留较小类别号
+            const int8_t *cell = score_data + native_cell(score, i, j);
+            int8_t max_score = score_init;
+            int max_class = -1;
+            if (classes == nullptr)
+            {
+                for (int c0 = 0; c0 < num_classes; c0 += score_c2)
+                {
+                    const int8_t *p = cell + (size_t)(c0 / score_c2) * score_group;
+                    const int n = num_classes - c0 < score_c2 ? num_classes - c0 : score_c2;
+                    int k = 0;
+                    while (k < n)
+                    {
+                        const int end = k + 16 <= n ? k + 16 : n;
+                        if (end - k == 16 && !any_above_i8(p + k, score_thres))
+                        {
+                            k = end;
+                            continue;
+                        }
+                        for (; k < end; k++)
+                        {
+                            if (p[k] > score_thres && p[k] > max_score)
+                            {
+                                max_score = p[k];
+                                max_class = c0 + k;
+                            }
+                        }
+                    }
+                }
+            }
+            else
+            {
+                for (int ci = 0; ci < num_classes; ci++)
+                {
+                    const int c = classes[ci];
+                    const int8_t s = cell[(size_t)(c / score_c2) * score_group + c % score_c2];
+                    if (s > score_thres && s > max_score)
+                    {
+                        max_score = s;
+                        max_class = c;
+                    }
+                }
+            }
+            if (!(max_score > score_thres))
+            {
+                continue;
+            }
+
+            float before_dfl[YOLOV8_MAX_DFL_LEN * 4];
+            const int8_t *p = box_data + native_cell(box, i, j);
+            for (int n = 0; n < dfl_len * 4; n++)
+            {
+                before_dfl[n] = dequantize<int8_t>(p[(size_t)(n / box_c2) * box_group + n % box_c2], box->zp, box->scale);
+            }
+            if (emit_candidate(before_dfl, dfl_len, i, j, stride, dequantize<int8_t>(max_score, score->zp, score->scale),
+                               max_class, out))
+            {
+                validCount++;
+            }
+        }
+    }
+    return validCount;
+}
+
+// 同一分支的张量须同布局、同类型，且网格一致
+static bool branch_consistent(const yolov8_tensor_view *box, const yolov8_tensor_view *score,
+                              const yolov8_tensor_view *score_sum)
+{
+    const yolov8_tensor_view *views[3] = {box, score, score_sum};
+    for (int k = 0; k < 3; k++)
+    {
+        const yolov8_tensor_view *v = views[k];
+        if (v == nullptr)
+        {
+            continue;
+        }
+        if (v->layout != box->layout || v->type != box->type || v->dims[2] != box->dims[2] ||
+            v->dims[3] != box->dims[3] || v->w_stride < v->dims[3])
+        {
+            return false;
+        }
+        if (v->layout == YOLOV8_LAYOUT_NCHW && v->w_stride != v->dims[3])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int yolov8_decode_outputs(const yolov8_tensor_view *views, int n_outputs, int model_height,
+                          const int *classes, int num_classes, yolov8_candidates *out, float threshold)
+{
+    const int per_branch = n_outputs / 3;
+    if (views == nullptr || per_branch < 2 || per_branch > 3 || n_outputs % 3 != 0)
+    {
+        return -1;
+    }
+    int total = 0;
+    for (int b = 0; b < 3; b++)
+    {
+        const yolov8_tensor_view *box = &views[b * per_branch];
+        const yolov8_tensor_view *score = box + 1;
+        const yolov8_tensor_view *sum = per_branch == 3 ? box + 2 : nullptr;
+        const int grid_h = box->dims[2];
+        const int grid_w = box->dims[3];
+        const int dfl_len = box->dims[1] / 4;
+        if (grid_h <= 0 || grid_w <= 0 || !branch_consistent(box, score, sum))
+        {
+            return -1;
+        }
+        const int stride = model_height / grid_h;
+
+        int n = -1;
+        if (box->layout == YOLOV8_LAYOUT_NC1HWC2)
+        {
+            if (box->type == YOLOV8_TENSOR_INT8)
+            {
+                n = yolov8_decode_branch_native_i8(box, score, sum, stride, dfl_len, classes, num_classes, out, threshold);
+            }
+        }
+        else if (box->type == YOLOV8_TENSOR_INT8)
+        {
+            n = yolov8_decode_branch_i8((const int8_t *)box->data, box->zp, box->scale,
+                                        (const int8_t *)score->data, score->zp, score->scale,
+                                        sum ? (const int8_t *)sum->data : nullptr, sum ? sum->zp : 0, sum ? sum->scale : 1.0f,
+                                        grid_h, grid_w, stride, dfl_len, classes, num_classes, out, threshold);
+        }
+        else if (box->type == YOLOV8_TENSOR_UINT8)
+        {
+            n = yolov8_decode_branch_u8((const uint8_t *)box->data, box->zp, box->scale,
+                                        (const uint8_t *)score->data, score->zp, score->scale,
+                                        sum ? (const uint8_t *)sum->data : nullptr, sum ? sum->zp : 0, sum ? sum->scale : 1.0f,
+                                        grid_h, grid_w, stride, dfl_len, classes, num_classes, out, threshold);
+        }
+        else if (box->type == YOLOV8_TENSOR_FLOAT32)
+        {
+            n = yolov8_decode_branch_fp32((const float *)box->data, (const float *)score->data,
+                                          sum ? (const float *)sum->data : nullptr,
+                                          grid_h, grid_w, stride, dfl_len, classes, num_classes, out, threshold);
+        }
+        if (n < 0)
+        {
+            return -1;
+        }
+        total += n;
+    }
+    return total;
+}
@@ -0,0 +1,219 @@
+// 无 RGA 时的 letterbox：定点双线性缩放 + 仅边框填充
+
+#include "yolov8_letterbox.h"
+
+#include <string.h>
+
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define YOLOV8_LETTERBOX_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define YOLOV8_LETTERBOX_SSE2 1
+#endif
+
+namespace {
+
+const int kCoefOne = 1 << YOLOV8_LETTERBOX_COEF_BITS;
+// 水平、垂直各乘一次 7 位权重，合计右移 14 位
+const int kOutShift = 2 * YOLOV8_LETTERBOX_COEF_BITS;
+
+// 每列的两个源偏移（字节）与右侧权重；两行水平插值结果（int16，最大 255 * 128）
+struct LetterboxScratch {
+    std::vector<int> xofs0;
+    std::vector<int> xofs1;
+    std::vector<int16_t> xw;
+    std::vector<int16_t> rows[2];
+    int row_src[2];
+};
+
+// 源坐标 -> (起点, 终点, 终点权重)。与原实现一样按 offset * ratio 截断取起点，
+// 小数部分量化到 7 位；量化后满权重时直接落到下一个像素
+inline void map_coord(int offset, float ratio, int crop, int src_len, int *i0, int *i1, int *w1)
+{
+    const float f = offset * ratio;
+    int i = (int)f;
+    int w = (int)((f - i) * kCoefOne + 0.5f);
+    if (w >= kCoefOne)
+    {
+        i++;
+        w = 0;
+    }
+    i += crop;
+    if (i > src_len - 1)
+    {
+        i = src_len - 1;
+        w = 0;
+    }
+    *i0 = i;
+    *i1 = i + 1 < src_len ? i + 1 : i;
+    *w1 = w;
+}
+
+template <int CH>
+void horizontal_row(const uint8_t *src_row, const LetterboxScratch &s, int box_w, int16_t *out)
+{
+    const int *x0 = s.xofs0.data();
+    const int *x1 = s.xofs1.data();
+    const int16_t *w = s.xw.data();
+    for (int x = 0; x < box_w; x++)
+    {
+        const uint8_t *a = src_row + x0[x];
+        const uint8_t *b = src_row + x1[x];
+        const int w1 = w[x];
+        const int w0 = kCoefOne - w1;
+        for (int c = 0; c < CH; c++)
+        {
+            out[x * CH + c] = (int16_t)(a[c] * w0 + b[c] * w1);
+        }
+    }
+}
+
+void horizontal(const uint8_t *src_row, const LetterboxScratch &s, int box_w, int channels, int16_t *out)
+{
+    switch (channels)
+    {
+    case 1:
+        horizontal_row<1>(src_row, s, box_w, out);
+        break;
+    case 3:
+        horizontal_row<3>(src_row, s, box_w, out);
+        break;
+    default:
+        horizontal_row<4>(src_row, s, box_w, out);
+        break;
+    }
+}
+
+// out = (h0 * w0 + h1 * w1 + 2^13) >> 14，SIMD 与标量逐位一致
+void vertical(const int16_t *h0, const int16_t *h1, int w0, int w1, int n, uint8_t *out)
+{
+    int i = 0;
+#if defined(YOLOV8_LETTERBOX_NEON)
+    for (; i + 16 <= n; i += 16)
+    {
+        const int16x8_t a0 = vld1q_s16(h0 + i);
+        const int16x8_t a1 = vld1q_s16(h0 + i + 8);
+        const int16x8_t b0 = vld1q_s16(h1 + i);
+        const int16x8_t b1 = vld1q_s16(h1 + i + 8);
+        int32x4_t s0 = vmlal_n_s16(vmull_n_s16(vget_low_s16(a0), (int16_t)w0), vget_low_s16(b0), (int16_t)w1);
+        int32x4_t s1 = vmlal_n_s16(vmull_n_s16(vget_high_s16(a0), (int16_t)w0), vget_high_s16(b0), (int16_t)w1);
+        int32x4_t s2 = vmlal_n_s16(vmull_n_s16(vget_low_s16(a1), (int16_t)w0), vget_low_s16(b1), (int16_t)w1);
+        int32x4_t s3 = vmlal_n_s16(vmull_n_s16(vget_high_s16(a1), (int16_t)w0), vget_high_s16(b1), (int16_t)w1);
+        const int16x8_t r0 = vcombine_s16(vrshrn_n_s32(s0, kOutShift), vrshrn_n_s32(s1, kOutShift));
+        const int16x8_t r1 = vcombine_s16(vrshrn_n_s32(s2, kOutShift), vrshrn_n_s32(s3, kOutShift));
+        vst1q_u8(out + i, vcombine_u8(vqmovun_s16(r0), vqmovun_s16(r1)));
+    }
+#elif defined(YOLOV8_LETTERBOX_SSE2)
+    // (h0, h1) 交错后与 (w0, w1) 做 madd，一条指令完成两项乘加
+    const __m128i w = _mm_set1_epi32((int)(((uint32_t)(uint16_t)w1 << 16) | (uint16_t)w0));
+    const __m128i round = _mm_set1_epi32(1 << (kOutShift - 1));
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m128i a0 = _mm_loadu_si128((const __m128i *)(h0 + i));
+        const __m128i a1 = _mm_loadu_si128((const __m128i *)(h0 + i + 8));
+        const __m128i b0 = _mm_loadu_si128((const __m128i *)(h1 + i));
+        const __m128i b1 = _mm_loadu_si128((const __m128i *)(h1 + i + 8));
+        __m128i s0 = _mm_madd_epi16(_mm_unpacklo_epi16(a0, b0), w);
+        __m128i s1 = _mm_madd_epi16(_mm_unpackhi_epi16(a0, b0), w);
+        __m128i s2 = _mm_madd_epi16(_mm_unpacklo_epi16(a1, b1), w);
+        __m128i s3 = _mm_madd_epi16(_mm_unpackhi_epi16(a1, b1), w);
+        s0 = _mm_srai_epi32(_mm_add_epi32(s0, round), kOutShift);
+        s1 = _mm_srai_epi32(_mm_add_epi32(s1, round), kOutShift);
+        s2 = _mm_srai_epi32(_mm_add_epi32(s2, round), kOutShift);
+        s3 = _mm_srai_epi32(_mm_add_epi32(s3, round), kOutShift);
+        const __m128i r0 = _mm_packs_epi32(s0, s1);
+        const __m128i r1 = _mm_packs_epi32(s2, s3);
+        _mm_storeu_si128((__m128i *)(out + i), _mm_packus_epi16(r0, r1));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        out[i] = (uint8_t)((h0[i] * w0 + h1[i] * w1 + (1 << (kOutShift - 1))) >> kOutShift);
+    }
+}
+
+// 取源行 sy 的水平插值结果所在的缓存槽，不覆盖正在使用的 keep 行
+int cached_row(LetterboxScratch &s, const uint8_t *src, int src_stride, int sy, int keep, int box_w, int channels)
+{
+    for (int slot = 0; slot < 2; slot++)
+    {
+        if (s.row_src[slot] == sy)
+        {
+            return slot;
+        }
+    }
+    const int slot = s.row_src[0] == keep ? 1 : 0;
+    horizontal(src + (size_t)sy * src_stride, s, box_w, channels, s.rows[slot].data());
+    s.row_src[slot] = sy;
+    return slot;
+}
+
+} // namespace
+
+int yolov8_letterbox_resize(const uint8_t *src, int src_w, int src_h, int src_stride,
+                            int crop_x, int crop_y, int crop_w, int crop_h, int channels,
+                            uint8_t *dst, int dst_w, int dst_h, int dst_stride,
+                            int box_x, int box_y, int box_w, int box_h, uint8_t pad)
+{
+    if (src == nullptr || dst == nullptr || (channels != 1 && channels != 3 && channels != 4) ||
+        crop_w <= 0 || crop_h <= 0 || crop_x < 0 || crop_y < 0 || crop_x + crop_w > src_w || crop_y + crop_h > src_h ||
+        box_w <= 0 || box_h <= 0 || box_x < 0 || box_y < 0 || box_x + box_w > dst_w || box_y + box_h > dst_h)
+    {
+        return -1;
+    }
+
+    // 每个工作线程一份，尺寸不变时 resize 不会重新分配
+    static thread_local LetterboxScratch s;
+    const float x_ratio = (float)crop_w / (float)box_w;
+    const float y_ratio = (float)crop_h / (float)box_h;
+    const int row_len = box_w * channels;
+
+    s.xofs0.resize(box_w);
+    s.xofs1.resize(box_w);
+    s.xw.resize(box_w);
+    for (int x = 0; x < box_w; x++)
+    {
+        int i0, i1, w1;
+        map_coord(x, x_ratio, crop_x, src_w, &i0, &i1, &w1);
+        s.xofs0[x] = i0 * channels;
+        s.xofs1[x] = i1 * channels;
+        s.xw[x] = (int16_t)w1;
+    }
+    s.rows[0].resize(row_len);
+    s.rows[1].resize(row_len);
+    s.row_src[0] = -1;
+    s.row_src[1] = -1;
+
+    const int left_bytes = box_x * channels;
+    const int right_bytes = (dst_w - box_x - box_w) * channels;
+    const int full_bytes = dst_w * channels;
+
+    for (int y = 0; y < dst_h; y++)
+    {
+        uint8_t *out = dst + (size_t)y * dst_stride;
+        if (y < box_y || y >= box_y + box_h)
+        {
+            memset(out, pad, full_bytes);
+            continue;
+        }
+        if (left_bytes > 0)
+        {
+            memset(out, pad, left_bytes);
+        }
+        if (right_bytes > 0)
+        {
+            memset(out + left_bytes + row_len, pad, right_bytes);
+        }
+
+        int sy0, sy1, wy1;
+        map_coord(y - box_y, y_ratio, crop_y, src_h, &sy0, &sy1, &wy1);
+        const int slot0 = cached_row(s, src, src_stride, sy0, wy1 != 0 ? sy1 : -1, box_w, channels);
+        // 纵向权重为 0 时只用一行（整数倍缩小时每行都是这种情况）
+        const int slot1 = wy1 != 0 ? cached_row(s, src, src_stride, sy1, sy0, box_w, channels) : slot0;
+        vertical(s.rows[slot0].data(), s.rows[slot1].data(), kCoefOne - wy1, wy1, row_len, out + left_bytes);
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+// 模型文件映射缓存
+
+#include "silent_printf.h"
+#include "yolov8_model.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace {
+
+struct MappedModel {
+    void *data;
+    size_t size;
+    int refs;
+};
+
+std::mutex g_models_mutex;
+std::map<std::string, MappedModel> g_models;
+
+} // namespace
+
+int yolov8_model_acquire(const char *path, yolov8_model_blob *blob, bool *mapped_now)
+{
+    if (path == NULL || blob == NULL)
+    {
+        return -1;
+    }
+    if (mapped_now != NULL)
+    {
+        *mapped_now = false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_models_mutex);
+    std::map<std::string, MappedModel>::iterator it = g_models.find(path);
+    if (it != g_models.end())
+    {
+        it->second.refs++;
+        blob->data = it->second.data;
+        blob->size = it->second.size;
+        return 0;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("open %s fail!\n", path);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size <= 0)
+    {
+        printf("stat %s fail!\n", path);
+        close(fd);
+        return -1;
+    }
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        printf("mmap %s fail!\n", path);
+        return -1;
+    }
+
+    MappedModel model = {data, (size_t)st.st_size, 1};
+    g_models[path] = model;
+    blob->data = data;
+    blob->size = model.size;
+    if (mapped_now != NULL)
+    {
+        *mapped_now = true;
+    }
+    return 0;
+}
+
+void yolov8_model_release(const char *path)
+{
+    if (path == NULL)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_models_mutex);
+    std::map<std::string, MappedModel>::iterator it = g_models.find(path);
+    if (it == g_models.end() || --it->second.refs > 0)
+    {
+        return;
+    }
+    munmap(it->second.data, it->second.size);
+    g_models.erase(it);
+}
+
+int yolov8_model_cached_count()
+{
+    std::lock_guard<std::mutex> lock(g_models_mutex);
+    return (int)g_models.size();
+}
@@ -0,0 +1,219 @@
+// 候选框非极大值抑制：类别分桶 + 部分排序 + 早退 IoU
+
+#include "yolov8_nms.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+float yolov8_box_iou(float xmin0, float ymin0, float xmax0, float ymax0,
+                     float xmin1, float ymin1, float xmax1, float ymax1)
+{
+    float w = fmax(0.f, fmin(xmax0, xmax1) - fmax(xmin0, xmin1) + 1.0);
+    float h = fmax(0.f, fmin(ymax0, ymax1) - fmax(ymin0, ymin1) + 1.0);
+    float i = w * h;
+    float u = (xmax0 - xmin0 + 1.0) * (ymax0 - ymin0 + 1.0) + (xmax1 - xmin1 + 1.0) * (ymax1 - ymin1 + 1.0) - i;
+    return u <= 0.f ? 0.f : (i / u);
+}
+
+namespace {
+
+// 与 yolov8_box_iou 逐位一致，面积预先算好（先保留框、后候选框，加法次序不变）
+inline float iou_with_area(float xmin0, float ymin0, float xmax0, float ymax0, double area0,
+                           float xmin1, float ymin1, float xmax1, float ymax1, double area1)
+{
+    float w = fmax(0.f, fmin(xmax0, xmax1) - fmax(xmin0, xmin1) + 1.0);
+    float h = fmax(0.f, fmin(ymax0, ymax1) - fmax(ymin0, ymin1) + 1.0);
+    float i = w * h;
+    float u = area0 + area1 - i;
+    return u <= 0.f ? 0.f : (i / u);
+}
+
+inline double box_area(float xmin, float ymin, float xmax, float ymax)
+{
+    return (xmax - xmin + 1.0) * (ymax - ymin + 1.0);
+}
+
+struct ScoreOrder {
+    const float *scores;
+    bool operator()(int a, int b) const { return scores[a] > scores[b] || (scores[a] == scores[b] && a < b); }
+};
+
+// 对 [first, last) 按分数贪心抑制，保留的下标追加到 scratch->kept，最多保留 max_keep 个。
+// 排序按需推进：每次只 partial_sort 出下一段，保留数够了就不再排后面的部分
+int suppress_bucket(const float *boxes, const float *scores, const int *class_ids, int *first, int *last,
+                    float class_offset, int min_class, float threshold, int max_keep, yolov8_nms_scratch *s)
+{
+    ScoreOrder cmp = {scores};
+    const long chunk = max_keep * 2 > 16 ? max_keep * 2 : 16;
+    int *sorted_end = first;
+    int kept = 0;
+    const bool separable = threshold >= 0.f;
+
+    s->x1.clear();
+    s->y1.clear();
+    s->x2.clear();
+    s->y2.clear();
+    s->area.clear();
+
+    for (int *it = first; it != last && kept < max_keep; ++it)
+    {
+        if (it == sorted_end)
+        {
+            sorted_end = last - it > chunk ? it + chunk : last;
+            std::partial_sort(it, sorted_end, last, cmp);
+        }
+
+        const int n = *it;
+        const float offset = class_offset * (class_ids[n] - min_class);
+        const float xmin = boxes[n * 4 + 0] + offset;
+        const float ymin = boxes[n * 4 + 1] + offset;
+        const float xmax = (boxes[n * 4 + 0] + boxes[n * 4 + 2]) + offset;
+        const float ymax = (boxes[n * 4 + 1] + boxes[n * 4 + 3]) + offset;
+        const double area = box_area(xmin, ymin, xmax, ymax);
+
+        bool suppressed = false;
+        const size_t n_kept = s->x1.size();
+        for (size_t k = 0; k < n_kept; k++)
+        {
+            // 不相交的框 IoU 为 0，先用与 iou_with_area 相同的表达式排除，省去除法
+            if (separable && (fmin(s->x2[k], xmax) - fmax(s->x1[k], xmin) + 1.0 <= 0.0 ||
+                              fmin(s->y2[k], ymax) - fmax(s->y1[k], ymin) + 1.0 <= 0.0))
+            {
+                continue;
+            }
+            if (iou_with_area(s->x1[k], s->y1[k], s->x2[k], s->y2[k], s->area[k],
+                              xmin, ymin, xmax, ymax, area) > threshold)
+            {
+                suppressed = true;
+                break;
+            }
+        }
+        if (suppressed)
+        {
+            continue;
+        }
+
+        s->x1.push_back(xmin);
+        s->y1.push_back(ymin);
+        s->x2.push_back(xmax);
+        s->y2.push_back(ymax);
+        s->area.push_back(area);
+        s->kept.push_back(n);
+        kept++;
+    }
+    return kept;
+}
+
+template <typename T>
+void reserve_counted(std::vector<T> &v, size_t n, uint64_t *allocations)
+{
+    if (v.capacity() < n)
+    {
+        v.reserve(n);
+        (*allocations)++;
+    }
+}
+
+} // namespace
+
+void yolov8_nms_reserve(yolov8_nms_scratch *s, int count, int n_classes)
+{
+    const size_t n = count > 0 ? (size_t)count : 0;
+    const size_t buckets = n_classes > 0 ? (size_t)n_classes + 1 : 1;
+    reserve_counted(s->order, n, &s->allocations);
+    reserve_counted(s->bucket_start, buckets, &s->allocations);
+    reserve_counted(s->kept, n > buckets ? n : buckets, &s->allocations);
+    reserve_counted(s->x1, n, &s->allocations);
+    reserve_counted(s->y1, n, &s->allocations);
+    reserve_counted(s->x2, n, &s->allocations);
+    reserve_counted(s->y2, n, &s->allocations);
+    reserve_counted(s->area, n, &s->allocations);
+}
+
+int yolov8_nms(const float *boxes, const float *scores, const int *class_ids, int count,
+               const yolov8_nms_config *config, int *keep, yolov8_nms_scratch *scratch)
+{
+    if (count <= 0 || config->max_detections <= 0)
+    {
+        return 0;
+    }
+
+    yolov8_nms_scratch local;
+    yolov8_nms_scratch *s = scratch != nullptr ? scratch : &local;
+    const int max_det = config->max_detections;
+
+    int min_class = class_ids[0];
+    int max_class = class_ids[0];
+    for (int i = 1; i < count; i++)
+    {
+        min_class = std::min(min_class, class_ids[i]);
+        max_class = std::max(max_class, class_ids[i]);
+    }
+
+    yolov8_nms_reserve(s, count, max_class - min_class + 1);
+    s->order.resize(count);
+    s->kept.clear();
+
+    if (config->class_batched)
+    {
+        // 每类平移 2M+2（M 为坐标绝对值上界），不同类别的框在 x/y 上都不相交，IoU 恒为 0
+        float extent = 0.f;
+        for (int i = 0; i < count; i++)
+        {
+            extent = std::max(extent, fabsf(boxes[i * 4 + 0]));
+            extent = std::max(extent, fabsf(boxes[i * 4 + 1]));
+            extent = std::max(extent, fabsf(boxes[i * 4 + 0] + boxes[i * 4 + 2]));
+            extent = std::max(extent, fabsf(boxes[i * 4 + 1] + boxes[i * 4 + 3]));
+        }
+        for (int i = 0; i < count; i++)
+        {
+            s->order[i] = i;
+        }
+        // 输出本就是全局分数序，保留够 max_det 个即可结束
+        suppress_bucket(boxes, scores, class_ids, s->order.data(), s->order.data() + count,
+                        2.f * extent + 2.f, min_class, config->nms_threshold, max_det, s);
+        const int n = (int)s->kept.size();
+        std::copy(s->kept.begin(), s->kept.end(), keep);
+        return n;
+    }
+
+    // 计数排序分桶；桶内保持下标升序，排序比较器再按分数重排
+    const int n_buckets = max_class - min_class + 1;
+    s->bucket_start.assign(n_buckets + 1, 0);
+    for (int i = 0; i < count; i++)
+    {
+        s->bucket_start[class_ids[i] - min_class + 1]++;
+    }
+    for (int b = 0; b < n_buckets; b++)
+    {
+        s->bucket_start[b + 1] += s->bucket_start[b];
+    }
+    {
+        std::vector<int> &cursor = s->kept; // 借用 kept 作为写指针，分桶后清空
+        cursor.assign(s->bucket_start.begin(), s->bucket_start.end() - 1);
+        for (int i = 0; i < count; i++)
+        {
+            s->order[cursor[class_ids[i] - min_class]++] = i;
+        }
+        cursor.clear();
+    }
+
+    for (int b = 0; b < n_buckets; b++)
+    {
+        int *first = s->order.data() + s->bucket_start[b];
+        int *last = s->order.data() + s->bucket_start[b + 1];
+        if (first != last)
+        {
+            suppress_bucket(boxes, scores, class_ids, first, last, 0.f, min_class, config->nms_threshold, max_det, s);
+        }
+    }
+
+    // 各类保留结果按全局分数序合并，截断到 max_det
+    ScoreOrder cmp = {scores};
+    const int n_kept = (int)s->kept.size();
+    const int n_out = std::min(n_kept, max_det);
+    std::partial_sort(s->kept.begin(), s->kept.begin() + n_out, s->kept.end(), cmp);
+    std::copy(s->kept.begin(), s->kept.begin() + n_out, keep);
+    return n_out;
+}
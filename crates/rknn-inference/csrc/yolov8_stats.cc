@@ -0,0 +1,119 @@
+// 推理统计
+
+#include "yolov8_stats.h"
+
+#include <string.h>
+#include <time.h>
+
+#include <mutex>
+
+struct yolov8_stats {
+    std::mutex mutex;
+    yolov8_inference_stats data;
+};
+
+yolov8_stats *yolov8_stats_create()
+{
+    yolov8_stats *stats = new yolov8_stats();
+    memset(&stats->data, 0, sizeof(stats->data));
+    return stats;
+}
+
+void yolov8_stats_destroy(yolov8_stats *stats)
+{
+    delete stats;
+}
+
+uint64_t yolov8_stats_now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000ull;
+}
+
+int yolov8_stats_bucket(uint64_t us)
+{
+    int bucket = 0;
+    while (us != 0 && bucket < YOLOV8_STATS_BUCKETS - 1)
+    {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void yolov8_stats_record_stage(yolov8_stats *stats, int stage, uint64_t us)
+{
+    if (stats == nullptr || stage < 0 || stage >= YOLOV8_STAGE_COUNT)
+    {
+        return;
+    }
+    const int bucket = yolov8_stats_bucket(us);
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    yolov8_stage_stats *s = &stats->data.stages[stage];
+    s->count++;
+    s->total_us += us;
+    s->last_us = us;
+    if (us > s->max_us)
+    {
+        s->max_us = us;
+    }
+    s->buckets[bucket]++;
+}
+
+void yolov8_stats_record_frame(yolov8_stats *stats, int candidates, int dropped, int detections)
+{
+    if (stats == nullptr)
+    {
+        return;
+    }
+    const uint64_t c = candidates > 0 ? (uint64_t)candidates : 0;
+    const uint64_t d = detections > 0 ? (uint64_t)detections : 0;
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    yolov8_inference_stats *s = &stats->data;
+    s->frames++;
+    s->candidates_total += c;
+    s->candidates_last = c;
+    if (c > s->candidates_max)
+    {
+        s->candidates_max = c;
+    }
+    s->candidates_dropped += dropped > 0 ? (uint64_t)dropped : 0;
+    s->detections_total += d;
+    s->detections_last = d;
+}
+
+void yolov8_stats_record_error(yolov8_stats *stats)
+{
+    if (stats == nullptr)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    stats->data.errors++;
+}
+
+void yolov8_stats_snapshot(yolov8_stats *stats, yolov8_inference_stats *out)
+{
+    if (out == nullptr)
+    {
+        return;
+    }
+    if (stats == nullptr)
+    {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    *out = stats->data;
+}
+
+void yolov8_stats_reset(yolov8_stats *stats)
+{
+    if (stats == nullptr)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    memset(&stats->data, 0, sizeof(stats->data));
+}
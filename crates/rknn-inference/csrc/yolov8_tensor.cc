@@ -0,0 +1,286 @@
+// 张量视图、.yv8t 读写与主机回放后端
+
+#include "yolov8_tensor.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+// 版本 1 的记录到 size 为止
+const size_t kRecordSizeV1 = offsetof(yolov8_tensor_record, layout);
+
+inline uint32_t element_size(uint32_t type) { return type == YOLOV8_TENSOR_FLOAT32 ? 4 : 1; }
+
+// 元素 (c, y, x) 的元素偏移
+inline size_t element_offset(const yolov8_tensor_record &r, uint32_t c, uint32_t y, uint32_t x)
+{
+    const size_t h = r.dims[2];
+    if (r.layout == YOLOV8_LAYOUT_NC1HWC2)
+    {
+        return (((c / r.c2) * h + y) * r.w_stride + x) * r.c2 + c % r.c2;
+    }
+    return (c * h + y) * r.w_stride + x;
+}
+
+class HostBackend : public yolov8_tensor_backend {
+public:
+    HostBackend(const std::vector<yolov8_tensor_frame> &frames, int input_size, bool copy_outputs)
+        : frames_(frames), input_(input_size > 0 ? input_size : 0), copy_outputs_(copy_outputs)
+    {
+        if (copy_outputs_)
+        {
+            size_t n = 0;
+            for (const yolov8_tensor_frame &f : frames_)
+            {
+                n = f.data.size() > n ? f.data.size() : n;
+            }
+            buffers_.resize(n);
+            for (const yolov8_tensor_frame &f : frames_)
+            {
+                for (size_t i = 0; i < f.data.size(); i++)
+                {
+                    if (f.data[i].size() > buffers_[i].size())
+                    {
+                        buffers_[i].resize(f.data[i].size());
+                    }
+                }
+            }
+        }
+    }
+
+    const char *name() const override { return copy_outputs_ ? "host-copy" : "host-zero-copy"; }
+
+    uint8_t *input(int *size) override
+    {
+        if (size != nullptr)
+        {
+            *size = (int)input_.size();
+        }
+        return input_.data();
+    }
+
+    int run() override
+    {
+        if (frames_.empty())
+        {
+            return -1;
+        }
+        current_ = current_ < 0 ? 0 : (current_ + 1) % (int)frames_.size();
+        if (copy_outputs_)
+        {
+            const yolov8_tensor_frame &f = frames_[current_];
+            for (size_t i = 0; i < f.data.size(); i++)
+            {
+                memcpy(buffers_[i].data(), f.data[i].data(), f.data[i].size());
+            }
+        }
+        return 0;
+    }
+
+    int outputs(yolov8_tensor_view *views, int max_views) override
+    {
+        if (current_ < 0)
+        {
+            return -1;
+        }
+        const yolov8_tensor_frame &f = frames_[current_];
+        const int n = (int)f.records.size();
+        if (n > max_views)
+        {
+            return -1;
+        }
+        yolov8_tensor_frame_views(&f, views);
+        if (copy_outputs_)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                views[i].data = buffers_[i].data();
+            }
+        }
+        return n;
+    }
+
+private:
+    std::vector<yolov8_tensor_frame> frames_;
+    std::vector<uint8_t> input_;
+    std::vector<std::vector<uint8_t> > buffers_;
+    bool copy_outputs_;
+    int current_ = -1;
+};
+
+} // namespace
+
+void yolov8_tensor_view_to_record(const yolov8_tensor_view *view, yolov8_tensor_record *record)
+{
+    memset(record, 0, sizeof(*record));
+    record->type = view->type;
+    record->zp = view->zp;
+    record->scale = view->scale;
+    memcpy(record->dims, view->dims, sizeof(record->dims));
+    record->size = view->size;
+    record->layout = view->layout;
+    record->c2 = view->c2;
+    record->w_stride = view->w_stride;
+}
+
+void yolov8_tensor_frame_views(const yolov8_tensor_frame *frame, yolov8_tensor_view *views)
+{
+    for (size_t i = 0; i < frame->records.size(); i++)
+    {
+        const yolov8_tensor_record &r = frame->records[i];
+        yolov8_tensor_view &v = views[i];
+        v.data = frame->data[i].data();
+        v.type = r.type;
+        v.layout = r.layout;
+        v.zp = r.zp;
+        v.scale = r.scale;
+        memcpy(v.dims, r.dims, sizeof(v.dims));
+        v.c2 = r.c2;
+        v.w_stride = r.w_stride;
+        v.size = r.size;
+    }
+}
+
+uint32_t yolov8_tensor_required_size(const yolov8_tensor_record *record)
+{
+    const yolov8_tensor_record &r = *record;
+    if (r.dims[1] == 0 || r.dims[2] == 0 || r.dims[3] == 0 || r.w_stride < r.dims[3] ||
+        (r.layout == YOLOV8_LAYOUT_NC1HWC2 && r.c2 == 0))
+    {
+        return 0;
+    }
+    return (uint32_t)((element_offset(r, r.dims[1] - 1, r.dims[2] - 1, r.dims[3] - 1) + 1) * element_size(r.type));
+}
+
+int yolov8_tensor_file_write(const char *path, const yolov8_tensor_view *views, int n_outputs, int model_width,
+                             int model_height)
+{
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        return -1;
+    }
+    yolov8_tensor_file_header header;
+    memcpy(header.magic, YOLOV8_TENSOR_FILE_MAGIC, 4);
+    header.version = YOLOV8_TENSOR_FILE_VERSION;
+    header.n_outputs = n_outputs;
+    header.model_width = model_width;
+    header.model_height = model_height;
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    for (int i = 0; ok && i < n_outputs; i++)
+    {
+        yolov8_tensor_record record;
+        yolov8_tensor_view_to_record(&views[i], &record);
+        ok = fwrite(&record, sizeof(record), 1, fp) == 1 && fwrite(views[i].data, 1, views[i].size, fp) == views[i].size;
+    }
+    fclose(fp);
+    return ok ? 0 : -1;
+}
+
+int yolov8_tensor_file_read(const char *path, yolov8_tensor_frame *frame)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        return -1;
+    }
+    yolov8_tensor_file_header header;
+    bool ok = fread(&header, sizeof(header), 1, fp) == 1 && memcmp(header.magic, YOLOV8_TENSOR_FILE_MAGIC, 4) == 0 &&
+              header.version >= 1 && header.version <= YOLOV8_TENSOR_FILE_VERSION &&
+              header.n_outputs > 0 && header.n_outputs <= 64;
+    const size_t record_size = header.version == 1 ? kRecordSizeV1 : sizeof(yolov8_tensor_record);
+
+    frame->model_width = header.model_width;
+    frame->model_height = header.model_height;
+    frame->records.clear();
+    frame->data.clear();
+    for (uint32_t i = 0; ok && i < header.n_outputs; i++)
+    {
+        yolov8_tensor_record record;
+        memset(&record, 0, sizeof(record));
+        ok = fread(&record, record_size, 1, fp) == 1;
+        if (!ok)
+        {
+            break;
+        }
+        if (header.version == 1)
+        {
+            record.layout = YOLOV8_LAYOUT_NCHW;
+            record.w_stride = record.dims[3];
+        }
+        const uint32_t required = yolov8_tensor_required_size(&record);
+        ok = required > 0 && record.size >= required;
+        if (!ok)
+        {
+            break;
+        }
+        std::vector<uint8_t> data(record.size);
+        ok = fread(data.data(), 1, record.size, fp) == record.size;
+        frame->records.push_back(record);
+        frame->data.push_back(std::move(data));
+    }
+    fclose(fp);
+    return ok ? 0 : -1;
+}
+
+int yolov8_tensor_frame_repack(const yolov8_tensor_frame *src, uint32_t layout, uint32_t c2, yolov8_tensor_frame *dst)
+{
+    if ((layout != YOLOV8_LAYOUT_NCHW && layout != YOLOV8_LAYOUT_NC1HWC2) || (layout == YOLOV8_LAYOUT_NC1HWC2 && c2 == 0))
+    {
+        return -1;
+    }
+    yolov8_tensor_frame out;
+    out.model_width = src->model_width;
+    out.model_height = src->model_height;
+    for (size_t i = 0; i < src->records.size(); i++)
+    {
+        const yolov8_tensor_record &from = src->records[i];
+        yolov8_tensor_record to = from;
+        to.layout = layout;
+        to.c2 = layout == YOLOV8_LAYOUT_NC1HWC2 ? c2 : 0;
+        to.w_stride = from.dims[3];
+        if (layout == YOLOV8_LAYOUT_NC1HWC2)
+        {
+            to.size = (from.dims[1] + c2 - 1) / c2 * c2 * from.dims[2] * from.dims[3] * element_size(from.type);
+        }
+        else
+        {
+            to.size = yolov8_tensor_required_size(&to);
+        }
+
+        const uint32_t elem = element_size(from.type);
+        std::vector<uint8_t> data(to.size, 0);
+        const uint8_t *in = src->data[i].data();
+        for (uint32_t c = 0; c < from.dims[1]; c++)
+        {
+            for (uint32_t y = 0; y < from.dims[2]; y++)
+            {
+                for (uint32_t x = 0; x < from.dims[3]; x++)
+                {
+                    memcpy(&data[element_offset(to, c, y, x) * elem], in + element_offset(from, c, y, x) * elem, elem);
+                }
+            }
+        }
+        out.records.push_back(to);
+        out.data.push_back(std::move(data));
+    }
+    *dst = out;
+    return 0;
+}
+
+yolov8_tensor_backend *yolov8_host_backend_create(const std::vector<yolov8_tensor_frame> &frames, int input_size,
+                                                  bool copy_outputs)
+{
+    if (frames.empty())
+    {
+        return nullptr;
+    }
+    return new HostBackend(frames, input_size, copy_outputs);
+}
+
+void yolov8_tensor_backend_destroy(yolov8_tensor_backend *backend)
+{
+    delete backend;
+}
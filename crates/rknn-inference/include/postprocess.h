@@ -6,12 +6,11 @@
 #include "rknn_api.h"
 #include "common.h"
 #include "image_utils.h"
+#include "yolov8_arena.h"
 
 #define OBJ_NAME_MAX_SIZE 64
-#define OBJ_NUMB_MAX_SIZE 128
-#define OBJ_CLASS_NUM 80
-#define NMS_THRESH 0.45
-#define BOX_THRESH 0.25
+#define OBJ_NUMB_MAX_SIZE 128 // 结果表容量，运行时 max_detections 的上限
+#define OBJ_CLASS_NUM 80      // 标签表容量（coco_80_labels_list.txt）；模型类别数按输出形状推导
 
 // class rknn_app_context_t;
 
@@ -30,7 +29,26 @@ typedef struct {
 int init_post_process();
 void deinit_post_process();
 char *coco_cls_to_name(int cls_id);
-int post_process(rknn_app_context_t *app_ctx, void *outputs, letterbox_t *letter_box, float conf_threshold, float nms_threshold, object_detect_result_list *od_results);
+// 阈值、类别过滤与最大检测数取自 app_ctx 的后处理配置（见 set_post_process_config）。
+// outputs 为 rknn_output 数组（RV1106 为 rknn_tensor_mem* 数组），按输出属性构造视图后交给 post_process_views
+int post_process(rknn_app_context_t *app_ctx, void *outputs, letterbox_t *letter_box, object_detect_result_list *od_results);
+// 直接按后端给出的输出视图后处理（视图布局可为 NCHW 或原生 NC1HWC2/NHWC）
+int post_process_views(rknn_app_context_t *app_ctx, const yolov8_tensor_view *views, letterbox_t *letter_box,
+                       object_detect_result_list *od_results);
+
+// 按输出张量形状创建/释放 app_ctx->post_arena；post_process 在工作区缺失时会自动创建
+int init_post_process_arena(rknn_app_context_t *app_ctx);
+void release_post_process_arena(rknn_app_context_t *app_ctx);
+// 后处理累计堆分配次数（初始化之后稳态推理应保持不变）
+uint64_t post_process_allocation_count(rknn_app_context_t *app_ctx);
+
+// 运行时后处理配置。默认值：conf 0.25、NMS 0.45、最多 OBJ_NUMB_MAX_SIZE 个、不过滤类别
+void default_post_process_config(yolov8_postprocess_config *config);
+// 校验并应用配置，非法配置返回 -1 且保持原配置；可在推理间隙随时调用
+int set_post_process_config(rknn_app_context_t *app_ctx, const yolov8_postprocess_config *config);
+int get_post_process_config(rknn_app_context_t *app_ctx, yolov8_postprocess_config *config);
+// 模型输出的类别数（由 score 张量形状推导），工作区未创建时返回 -1
+int post_process_num_classes(rknn_app_context_t *app_ctx);
 
 void deinitPostProcess();
 #endif //_RKNN_YOLOV8_DEMO_POSTPROCESS_H_
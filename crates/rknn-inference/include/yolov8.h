@@ -27,6 +27,13 @@
     }rknn_dma_buf;
 #endif
 
+// 输出张量个数上限（3 个分支，每分支 box / score / score_sum），init 时校验；
+// 推理路径的输出视图按此定长放在栈上
+#define YOLOV8_MAX_OUTPUTS 9
+
+struct yolov8_postprocess_arena;
+struct yolov8_stats;
+
 typedef struct {
     rknn_context rknn_ctx;
     rknn_input_output_num io_num;
@@ -34,23 +41,53 @@ typedef struct {
     rknn_tensor_attr* output_attrs;
 #if defined(RV1106_1103) 
     rknn_tensor_mem* input_mems[1];
-    rknn_tensor_mem* output_mems[9];
+    rknn_tensor_mem* output_mems[YOLOV8_MAX_OUTPUTS];
     rknn_dma_buf img_dma_buf;
-#endif
-#if defined(ZERO_COPY)  
-    rknn_tensor_mem* input_mems[1];
-    rknn_tensor_mem* output_mems[9];
-    rknn_tensor_attr* input_native_attrs;
-    rknn_tensor_attr* output_native_attrs;
 #endif
     int model_channel;
     int model_width;
     int model_height;
     bool is_quant;
+    struct yolov8_postprocess_arena* post_arena; // 后处理工作区（init 时创建，release 时释放）
+    struct yolov8_tensor_backend* backend; // 输入/输出张量内存（拷贝或 zero copy，见 yolov8_tensor.h），init 时创建
+    struct yolov8_stats* stats; // 各阶段耗时与候选数统计（见 yolov8_stats.h），init 时创建
 } rknn_app_context_t;
 
 #include "postprocess.h"
+#include "yolov8_tensor.h"
+#include "yolov8_stats.h"
+
+// 输入输出方式：auto 在 RKNPU2 的量化模型上使用 zero copy，不可用时退回拷贝；
+// 环境变量 SMARTSCOPE_RKNN_IO=copy|zero_copy 可强制指定
+typedef enum {
+    YOLOV8_IO_AUTO = 0,
+    YOLOV8_IO_COPY = 1,
+    YOLOV8_IO_ZERO_COPY = 2,
+} yolov8_io_mode;
 
+yolov8_io_mode yolov8_io_mode_from_env();
+// 创建 rknn 后端（需在 io_num / 属性 / 模型尺寸填好之后），失败返回 NULL
+yolov8_tensor_backend* yolov8_create_rknn_backend(rknn_app_context_t* app_ctx, yolov8_io_mode mode);
+// 由输出属性构造视图：logical 为 RKNN_QUERY_OUTPUT_ATTR 的属性（逻辑形状），
+// native 为数据实际的属性（拷贝输出与 logical 相同，zero copy 为原生属性）；size 不足时返回 -1
+int yolov8_view_from_attr(const rknn_tensor_attr* logical, const rknn_tensor_attr* native, const void* data,
+                          uint32_t size, bool is_float, yolov8_tensor_view* view);
+
+
+// 初始化各阶段耗时（毫秒），用于统计 AI 服务冷启动
+typedef struct {
+    double load_ms;  // 映射模型文件（见 yolov8_model.h，命中缓存时接近 0）
+    double init_ms;  // rknn_init 或 rknn_dup_context
+    double query_ms; // 查询输入输出属性（复制上下文时为拷贝源属性）
+    double setup_ms; // 后处理工作区与张量后端
+    int duplicated;  // 1 表示由 rknn_dup_context 复制
+} yolov8_init_timing;
+
+// 初始化上下文：src 非空且平台支持时用 rknn_dup_context 复制 src（共享权重，跳过模型加载与属性查询，
+// 复制失败时退回从 model_path 加载），否则从 model_path 加载。RKNPU1 / RV1106 没有 rknn_dup_context。
+// 失败时已创建的部分会被释放。timing 可为 NULL
+int yolov8_init_model_ex(const char* model_path, const rknn_app_context_t* src, rknn_app_context_t* app_ctx,
+                         yolov8_init_timing* timing);
 
 int init_yolov8_model(const char* model_path, rknn_app_context_t* app_ctx);
 
@@ -58,7 +95,14 @@ int release_yolov8_model(rknn_app_context_t* app_ctx);
 
 int inference_yolov8_model(rknn_app_context_t* app_ctx, image_buffer_t* img, object_detect_result_list* od_results);
 
+// 把上下文固定到一个 NPU 核心（rknn_set_core_mask）：core 为 0..2 时只在该核心上运行，-1 交给驱动调度。
+// RKNPU1 / RV1106 只有单核，只接受 -1
+int yolov8_set_npu_core(rknn_app_context_t* app_ctx, int core);
+
 // Separate step functions for benchmarking
+// yolov8_preprocess 输出的 dst_img 指向后端的输入缓冲（下一帧覆盖），调用方不要释放。
+// yolov8_inference 填入的 outputs 只是本帧输出的句柄（buf/size 指向后端内存，zero copy 时为原生布局），
+// yolov8_postprocess 按后端的视图解码；用完调用 yolov8_release_outputs
 int yolov8_preprocess(rknn_app_context_t* app_ctx, image_buffer_t* img, image_buffer_t* dst_img, letterbox_t* letter_box);
 int yolov8_inference(rknn_app_context_t* app_ctx, image_buffer_t* dst_img, rknn_output* outputs);
 int yolov8_postprocess(rknn_app_context_t* app_ctx, rknn_output* outputs, letterbox_t* letter_box, object_detect_result_list* od_results);
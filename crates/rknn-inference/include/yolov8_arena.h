@@ -0,0 +1,68 @@
+#ifndef _RKNN_YOLOV8_ARENA_H_
+#define _RKNN_YOLOV8_ARENA_H_
+
+// 后处理工作区：每个 rknn_app_context_t 一份，在 init_yolov8_model 时按输出张量形状一次性分配
+//
+// 候选数上限为三个分支格子数之和（每个格子最多产生一个候选），候选缓冲按此定长；
+// NMS 工作区同样预留到上限。稳态推理的解码与 NMS 不再触发堆分配，
+// allocations 计数在初始化之后应保持不变。
+//
+// allocations 是自报计数：只在创建时与 NMS 扩容处手动累加，并不拦截 operator new，
+// 因此只能发现已知预留点的意外扩容。稳态零分配由 yolov8_decode_bench 替换全局 operator new 计数来验证。
+//
+// 工作区同时保存运行时后处理配置（阈值、类别过滤、最大检测数），
+// 设置配置时把类别位图展开成升序类别列表，解码只扫描列表中的类别。
+
+#include <stdint.h>
+#include <vector>
+
+#include "yolov8_decode.h"
+#include "yolov8_nms.h"
+
+#define YOLOV8_MAX_CLASSES 256
+#define YOLOV8_DEFAULT_CONF_THRESH 0.25f
+#define YOLOV8_DEFAULT_NMS_THRESH 0.45f
+
+// 后处理配置（纯 C 布局，Rust 侧 ffi::RknnPostprocessConfig 与之一一对应）
+typedef struct {
+    float conf_threshold;                          // 置信度阈值
+    float nms_threshold;                           // NMS IoU 阈值
+    int max_detections;                            // 每帧最多输出的检测数，<= 0 或超过结果表容量时取容量
+    uint64_t class_mask[YOLOV8_MAX_CLASSES / 64];  // 类别 c 对应 class_mask[c / 64] 的第 c % 64 位；全 0 表示不过滤
+} yolov8_postprocess_config;
+
+typedef struct yolov8_postprocess_arena {
+    std::vector<float> boxes;
+    std::vector<float> probs;
+    std::vector<int> class_ids;
+    std::vector<int> keep;
+    yolov8_candidates candidates;
+    yolov8_nms_scratch nms;
+    std::vector<int> classes; // 允许的类别（升序），由 class_mask 展开
+    yolov8_postprocess_config config;
+    int max_candidates;
+    int num_classes;     // 模型输出的类别数
+    int filter_classes;  // 非 0：只解码 classes 中的类别
+    int max_detections;  // 结果表容量，config.max_detections 的上限
+    uint64_t allocations; // 工作区自身的分配次数（自报，不含 nms.allocations）
+} yolov8_postprocess_arena;
+
+yolov8_postprocess_arena *yolov8_arena_create(int max_candidates, int num_classes, int max_detections);
+void yolov8_arena_destroy(yolov8_postprocess_arena *arena);
+
+// 默认配置：YOLOV8_DEFAULT_*_THRESH、检测数上限 max_detections、不过滤类别
+void yolov8_postprocess_default_config(yolov8_postprocess_config *config, int max_detections);
+
+// 校验并保存配置（不分配内存）。阈值须在 [0, 1] 内，且至少允许一个模型内的类别；失败返回 -1，原配置不变
+int yolov8_arena_configure(yolov8_postprocess_arena *arena, const yolov8_postprocess_config *config);
+
+// 本帧解码要扫描的类别：全部类别时返回 nullptr，*count 为类别数
+const int *yolov8_arena_classes(const yolov8_postprocess_arena *arena, int *count);
+
+// 开始新一帧：清空候选缓冲并返回它
+yolov8_candidates *yolov8_arena_begin(yolov8_postprocess_arena *arena);
+
+// 自创建以来的堆分配总次数（工作区 + NMS 扩容，自报计数，见文件头）
+uint64_t yolov8_arena_allocations(const yolov8_postprocess_arena *arena);
+
+#endif // _RKNN_YOLOV8_ARENA_H_
@@ -0,0 +1,167 @@
+#ifndef _RKNN_YOLOV8_DECODE_H_
+#define _RKNN_YOLOV8_DECODE_H_
+
+// YOLOv8 检测头单分支解码（不依赖 rknn_api.h，可在 x86 上编译测试与基准）
+//
+// 输出张量为类别主序（NCHW）布局：
+//   score[c * grid_len + cell]        c < num_classes
+//   box  [k * grid_len + cell]        k < 4 * dfl_len
+// 先用类别最大值内核沿各类别的连续行扫描（NEON / SSE2，否则标量），
+// 找出超过阈值的格子；DFL 与框解码只对这些幸存格子执行。
+// 输出与逐格子逐类别的标量实现逐位一致（同分取较小类别号）。
+// NPU 原生布局（NC1HWC2 / NHWC，zero copy 时直接拿到的输出）另有按格子扫描的解码，见下文。
+
+#include <math.h>
+#include <stdint.h>
+
+// 一个 SIMD 块处理的格子数
+#define YOLOV8_DECODE_BLOCK 64
+
+// DFL 每条边的 bin 数上限（YOLOv8 的 reg_max 为 16），用于定长栈缓冲
+#define YOLOV8_MAX_DFL_LEN 32
+
+// 候选缓冲：容量固定，由调用方提供存储（见 yolov8_arena.h），追加时不分配内存；
+// 满了之后的候选计入 dropped 并丢弃
+typedef struct {
+    float *boxes;       // capacity * 4，(x, y, w, h)
+    float *probs;
+    int *class_ids;
+    int count;
+    int capacity;
+    int dropped;
+} yolov8_candidates;
+
+inline bool yolov8_candidates_push(yolov8_candidates *out, float x, float y, float w, float h, float prob, int class_id)
+{
+    if (out->count >= out->capacity)
+    {
+        out->dropped++;
+        return false;
+    }
+    float *box = out->boxes + (size_t)out->count * 4;
+    box[0] = x;
+    box[1] = y;
+    box[2] = w;
+    box[3] = h;
+    out->probs[out->count] = prob;
+    out->class_ids[out->count] = class_id;
+    out->count++;
+    return true;
+}
+
+inline int32_t yolov8_clip(float val, float min, float max)
+{
+    float f = val <= min ? min : (val >= max ? max : val);
+    return f;
+}
+
+inline int8_t yolov8_qnt_f32_to_i8(float f32, int32_t zp, float scale)
+{
+    float dst_val = (f32 / scale) + zp;
+    return (int8_t)yolov8_clip(dst_val, -128, 127);
+}
+
+inline uint8_t yolov8_qnt_f32_to_u8(float f32, int32_t zp, float scale)
+{
+    float dst_val = (f32 / scale) + zp;
+    return (uint8_t)yolov8_clip(dst_val, 0, 255);
+}
+
+inline float yolov8_deqnt_i8(int8_t qnt, int32_t zp, float scale) { return ((float)qnt - (float)zp) * scale; }
+
+inline float yolov8_deqnt_u8(uint8_t qnt, int32_t zp, float scale) { return ((float)qnt - (float)zp) * scale; }
+
+// DFL：每条边 dfl_len 个 bin 做 softmax 后取期望（dfl_len <= YOLOV8_MAX_DFL_LEN）
+void yolov8_compute_dfl(const float *tensor, int dfl_len, float *box);
+
+// 类别最大值内核：对 [cell, cell + count) 中每个格子，在 num_classes 个类别里
+// 取 score > thresh 且严格大于当前最大值的类别（初值为 init，类别为 -1）。
+// classes 为空时扫描类别 0..num_classes-1；否则只扫描 classes[0..num_classes)（须升序），
+// 未列出的类别的分数行完全不读取
+void yolov8_class_max_i8(const int8_t *scores, int grid_len, int cell, int count, const int *classes, int num_classes,
+                         int8_t thresh, int8_t init, int8_t *max_score, int *max_class);
+void yolov8_class_max_u8(const uint8_t *scores, int grid_len, int cell, int count, const int *classes, int num_classes,
+                         uint8_t thresh, uint8_t init, uint8_t *max_score, int *max_class);
+void yolov8_class_max_fp32(const float *scores, int grid_len, int cell, int count, const int *classes, int num_classes,
+                           float thresh, float init, float *max_score, int *max_class);
+
+// 单分支解码，返回新增候选数；候选追加到 out，框坐标为模型输入坐标系
+// score_sum_tensor 可为空（无 score_sum 输出的模型）；dfl_len 超过上限时返回 -1
+int yolov8_decode_branch_i8(const int8_t *box_tensor, int32_t box_zp, float box_scale,
+                            const int8_t *score_tensor, int32_t score_zp, float score_scale,
+                            const int8_t *score_sum_tensor, int32_t score_sum_zp, float score_sum_scale,
+                            int grid_h, int grid_w, int stride, int dfl_len, const int *classes, int num_classes,
+                            yolov8_candidates *out, float threshold);
+int yolov8_decode_branch_u8(const uint8_t *box_tensor, int32_t box_zp, float box_scale,
+                            const uint8_t *score_tensor, int32_t score_zp, float score_scale,
+                            const uint8_t *score_sum_tensor, int32_t score_sum_zp, float score_sum_scale,
+                            int grid_h, int grid_w, int stride, int dfl_len, const int *classes, int num_classes,
+                            yolov8_candidates *out, float threshold);
+int yolov8_decode_branch_fp32(const float *box_tensor, const float *score_tensor, const float *score_sum_tensor,
+                              int grid_h, int grid_w, int stride, int dfl_len, const int *classes, int num_classes,
+                              yolov8_candidates *out, float threshold);
+
+// 录制的输出张量文件（供离线基准回放，读写见 yolov8_tensor.h）：
+//   yolov8_tensor_file_header，随后 n_outputs 组 (yolov8_tensor_record, size 字节数据)
+// 版本 1 的记录没有 layout / c2 / w_stride 三个字段（均为 NCHW）
+#define YOLOV8_TENSOR_FILE_MAGIC "YV8T"
+#define YOLOV8_TENSOR_FILE_VERSION 2
+
+enum yolov8_tensor_record_type {
+    YOLOV8_TENSOR_INT8 = 0,
+    YOLOV8_TENSOR_UINT8 = 1,
+    YOLOV8_TENSOR_FLOAT32 = 2,
+};
+
+// 张量内存布局。NPU 原生输出为 NC1HWC2：通道按 c2 个一组，组内通道连续存放，
+//   元素 (c, y, x) 位于 ((c / c2) * H * w_stride + y * w_stride + x) * c2 + c % c2
+// NHWC 即 c2 = C 的 NC1HWC2（只有一组），按同一布局处理
+enum yolov8_tensor_layout {
+    YOLOV8_LAYOUT_NCHW = 0,
+    YOLOV8_LAYOUT_NC1HWC2 = 1,
+};
+
+// 输出张量视图：数据归后端所有，下一次推理前有效
+typedef struct {
+    const void *data;
+    uint32_t type;      // yolov8_tensor_record_type
+    uint32_t layout;    // yolov8_tensor_layout
+    int32_t zp;
+    float scale;
+    uint32_t dims[4];   // 逻辑形状 NCHW（与布局无关）
+    uint32_t c2;        // NC1HWC2 每组通道数；NCHW 时为 0
+    uint32_t w_stride;  // 每行格子数（>= W）
+    uint32_t size;      // 数据字节数
+} yolov8_tensor_view;
+
+// 原生布局（NC1HWC2 / NHWC）int8 单分支解码：每个格子的类别分数按组连续，
+// 无需转置为 NCHW；输出与 yolov8_decode_branch_i8 对同一张量的 NCHW 排布逐位一致
+int yolov8_decode_branch_native_i8(const yolov8_tensor_view *box, const yolov8_tensor_view *score,
+                                   const yolov8_tensor_view *score_sum, int stride, int dfl_len,
+                                   const int *classes, int num_classes, yolov8_candidates *out, float threshold);
+
+// 解码全部输出（每分支 box、score[、score_sum]，共 3 个分支），按各视图的布局与类型分派，
+// 候选追加到 out；返回候选总数，布局/类型组合不支持时返回 -1
+int yolov8_decode_outputs(const yolov8_tensor_view *views, int n_outputs, int model_height,
+                          const int *classes, int num_classes, yolov8_candidates *out, float threshold);
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t n_outputs;
+    uint32_t model_width;
+    uint32_t model_height;
+} yolov8_tensor_file_header;
+
+typedef struct {
+    uint32_t type;      // yolov8_tensor_record_type
+    int32_t zp;
+    float scale;
+    uint32_t dims[4];   // NCHW
+    uint32_t size;      // 数据字节数
+    uint32_t layout;    // yolov8_tensor_layout（版本 2 起）
+    uint32_t c2;
+    uint32_t w_stride;
+} yolov8_tensor_record;
+
+#endif // _RKNN_YOLOV8_DECODE_H_
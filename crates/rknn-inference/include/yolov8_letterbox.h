@@ -0,0 +1,25 @@
+#ifndef _RKNN_YOLOV8_LETTERBOX_H_
+#define _RKNN_YOLOV8_LETTERBOX_H_
+
+// 无 RGA 时的 letterbox：定点双线性缩放 + 边框填充，一趟写完目标图（不依赖 rknn_api.h / RGA）
+//
+// 原 CPU 路径先 memset 整张目标图，再逐像素、逐通道做浮点双线性（边缘判断在最内层）。
+// 这里每列的源坐标与权重预先算好（7 位定点），每个源行只做一次水平插值并缓存两行，
+// 垂直插值用 NEON/SSE2 一次处理 16 个字节；填充色只写缩放区域以外的边框。
+// 与原浮点实现相比每个通道最多差 1~2 个灰阶（原实现截断取整，这里四舍五入）。
+
+#include <stdint.h>
+
+#define YOLOV8_LETTERBOX_COEF_BITS 7
+
+// 把源图 [crop_x, crop_x + crop_w) x [crop_y, crop_y + crop_h) 缩放到目标图
+// [box_x, box_x + box_w) x [box_y, box_y + box_h)，目标图其余部分填 pad。
+// channels 为 1/3/4（GRAY8/RGB888/RGBA8888），stride 为每行字节数。
+// 坐标映射与原实现相同：src = crop + dst_offset * (crop_w / box_w)。
+// 列表与行缓冲按线程复用，尺寸不变时不分配内存。参数非法返回 -1
+int yolov8_letterbox_resize(const uint8_t *src, int src_w, int src_h, int src_stride,
+                            int crop_x, int crop_y, int crop_w, int crop_h, int channels,
+                            uint8_t *dst, int dst_w, int dst_h, int dst_stride,
+                            int box_x, int box_y, int box_w, int box_h, uint8_t pad);
+
+#endif // _RKNN_YOLOV8_LETTERBOX_H_
@@ -0,0 +1,26 @@
+#ifndef _RKNN_YOLOV8_MODEL_H_
+#define _RKNN_YOLOV8_MODEL_H_
+
+// 模型文件映射缓存（不依赖 rknn_api.h）
+//
+// 原来每个上下文都用 read_data_from_file 把整个 .rknn 读进 malloc 的缓冲再交给 rknn_init，
+// 6 个工作线程就要读 6 遍、拷 6 份。这里按路径 mmap 一次，同时初始化的上下文共享同一份映射
+// （MAP_PRIVATE，rknn_init 若写入也只影响进程内的私有页），最后一个使用者释放时 munmap。
+// rknn_init 会把模型拷进驱动内存，所以 init 返回后即可释放。
+
+#include <stddef.h>
+
+typedef struct {
+    void *data;
+    size_t size;
+} yolov8_model_blob;
+
+// 映射 path（已映射时共享并增加引用计数），成功返回 0；
+// mapped_now 非空时返回本次是否真的打开并映射了文件（未命中缓存）
+int yolov8_model_acquire(const char *path, yolov8_model_blob *blob, bool *mapped_now);
+// 释放一次引用，引用计数归零时 munmap
+void yolov8_model_release(const char *path);
+// 当前缓存中的映射数（测试/诊断用）
+int yolov8_model_cached_count();
+
+#endif // _RKNN_YOLOV8_MODEL_H_
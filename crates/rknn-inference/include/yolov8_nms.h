@@ -0,0 +1,49 @@
+#ifndef _RKNN_YOLOV8_NMS_H_
+#define _RKNN_YOLOV8_NMS_H_
+
+// 候选框非极大值抑制（不依赖 rknn_api.h，可在 x86 上编译测试与基准）
+//
+// 候选按类别分桶（计数排序），桶内按 (score 降序, 候选下标升序) 排序——
+// 大桶先 partial_sort 取前若干名，不够再排剩余部分；
+// 抑制阶段只和已保留框比较（SoA 布局），命中第一个 IoU > 阈值即提前退出。
+// 每类最多保留 max_detections 个，最后按同样的次序合并截断。
+//
+// 与原 quick_sort_indice_inverse + 逐类 nms() 的结果一致；
+// 原快排对同分候选的次序不确定，这里固定为下标升序。
+
+#include <stdint.h>
+#include <vector>
+
+typedef struct {
+    float nms_threshold;
+    int max_detections;
+    // 非 0：坐标按类别平移到互不重叠的区域后整体排序一次、单趟抑制。
+    // 少了分桶开销，但大坐标下 IoU 舍入可能与逐类模式有细微差异
+    int class_batched;
+} yolov8_nms_config;
+
+// 排序与抑制用的工作区，跨调用复用可避免重复分配。
+// yolov8_nms 开头按候选数与类别范围一次性扩容，之后不再分配；
+// allocations 累计扩容次数，稳态下应保持不变
+typedef struct {
+    std::vector<int> order;
+    std::vector<int> bucket_start;
+    std::vector<int> kept;
+    std::vector<float> x1, y1, x2, y2;
+    std::vector<double> area;
+    uint64_t allocations = 0;
+} yolov8_nms_scratch;
+
+// 预留 count 个候选、n_classes 个类别桶的容量
+void yolov8_nms_reserve(yolov8_nms_scratch *scratch, int count, int n_classes);
+
+// 与原实现一致的 IoU（含 +1 像素约定）
+float yolov8_box_iou(float xmin0, float ymin0, float xmax0, float ymax0,
+                     float xmin1, float ymin1, float xmax1, float ymax1);
+
+// boxes 为 (x, y, w, h) 连续排列；keep 接收保留的候选下标（按输出次序），返回保留个数。
+// scratch 可为空（内部临时分配）
+int yolov8_nms(const float *boxes, const float *scores, const int *class_ids, int count,
+               const yolov8_nms_config *config, int *keep, yolov8_nms_scratch *scratch);
+
+#endif // _RKNN_YOLOV8_NMS_H_
@@ -0,0 +1,68 @@
+#ifndef _RKNN_YOLOV8_STATS_H_
+#define _RKNN_YOLOV8_STATS_H_
+
+// 推理统计：每个 rknn_app_context_t 一份，在 init 时创建，release 时释放
+//
+// 热路径只做计数与直方图累加（不打印、不分配），由调用方随时取快照。
+// 各阶段耗时按微秒记入以 2 为底的直方图：桶 0 为 0us，桶 i（i >= 1）为 [2^(i-1), 2^i) us，
+// 最后一个桶兜底所有更长的耗时，分位数按桶上界估计。
+// 统计内部带锁：推理线程记录的同时可以在其他线程取快照或清零。
+
+#include <stdint.h>
+
+#define YOLOV8_STATS_BUCKETS 20
+
+// 统计的阶段（Rust 侧 InferenceStage 与之一一对应）
+typedef enum {
+    YOLOV8_STAGE_PREPROCESS = 0, // letterbox 写入输入缓冲
+    YOLOV8_STAGE_RUN = 1,        // 拷贝输入 + rknn_run
+    YOLOV8_STAGE_OUTPUTS = 2,    // 取输出（拷贝后端的 rknn_outputs_get，zero copy 只有视图）
+    YOLOV8_STAGE_DECODE = 3,     // 解码候选框
+    YOLOV8_STAGE_NMS = 4,        // NMS 与结果换算
+    YOLOV8_STAGE_COUNT = 5,
+} yolov8_stage;
+
+// 单阶段耗时（纯 C 布局，Rust 侧 StageStats 与之一一对应）
+typedef struct {
+    uint64_t count;
+    uint64_t total_us;
+    uint64_t max_us;
+    uint64_t last_us;
+    uint64_t buckets[YOLOV8_STATS_BUCKETS];
+} yolov8_stage_stats;
+
+// 一个上下文的统计快照（纯 C 布局，Rust 侧 InferenceStats 与之一一对应）
+typedef struct {
+    yolov8_stage_stats stages[YOLOV8_STAGE_COUNT];
+    uint64_t frames;             // 完成后处理的帧数
+    uint64_t errors;             // 失败次数（推理、取输出、后处理）
+    uint64_t candidates_total;   // 解码得到的候选数累计（NMS 之前）
+    uint64_t candidates_max;
+    uint64_t candidates_last;
+    uint64_t candidates_dropped; // 超出候选缓冲容量被丢弃的累计数
+    uint64_t detections_total;   // NMS 之后输出的检测数累计
+    uint64_t detections_last;
+} yolov8_inference_stats;
+
+struct yolov8_stats;
+
+yolov8_stats *yolov8_stats_create();
+void yolov8_stats_destroy(yolov8_stats *stats);
+
+// 单调时钟（微秒），阶段计时统一用它
+uint64_t yolov8_stats_now_us();
+
+// 耗时对应的直方图桶
+int yolov8_stats_bucket(uint64_t us);
+
+// 以下记录函数 stats 为 NULL 时什么也不做
+void yolov8_stats_record_stage(yolov8_stats *stats, int stage, uint64_t us);
+// 一帧后处理完成：candidates / dropped 为解码结果，detections 为 NMS 后的检测数
+void yolov8_stats_record_frame(yolov8_stats *stats, int candidates, int dropped, int detections);
+void yolov8_stats_record_error(yolov8_stats *stats);
+
+// 取快照（stats 为 NULL 时输出全 0）；清零所有计数
+void yolov8_stats_snapshot(yolov8_stats *stats, yolov8_inference_stats *out);
+void yolov8_stats_reset(yolov8_stats *stats);
+
+#endif // _RKNN_YOLOV8_STATS_H_
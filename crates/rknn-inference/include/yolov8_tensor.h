@@ -0,0 +1,62 @@
+#ifndef _RKNN_YOLOV8_TENSOR_H_
+#define _RKNN_YOLOV8_TENSOR_H_
+
+// 推理后端的张量内存抽象（不依赖 rknn_api.h，可在 x86 上编译测试与基准）
+//
+// 后端管理模型输入缓冲与输出张量的内存：预处理把 letterbox 结果直接写进 input()，
+// run() 之后 outputs() 给出各输出的视图（yolov8_tensor_view），后处理按视图的布局与类型解码。
+//   - rknn 拷贝后端（yolov8.h）：run() 为 rknn_inputs_set + rknn_run，outputs() 时 rknn_outputs_get，输出为 NCHW
+//   - rknn zero copy 后端（yolov8.h）：rknn_create_mem + rknn_set_io_mem，输入输出常驻 NPU 内存，输出为原生布局
+//   - 主机回放后端（本文件）：输出来自录制的 .yv8t，可重排为原生布局，在没有 NPU 的机器上测试与基准
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "yolov8_decode.h"
+
+struct yolov8_tensor_backend {
+    virtual ~yolov8_tensor_backend() {}
+    virtual const char *name() const = 0;
+    // 模型输入缓冲（NHWC uint8，模型输入尺寸），size 为字节数；后端存续期间地址不变
+    virtual uint8_t *input(int *size) = 0;
+    // 推理一帧；上一帧 outputs() 给出的视图随之失效
+    virtual int run() = 0;
+    // 最近一次 run() 的输出视图，返回输出个数；未 run 或 max_views 不够时返回 -1。
+    // 拷贝后端在本帧第一次调用时才 rknn_outputs_get，之后返回同一组视图
+    virtual int outputs(yolov8_tensor_view *views, int max_views) = 0;
+    // 归还本帧输出（拷贝后端释放 rknn_outputs_get 的缓冲，zero copy 无操作）
+    virtual void release_outputs() {}
+};
+
+// 一帧输出张量：记录（形状、布局、量化参数）与数据分开存放，拷贝安全
+struct yolov8_tensor_frame {
+    uint32_t model_width = 0;
+    uint32_t model_height = 0;
+    std::vector<yolov8_tensor_record> records;
+    std::vector<std::vector<uint8_t> > data;
+};
+
+// 视图 <-> 记录；视图的 data 指向 frame 内部存储，frame 修改或销毁后失效
+void yolov8_tensor_view_to_record(const yolov8_tensor_view *view, yolov8_tensor_record *record);
+void yolov8_tensor_frame_views(const yolov8_tensor_frame *frame, yolov8_tensor_view *views);
+
+// 按布局、形状与 w_stride 计算的最小数据字节数（回放时据此校验文件，防止越界读）
+uint32_t yolov8_tensor_required_size(const yolov8_tensor_record *record);
+
+// 写/读 .yv8t（读兼容版本 1），成功返回 0
+int yolov8_tensor_file_write(const char *path, const yolov8_tensor_view *views, int n_outputs, int model_width,
+                             int model_height);
+int yolov8_tensor_file_read(const char *path, yolov8_tensor_frame *frame);
+
+// 重排到 layout（NC1HWC2 时每组 c2 个通道，末组不足部分补 0；w_stride 取 W），成功返回 0
+int yolov8_tensor_frame_repack(const yolov8_tensor_frame *src, uint32_t layout, uint32_t c2, yolov8_tensor_frame *dst);
+
+// 主机回放后端：每次 run() 切换到下一帧（循环回放）。
+// copy_outputs 为真时模拟 rknn_outputs_get，每帧把输出拷进后端自己的缓冲；
+// 否则视图直接指向帧数据，与 zero copy 后端一样没有逐帧拷贝
+yolov8_tensor_backend *yolov8_host_backend_create(const std::vector<yolov8_tensor_frame> &frames, int input_size,
+                                                  bool copy_outputs);
+void yolov8_tensor_backend_destroy(yolov8_tensor_backend *backend);
+
+#endif // _RKNN_YOLOV8_TENSOR_H_
@@ -1,4 +1,4 @@
-use crate::types::{DetectionResult, ImageRect};
+use crate::types::{DetectionResult, ImageRect, InferenceStats};
 
 // RKNN API types (opaque pointer)
 pub type RknnContext = usize;
@@ -44,6 +44,12 @@ pub struct RknnAppContext {
     pub model_width: i32,
     pub model_height: i32,
     pub is_quant: bool,
+    /// 后处理工作区（C++ 侧 yolov8_postprocess_arena，由 init/release 管理）
+    pub post_arena: *mut libc::c_void,
+    /// 输入/输出张量后端（C++ 侧 yolov8_tensor_backend，拷贝或 zero copy，由 init/release 管理）
+    pub backend: *mut libc::c_void,
+    /// 推理统计（C++ 侧 yolov8_stats，由 init/release 管理，内部带锁）
+    pub stats: *mut libc::c_void,
 }
 
 impl Default for RknnAppContext {
@@ -57,6 +63,9 @@ impl Default for RknnAppContext {
             model_width: 0,
             model_height: 0,
             is_quant: false,
+            post_arena: std::ptr::null_mut(),
+            backend: std::ptr::null_mut(),
+            stats: std::ptr::null_mut(),
         }
     }
 }
@@ -190,11 +199,55 @@ impl std::ops::DerefMut for FfiImageBuffer {
     }
 }
 
+/// 后处理配置，对应 C++ 侧 yolov8_postprocess_config
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct RknnPostprocessConfig {
+    pub conf_threshold: f32,
+    pub nms_threshold: f32,
+    pub max_detections: i32,
+    pub class_mask: [u64; crate::types::MAX_CLASSES / 64],
+}
+
+impl RknnPostprocessConfig {
+    pub fn from_config(config: &crate::types::PostprocessConfig) -> crate::Result<Self> {
+        config.validate()?;
+        Ok(Self {
+            conf_threshold: config.conf_threshold,
+            nms_threshold: config.nms_threshold,
+            max_detections: config.max_detections.min(OBJ_NUMB_MAX_SIZE) as i32,
+            class_mask: config.class_mask()?,
+        })
+    }
+}
+
+/// 初始化各阶段耗时，对应 C++ 侧 yolov8_init_timing
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct RknnInitTiming {
+    pub load_ms: f64,
+    pub init_ms: f64,
+    pub query_ms: f64,
+    pub setup_ms: f64,
+    pub duplicated: i32,
+}
+
 // External C functions
 extern "C" {
     pub fn init_yolov8_model_wrapper(model_path: *const libc::c_char, app_ctx: *mut RknnAppContext)
         -> i32;
 
+    pub fn yolov8_init_model_ex_wrapper(
+        model_path: *const libc::c_char,
+        src: *const RknnAppContext,
+        app_ctx: *mut RknnAppContext,
+        timing: *mut RknnInitTiming,
+    ) -> i32;
+
+    pub fn yolov8_model_acquire_wrapper(model_path: *const libc::c_char) -> i32;
+
+    pub fn yolov8_model_release_wrapper(model_path: *const libc::c_char);
+
     pub fn release_yolov8_model_wrapper(app_ctx: *mut RknnAppContext) -> i32;
 
     pub fn inference_yolov8_model_wrapper(
@@ -203,12 +256,27 @@ extern "C" {
         od_results: *mut ObjectDetectResultList,
     ) -> i32;
 
+    pub fn yolov8_set_npu_core_wrapper(app_ctx: *mut RknnAppContext, core: i32) -> i32;
+
     pub fn init_post_process_wrapper() -> i32;
 
     pub fn deinit_post_process_wrapper();
 
     pub fn coco_cls_to_name_wrapper(cls_id: i32) -> *const libc::c_char;
 
+    pub fn post_process_allocation_count_wrapper(app_ctx: *mut RknnAppContext) -> u64;
+
+    pub fn set_post_process_config_wrapper(
+        app_ctx: *mut RknnAppContext,
+        config: *const RknnPostprocessConfig,
+    ) -> i32;
+
+    pub fn post_process_num_classes_wrapper(app_ctx: *mut RknnAppContext) -> i32;
+
+    pub fn yolov8_stats_snapshot_wrapper(stats: *mut libc::c_void, out: *mut InferenceStats);
+
+    pub fn yolov8_stats_reset_wrapper(stats: *mut libc::c_void);
+
     // Separate step functions for benchmarking
     pub fn yolov8_preprocess_wrapper(
         app_ctx: *mut RknnAppContext,
@@ -281,6 +349,26 @@ pub unsafe fn init_yolov8_model(model_path: *const libc::c_char, app_ctx: *mut R
     init_yolov8_model_wrapper(model_path, app_ctx)
 }
 
+#[inline]
+pub unsafe fn yolov8_init_model_ex(
+    model_path: *const libc::c_char,
+    src: *const RknnAppContext,
+    app_ctx: *mut RknnAppContext,
+    timing: *mut RknnInitTiming,
+) -> i32 {
+    yolov8_init_model_ex_wrapper(model_path, src, app_ctx, timing)
+}
+
+#[inline]
+pub unsafe fn yolov8_model_acquire(model_path: *const libc::c_char) -> i32 {
+    yolov8_model_acquire_wrapper(model_path)
+}
+
+#[inline]
+pub unsafe fn yolov8_model_release(model_path: *const libc::c_char) {
+    yolov8_model_release_wrapper(model_path)
+}
+
 #[inline]
 pub unsafe fn release_yolov8_model(app_ctx: *mut RknnAppContext) -> i32 {
     release_yolov8_model_wrapper(app_ctx)
@@ -295,6 +383,11 @@ pub unsafe fn inference_yolov8_model(
     inference_yolov8_model_wrapper(app_ctx, img, od_results)
 }
 
+#[inline]
+pub unsafe fn yolov8_set_npu_core(app_ctx: *mut RknnAppContext, core: i32) -> i32 {
+    yolov8_set_npu_core_wrapper(app_ctx, core)
+}
+
 #[inline]
 pub unsafe fn init_post_process() -> i32 {
     init_post_process_wrapper()
@@ -310,6 +403,34 @@ pub unsafe fn coco_cls_to_name(cls_id: i32) -> *const libc::c_char {
     coco_cls_to_name_wrapper(cls_id)
 }
 
+#[inline]
+pub unsafe fn post_process_allocation_count(app_ctx: *mut RknnAppContext) -> u64 {
+    post_process_allocation_count_wrapper(app_ctx)
+}
+
+#[inline]
+pub unsafe fn set_post_process_config(
+    app_ctx: *mut RknnAppContext,
+    config: *const RknnPostprocessConfig,
+) -> i32 {
+    set_post_process_config_wrapper(app_ctx, config)
+}
+
+#[inline]
+pub unsafe fn post_process_num_classes(app_ctx: *mut RknnAppContext) -> i32 {
+    post_process_num_classes_wrapper(app_ctx)
+}
+
+#[inline]
+pub unsafe fn yolov8_stats_snapshot(stats: *mut libc::c_void, out: *mut InferenceStats) {
+    yolov8_stats_snapshot_wrapper(stats, out)
+}
+
+#[inline]
+pub unsafe fn yolov8_stats_reset(stats: *mut libc::c_void) {
+    yolov8_stats_reset_wrapper(stats)
+}
+
 // Separate step wrappers for benchmarking
 #[inline]
 pub unsafe fn yolov8_preprocess(
@@ -85,6 +85,8 @@
 //! - 对于实时应用，推荐使用6个工作线程以获得最佳并发效率
 //! - 预处理在主线程进行，避免RGA多线程冲突
 //! - 可以持续输入图像，按需获取检测结果，最大化NPU利用率
+//! - 多核 NPU（RK3588）上推荐`PipelinedInferenceService`：预处理、NPU 运行、后处理三级流水，
+//!   每个上下文固定到一个 NPU 核心，见 [`pipeline`]
 
 pub mod ffi;
 mod error;
@@ -92,6 +94,9 @@ mod types;
 pub mod service;
 pub mod simple_service;
 pub mod multi_detector_service;
+pub mod pipeline;
+pub mod pipeline_service;
+pub mod tiling;
 
 pub use error::{RknnError, Result};
 pub use types::*;
@@ -99,13 +104,28 @@ pub use service::{InferenceService};
 pub use simple_service::{SimpleInferenceService};
 pub use multi_detector_service::{MultiDetectorInferenceService, ImagePreprocessor};
 pub use multi_detector_service::ServiceStats;
+pub use pipeline::{PipelineConfig, PipelineScheduler, PipelineStats, StageRunner};
+pub use pipeline_service::{
+    PipelineServiceConfig, PipelinedInferenceService, PreparedTile, RknnStageRunner, StartupReport, TileJob,
+};
+pub use tiling::{DetectionMode, FrameRect, TilingConfig};
 
 use std::ffi::CString;
 use std::path::Path;
+use std::time::Instant;
 
 /// YOLOv8 detection model context
 pub struct Yolov8Detector {
     ctx: ffi::RknnAppContext,
+    /// 分步推理的输出句柄（每个输出一个，指向后端内存）
+    outputs: Vec<ffi::RknnOutput>,
+    /// run_model_input / run_letterboxed 之后、postprocess_outputs 之前为真
+    outputs_pending: bool,
+    /// C 侧 letterbox 的偏移与 [`tiling::LetterboxGeometry`] 约定偏移之差，后处理时加到检测框上
+    box_shift: (i32, i32),
+    /// 模型路径（复制上下文失败时据此重新加载）
+    model_path: CString,
+    init_timing: InitTiming,
 }
 
 /// Get COCO class name from class ID
@@ -126,25 +146,105 @@ impl Yolov8Detector {
         let path_str = model_path.as_ref().to_str()
             .ok_or(RknnError::InvalidPath)?;
         let c_path = CString::new(path_str)?;
+        Self::init(c_path, None)
+    }
 
+    /// 从模型文件加载，或在 src 非空时复制 src 的上下文（C 侧不支持复制时退回加载）
+    fn init(model_path: CString, src: Option<&ffi::RknnAppContext>) -> Result<Self> {
         let mut ctx = ffi::RknnAppContext::default();
+        let mut timing = ffi::RknnInitTiming::default();
+        let src_ptr = src.map_or(std::ptr::null(), |c| c as *const _);
 
         unsafe {
-            let ret = ffi::init_yolov8_model(c_path.as_ptr(), &mut ctx as *mut _);
+            let ret = ffi::yolov8_init_model_ex(model_path.as_ptr(), src_ptr, &mut ctx as *mut _, &mut timing as *mut _);
             if ret < 0 {
                 return Err(RknnError::InitFailed(ret));
             }
         }
 
-        // Initialize post-processing
+        // Initialize post-processing（类别名全进程共享，只有第一个实例读文件）
+        let labels_start = Instant::now();
         unsafe {
             let ret = ffi::init_post_process();
             if ret < 0 {
+                ffi::release_yolov8_model(&mut ctx as *mut _);
                 return Err(RknnError::PostProcessInitFailed(ret));
             }
         }
 
-        Ok(Self { ctx })
+        let init_timing = InitTiming {
+            load_ms: timing.load_ms,
+            init_ms: timing.init_ms,
+            query_ms: timing.query_ms,
+            setup_ms: timing.setup_ms,
+            labels_ms: labels_start.elapsed().as_secs_f64() * 1000.0,
+            duplicated: timing.duplicated != 0,
+        };
+        let outputs = (0..ctx.io_num.n_output).map(|_| ffi::RknnOutput::default()).collect();
+        Ok(Self { ctx, outputs, outputs_pending: false, box_shift: (0, 0), model_path, init_timing })
+    }
+
+    /// 复制一个检测器：平台支持时用 rknn_dup_context 共享权重，跳过模型加载与属性查询；
+    /// 不支持（RKNPU1 / RV1106）或复制失败时从同一个模型文件重新加载。
+    ///
+    /// 新实例有自己的输入输出内存与后处理工作区，后处理配置取默认值，NPU 核心需另行绑定。
+    /// 可以从多个线程同时复制同一个检测器（复制调用在 C 侧串行）。
+    pub fn duplicate(&self) -> Result<Self> {
+        Self::init(self.model_path.clone(), Some(&self.ctx))
+    }
+
+    /// 复制检测器并应用后处理配置
+    pub fn duplicate_with_config(&self, config: &PostprocessConfig) -> Result<Self> {
+        let mut detector = self.duplicate()?;
+        detector.set_postprocess_config(config)?;
+        Ok(detector)
+    }
+
+    /// 初始化各阶段耗时
+    pub fn init_timing(&self) -> InitTiming {
+        self.init_timing
+    }
+
+    /// 推理统计快照：各阶段耗时直方图、候选数与检测数（C 侧统计带锁，可与推理并发读取）
+    pub fn stats(&self) -> InferenceStats {
+        self.stats_handle().snapshot()
+    }
+
+    /// 清零推理统计
+    pub fn reset_stats(&self) {
+        self.stats_handle().reset()
+    }
+
+    /// 统计句柄，供流水线在推理线程之外汇总；只在检测器存续期间有效
+    pub(crate) fn stats_handle(&self) -> StatsHandle {
+        StatsHandle { ptr: self.ctx.stats }
+    }
+
+    /// 创建检测器并应用后处理配置
+    pub fn new_with_config<P: AsRef<Path>>(model_path: P, config: &PostprocessConfig) -> Result<Self> {
+        let mut detector = Self::new(model_path)?;
+        detector.set_postprocess_config(config)?;
+        Ok(detector)
+    }
+
+    /// 更新后处理配置（阈值、类别过滤、最大检测数），对之后的推理生效
+    ///
+    /// 配置非法（阈值越界、类别超出位图范围或模型内没有任何允许的类别）时返回错误，原配置保持不变。
+    pub fn set_postprocess_config(&mut self, config: &PostprocessConfig) -> Result<()> {
+        let ffi_config = ffi::RknnPostprocessConfig::from_config(config)?;
+        let ret = unsafe { ffi::set_post_process_config(&mut self.ctx as *mut _, &ffi_config as *const _) };
+        if ret < 0 {
+            return Err(RknnError::InvalidInput(format!(
+                "postprocess config rejected for a {}-class model",
+                self.num_classes()
+            )));
+        }
+        Ok(())
+    }
+
+    /// 模型输出的类别数（由 score 输出张量形状推导）
+    pub fn num_classes(&mut self) -> i32 {
+        unsafe { ffi::post_process_num_classes(&mut self.ctx as *mut _) }
     }
 
     /// Run inference on an image
@@ -167,15 +267,169 @@ impl Yolov8Detector {
         Ok(od_results.to_detection_results())
     }
 
+    /// 把检测器固定到一个 NPU 核心（`None` 交给驱动调度）
+    ///
+    /// 流水线调度器按核心分配上下文时使用；单核平台（RKNPU1 / RV1106）只接受 `None`。
+    pub fn set_npu_core(&mut self, core: Option<u32>) -> Result<()> {
+        let core = core.map(|c| c as i32).unwrap_or(-1);
+        let ret = unsafe { ffi::yolov8_set_npu_core(&mut self.ctx as *mut _, core) };
+        if ret < 0 {
+            return Err(RknnError::InvalidInput(format!("cannot bind NPU core {}", core)));
+        }
+        Ok(())
+    }
+
+    /// 分步推理的 NPU 阶段：运行一帧已 letterbox 到模型尺寸的 RGB888 图像
+    ///
+    /// 输入拷进后端的常驻输入缓冲后运行，输出留在后端里；
+    /// 必须先用 [`Self::postprocess_outputs`] 取走，才能再次运行。
+    pub fn run_model_input(&mut self, input: &ImageBuffer) -> Result<()> {
+        if self.outputs_pending {
+            return Err(RknnError::InvalidInput("outputs of the previous run not postprocessed".to_string()));
+        }
+        let (width, height) = self.model_size();
+        if input.format != ImageFormat::Rgb888
+            || input.width as u32 != width
+            || input.height as u32 != height
+            || input.data.len() < (width * height * 3) as usize
+        {
+            return Err(RknnError::InvalidImageFormat);
+        }
+
+        // C 侧只读输入（拷进后端缓冲），直接借用数据
+        let mut img = ffi::CImageBuffer {
+            width: input.width,
+            height: input.height,
+            width_stride: input.width,
+            height_stride: input.height,
+            format: input.format as i32,
+            virt_addr: input.data.as_ptr() as *mut u8,
+            size: input.data.len() as i32,
+            fd: -1,
+        };
+        let ret = unsafe { ffi::yolov8_inference(&mut self.ctx as *mut _, &mut img as *mut _, self.outputs.as_mut_ptr()) };
+        if ret < 0 {
+            return Err(RknnError::InferenceFailed(ret));
+        }
+        self.box_shift = (0, 0);
+        self.outputs_pending = true;
+        Ok(())
+    }
+
+    /// 分步推理的 NPU 阶段：把任意尺寸的 RGB888 图像 letterbox 进后端的输入缓冲后运行
+    ///
+    /// letterbox 在 C 侧完成（有 RGA 时用 RGA，否则为定点 SIMD 内核），直接写进上下文的常驻输入缓冲
+    /// （zero copy 时即 NPU 的输入内存），没有 Rust 侧的中间图像，也没有 [`Self::run_model_input`] 的整帧拷贝。
+    /// 检测框与 [`Self::run_model_input`] 一样是模型输入坐标（[`ImagePreprocessor`] 的居中等比约定）；
+    /// C 侧为对齐微调的偏移在后处理时换算回来。
+    pub fn run_letterboxed(&mut self, image: &ImageBuffer) -> Result<()> {
+        if self.outputs_pending {
+            return Err(RknnError::InvalidInput("outputs of the previous run not postprocessed".to_string()));
+        }
+        if image.format != ImageFormat::Rgb888
+            || image.width <= 0
+            || image.height <= 0
+            || image.data.len() < (image.width * image.height * 3) as usize
+        {
+            return Err(RknnError::InvalidImageFormat);
+        }
+
+        // C 侧只读源图，直接借用数据；dst 由 yolov8_preprocess 指向后端输入缓冲
+        let mut src = ffi::CImageBuffer {
+            width: image.width,
+            height: image.height,
+            width_stride: image.width,
+            height_stride: image.height,
+            format: image.format as i32,
+            virt_addr: image.data.as_ptr() as *mut u8,
+            size: image.data.len() as i32,
+            fd: -1,
+        };
+        let mut dst = ffi::CImageBuffer {
+            width: 0,
+            height: 0,
+            width_stride: 0,
+            height_stride: 0,
+            format: 0,
+            virt_addr: std::ptr::null_mut(),
+            size: 0,
+            fd: -1,
+        };
+        let mut letter_box = ffi::LetterBox::default();
+        let ctx = &mut self.ctx as *mut _;
+        let ret = unsafe { ffi::yolov8_preprocess(ctx, &mut src as *mut _, &mut dst as *mut _, &mut letter_box as *mut _) };
+        if ret < 0 {
+            return Err(RknnError::InferenceFailed(ret));
+        }
+        // dst 已是后端输入缓冲，yolov8_inference 不再拷贝
+        let ret = unsafe { ffi::yolov8_inference(ctx, &mut dst as *mut _, self.outputs.as_mut_ptr()) };
+        if ret < 0 {
+            return Err(RknnError::InferenceFailed(ret));
+        }
+
+        let (model_width, model_height) = self.model_size();
+        let nominal = tiling::LetterboxGeometry::new(image.width as u32, image.height as u32, model_width, model_height);
+        self.box_shift = (nominal.x_offset as i32 - letter_box.x_pad, nominal.y_offset as i32 - letter_box.y_pad);
+        self.outputs_pending = true;
+        Ok(())
+    }
+
+    /// 分步推理的后处理阶段：解码上一次 [`Self::run_model_input`] / [`Self::run_letterboxed`] 的输出并归还输出缓冲
+    ///
+    /// 检测框为模型输入坐标系。
+    pub fn postprocess_outputs(&mut self) -> Result<Vec<DetectionResult>> {
+        if !self.outputs_pending {
+            return Err(RknnError::InvalidInput("no outputs to postprocess".to_string()));
+        }
+        let mut letter_box = ffi::LetterBox::default();
+        let mut od_results = ffi::ObjectDetectResultList::default();
+        let ret = unsafe {
+            let ret = ffi::yolov8_postprocess(
+                &mut self.ctx as *mut _,
+                self.outputs.as_mut_ptr(),
+                &mut letter_box as *mut _,
+                &mut od_results as *mut _,
+            );
+            ffi::yolov8_release_outputs(&mut self.ctx as *mut _, self.outputs.as_mut_ptr());
+            ret
+        };
+        self.outputs_pending = false;
+        if ret < 0 {
+            return Err(RknnError::InferenceFailed(ret));
+        }
+        let mut detections = od_results.to_detection_results();
+        let (dx, dy) = self.box_shift;
+        if dx != 0 || dy != 0 {
+            for d in &mut detections {
+                d.bbox.left += dx;
+                d.bbox.right += dx;
+                d.bbox.top += dy;
+                d.bbox.bottom += dy;
+            }
+        }
+        Ok(detections)
+    }
+
     /// Get model input dimensions
     pub fn model_size(&self) -> (u32, u32) {
         (self.ctx.model_width as u32, self.ctx.model_height as u32)
     }
+
+    /// 后处理累计堆分配次数（工作区创建时的分配 + NMS 扩容）
+    ///
+    /// 工作区在模型初始化时按输出形状一次性分配，稳态推理下该值应保持不变。
+    /// 该值由 C 侧在已知的预留点自行累加，不拦截全局分配器，只能发现这些预留点的意外扩容。
+    pub fn postprocess_allocations(&mut self) -> u64 {
+        unsafe { ffi::post_process_allocation_count(&mut self.ctx as *mut _) }
+    }
 }
 
 impl Drop for Yolov8Detector {
     fn drop(&mut self) {
         unsafe {
+            if self.outputs_pending {
+                ffi::yolov8_release_outputs(&mut self.ctx as *mut _, self.outputs.as_mut_ptr());
+            }
             ffi::release_yolov8_model(&mut self.ctx as *mut _);
             ffi::deinit_post_process();
         }
@@ -185,3 +439,53 @@ impl Drop for Yolov8Detector {
 // Thread safety: RKNN context is not thread-safe by default
 // Users should manage thread safety externally if needed
 unsafe impl Send for Yolov8Detector {}
+// 共享引用只能读初始化时确定的字段（模型尺寸、耗时）、读统计（C 侧带锁）或调用 duplicate（C 侧串行复制），
+// 推理等会改动上下文的操作都需要 &mut
+unsafe impl Sync for Yolov8Detector {}
+
+/// 检测器的推理统计（C++ 侧 yolov8_stats）：持有方须保证对应的检测器仍然存续
+#[derive(Clone, Copy)]
+pub(crate) struct StatsHandle {
+    ptr: *mut libc::c_void,
+}
+
+// C 侧统计内部带锁，可从任意线程读取或清零
+unsafe impl Send for StatsHandle {}
+unsafe impl Sync for StatsHandle {}
+
+impl StatsHandle {
+    pub(crate) fn snapshot(&self) -> InferenceStats {
+        let mut stats = InferenceStats::default();
+        unsafe { ffi::yolov8_stats_snapshot(self.ptr, &mut stats as *mut _) };
+        stats
+    }
+
+    pub(crate) fn reset(&self) {
+        unsafe { ffi::yolov8_stats_reset(self.ptr) };
+    }
+}
+
+/// 在作用域内保持模型文件的映射（见 C++ 侧 yolov8_model.h）
+///
+/// 期间从同一路径加载的实例共享这一份映射，不再各自打开、映射文件。
+pub(crate) struct ModelFileGuard {
+    path: CString,
+}
+
+impl ModelFileGuard {
+    pub(crate) fn new<P: AsRef<Path>>(model_path: P) -> Result<Self> {
+        let path_str = model_path.as_ref().to_str().ok_or(RknnError::InvalidPath)?;
+        let path = CString::new(path_str)?;
+        let ret = unsafe { ffi::yolov8_model_acquire(path.as_ptr()) };
+        if ret < 0 {
+            return Err(RknnError::InitFailed(ret));
+        }
+        Ok(Self { path })
+    }
+}
+
+impl Drop for ModelFileGuard {
+    fn drop(&mut self) {
+        unsafe { ffi::yolov8_model_release(self.path.as_ptr()) };
+    }
+}
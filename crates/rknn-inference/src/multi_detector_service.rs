@@ -123,6 +123,25 @@ impl ImagePreprocessor {
     ///
     /// 预处理后的ImageBuffer (640x640 RGB888格式)
     pub fn preprocess(&self, img: &image::RgbImage) -> ImageBuffer {
+        self.letterbox(img)
+    }
+
+    /// 预处理借用的RGB888数据（不复制输入）
+    ///
+    /// `data` 长度不足 `width * height * 3` 时返回 None
+    pub fn preprocess_rgb888(&self, data: &[u8], width: u32, height: u32) -> Option<ImageBuffer> {
+        let len = (width as usize) * (height as usize) * 3;
+        if data.len() < len {
+            return None;
+        }
+        let view = image::ImageBuffer::<image::Rgb<u8>, &[u8]>::from_raw(width, height, &data[..len])?;
+        Some(self.letterbox(&view))
+    }
+
+    fn letterbox<I>(&self, img: &I) -> ImageBuffer
+    where
+        I: image::GenericImageView<Pixel = image::Rgb<u8>>,
+    {
         let (orig_w, orig_h) = (img.width(), img.height());
 
         // 计算缩放比例
@@ -249,6 +268,27 @@ impl MultiDetectorInferenceService {
         num_workers: usize,
         queue_size: usize,
     ) -> Result<Self, crate::RknnError> {
+        Self::new_with_config(model_path, num_workers, queue_size, crate::PostprocessConfig::default())
+    }
+
+    /// 创建新的异步多Detector推理服务，指定队列大小与后处理配置
+    ///
+    /// 配置在启动工作线程前校验，每个工作线程的 detector 创建后应用同一份配置。
+    ///
+    /// # 示例
+    ///
+    /// ```rust
+    /// let config = PostprocessConfig { conf_threshold: 0.4, allowed_classes: vec![0], ..Default::default() };
+    /// let service = MultiDetectorInferenceService::new_with_config("models/yolov8m.rknn", 6, 6, config)?;
+    /// # Ok::<(), Box<dyn std::error::Error>>(())
+    /// ```
+    pub fn new_with_config<P: AsRef<std::path::Path>>(
+        model_path: P,
+        num_workers: usize,
+        queue_size: usize,
+        postprocess_config: crate::PostprocessConfig,
+    ) -> Result<Self, crate::RknnError> {
+        postprocess_config.validate()?;
         let input_queue = Arc::new(Mutex::new(
             std::collections::VecDeque::<AsyncInferenceTask>::new(),
         ));
@@ -272,10 +312,11 @@ impl MultiDetectorInferenceService {
                 .to_path_buf()
                 .to_string_lossy()
                 .to_string();
+            let postprocess_config = postprocess_config.clone();
 
             let handle = thread::spawn(move || {
                 // 每个线程创建自己的独立detector
-                let mut detector = match crate::Yolov8Detector::new(&model_path_owned) {
+                let mut detector = match crate::Yolov8Detector::new_with_config(&model_path_owned, &postprocess_config) {
                     Ok(det) => det,
                     Err(_) => {
                         return;
@@ -0,0 +1,727 @@
+//! 三级流水线推理调度器
+//!
+//! 预处理池 → NPU 运行队列 → 后处理池，三级之间用有界队列衔接：
+//!
+//! - 准入：提交的帧进入有界的准入队列，满时挤掉最旧的等待帧（最新帧优先），提交方从不阻塞。
+//!   一帧可以拆成一组输入（如分块检测的各个图块）一起提交，准入与挤掉都以组为单位，组内序号连续
+//! - 预处理池：若干 CPU 线程取帧预处理，结果放入有界的 NPU 队列；NPU 队列满时阻塞，反压到准入队列
+//! - NPU 运行队列：每个 NPU 核心一个线程，核心上有若干上下文（槽位）。线程先占一个本核心的空闲槽位再取帧运行，
+//!   输出留在槽位的上下文里交给后处理，后处理完成后槽位归还本核心。
+//!   每核心两个槽位时，一个槽位在 NPU 上运行的同时另一个在做后处理
+//! - 后处理池：若干 CPU 线程解码输出
+//! - 按序输出：结果按提交序号重排后发出，准入时被挤掉的序号直接跳过；
+//!   输出队列有界，调用方取得慢时丢弃最旧的结果
+//!
+//! 各阶段的实际工作由 [`StageRunner`] 提供：RKNN 实现见 [`crate::pipeline_service`]，
+//! 单元测试用纯 CPU 的模拟实现验证调度逻辑。
+
+use std::collections::{BTreeMap, VecDeque};
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::{Arc, Condvar, Mutex};
+use std::thread;
+use std::time::{Duration, Instant};
+
+use crate::{Result, RknnError};
+
+/// 流水线各阶段的执行者
+///
+/// `Context` 是 NPU 阶段的上下文（RKNN 中即一个绑定了核心的模型实例）。
+/// 同一个上下文上 `run` 与随后的 `postprocess` 成对调用，中间不会有别的帧使用它。
+pub trait StageRunner: Send + Sync + 'static {
+    type Input: Send + 'static;
+    type Prepared: Send + 'static;
+    type Context: Send + 'static;
+    type Output: Send + 'static;
+
+    /// 预处理（预处理池中并发调用）
+    fn preprocess(&self, input: Self::Input) -> Result<Self::Prepared>;
+    /// 在 ctx 上运行一帧，输出留在 ctx 里（由 ctx 所在核心的线程调用）
+    fn run(&self, ctx: &mut Self::Context, prepared: &Self::Prepared) -> Result<()>;
+    /// 取出 ctx 上一次 run 的输出并解码（后处理池中调用）
+    fn postprocess(&self, ctx: &mut Self::Context, prepared: &Self::Prepared) -> Result<Self::Output>;
+}
+
+/// 流水线配置
+#[derive(Debug, Clone)]
+pub struct PipelineConfig {
+    /// 预处理线程数
+    pub preprocess_workers: usize,
+    /// 后处理线程数
+    pub postprocess_workers: usize,
+    /// 等待预处理的帧（组）数上限，超出时挤掉最旧的帧
+    pub admission_capacity: usize,
+    /// 已发出、尚未被取走的结果数上限，超出时丢弃最旧的结果
+    pub output_capacity: usize,
+}
+
+impl Default for PipelineConfig {
+    fn default() -> Self {
+        Self {
+            preprocess_workers: 2,
+            postprocess_workers: 2,
+            admission_capacity: 2,
+            output_capacity: 8,
+        }
+    }
+}
+
+/// 流水线统计
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct PipelineStats {
+    /// 提交的帧数
+    pub submitted: usize,
+    /// 准入时被新帧挤掉的帧数
+    pub dropped: usize,
+    /// 成功完成的帧数
+    pub completed: usize,
+    /// 某一阶段失败的帧数
+    pub failed: usize,
+    /// 已发出但调用方没来得及取走、被丢弃的结果数
+    pub output_dropped: usize,
+    /// 仍在流水线中的帧数
+    pub in_flight: usize,
+}
+
+struct QueueState<T> {
+    items: VecDeque<T>,
+    closed: bool,
+}
+
+/// 有界队列：push_latest 满时挤掉最旧的元素，push_wait 满时阻塞
+struct BoundedQueue<T> {
+    state: Mutex<QueueState<T>>,
+    not_empty: Condvar,
+    not_full: Condvar,
+    capacity: usize,
+}
+
+impl<T> BoundedQueue<T> {
+    fn new(capacity: usize) -> Self {
+        Self {
+            state: Mutex::new(QueueState { items: VecDeque::with_capacity(capacity), closed: false }),
+            not_empty: Condvar::new(),
+            not_full: Condvar::new(),
+            capacity: capacity.max(1),
+        }
+    }
+
+    /// 入队，满时挤掉并返回最旧的元素
+    fn push_latest(&self, item: T) -> Option<T> {
+        let mut state = self.state.lock().unwrap();
+        let evicted = if state.items.len() >= self.capacity { state.items.pop_front() } else { None };
+        state.items.push_back(item);
+        self.not_empty.notify_one();
+        evicted
+    }
+
+    /// 入队，满时等待；队列已关闭返回 false
+    fn push_wait(&self, item: T) -> bool {
+        let mut state = self.state.lock().unwrap();
+        while !state.closed && state.items.len() >= self.capacity {
+            state = self.not_full.wait(state).unwrap();
+        }
+        if state.closed {
+            return false;
+        }
+        state.items.push_back(item);
+        self.not_empty.notify_one();
+        true
+    }
+
+    /// 出队，空时等待；队列关闭且已取空时返回 None
+    fn pop_wait(&self) -> Option<T> {
+        let mut state = self.state.lock().unwrap();
+        loop {
+            if let Some(item) = state.items.pop_front() {
+                self.not_full.notify_one();
+                return Some(item);
+            }
+            if state.closed {
+                return None;
+            }
+            state = self.not_empty.wait(state).unwrap();
+        }
+    }
+
+    fn pop_timeout(&self, timeout: Duration) -> Option<T> {
+        let deadline = Instant::now() + timeout;
+        let mut state = self.state.lock().unwrap();
+        loop {
+            if let Some(item) = state.items.pop_front() {
+                self.not_full.notify_one();
+                return Some(item);
+            }
+            let now = Instant::now();
+            if state.closed || now >= deadline {
+                return None;
+            }
+            state = self.not_empty.wait_timeout(state, deadline - now).unwrap().0;
+        }
+    }
+
+    fn drain(&self) -> Vec<T> {
+        let mut state = self.state.lock().unwrap();
+        let items: Vec<T> = state.items.drain(..).collect();
+        self.not_full.notify_all();
+        items
+    }
+
+    fn len(&self) -> usize {
+        self.state.lock().unwrap().items.len()
+    }
+
+    /// 关闭队列：等待中的 push/pop 返回，已入队的元素仍可取出
+    fn close(&self) {
+        self.state.lock().unwrap().closed = true;
+        self.not_empty.notify_all();
+        self.not_full.notify_all();
+    }
+}
+
+/// 按序号重排；值为 None 的序号（准入时被挤掉）直接跳过
+struct Reorder<O> {
+    next: usize,
+    pending: BTreeMap<usize, Option<Result<O>>>,
+}
+
+/// 已在 NPU 上运行完、等待后处理的帧
+struct PostTask<P> {
+    seq: usize,
+    slot: usize,
+    prepared: P,
+}
+
+struct Shared<R: StageRunner> {
+    runner: R,
+    /// 准入单位为一组输入（单帧提交时组内只有一个）
+    admission: BoundedQueue<Vec<(usize, R::Input)>>,
+    npu_queue: BoundedQueue<(usize, R::Prepared)>,
+    post_queue: BoundedQueue<PostTask<R::Prepared>>,
+    contexts: Vec<Mutex<R::Context>>,
+    slot_core: Vec<usize>,
+    free_slots: Vec<BoundedQueue<usize>>,
+    reorder: Mutex<Reorder<R::Output>>,
+    output: BoundedQueue<(usize, Result<R::Output>)>,
+    next_seq: AtomicUsize,
+    submitted: AtomicUsize,
+    dropped: AtomicUsize,
+    completed: AtomicUsize,
+    failed: AtomicUsize,
+    output_dropped: AtomicUsize,
+}
+
+impl<R: StageRunner> Shared<R> {
+    /// 帧离开流水线（result 为 None 表示被挤掉），按序发出已连续的结果
+    fn finish(&self, seq: usize, result: Option<Result<R::Output>>) {
+        let counter = match &result {
+            Some(Ok(_)) => &self.completed,
+            Some(Err(_)) => &self.failed,
+            None => &self.dropped,
+        };
+
+        let mut reorder = self.reorder.lock().unwrap();
+        reorder.pending.insert(seq, result);
+        loop {
+            let next = reorder.next;
+            let entry = match reorder.pending.remove(&next) {
+                Some(entry) => entry,
+                None => break,
+            };
+            reorder.next += 1;
+            if let Some(result) = entry {
+                if self.output.push_latest((next, result)).is_some() {
+                    self.output_dropped.fetch_add(1, Ordering::Relaxed);
+                }
+            }
+        }
+        // 发出之后再计数：in_flight 为 0 时所有结果都已在输出队列里
+        counter.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// 组内输入依次预处理，逐个交给 NPU 队列，由各核心并行运行
+    fn preprocess_loop(&self) {
+        while let Some(group) = self.admission.pop_wait() {
+            let mut inputs = group.into_iter();
+            while let Some((seq, input)) = inputs.next() {
+                match self.runner.preprocess(input) {
+                    Ok(prepared) => {
+                        if !self.npu_queue.push_wait((seq, prepared)) {
+                            // 关闭中：组内其余输入不再处理
+                            for (seq, _) in inputs {
+                                self.finish(seq, None);
+                            }
+                            return;
+                        }
+                    }
+                    Err(e) => self.finish(seq, Some(Err(e))),
+                }
+            }
+        }
+    }
+
+    /// 核心线程：先占本核心的空闲槽位再取帧，保证取到的帧马上能运行
+    fn npu_loop(&self, core: usize) {
+        let free = &self.free_slots[core];
+        while let Some(slot) = free.pop_wait() {
+            let (seq, prepared) = match self.npu_queue.pop_wait() {
+                Some(task) => task,
+                None => break,
+            };
+            let ret = {
+                let mut ctx = self.contexts[slot].lock().unwrap();
+                self.runner.run(&mut ctx, &prepared)
+            };
+            match ret {
+                Ok(()) => {
+                    if !self.post_queue.push_wait(PostTask { seq, slot, prepared }) {
+                        break;
+                    }
+                }
+                Err(e) => {
+                    free.push_wait(slot);
+                    self.finish(seq, Some(Err(e)));
+                }
+            }
+        }
+    }
+
+    fn postprocess_loop(&self) {
+        while let Some(task) = self.post_queue.pop_wait() {
+            let result = {
+                let mut ctx = self.contexts[task.slot].lock().unwrap();
+                self.runner.postprocess(&mut ctx, &task.prepared)
+            };
+            self.free_slots[self.slot_core[task.slot]].push_wait(task.slot);
+            self.finish(task.seq, Some(result));
+        }
+    }
+}
+
+/// 三级流水线调度器
+///
+/// 提交返回序号（从 1 开始），结果按序号递增发出；被挤掉的帧没有结果。
+pub struct PipelineScheduler<R: StageRunner> {
+    shared: Arc<Shared<R>>,
+    threads: Vec<thread::JoinHandle<()>>,
+    cores: usize,
+}
+
+impl<R: StageRunner> PipelineScheduler<R> {
+    /// 创建调度器
+    ///
+    /// `cores[i]` 为第 i 个 NPU 核心上的上下文（调用方负责把它们绑定到该核心），每个核心至少一个。
+    pub fn new(runner: R, cores: Vec<Vec<R::Context>>, config: PipelineConfig) -> Result<Self> {
+        if cores.is_empty() || cores.iter().any(|c| c.is_empty()) {
+            return Err(RknnError::InvalidInput("pipeline needs at least one context per core".to_string()));
+        }
+        if config.preprocess_workers == 0 || config.postprocess_workers == 0 {
+            return Err(RknnError::InvalidInput("pipeline needs at least one pre/postprocess worker".to_string()));
+        }
+
+        let num_cores = cores.len();
+        let mut contexts = Vec::new();
+        let mut slot_core = Vec::new();
+        let mut free_slots = Vec::with_capacity(num_cores);
+        for (core, core_contexts) in cores.into_iter().enumerate() {
+            let free = BoundedQueue::new(core_contexts.len());
+            for ctx in core_contexts {
+                free.push_latest(contexts.len());
+                slot_core.push(core);
+                contexts.push(Mutex::new(ctx));
+            }
+            free_slots.push(free);
+        }
+        let num_slots = contexts.len();
+
+        let shared = Arc::new(Shared {
+            runner,
+            admission: BoundedQueue::new(config.admission_capacity),
+            npu_queue: BoundedQueue::new(num_slots),
+            post_queue: BoundedQueue::new(num_slots),
+            contexts,
+            slot_core,
+            free_slots,
+            reorder: Mutex::new(Reorder { next: 1, pending: BTreeMap::new() }),
+            output: BoundedQueue::new(config.output_capacity),
+            next_seq: AtomicUsize::new(1),
+            submitted: AtomicUsize::new(0),
+            dropped: AtomicUsize::new(0),
+            completed: AtomicUsize::new(0),
+            failed: AtomicUsize::new(0),
+            output_dropped: AtomicUsize::new(0),
+        });
+
+        let mut threads = Vec::new();
+        for _ in 0..config.preprocess_workers {
+            let shared = shared.clone();
+            threads.push(thread::spawn(move || shared.preprocess_loop()));
+        }
+        for core in 0..num_cores {
+            let shared = shared.clone();
+            threads.push(thread::spawn(move || shared.npu_loop(core)));
+        }
+        for _ in 0..config.postprocess_workers {
+            let shared = shared.clone();
+            threads.push(thread::spawn(move || shared.postprocess_loop()));
+        }
+
+        Ok(Self { shared, threads, cores: num_cores })
+    }
+
+    /// 提交一帧（不阻塞），返回序号；准入队列满时挤掉最旧的等待帧
+    pub fn submit(&self, input: R::Input) -> usize {
+        self.submit_group(vec![input]).map_or(0, |(first, _)| first)
+    }
+
+    /// 把一帧拆成的一组输入一起提交（不阻塞），返回组内首尾序号（连续）；空组返回 None
+    ///
+    /// 准入队列满时挤掉最旧的一整组，组内输入要么都进入流水线，要么都被挤掉。
+    /// 各输入的结果仍按序号逐个发出，由调用方按序号区间合并。
+    pub fn submit_group(&self, inputs: Vec<R::Input>) -> Option<(usize, usize)> {
+        if inputs.is_empty() {
+            return None;
+        }
+        let shared = &self.shared;
+        let n = inputs.len();
+        let first = shared.next_seq.fetch_add(n, Ordering::Relaxed);
+        shared.submitted.fetch_add(n, Ordering::Relaxed);
+        let group: Vec<(usize, R::Input)> = (first..first + n).zip(inputs).collect();
+        if let Some(evicted) = shared.admission.push_latest(group) {
+            for (seq, _) in evicted {
+                shared.finish(seq, None);
+            }
+        }
+        Some((first, first + n - 1))
+    }
+
+    /// 取下一个结果（按序号递增），没有时立即返回 None
+    pub fn try_recv(&self) -> Option<(usize, Result<R::Output>)> {
+        self.shared.output.pop_timeout(Duration::from_secs(0))
+    }
+
+    /// 取下一个结果，最多等待 timeout
+    pub fn recv_timeout(&self, timeout: Duration) -> Option<(usize, Result<R::Output>)> {
+        self.shared.output.pop_timeout(timeout)
+    }
+
+    /// 丢弃尚未开始预处理的帧和未取走的结果（已进入后续阶段的帧照常完成）
+    pub fn clear_pending(&self) {
+        for group in self.shared.admission.drain() {
+            for (seq, _) in group {
+                self.shared.finish(seq, None);
+            }
+        }
+        self.shared.output.drain();
+    }
+
+    pub fn stats(&self) -> PipelineStats {
+        let s = &self.shared;
+        let submitted = s.submitted.load(Ordering::Relaxed);
+        let dropped = s.dropped.load(Ordering::Relaxed);
+        let completed = s.completed.load(Ordering::Relaxed);
+        let failed = s.failed.load(Ordering::Relaxed);
+        PipelineStats {
+            submitted,
+            dropped,
+            completed,
+            failed,
+            output_dropped: s.output_dropped.load(Ordering::Relaxed),
+            in_flight: submitted.saturating_sub(dropped + completed + failed),
+        }
+    }
+
+    /// 等待预处理的帧（组）数
+    pub fn pending_len(&self) -> usize {
+        self.shared.admission.len()
+    }
+
+    pub fn core_count(&self) -> usize {
+        self.cores
+    }
+
+    pub fn context_count(&self) -> usize {
+        self.shared.contexts.len()
+    }
+}
+
+impl<R: StageRunner> Drop for PipelineScheduler<R> {
+    fn drop(&mut self) {
+        let s = &self.shared;
+        // 未运行的帧直接丢弃；已在 NPU 上跑完的帧交给后处理收尾，上下文不带着未取的输出销毁
+        s.admission.drain();
+        s.admission.close();
+        s.npu_queue.drain();
+        s.npu_queue.close();
+        for free in &s.free_slots {
+            free.close();
+        }
+        s.post_queue.close();
+        for handle in self.threads.drain(..) {
+            let _ = handle.join();
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::atomic::AtomicBool;
+
+    /// 模拟 NPU 上下文：run 把结果暂存在上下文里，postprocess 取走
+    struct MockContext {
+        core: usize,
+        pending: Option<u32>,
+    }
+
+    #[derive(Default)]
+    struct MockRunner {
+        preprocess_delay_ms: u64,
+        run_delay_ms: u64,
+        /// 每个核心上同时在运行的帧数，以及出现过的最大值
+        active: Vec<AtomicUsize>,
+        max_active_per_core: AtomicUsize,
+        active_total: AtomicUsize,
+        max_active_total: AtomicUsize,
+        runs_per_core: Vec<AtomicUsize>,
+        postprocess_without_run: AtomicBool,
+        fail_preprocess_every: u32,
+        fail_run_every: u32,
+    }
+
+    impl MockRunner {
+        fn new(cores: usize) -> Self {
+            Self {
+                active: (0..cores).map(|_| AtomicUsize::new(0)).collect(),
+                runs_per_core: (0..cores).map(|_| AtomicUsize::new(0)).collect(),
+                ..Default::default()
+            }
+        }
+    }
+
+    impl StageRunner for MockRunner {
+        type Input = u32;
+        type Prepared = u32;
+        type Context = MockContext;
+        type Output = (u32, usize);
+
+        fn preprocess(&self, input: u32) -> Result<u32> {
+            if self.fail_preprocess_every > 0 && input % self.fail_preprocess_every == 0 {
+                return Err(RknnError::InvalidInput(format!("frame {}", input)));
+            }
+            // 奇偶帧耗时不同，让预处理池乱序完成
+            let delay = if input % 2 == 0 { self.preprocess_delay_ms * 2 } else { self.preprocess_delay_ms };
+            thread::sleep(Duration::from_millis(delay));
+            Ok(input)
+        }
+
+        fn run(&self, ctx: &mut MockContext, prepared: &u32) -> Result<()> {
+            let active = self.active[ctx.core].fetch_add(1, Ordering::SeqCst) + 1;
+            self.max_active_per_core.fetch_max(active, Ordering::SeqCst);
+            let total = self.active_total.fetch_add(1, Ordering::SeqCst) + 1;
+            self.max_active_total.fetch_max(total, Ordering::SeqCst);
+            thread::sleep(Duration::from_millis(self.run_delay_ms));
+            self.active_total.fetch_sub(1, Ordering::SeqCst);
+            self.active[ctx.core].fetch_sub(1, Ordering::SeqCst);
+            self.runs_per_core[ctx.core].fetch_add(1, Ordering::SeqCst);
+
+            if self.fail_run_every > 0 && *prepared % self.fail_run_every == 0 {
+                return Err(RknnError::InferenceFailed(-1));
+            }
+            ctx.pending = Some(*prepared * 2);
+            Ok(())
+        }
+
+        fn postprocess(&self, ctx: &mut MockContext, prepared: &u32) -> Result<(u32, usize)> {
+            match ctx.pending.take() {
+                Some(value) if value == *prepared * 2 => Ok((value, ctx.core)),
+                _ => {
+                    self.postprocess_without_run.store(true, Ordering::SeqCst);
+                    Err(RknnError::InferenceFailed(-2))
+                }
+            }
+        }
+    }
+
+    fn contexts(cores: usize, per_core: usize) -> Vec<Vec<MockContext>> {
+        (0..cores)
+            .map(|core| (0..per_core).map(|_| MockContext { core, pending: None }).collect())
+            .collect()
+    }
+
+    fn collect(scheduler: &PipelineScheduler<MockRunner>, expected: usize) -> Vec<(usize, Result<(u32, usize)>)> {
+        let mut results = Vec::new();
+        let deadline = Instant::now() + Duration::from_secs(10);
+        while results.len() < expected && Instant::now() < deadline {
+            if let Some(r) = scheduler.recv_timeout(Duration::from_millis(50)) {
+                results.push(r);
+            } else if scheduler.stats().in_flight == 0 && scheduler.shared.output.len() == 0 {
+                break;
+            }
+        }
+        results
+    }
+
+    #[test]
+    fn test_results_in_submission_order() {
+        let mut runner = MockRunner::new(3);
+        runner.preprocess_delay_ms = 1;
+        runner.run_delay_ms = 2;
+        let config = PipelineConfig {
+            preprocess_workers: 4,
+            postprocess_workers: 2,
+            admission_capacity: 64,
+            output_capacity: 64,
+        };
+        let scheduler = PipelineScheduler::new(runner, contexts(3, 2), config).unwrap();
+
+        for i in 1..=40u32 {
+            assert_eq!(scheduler.submit(i), i as usize);
+        }
+        let results = collect(&scheduler, 40);
+        assert_eq!(results.len(), 40);
+        for (i, (seq, result)) in results.iter().enumerate() {
+            assert_eq!(*seq, i + 1);
+            assert_eq!(result.as_ref().unwrap().0, (i as u32 + 1) * 2);
+        }
+
+        let stats = scheduler.stats();
+        assert_eq!(stats.completed, 40);
+        assert_eq!(stats.dropped + stats.failed + stats.in_flight, 0);
+        assert!(!scheduler.shared.runner.postprocess_without_run.load(Ordering::SeqCst));
+    }
+
+    #[test]
+    fn test_one_frame_per_core_and_cores_run_in_parallel() {
+        let mut runner = MockRunner::new(3);
+        runner.run_delay_ms = 5;
+        let config = PipelineConfig { admission_capacity: 64, output_capacity: 64, ..Default::default() };
+        let scheduler = PipelineScheduler::new(runner, contexts(3, 2), config).unwrap();
+
+        for i in 1..=30u32 {
+            scheduler.submit(i);
+        }
+        let results = collect(&scheduler, 30);
+        assert_eq!(results.len(), 30);
+
+        let runner = &scheduler.shared.runner;
+        // 同一核心上的两个槽位不会同时运行，不同核心之间并行
+        assert_eq!(runner.max_active_per_core.load(Ordering::SeqCst), 1);
+        assert!(runner.max_active_total.load(Ordering::SeqCst) >= 2);
+        for core in 0..3 {
+            assert!(runner.runs_per_core[core].load(Ordering::SeqCst) > 0);
+        }
+        let cores_in_results: std::collections::HashSet<usize> =
+            results.iter().map(|(_, r)| r.as_ref().unwrap().1).collect();
+        assert_eq!(cores_in_results.len(), 3);
+    }
+
+    #[test]
+    fn test_latest_frame_wins_admission() {
+        let mut runner = MockRunner::new(1);
+        runner.preprocess_delay_ms = 10;
+        let config = PipelineConfig {
+            preprocess_workers: 1,
+            postprocess_workers: 1,
+            admission_capacity: 2,
+            output_capacity: 64,
+        };
+        let scheduler = PipelineScheduler::new(runner, contexts(1, 1), config).unwrap();
+
+        for i in 1..=20u32 {
+            scheduler.submit(i);
+        }
+        let results = collect(&scheduler, 20);
+        let stats = scheduler.stats();
+        assert!(stats.dropped > 0);
+        assert_eq!(stats.completed + stats.dropped, 20);
+        assert_eq!(results.len(), stats.completed);
+        // 最后提交的帧一定会被处理，输出序号严格递增
+        assert_eq!(results.last().unwrap().0, 20);
+        assert!(results.windows(2).all(|w| w[0].0 < w[1].0));
+    }
+
+    #[test]
+    fn test_groups_admitted_and_evicted_whole() {
+        let mut runner = MockRunner::new(3);
+        runner.preprocess_delay_ms = 5;
+        let config = PipelineConfig {
+            preprocess_workers: 1,
+            postprocess_workers: 2,
+            admission_capacity: 1,
+            output_capacity: 256,
+        };
+        let scheduler = PipelineScheduler::new(runner, contexts(3, 2), config).unwrap();
+
+        // 组比准入容量大也整组进入；序号连续
+        let mut groups = Vec::new();
+        for g in 0..10u32 {
+            let inputs: Vec<u32> = (0..6).map(|i| g * 6 + i + 1).collect();
+            groups.push(scheduler.submit_group(inputs).unwrap());
+        }
+        assert_eq!(groups[0], (1, 6));
+        assert_eq!(groups[9], (55, 60));
+        assert!(scheduler.submit_group(Vec::new()).is_none());
+
+        let results = collect(&scheduler, 60);
+        let stats = scheduler.stats();
+        assert!(stats.dropped > 0);
+        assert_eq!(stats.completed + stats.dropped, 60);
+        // 每组要么全部完成，要么全部被挤掉
+        for &(first, last) in &groups {
+            let done = results.iter().filter(|(seq, _)| *seq >= first && *seq <= last).count();
+            assert!(done == 0 || done == 6, "group {}..={} has {} results", first, last, done);
+        }
+        assert_eq!(results.last().unwrap().0, 60);
+    }
+
+    #[test]
+    fn test_failures_keep_order_and_release_contexts() {
+        let mut runner = MockRunner::new(1);
+        runner.fail_preprocess_every = 5;
+        runner.fail_run_every = 7;
+        let config = PipelineConfig { admission_capacity: 64, output_capacity: 64, ..Default::default() };
+        // 单核单槽位：运行失败若不归还槽位，后续帧会卡死
+        let scheduler = PipelineScheduler::new(runner, contexts(1, 1), config).unwrap();
+
+        for i in 1..=30u32 {
+            scheduler.submit(i);
+        }
+        let results = collect(&scheduler, 30);
+        assert_eq!(results.len(), 30);
+        for (seq, result) in &results {
+            let failed = *seq % 5 == 0 || *seq % 7 == 0;
+            assert_eq!(result.is_err(), failed, "frame {}", seq);
+        }
+        assert!(results.windows(2).all(|w| w[0].0 + 1 == w[1].0));
+        assert_eq!(scheduler.stats().failed, 10);
+    }
+
+    #[test]
+    fn test_output_queue_drops_oldest() {
+        let runner = MockRunner::new(1);
+        let config = PipelineConfig { admission_capacity: 64, output_capacity: 2, ..Default::default() };
+        let scheduler = PipelineScheduler::new(runner, contexts(1, 2), config).unwrap();
+
+        for i in 1..=10u32 {
+            scheduler.submit(i);
+        }
+        let deadline = Instant::now() + Duration::from_secs(10);
+        while scheduler.stats().in_flight > 0 && Instant::now() < deadline {
+            thread::sleep(Duration::from_millis(1));
+        }
+        assert_eq!(scheduler.stats().output_dropped, 8);
+        assert_eq!(scheduler.try_recv().unwrap().0, 9);
+        assert_eq!(scheduler.try_recv().unwrap().0, 10);
+        assert!(scheduler.try_recv().is_none());
+    }
+
+    #[test]
+    fn test_invalid_config() {
+        assert!(PipelineScheduler::new(MockRunner::new(1), Vec::new(), PipelineConfig::default()).is_err());
+        assert!(PipelineScheduler::new(MockRunner::new(2), vec![vec![MockContext { core: 0, pending: None }], Vec::new()],
+            PipelineConfig::default())
+        .is_err());
+        let config = PipelineConfig { preprocess_workers: 0, ..Default::default() };
+        assert!(PipelineScheduler::new(MockRunner::new(1), contexts(1, 1), config).is_err());
+    }
+}
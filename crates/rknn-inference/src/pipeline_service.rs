@@ -0,0 +1,552 @@
+//! 流水线推理服务
+//!
+//! 在 [`PipelineScheduler`] 上接入 RKNN：每个 NPU 核心若干个 [`Yolov8Detector`]（rknn_set_core_mask 固定到该核心），
+//! 预处理池只做裁块，核心线程把图像 letterbox 进上下文的输入缓冲后 rknn_run，后处理池解码输出。
+//! 与 [`crate::MultiDetectorInferenceService`] 的区别：后者每个工作线程串行做完整的一帧，
+//! 不绑定核心；这里三个阶段在不同帧上同时进行，提交不阻塞（最新帧优先），结果按提交顺序发出。
+//!
+//! 分块 / ROI 检测（见 [`crate::tiling`]）：一帧按 [`TilingConfig`] 拆成若干检测任务作为一组提交，
+//! 各图块在不同核心上并行运行，结果换算到整帧的模型输入坐标后跨块合并，作为这一帧的结果发出。
+//!
+//! ```rust
+//! use rknn_inference::{ImageBuffer, PipelinedInferenceService, PipelineServiceConfig, PostprocessConfig};
+//!
+//! // RK3588：3 个核心，每核心 2 个上下文
+//! let config = PipelineServiceConfig::with_contexts(3, 6);
+//! let service = PipelinedInferenceService::new("models/yolov8m.rknn", config, PostprocessConfig::default())?;
+//!
+//! // 提交原始 RGB888 帧（任意尺寸），预处理在流水线里完成
+//! let task_id = service.submit(ImageBuffer::from_rgb888(1280, 720, vec![0; 1280 * 720 * 3]));
+//! if let Some((id, result)) = service.try_get_latest_result() {
+//!     println!("任务 {} 结果: {:?}", id, result.map(|d| d.len()));
+//! }
+//! # Ok::<(), Box<dyn std::error::Error>>(())
+//! ```
+
+use std::collections::VecDeque;
+use std::fmt;
+use std::path::Path;
+use std::sync::{Arc, Mutex};
+use std::thread;
+use std::time::{Duration, Instant};
+
+use crate::pipeline::{PipelineConfig, PipelineScheduler, PipelineStats, StageRunner};
+use crate::tiling::{self, FrameRect, TileMapping, TilePlanner, TilingConfig};
+use crate::{
+    DetectionResult, ImageBuffer, ImageFormat, InferenceStats, InitTiming, ModelFileGuard, PostprocessConfig, Result,
+    RknnError, StatsHandle, Yolov8Detector,
+};
+
+/// 最新结果的有效期（与 MultiDetectorInferenceService 一致）
+const LATEST_RESULT_TTL: Duration = Duration::from_secs(2);
+/// 记录的已提交帧（序号区间）上限；结果取得慢时更早的记录直接丢弃
+const MAX_PENDING_GROUPS: usize = 64;
+/// 合并后每帧最多的检测数（与 C 侧结果表容量一致）
+const MAX_MERGED_DETECTIONS: usize = 128;
+
+/// 流水线推理服务配置
+#[derive(Debug, Clone)]
+pub struct PipelineServiceConfig {
+    /// 使用的 NPU 核心数（RK3588 为 3）；0 表示不绑定核心、交给驱动调度（单核平台）
+    pub npu_cores: usize,
+    /// 每个核心上的上下文数；2 时一个上下文在 NPU 上运行的同时另一个在做后处理
+    pub contexts_per_core: usize,
+    /// 上下文总数；设置时代替 contexts_per_core，按总数分到各核心（见 contexts_on_cores）
+    pub total_contexts: Option<usize>,
+    /// 预处理/后处理线程数与队列容量
+    pub pipeline: PipelineConfig,
+    /// 整幅 / 分块 / 自适应检测（运行中可用 set_tiling_config 修改）
+    pub tiling: TilingConfig,
+}
+
+impl Default for PipelineServiceConfig {
+    fn default() -> Self {
+        Self {
+            npu_cores: 3,
+            contexts_per_core: 2,
+            total_contexts: None,
+            pipeline: PipelineConfig::default(),
+            tiling: TilingConfig::default(),
+        }
+    }
+}
+
+impl PipelineServiceConfig {
+    /// 恰好 num_contexts 个上下文（至少一个）分到 npu_cores 个核心
+    pub fn with_contexts(npu_cores: usize, num_contexts: usize) -> Self {
+        Self {
+            npu_cores,
+            total_contexts: Some(num_contexts.max(1)),
+            ..Default::default()
+        }
+    }
+
+    /// 各核心组的上下文数（不绑定核心时只有一组）
+    ///
+    /// 按总数分配时每核心 total / cores 个，余数依次给前面的核心；
+    /// 总数少于核心数时只使用前 total 个核心。
+    pub fn contexts_on_cores(&self) -> Vec<usize> {
+        let groups = self.npu_cores.max(1);
+        match self.total_contexts {
+            Some(total) => (0..groups.min(total))
+                .map(|i| total / groups + usize::from(i < total % groups))
+                .collect(),
+            None => vec![self.contexts_per_core; groups],
+        }
+    }
+}
+
+/// 一个检测任务：整帧，或帧上的一块区域（图块 / ROI）
+pub struct TileJob {
+    /// 原始 RGB888 帧（任意尺寸），同一帧的各任务共享
+    pub frame: Arc<ImageBuffer>,
+    /// 区域及其坐标换算；None 为整帧，输出即整帧的模型输入坐标
+    pub mapping: Option<TileMapping>,
+}
+
+/// 预处理后的检测任务
+pub struct PreparedTile {
+    /// 整帧或裁出的图块（RGB888，任意尺寸），运行时再 letterbox 进上下文的输入缓冲
+    pub image: ImageBuffer,
+    pub mapping: Option<TileMapping>,
+}
+
+/// RKNN 的流水线阶段：裁块 → letterbox 进输入缓冲 + rknn_run → 解码（图块的框换算回整帧坐标）
+///
+/// letterbox 不在预处理池做：上下文的输入缓冲（zero copy 时即 NPU 输入内存）只在核心线程持有上下文时可写，
+/// 在这里直接写进去（C 侧 RGA 或定点 SIMD 内核），省掉中间图像和一次整帧拷贝。
+/// 预处理耗时统计因此来自 C 侧的 letterbox，裁块耗时不计入。
+pub struct RknnStageRunner {
+    model_width: i32,
+    model_height: i32,
+}
+
+impl StageRunner for RknnStageRunner {
+    type Input = TileJob;
+    type Prepared = PreparedTile;
+    type Context = Yolov8Detector;
+    /// 整帧模型输入坐标系的检测框
+    type Output = Vec<DetectionResult>;
+
+    fn preprocess(&self, job: TileJob) -> Result<PreparedTile> {
+        let frame = &job.frame;
+        if frame.format != ImageFormat::Rgb888 || frame.width <= 0 || frame.height <= 0 {
+            return Err(RknnError::InvalidImageFormat);
+        }
+        let image = match &job.mapping {
+            // 整帧：只有这一个任务持有帧时直接取走，避免拷贝
+            None => Arc::try_unwrap(job.frame).unwrap_or_else(|shared| (*shared).clone()),
+            Some(mapping) => tiling::crop_rgb888(frame, mapping.tile).ok_or(RknnError::InvalidImageFormat)?,
+        };
+        Ok(PreparedTile { image, mapping: job.mapping })
+    }
+
+    fn run(&self, detector: &mut Yolov8Detector, prepared: &PreparedTile) -> Result<()> {
+        let image = &prepared.image;
+        if image.width == self.model_width && image.height == self.model_height {
+            detector.run_model_input(image)
+        } else {
+            detector.run_letterboxed(image)
+        }
+    }
+
+    fn postprocess(&self, detector: &mut Yolov8Detector, prepared: &PreparedTile) -> Result<Vec<DetectionResult>> {
+        let detections = detector.postprocess_outputs()?;
+        Ok(match &prepared.mapping {
+            None => detections,
+            Some(mapping) => detections.iter().filter_map(|d| mapping.map(d)).collect(),
+        })
+    }
+}
+
+/// AI 服务冷启动耗时报告
+#[derive(Debug, Clone, Default)]
+pub struct StartupReport {
+    /// 每个模型实例绑定的核心与初始化耗时（第一个从文件加载，其余并行复制）
+    pub contexts: Vec<(Option<u32>, InitTiming)>,
+    /// 从开始创建到全部实例就绪、流水线启动的墙钟时间（毫秒）
+    pub total_ms: f64,
+}
+
+impl fmt::Display for StartupReport {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(f, "AI startup: {} context(s) ready in {:.1} ms", self.contexts.len(), self.total_ms)?;
+        if let Some((_, first)) = self.contexts.first() {
+            write!(
+                f,
+                "; first: load {:.1} + init {:.1} + query {:.1} + setup {:.1} + labels {:.1} ms",
+                first.load_ms, first.init_ms, first.query_ms, first.setup_ms, first.labels_ms
+            )?;
+        }
+        let rest = &self.contexts[self.contexts.len().min(1)..];
+        if !rest.is_empty() {
+            let duplicated = rest.iter().filter(|(_, t)| t.duplicated).count();
+            let slowest = rest.iter().map(|(_, t)| t.total_ms()).fold(0.0, f64::max);
+            write!(
+                f,
+                "; {} more in parallel ({} duplicated, {} reloaded), slowest {:.1} ms",
+                rest.len(),
+                duplicated,
+                rest.len() - duplicated,
+                slowest
+            )?;
+        }
+        Ok(())
+    }
+}
+
+/// 一帧提交的任务序号区间
+#[derive(Debug, Clone, Copy)]
+struct FrameGroup {
+    first: usize,
+    last: usize,
+}
+
+/// 正在收集各任务结果的帧
+struct GroupResults {
+    group: FrameGroup,
+    received: usize,
+    detections: Vec<DetectionResult>,
+    error: Option<RknnError>,
+}
+
+struct LatestResult {
+    result: Option<(usize, Result<Vec<DetectionResult>>)>,
+    timestamp: Instant,
+    collecting: Option<GroupResults>,
+}
+
+/// 分块检测的运行时状态
+struct TilingState {
+    config: TilingConfig,
+    roi: Option<FrameRect>,
+    planner: TilePlanner,
+}
+
+/// 流水线推理服务
+pub struct PipelinedInferenceService {
+    scheduler: PipelineScheduler<RknnStageRunner>,
+    latest: Mutex<LatestResult>,
+    startup: StartupReport,
+    tiling: Mutex<TilingState>,
+    /// 已提交、结果尚未收齐的帧（按序号递增）
+    groups: Mutex<VecDeque<FrameGroup>>,
+    model_size: (u32, u32),
+    max_detections: usize,
+    /// 各上下文的统计句柄；上下文归 scheduler 所有，与服务同生命周期
+    context_stats: Vec<StatsHandle>,
+}
+
+impl PipelinedInferenceService {
+    /// 创建服务，任一上下文创建或绑定失败即返回错误
+    ///
+    /// 模型文件只映射一次：第一个上下文在调用线程上加载，其余上下文并行地从它复制
+    /// （rknn_dup_context 共享权重；平台不支持时并行地从同一份映射重新加载）。
+    pub fn new<P: AsRef<Path>>(
+        model_path: P,
+        config: PipelineServiceConfig,
+        postprocess_config: PostprocessConfig,
+    ) -> Result<Self> {
+        let start = Instant::now();
+        postprocess_config.validate()?;
+        config.tiling.validate()?;
+        let per_core = config.contexts_on_cores();
+        if per_core.is_empty() || per_core.contains(&0) {
+            return Err(RknnError::InvalidInput("every NPU core needs at least 1 context".to_string()));
+        }
+
+        let core_ids: Vec<Option<u32>> = if config.npu_cores == 0 {
+            vec![None]
+        } else {
+            (0..per_core.len() as u32).map(Some).collect()
+        };
+        // 第 i 个上下文属于核心组 slot_groups[i]，绑定到 slot_cores[i]
+        let slot_groups: Vec<usize> = per_core
+            .iter()
+            .enumerate()
+            .flat_map(|(group, &n)| std::iter::repeat(group).take(n))
+            .collect();
+        let slot_cores: Vec<Option<u32>> = slot_groups.iter().map(|&group| core_ids[group]).collect();
+
+        let _model_file = ModelFileGuard::new(model_path.as_ref())?;
+        let mut first = Yolov8Detector::new_with_config(model_path.as_ref(), &postprocess_config)?;
+        first.set_npu_core(slot_cores[0])?;
+
+        let others: Vec<Result<Yolov8Detector>> = thread::scope(|scope| {
+            let first = &first;
+            let postprocess_config = &postprocess_config;
+            let handles: Vec<_> = slot_cores[1..]
+                .iter()
+                .map(|&core| {
+                    scope.spawn(move || {
+                        let mut detector = first.duplicate_with_config(postprocess_config)?;
+                        detector.set_npu_core(core)?;
+                        Ok(detector)
+                    })
+                })
+                .collect();
+            handles
+                .into_iter()
+                .map(|h| h.join().unwrap_or_else(|_| Err(RknnError::InitFailed(-1))))
+                .collect()
+        });
+
+        let mut detectors = Vec::with_capacity(slot_cores.len());
+        detectors.push(first);
+        for detector in others {
+            detectors.push(detector?);
+        }
+
+        let mut startup = StartupReport::default();
+        let model_size = detectors[0].model_size();
+        let context_stats: Vec<StatsHandle> = detectors.iter().map(|d| d.stats_handle()).collect();
+        let mut cores: Vec<Vec<Yolov8Detector>> = per_core.iter().map(|&n| Vec::with_capacity(n)).collect();
+        for (i, detector) in detectors.into_iter().enumerate() {
+            startup.contexts.push((slot_cores[i], detector.init_timing()));
+            cores[slot_groups[i]].push(detector);
+        }
+
+        let runner = RknnStageRunner { model_width: model_size.0 as i32, model_height: model_size.1 as i32 };
+        let scheduler = PipelineScheduler::new(runner, cores, config.pipeline)?;
+        startup.total_ms = start.elapsed().as_secs_f64() * 1000.0;
+        let max_detections = match postprocess_config.max_detections {
+            0 => MAX_MERGED_DETECTIONS,
+            n => n.min(MAX_MERGED_DETECTIONS),
+        };
+        Ok(Self {
+            scheduler,
+            latest: Mutex::new(LatestResult { result: None, timestamp: Instant::now(), collecting: None }),
+            startup,
+            tiling: Mutex::new(TilingState { config: config.tiling, roi: None, planner: TilePlanner::default() }),
+            groups: Mutex::new(VecDeque::new()),
+            model_size,
+            max_detections,
+            context_stats,
+        })
+    }
+
+    /// 冷启动耗时报告
+    pub fn startup_report(&self) -> &StartupReport {
+        &self.startup
+    }
+
+    /// 提交一帧原始 RGB888 图像（不阻塞），返回任务 ID；流水线满时挤掉最旧的等待帧
+    ///
+    /// 按检测方式拆成整帧 / ROI / 若干图块的任务一起提交；任务 ID 与该帧结果的 ID 相同
+    pub fn submit(&self, frame: ImageBuffer) -> usize {
+        let (frame_w, frame_h) = (frame.width.max(0) as u32, frame.height.max(0) as u32);
+        let (model_w, model_h) = self.model_size;
+        let regions = if frame_w == 0 || frame_h == 0 {
+            // 无效帧照常提交，由预处理报错
+            vec![FrameRect::default()]
+        } else {
+            let mut tiling = self.tiling.lock().unwrap();
+            let TilingState { config, roi, planner } = &mut *tiling;
+            planner.plan(config, frame_w, frame_h, *roi, model_w.min(model_h)).0
+        };
+
+        let full = FrameRect::full(frame_w, frame_h);
+        let frame = Arc::new(frame);
+        let jobs: Vec<TileJob> = regions
+            .iter()
+            .map(|&region| TileJob {
+                frame: Arc::clone(&frame),
+                mapping: if region == full || region == FrameRect::default() {
+                    None
+                } else {
+                    Some(TileMapping::new(region, frame_w, frame_h, model_w, model_h))
+                },
+            })
+            .collect();
+        drop(frame);
+
+        // 持锁提交，取结果的一方不会先于区间记录看到这一帧的结果
+        let mut groups = self.groups.lock().unwrap();
+        let (first, last) = match self.scheduler.submit_group(jobs) {
+            Some(range) => range,
+            None => return 0,
+        };
+        if groups.len() >= MAX_PENDING_GROUPS {
+            groups.pop_front();
+        }
+        groups.push_back(FrameGroup { first, last });
+        last
+    }
+
+    /// 获取最新结果（超过 2 秒未更新视为过期）
+    ///
+    /// 结果按提交顺序发出，这里只保留最后一个；同一结果可以重复读取。
+    pub fn try_get_latest_result(&self) -> Option<(usize, Result<Vec<DetectionResult>>)> {
+        let mut latest = self.latest.lock().unwrap();
+        while let Some((seq, result)) = self.scheduler.try_recv() {
+            if let Some(frame_result) = self.collect(&mut latest, seq, result) {
+                latest.result = Some(frame_result);
+                latest.timestamp = Instant::now();
+            }
+        }
+        if latest.timestamp.elapsed() > LATEST_RESULT_TTL {
+            latest.result = None;
+        }
+        latest.result.clone()
+    }
+
+    /// 收集一个任务的结果；一帧的任务收齐时返回合并后的帧结果
+    fn collect(
+        &self,
+        latest: &mut LatestResult,
+        seq: usize,
+        result: Result<Vec<DetectionResult>>,
+    ) -> Option<(usize, Result<Vec<DetectionResult>>)> {
+        let group = {
+            let mut groups = self.groups.lock().unwrap();
+            while groups.front().map_or(false, |g| g.last < seq) {
+                groups.pop_front();
+            }
+            match groups.front() {
+                Some(g) if g.first <= seq => *g,
+                // 区间记录已被丢弃：按单任务处理
+                _ => FrameGroup { first: seq, last: seq },
+            }
+        };
+
+        let same_group = latest.collecting.as_ref().map_or(false, |c| c.group.first == group.first);
+        if !same_group {
+            latest.collecting = Some(GroupResults { group, received: 0, detections: Vec::new(), error: None });
+        }
+        let collecting = latest.collecting.as_mut().unwrap();
+        collecting.received += 1;
+        match result {
+            Ok(detections) => collecting.detections.extend(detections),
+            Err(e) => {
+                collecting.error.get_or_insert(e);
+            }
+        }
+        if seq != group.last {
+            return None;
+        }
+
+        let done = latest.collecting.take().unwrap();
+        if done.received != group.last - group.first + 1 {
+            // 组内有任务没有结果（关闭中被丢弃），这一帧不完整
+            return None;
+        }
+        let merged = match done.error {
+            Some(e) => Err(e),
+            None if group.first == group.last => Ok(done.detections),
+            None => {
+                let tiling = self.tiling.lock().unwrap();
+                Ok(tiling::merge_detections(
+                    done.detections,
+                    tiling.config.merge_iou,
+                    tiling.config.merge_containment,
+                    self.max_detections,
+                ))
+            }
+        };
+        if let Ok(detections) = &merged {
+            let mut tiling = self.tiling.lock().unwrap();
+            let TilingState { config, planner, .. } = &mut *tiling;
+            planner.observe(config, detections);
+        }
+        Some((group.last, merged))
+    }
+
+    /// 丢弃等待中的帧与已有结果（用于重置或错误恢复）
+    pub fn clear_all(&self) {
+        self.scheduler.clear_pending();
+        let mut latest = self.latest.lock().unwrap();
+        latest.result = None;
+        latest.collecting = None;
+        latest.timestamp = Instant::now();
+    }
+
+    /// 修改检测方式（对之后提交的帧生效）
+    pub fn set_tiling_config(&self, config: TilingConfig) -> Result<()> {
+        config.validate()?;
+        let mut tiling = self.tiling.lock().unwrap();
+        tiling.config = config;
+        tiling.planner = TilePlanner::default();
+        Ok(())
+    }
+
+    pub fn tiling_config(&self) -> TilingConfig {
+        self.tiling.lock().unwrap().config.clone()
+    }
+
+    /// 设置检测区域（源帧像素，如前端放大时的可见区域）；None 为整帧
+    pub fn set_roi(&self, roi: Option<FrameRect>) {
+        self.tiling.lock().unwrap().roi = roi.filter(|r| r.width > 0 && r.height > 0);
+    }
+
+    pub fn roi(&self) -> Option<FrameRect> {
+        self.tiling.lock().unwrap().roi
+    }
+
+    /// 流水线计数（按检测任务计：分块的一帧计多个）
+    pub fn stats(&self) -> PipelineStats {
+        self.scheduler.stats()
+    }
+
+    /// 所有上下文汇总的推理统计（各阶段耗时直方图、候选数），预处理为核心线程上 letterbox 进输入缓冲的耗时
+    ///
+    /// 只读各上下文的统计，不占用上下文，推理进行中也可以调用。
+    pub fn inference_stats(&self) -> InferenceStats {
+        let mut total = InferenceStats::default();
+        for handle in &self.context_stats {
+            total.merge(&handle.snapshot());
+        }
+        total
+    }
+
+    /// 清零推理统计（不影响 [`PipelineStats`] 计数）
+    pub fn reset_inference_stats(&self) {
+        for handle in &self.context_stats {
+            handle.reset();
+        }
+    }
+
+    /// 绑定的核心组数（不绑定核心时为 1）
+    pub fn core_count(&self) -> usize {
+        self.scheduler.core_count()
+    }
+
+    /// 上下文（模型实例）总数
+    pub fn context_count(&self) -> usize {
+        self.scheduler.context_count()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_contexts_spread_over_cores() {
+        assert_eq!(PipelineServiceConfig::with_contexts(3, 6).contexts_on_cores(), vec![2, 2, 2]);
+        // 余数给前面的核心，总数不变
+        assert_eq!(PipelineServiceConfig::with_contexts(3, 4).contexts_on_cores(), vec![2, 1, 1]);
+        assert_eq!(PipelineServiceConfig::with_contexts(3, 5).contexts_on_cores(), vec![2, 2, 1]);
+        // 少于核心数时只用前面的核心
+        assert_eq!(PipelineServiceConfig::with_contexts(3, 1).contexts_on_cores(), vec![1]);
+        assert_eq!(PipelineServiceConfig::with_contexts(3, 0).contexts_on_cores(), vec![1]);
+        // 不绑定核心时所有上下文在同一组
+        assert_eq!(PipelineServiceConfig::with_contexts(0, 6).contexts_on_cores(), vec![6]);
+        assert_eq!(PipelineServiceConfig::default().contexts_on_cores(), vec![2, 2, 2]);
+    }
+
+    #[test]
+    fn test_startup_report_summary() {
+        let first = InitTiming { load_ms: 1.0, init_ms: 500.0, query_ms: 2.0, setup_ms: 3.0, labels_ms: 0.5, duplicated: false };
+        let dup = InitTiming { init_ms: 20.0, setup_ms: 3.0, duplicated: true, ..Default::default() };
+        let report = StartupReport {
+            contexts: vec![(Some(0), first), (Some(0), dup), (Some(1), InitTiming { init_ms: 30.0, ..dup })],
+            total_ms: 560.0,
+        };
+        let text = report.to_string();
+        assert!(text.contains("3 context(s) ready in 560.0 ms"), "{}", text);
+        assert!(text.contains("init 500.0"), "{}", text);
+        assert!(text.contains("2 more in parallel (2 duplicated, 0 reloaded), slowest 33.0 ms"), "{}", text);
+
+        assert_eq!(StartupReport::default().to_string(), "AI startup: 0 context(s) ready in 0.0 ms");
+    }
+}
@@ -0,0 +1,446 @@
+//! 分块 / ROI 检测
+//!
+//! 整幅 1280x720 的帧 letterbox 到 640x640 时分辨率减半，内窥图像里的小缺陷容易漏检。
+//! 这里把检测区域（整帧或用户选定的 ROI）切成相互重叠的图块，每块按原分辨率（图块边长默认等于模型输入）
+//! 送进模型，各图块的框换算回同一坐标系后跨块做 NMS 合并：
+//!
+//! - [`plan_tiles`]：按重叠比例在区域上均匀铺图块，首尾图块贴齐区域边缘
+//! - [`TileMapping`]：图块的模型输入坐标 → 整帧 letterbox 后的模型输入坐标
+//!   （与整帧检测的输出同一坐标系，前端叠加层不需要区分）
+//! - [`merge_detections`]：同类框按 IoU 或包含比例（图块边缘截断的框）合并，保留置信度高的
+//! - [`TilePlanner`]：按 [`DetectionMode`] 决定每帧的检测任务；自适应模式只在上一帧出现低置信度检测时分块，
+//!   且连续分块的帧数有上限，吞吐有界
+//!
+//! 图块作为一组输入提交给流水线（见 [`crate::PipelineScheduler::submit_group`]），在各 NPU 核心上并行运行。
+
+use crate::{DetectionResult, ImageBuffer, ImageRect, Result, RknnError};
+
+/// 源帧上的矩形（像素）
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct FrameRect {
+    pub x: u32,
+    pub y: u32,
+    pub width: u32,
+    pub height: u32,
+}
+
+impl FrameRect {
+    pub fn new(x: u32, y: u32, width: u32, height: u32) -> Self {
+        Self { x, y, width, height }
+    }
+
+    /// 整帧
+    pub fn full(frame_width: u32, frame_height: u32) -> Self {
+        Self::new(0, 0, frame_width, frame_height)
+    }
+
+    /// 裁到帧内；与帧没有交集或为空时返回 None
+    pub fn clamp_to(&self, frame_width: u32, frame_height: u32) -> Option<FrameRect> {
+        let x0 = self.x.min(frame_width);
+        let y0 = self.y.min(frame_height);
+        let x1 = self.x.saturating_add(self.width).min(frame_width);
+        let y1 = self.y.saturating_add(self.height).min(frame_height);
+        if x1 <= x0 || y1 <= y0 {
+            return None;
+        }
+        Some(Self::new(x0, y0, x1 - x0, y1 - y0))
+    }
+}
+
+/// 检测方式
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum DetectionMode {
+    /// 整个区域（整帧或 ROI）缩放到模型输入，一帧一次推理
+    Full,
+    /// 每帧都分块
+    Tiled,
+    /// 上一帧出现低置信度检测时分块，否则整幅
+    Adaptive,
+}
+
+impl Default for DetectionMode {
+    fn default() -> Self {
+        DetectionMode::Full
+    }
+}
+
+/// 分块检测配置
+#[derive(Debug, Clone)]
+pub struct TilingConfig {
+    pub mode: DetectionMode,
+    /// 图块边长（源帧像素）；0 取模型输入尺寸，图块不缩放、保持原分辨率
+    pub tile_size: u32,
+    /// 相邻图块的最小重叠比例（0..0.9）
+    pub overlap: f32,
+    /// 分块时再加一次整个区域的缩放检测，找回跨多个图块的大目标
+    pub include_overview: bool,
+    /// 跨块合并：同类框 IoU 超过此值视为同一目标
+    pub merge_iou: f32,
+    /// 跨块合并：交集占较小框面积的比例超过此值也视为同一目标（图块边缘截断的框）
+    pub merge_containment: f32,
+    /// 自适应：上一帧有置信度低于此值的检测时，下一帧分块
+    pub low_confidence: f32,
+    /// 自适应：最多连续分块的帧数，之后插入一帧整幅检测重新评估
+    pub max_consecutive_tiled: u32,
+}
+
+impl Default for TilingConfig {
+    fn default() -> Self {
+        Self {
+            mode: DetectionMode::Full,
+            tile_size: 0,
+            overlap: 0.2,
+            include_overview: true,
+            merge_iou: 0.5,
+            merge_containment: 0.8,
+            low_confidence: 0.5,
+            max_consecutive_tiled: 4,
+        }
+    }
+}
+
+impl TilingConfig {
+    pub fn validate(&self) -> Result<()> {
+        if !(0.0..0.9).contains(&self.overlap) {
+            return Err(RknnError::InvalidInput(format!("tile overlap {} out of range [0, 0.9)", self.overlap)));
+        }
+        for (name, value) in [
+            ("merge_iou", self.merge_iou),
+            ("merge_containment", self.merge_containment),
+            ("low_confidence", self.low_confidence),
+        ] {
+            if !(0.0..=1.0).contains(&value) {
+                return Err(RknnError::InvalidInput(format!("{} {} out of range [0, 1]", name, value)));
+            }
+        }
+        Ok(())
+    }
+}
+
+/// 一条轴上的图块起点：个数取满足重叠要求的最小值，起点均匀分布，首尾贴齐
+fn axis_positions(length: u32, tile: u32, overlap: f32) -> Vec<u32> {
+    if length <= tile {
+        return vec![0];
+    }
+    let stride = ((tile as f32 * (1.0 - overlap)).floor() as u32).max(1);
+    let span = length - tile;
+    let count = (span + stride - 1) / stride + 1;
+    (0..count)
+        .map(|i| ((span as u64 * i as u64 + (count as u64 - 1) / 2) / (count as u64 - 1)) as u32)
+        .collect()
+}
+
+/// 在 region 上铺 tile x tile 的图块（区域某一边不足 tile 时图块在该方向取区域长度）
+pub fn plan_tiles(region: FrameRect, tile: u32, overlap: f32) -> Vec<FrameRect> {
+    if region.width == 0 || region.height == 0 || tile == 0 {
+        return Vec::new();
+    }
+    let tile_w = tile.min(region.width);
+    let tile_h = tile.min(region.height);
+    let xs = axis_positions(region.width, tile_w, overlap);
+    let ys = axis_positions(region.height, tile_h, overlap);
+    let mut tiles = Vec::with_capacity(xs.len() * ys.len());
+    for &y in &ys {
+        for &x in &xs {
+            tiles.push(FrameRect::new(region.x + x, region.y + y, tile_w, tile_h));
+        }
+    }
+    tiles
+}
+
+/// letterbox 的缩放与偏移（与 [`crate::ImagePreprocessor`] 的 letterbox 相同的取整）
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct LetterboxGeometry {
+    pub scale: f32,
+    pub x_offset: f32,
+    pub y_offset: f32,
+}
+
+impl LetterboxGeometry {
+    pub fn new(src_width: u32, src_height: u32, model_width: u32, model_height: u32) -> Self {
+        let scale = (model_width as f32 / src_width as f32).min(model_height as f32 / src_height as f32);
+        let new_w = (src_width as f32 * scale) as u32;
+        let new_h = (src_height as f32 * scale) as u32;
+        Self {
+            scale,
+            x_offset: (model_width.saturating_sub(new_w) / 2) as f32,
+            y_offset: (model_height.saturating_sub(new_h) / 2) as f32,
+        }
+    }
+}
+
+/// 图块检测框的坐标换算：图块的模型输入坐标 → 源帧像素 → 整帧的模型输入坐标
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct TileMapping {
+    pub tile: FrameRect,
+    tile_letterbox: LetterboxGeometry,
+    frame_letterbox: LetterboxGeometry,
+}
+
+impl TileMapping {
+    pub fn new(tile: FrameRect, frame_width: u32, frame_height: u32, model_width: u32, model_height: u32) -> Self {
+        Self {
+            tile,
+            tile_letterbox: LetterboxGeometry::new(tile.width, tile.height, model_width, model_height),
+            frame_letterbox: LetterboxGeometry::new(frame_width, frame_height, model_width, model_height),
+        }
+    }
+
+    /// 换算一个框；框在图块的有效区域外（落在 letterbox 填充里）时返回 None
+    pub fn map(&self, det: &DetectionResult) -> Option<DetectionResult> {
+        let t = &self.tile_letterbox;
+        let f = &self.frame_letterbox;
+        let to_frame_x = |v: i32| {
+            let px = ((v as f32 - t.x_offset) / t.scale).clamp(0.0, self.tile.width as f32);
+            (px + self.tile.x as f32) * f.scale + f.x_offset
+        };
+        let to_frame_y = |v: i32| {
+            let px = ((v as f32 - t.y_offset) / t.scale).clamp(0.0, self.tile.height as f32);
+            (px + self.tile.y as f32) * f.scale + f.y_offset
+        };
+        let bbox = ImageRect {
+            left: to_frame_x(det.bbox.left).round() as i32,
+            top: to_frame_y(det.bbox.top).round() as i32,
+            right: to_frame_x(det.bbox.right).round() as i32,
+            bottom: to_frame_y(det.bbox.bottom).round() as i32,
+        };
+        if bbox.right <= bbox.left || bbox.bottom <= bbox.top {
+            return None;
+        }
+        Some(DetectionResult::new(bbox, det.confidence, det.class_id))
+    }
+}
+
+fn area(r: &ImageRect) -> f32 {
+    ((r.right - r.left).max(0) as f32) * ((r.bottom - r.top).max(0) as f32)
+}
+
+fn intersection(a: &ImageRect, b: &ImageRect) -> f32 {
+    let w = (a.right.min(b.right) - a.left.max(b.left)).max(0) as f32;
+    let h = (a.bottom.min(b.bottom) - a.top.max(b.top)).max(0) as f32;
+    w * h
+}
+
+/// 跨块合并：按置信度从高到低，同类框与已保留的框 IoU 超过 iou 或包含比例超过 containment 时丢弃。
+/// 最多保留 max_detections 个（0 表示不限）
+pub fn merge_detections(
+    mut detections: Vec<DetectionResult>,
+    iou: f32,
+    containment: f32,
+    max_detections: usize,
+) -> Vec<DetectionResult> {
+    detections.sort_by(|a, b| b.confidence.partial_cmp(&a.confidence).unwrap_or(std::cmp::Ordering::Equal));
+    let limit = if max_detections == 0 { usize::MAX } else { max_detections };
+    let mut kept: Vec<DetectionResult> = Vec::with_capacity(detections.len().min(limit));
+    for det in detections {
+        if kept.len() >= limit {
+            break;
+        }
+        let det_area = area(&det.bbox);
+        let duplicate = kept.iter().filter(|k| k.class_id == det.class_id).any(|k| {
+            let inter = intersection(&k.bbox, &det.bbox);
+            if inter <= 0.0 {
+                return false;
+            }
+            let kept_area = area(&k.bbox);
+            let union = kept_area + det_area - inter;
+            let smaller = kept_area.min(det_area);
+            (union > 0.0 && inter / union > iou) || (smaller > 0.0 && inter / smaller > containment)
+        });
+        if !duplicate {
+            kept.push(det);
+        }
+    }
+    kept
+}
+
+/// 从 RGB888 帧上裁出一块（连续存放）
+pub fn crop_rgb888(frame: &ImageBuffer, rect: FrameRect) -> Option<ImageBuffer> {
+    let (fw, fh) = (frame.width.max(0) as u32, frame.height.max(0) as u32);
+    if rect.clamp_to(fw, fh) != Some(rect) || frame.data.len() < (fw as usize) * (fh as usize) * 3 {
+        return None;
+    }
+    let row = rect.width as usize * 3;
+    let stride = fw as usize * 3;
+    let mut data = Vec::with_capacity(row * rect.height as usize);
+    for y in rect.y..rect.y + rect.height {
+        let start = y as usize * stride + rect.x as usize * 3;
+        data.extend_from_slice(&frame.data[start..start + row]);
+    }
+    Some(ImageBuffer::from_rgb888(rect.width as i32, rect.height as i32, data))
+}
+
+/// 每帧的检测计划：决定整幅还是分块，并给出各检测任务的区域
+#[derive(Debug, Default)]
+pub struct TilePlanner {
+    /// 上一个完成的帧里是否有低置信度检测
+    low_confidence_seen: bool,
+    /// 已连续提交的分块帧数
+    consecutive_tiled: u32,
+}
+
+impl TilePlanner {
+    /// 本帧的检测区域列表：第一个为整个区域（整幅检测或分块时的概览，可能省略），其余为图块。
+    /// 返回 (区域列表, 是否分块)；ROI 为空或在帧外时以整帧为区域
+    pub fn plan(
+        &mut self,
+        config: &TilingConfig,
+        frame_width: u32,
+        frame_height: u32,
+        roi: Option<FrameRect>,
+        model_size: u32,
+    ) -> (Vec<FrameRect>, bool) {
+        let region = roi
+            .and_then(|r| r.clamp_to(frame_width, frame_height))
+            .unwrap_or_else(|| FrameRect::full(frame_width, frame_height));
+        let tile = if config.tile_size == 0 { model_size } else { config.tile_size };
+
+        let want_tiles = match config.mode {
+            DetectionMode::Full => false,
+            DetectionMode::Tiled => true,
+            DetectionMode::Adaptive => {
+                self.low_confidence_seen && self.consecutive_tiled < config.max_consecutive_tiled.max(1)
+            }
+        };
+        let tiles = if want_tiles { plan_tiles(region, tile, config.overlap) } else { Vec::new() };
+        // 区域本身不超过一个图块时分块没有意义，整幅检测即可（小 ROI 会被放大到模型输入）
+        if tiles.len() <= 1 {
+            self.consecutive_tiled = 0;
+            return (vec![region], false);
+        }
+
+        self.consecutive_tiled += 1;
+        let mut regions = Vec::with_capacity(tiles.len() + 1);
+        if config.include_overview {
+            regions.push(region);
+        }
+        regions.extend(tiles);
+        (regions, true)
+    }
+
+    /// 记录一帧的合并结果，供自适应模式决定下一帧
+    pub fn observe(&mut self, config: &TilingConfig, detections: &[DetectionResult]) {
+        self.low_confidence_seen = detections.iter().any(|d| d.confidence < config.low_confidence);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn det(left: i32, top: i32, right: i32, bottom: i32, confidence: f32, class_id: i32) -> DetectionResult {
+        DetectionResult::new(ImageRect { left, top, right, bottom }, confidence, class_id)
+    }
+
+    #[test]
+    fn test_plan_tiles_covers_region_with_overlap() {
+        let tiles = plan_tiles(FrameRect::full(1280, 720), 640, 0.2);
+        let xs: Vec<u32> = tiles.iter().filter(|t| t.y == 0).map(|t| t.x).collect();
+        let ys: Vec<u32> = tiles.iter().filter(|t| t.x == 0).map(|t| t.y).collect();
+        assert_eq!(xs, vec![0, 320, 640]);
+        assert_eq!(ys, vec![0, 80]);
+        assert!(tiles.iter().all(|t| t.width == 640 && t.height == 640));
+
+        // ROI 不足一个图块：一块，取 ROI 本身
+        let roi = FrameRect::new(100, 50, 300, 200);
+        assert_eq!(plan_tiles(roi, 640, 0.2), vec![roi]);
+
+        // 每个像素都被覆盖，相邻图块重叠不少于要求
+        let region = FrameRect::new(10, 20, 1000, 700);
+        let tiles = plan_tiles(region, 320, 0.25);
+        for x in [10u32, 500, 1009] {
+            for y in [20u32, 400, 719] {
+                assert!(tiles.iter().any(|t| x >= t.x && x < t.x + t.width && y >= t.y && y < t.y + t.height));
+            }
+        }
+        let xs = axis_positions(1000, 320, 0.25);
+        assert!(xs.windows(2).all(|w| w[1] - w[0] <= 240));
+        assert_eq!(*xs.last().unwrap(), 680);
+    }
+
+    #[test]
+    fn test_tile_mapping_to_frame_model_space() {
+        // 1280x720 整帧 letterbox 到 640：scale 0.5，y 偏移 140
+        let tile = FrameRect::new(640, 80, 640, 640);
+        let mapping = TileMapping::new(tile, 1280, 720, 640, 640);
+        // 图块原分辨率送入模型，图块内 (100, 200)-(140, 260) 即源帧 (740, 280)-(780, 340)
+        let mapped = mapping.map(&det(100, 200, 140, 260, 0.9, 3)).unwrap();
+        assert_eq!(
+            (mapped.bbox.left, mapped.bbox.top, mapped.bbox.right, mapped.bbox.bottom),
+            (370, 280, 390, 310)
+        );
+        assert_eq!(mapped.class_id, 3);
+
+        // 整帧区域的换算是恒等的
+        let full = TileMapping::new(FrameRect::full(1280, 720), 1280, 720, 640, 640);
+        let same = full.map(&det(10, 150, 200, 300, 0.5, 0)).unwrap();
+        assert_eq!((same.bbox.left, same.bbox.top, same.bbox.right, same.bbox.bottom), (10, 150, 200, 300));
+
+        // 小 ROI 放大送入模型
+        let roi = TileMapping::new(FrameRect::new(0, 0, 320, 180), 1280, 720, 640, 640);
+        let zoomed = roi.map(&det(0, 140, 640, 500, 0.5, 0)).unwrap();
+        assert_eq!((zoomed.bbox.left, zoomed.bbox.top, zoomed.bbox.right, zoomed.bbox.bottom), (0, 140, 160, 230));
+    }
+
+    #[test]
+    fn test_merge_detections_across_tiles() {
+        let merged = merge_detections(
+            vec![
+                det(0, 0, 100, 100, 0.6, 1),
+                det(5, 5, 105, 105, 0.9, 1),  // 与上一个 IoU 高：保留置信度高的
+                det(60, 0, 100, 100, 0.7, 1), // 被截断、完全落在上面的框里
+                det(0, 0, 100, 100, 0.5, 2),  // 不同类别不合并
+                det(300, 300, 340, 340, 0.4, 1),
+            ],
+            0.5,
+            0.8,
+            0,
+        );
+        let confidences: Vec<f32> = merged.iter().map(|d| d.confidence).collect();
+        assert_eq!(confidences, vec![0.9, 0.5, 0.4]);
+
+        let limited = merge_detections(vec![det(0, 0, 10, 10, 0.9, 0), det(50, 50, 60, 60, 0.8, 0)], 0.5, 0.8, 1);
+        assert_eq!(limited.len(), 1);
+    }
+
+    #[test]
+    fn test_crop_rgb888() {
+        let data: Vec<u8> = (0..4 * 3 * 3).map(|v| v as u8).collect();
+        let frame = ImageBuffer::from_rgb888(4, 3, data);
+        let crop = crop_rgb888(&frame, FrameRect::new(1, 1, 2, 2)).unwrap();
+        assert_eq!(crop.width, 2);
+        assert_eq!(crop.data, vec![15, 16, 17, 18, 19, 20, 27, 28, 29, 30, 31, 32]);
+        assert!(crop_rgb888(&frame, FrameRect::new(3, 0, 2, 1)).is_none());
+    }
+
+    #[test]
+    fn test_adaptive_planner_bounds_tiled_frames() {
+        let config = TilingConfig { mode: DetectionMode::Adaptive, max_consecutive_tiled: 2, ..Default::default() };
+        let mut planner = TilePlanner::default();
+
+        let (regions, tiled) = planner.plan(&config, 1280, 720, None, 640);
+        assert!(!tiled);
+        assert_eq!(regions, vec![FrameRect::full(1280, 720)]);
+
+        // 出现低置信度检测后分块（概览 + 6 块），连续两帧后插入一帧整幅
+        planner.observe(&config, &[det(0, 0, 10, 10, 0.3, 0)]);
+        let (regions, tiled) = planner.plan(&config, 1280, 720, None, 640);
+        assert!(tiled);
+        assert_eq!(regions.len(), 7);
+        assert!(planner.plan(&config, 1280, 720, None, 640).1);
+        assert!(!planner.plan(&config, 1280, 720, None, 640).1);
+        assert!(planner.plan(&config, 1280, 720, None, 640).1);
+
+        // 只有高置信度检测时回到整幅
+        planner.observe(&config, &[det(0, 0, 10, 10, 0.9, 0)]);
+        assert!(!planner.plan(&config, 1280, 720, None, 640).1);
+
+        // ROI 模式：整幅检测只看 ROI
+        let roi = FrameRect::new(200, 100, 400, 300);
+        let full = TilingConfig::default();
+        assert_eq!(planner.plan(&full, 1280, 720, Some(roi), 640), (vec![roi], false));
+        // 帧外的 ROI 退回整帧
+        let outside = Some(FrameRect::new(2000, 0, 10, 10));
+        assert_eq!(planner.plan(&full, 1280, 720, outside, 640).0, vec![FrameRect::full(1280, 720)]);
+    }
+}
@@ -71,3 +71,319 @@ impl DetectionResult {
         }
     }
 }
+
+/// 类别位图能表示的最大类别数（与 C++ 侧 YOLOV8_MAX_CLASSES 一致）
+pub const MAX_CLASSES: usize = 256;
+
+/// YOLOv8 后处理配置
+///
+/// 替代原先编译期固定的阈值宏，按部署场景在运行时调整。
+/// 类别数由模型 score 输出的形状决定，不在这里配置。
+#[derive(Debug, Clone, PartialEq)]
+pub struct PostprocessConfig {
+    /// 置信度阈值，范围 [0, 1]
+    pub conf_threshold: f32,
+    /// NMS IoU 阈值，范围 [0, 1]
+    pub nms_threshold: f32,
+    /// 每帧最多输出的检测数，0 或超过结果表容量（128）时取容量
+    pub max_detections: usize,
+    /// 只保留这些类别；为空表示不过滤。过滤在解码阶段完成，未列出类别的分数不会被读取
+    pub allowed_classes: Vec<u32>,
+}
+
+impl Default for PostprocessConfig {
+    fn default() -> Self {
+        Self {
+            conf_threshold: 0.25,
+            nms_threshold: 0.45,
+            max_detections: 128,
+            allowed_classes: Vec::new(),
+        }
+    }
+}
+
+impl PostprocessConfig {
+    /// 允许类别的位图（类别 c 对应 `mask[c / 64]` 的第 `c % 64` 位），全 0 表示不过滤
+    pub fn class_mask(&self) -> crate::Result<[u64; MAX_CLASSES / 64]> {
+        let mut mask = [0u64; MAX_CLASSES / 64];
+        for &c in &self.allowed_classes {
+            let c = c as usize;
+            if c >= MAX_CLASSES {
+                return Err(crate::RknnError::InvalidInput(format!(
+                    "class id {} exceeds the supported maximum {}",
+                    c,
+                    MAX_CLASSES - 1
+                )));
+            }
+            mask[c / 64] |= 1u64 << (c % 64);
+        }
+        Ok(mask)
+    }
+
+    /// 检查阈值与类别范围
+    pub fn validate(&self) -> crate::Result<()> {
+        if !(0.0..=1.0).contains(&self.conf_threshold) {
+            return Err(crate::RknnError::InvalidInput(format!(
+                "conf_threshold {} out of [0, 1]",
+                self.conf_threshold
+            )));
+        }
+        if !(0.0..=1.0).contains(&self.nms_threshold) {
+            return Err(crate::RknnError::InvalidInput(format!(
+                "nms_threshold {} out of [0, 1]",
+                self.nms_threshold
+            )));
+        }
+        self.class_mask().map(|_| ())
+    }
+}
+
+/// 单个模型实例的初始化耗时（毫秒）
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct InitTiming {
+    /// 映射模型文件（命中映射缓存或复制上下文时接近 0）
+    pub load_ms: f64,
+    /// rknn_init 或 rknn_dup_context
+    pub init_ms: f64,
+    /// 查询输入输出属性（复制上下文时为拷贝源属性）
+    pub query_ms: f64,
+    /// 后处理工作区与张量后端
+    pub setup_ms: f64,
+    /// 类别名（全进程只在第一个实例读文件）
+    pub labels_ms: f64,
+    /// 是否由 rknn_dup_context 复制而来
+    pub duplicated: bool,
+}
+
+impl InitTiming {
+    pub fn total_ms(&self) -> f64 {
+        self.load_ms + self.init_ms + self.query_ms + self.setup_ms + self.labels_ms
+    }
+}
+
+/// 耗时直方图的桶数（与 C++ 侧 YOLOV8_STATS_BUCKETS 一致）
+pub const STATS_BUCKETS: usize = 20;
+
+/// 单阶段耗时统计（微秒，布局与 C++ 侧 yolov8_stage_stats 一致）
+///
+/// 直方图以 2 为底：桶 0 为 0us，桶 i（i >= 1）为 [2^(i-1), 2^i) us，最后一个桶兜底更长的耗时
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct StageStats {
+    pub count: u64,
+    pub total_us: u64,
+    pub max_us: u64,
+    pub last_us: u64,
+    pub buckets: [u64; STATS_BUCKETS],
+}
+
+impl StageStats {
+    /// 耗时所在的桶（与 C++ 侧 yolov8_stats_bucket 相同）
+    pub fn bucket(us: u64) -> usize {
+        let bits = (64 - us.leading_zeros()) as usize;
+        bits.min(STATS_BUCKETS - 1)
+    }
+
+    /// 记录一次耗时（Rust 侧的阶段，如流水线预处理）
+    pub fn record(&mut self, us: u64) {
+        self.count += 1;
+        self.total_us += us;
+        self.last_us = us;
+        self.max_us = self.max_us.max(us);
+        self.buckets[Self::bucket(us)] += 1;
+    }
+
+    /// 合并另一份统计（多个上下文汇总）；last 取非空的一方
+    pub fn merge(&mut self, other: &StageStats) {
+        if other.count == 0 {
+            return;
+        }
+        self.count += other.count;
+        self.total_us += other.total_us;
+        self.max_us = self.max_us.max(other.max_us);
+        self.last_us = other.last_us;
+        for (dst, src) in self.buckets.iter_mut().zip(other.buckets.iter()) {
+            *dst += *src;
+        }
+    }
+
+    pub fn mean_us(&self) -> f64 {
+        if self.count == 0 {
+            0.0
+        } else {
+            self.total_us as f64 / self.count as f64
+        }
+    }
+
+    /// 分位数估计（p 取 0..=1）：取累计计数达到 p 的桶上界，不超过 max_us
+    pub fn percentile_us(&self, p: f64) -> u64 {
+        if self.count == 0 {
+            return 0;
+        }
+        let rank = ((p.clamp(0.0, 1.0) * self.count as f64).ceil() as u64).max(1);
+        let mut seen = 0u64;
+        for (i, n) in self.buckets.iter().enumerate() {
+            seen += *n;
+            if seen >= rank {
+                let upper = if i == 0 { 0 } else { (1u64 << i) - 1 };
+                return upper.min(self.max_us);
+            }
+        }
+        self.max_us
+    }
+}
+
+/// 推理统计快照（布局与 C++ 侧 yolov8_inference_stats 一致）
+///
+/// 单个上下文由 `Yolov8Detector::stats` 取得；流水线服务把各上下文汇总，并计入 Rust 侧的预处理
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct InferenceStats {
+    /// 缩放 / letterbox 到模型输入
+    pub preprocess: StageStats,
+    /// 拷贝输入 + rknn_run
+    pub run: StageStats,
+    /// 取输出（拷贝后端的 rknn_outputs_get）
+    pub outputs: StageStats,
+    /// 解码候选框
+    pub decode: StageStats,
+    /// NMS 与结果换算
+    pub nms: StageStats,
+    /// 完成后处理的帧数
+    pub frames: u64,
+    /// 失败次数（推理、取输出、后处理）
+    pub errors: u64,
+    /// 解码得到的候选数（NMS 之前）
+    pub candidates_total: u64,
+    pub candidates_max: u64,
+    pub candidates_last: u64,
+    /// 超出候选缓冲容量被丢弃的累计数
+    pub candidates_dropped: u64,
+    /// NMS 之后的检测数
+    pub detections_total: u64,
+    pub detections_last: u64,
+}
+
+impl InferenceStats {
+    pub fn merge(&mut self, other: &InferenceStats) {
+        self.preprocess.merge(&other.preprocess);
+        self.run.merge(&other.run);
+        self.outputs.merge(&other.outputs);
+        self.decode.merge(&other.decode);
+        self.nms.merge(&other.nms);
+        self.frames += other.frames;
+        self.errors += other.errors;
+        self.candidates_total += other.candidates_total;
+        self.candidates_max = self.candidates_max.max(other.candidates_max);
+        if other.frames > 0 {
+            self.candidates_last = other.candidates_last;
+            self.detections_last = other.detections_last;
+        }
+        self.candidates_dropped += other.candidates_dropped;
+        self.detections_total += other.detections_total;
+    }
+
+    /// 按 C++ 侧 yolov8_stage 的顺序列出各阶段
+    pub fn stages(&self) -> [(&'static str, &StageStats); 5] {
+        [
+            ("preprocess", &self.preprocess),
+            ("run", &self.run),
+            ("outputs", &self.outputs),
+            ("decode", &self.decode),
+            ("nms", &self.nms),
+        ]
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_postprocess_config_class_mask() {
+        let config = PostprocessConfig {
+            allowed_classes: vec![0, 63, 64, 255],
+            ..Default::default()
+        };
+        let mask = config.class_mask().unwrap();
+        assert_eq!(mask, [1u64 | (1u64 << 63), 1u64, 0u64, 1u64 << 63]);
+        assert_eq!(PostprocessConfig::default().class_mask().unwrap(), [0; 4]);
+    }
+
+    #[test]
+    fn test_postprocess_config_validate() {
+        assert!(PostprocessConfig::default().validate().is_ok());
+
+        let bad_class = PostprocessConfig {
+            allowed_classes: vec![256],
+            ..Default::default()
+        };
+        assert!(bad_class.validate().is_err());
+
+        let bad_conf = PostprocessConfig {
+            conf_threshold: 1.5,
+            ..Default::default()
+        };
+        assert!(bad_conf.validate().is_err());
+
+        let nan_nms = PostprocessConfig {
+            nms_threshold: f32::NAN,
+            ..Default::default()
+        };
+        assert!(nan_nms.validate().is_err());
+    }
+
+    #[test]
+    fn test_stage_stats_histogram() {
+        assert_eq!(StageStats::bucket(0), 0);
+        assert_eq!(StageStats::bucket(1), 1);
+        assert_eq!(StageStats::bucket(3), 2);
+        assert_eq!(StageStats::bucket(1024), 11);
+        assert_eq!(StageStats::bucket(u64::MAX), STATS_BUCKETS - 1);
+
+        let mut stats = StageStats::default();
+        for us in [100u64, 100, 100, 5000] {
+            stats.record(us);
+        }
+        assert_eq!(stats.count, 4);
+        assert_eq!(stats.max_us, 5000);
+        assert_eq!(stats.last_us, 5000);
+        assert_eq!(stats.mean_us(), 1325.0);
+        // 100us 落在 [64, 128) 桶，p50 取桶上界；p99 不超过最大值
+        assert_eq!(stats.percentile_us(0.5), 127);
+        assert_eq!(stats.percentile_us(0.99), 5000);
+        assert_eq!(StageStats::default().percentile_us(0.5), 0);
+    }
+
+    #[test]
+    fn test_inference_stats_merge() {
+        let mut a = InferenceStats::default();
+        a.run.record(10_000);
+        a.frames = 1;
+        a.candidates_total = 30;
+        a.candidates_max = 30;
+        a.candidates_last = 30;
+        a.detections_last = 2;
+
+        let mut b = InferenceStats::default();
+        b.run.record(20_000);
+        b.frames = 2;
+        b.candidates_total = 10;
+        b.candidates_max = 6;
+        b.candidates_last = 4;
+        b.detections_last = 1;
+
+        let mut total = InferenceStats::default();
+        total.merge(&a);
+        total.merge(&b);
+        total.merge(&InferenceStats::default());
+        assert_eq!(total.run.count, 2);
+        assert_eq!(total.run.max_us, 20_000);
+        assert_eq!(total.frames, 3);
+        assert_eq!(total.candidates_total, 40);
+        assert_eq!(total.candidates_max, 30);
+        assert_eq!(total.candidates_last, 4);
+        assert_eq!(total.detections_last, 1);
+        assert_eq!(total.stages()[1].0, "run");
+    }
+}
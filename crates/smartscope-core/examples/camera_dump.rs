@@ -0,0 +1,56 @@
+//! 从真实相机录制帧转储（.ssdump）
+//!
+//! 录制的文件保留原始压缩帧、采集时间戳与左右配对，
+//! 可在 smartscope.toml 中设置 `[camera] source = "replay"` 回放。
+//!
+//! 用法:
+//!   cargo run -p smartscope-core --example camera_dump -- <输出.ssdump> [秒数]
+
+use smartscope_core::config::SmartScopeConfig;
+use smartscope_core::{CameraManager, FrameDumper};
+use std::sync::Arc;
+use std::time::{Duration, Instant};
+
+fn main() -> Result<(), Box<dyn std::error::Error>> {
+    let args: Vec<String> = std::env::args().skip(1).collect();
+    if args.is_empty() {
+        eprintln!("用法: camera_dump <输出.ssdump> [秒数]");
+        std::process::exit(1);
+    }
+    let output = &args[0];
+    let seconds: u64 = args.get(1).and_then(|s| s.parse().ok()).unwrap_or(10);
+
+    let config = SmartScopeConfig::load_with_fallback();
+    let mut camera = CameraManager::new(config);
+    camera.initialize()?;
+    camera.start()?;
+    println!("相机模式: {:?}，录制 {} 秒 -> {}", camera.get_camera_mode(), seconds, output);
+
+    let dumper = Arc::new(FrameDumper::start(output, 64)?);
+    camera.set_dump_sink(Some(Arc::clone(&dumper)));
+
+    let signal = camera.frame_signal();
+    let deadline = Instant::now() + Duration::from_secs(seconds);
+    let mut seq = 0;
+    while Instant::now() < deadline {
+        if let Some((s, _)) = signal.wait_newer(seq, Duration::from_millis(100)) {
+            seq = s;
+        }
+        camera.process_frames();
+        // 取走缓存，模拟显示端消费
+        let _ = camera.get_left_frame();
+        let _ = camera.get_right_frame();
+        let _ = camera.get_single_frame();
+    }
+
+    camera.set_dump_sink(None);
+    let stats = dumper.stop()?;
+    camera.stop()?;
+    println!(
+        "写入 {} 帧，丢帧 {}，{:.1} MB",
+        stats.frames_written,
+        stats.frames_dropped,
+        stats.bytes_written as f64 / 1_048_576.0
+    );
+    Ok(())
+}
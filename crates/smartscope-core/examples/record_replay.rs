@@ -0,0 +1,86 @@
+//! 录制引擎回放测试
+//!
+//! 从 JPEG 目录或拼接的 MJPEG 文件读取帧，按指定帧率送入 VideoRecorder，
+//! 无需相机即可验证容器输出与丢帧/吞吐统计。
+//!
+//! 用法:
+//!   cargo run -p smartscope-core --example record_replay -- <JPEG目录|文件.mjpeg> <输出.mkv|.avi> [fps] [--h264] [--burst]
+//!
+//! `--burst` 不按帧率节流，一次性提交全部帧，用于观察队列满时的丢帧行为。
+
+use smartscope_core::replay::{jpeg_dimensions, split_mjpeg};
+use smartscope_core::{RecorderConfig, RecordingCodec, VideoRecorder};
+use std::path::{Path, PathBuf};
+use std::time::{Duration, Instant, SystemTime};
+
+fn load_frames(input: &Path) -> std::io::Result<Vec<Vec<u8>>> {
+    if input.is_dir() {
+        let mut paths: Vec<PathBuf> = std::fs::read_dir(input)?
+            .filter_map(|e| e.ok().map(|e| e.path()))
+            .filter(|p| {
+                p.extension()
+                    .and_then(|e| e.to_str())
+                    .map(|e| e.eq_ignore_ascii_case("jpg") || e.eq_ignore_ascii_case("jpeg"))
+                    .unwrap_or(false)
+            })
+            .collect();
+        paths.sort();
+        paths.iter().map(std::fs::read).collect()
+    } else {
+        Ok(split_mjpeg(&std::fs::read(input)?))
+    }
+}
+
+fn main() -> Result<(), Box<dyn std::error::Error>> {
+    let args: Vec<String> = std::env::args().skip(1).collect();
+    let positional: Vec<&String> = args.iter().filter(|a| !a.starts_with("--")).collect();
+    if positional.len() < 2 {
+        eprintln!("用法: record_replay <JPEG目录|文件.mjpeg> <输出.mkv|.avi> [fps] [--h264] [--burst]");
+        std::process::exit(1);
+    }
+    let input = Path::new(positional[0]);
+    let output = Path::new(positional[1]);
+    let fps: u32 = positional.get(2).and_then(|s| s.parse().ok()).unwrap_or(30);
+    let h264 = args.iter().any(|a| a == "--h264");
+    let burst = args.iter().any(|a| a == "--burst");
+
+    let frames = load_frames(input)?;
+    if frames.is_empty() {
+        return Err("输入中没有 JPEG 帧".into());
+    }
+    let (width, height) = jpeg_dimensions(&frames[0]).ok_or("无法解析 JPEG 尺寸")?;
+    println!("读取 {} 帧 ({}x{})，目标帧率 {} fps", frames.len(), width, height, fps);
+
+    let mut config = RecorderConfig::new(output, fps);
+    if h264 {
+        config.codec = RecordingCodec::H264Software;
+    }
+    let recorder = VideoRecorder::start(config)?;
+
+    let interval = Duration::from_secs_f64(1.0 / fps.max(1) as f64);
+    let t0 = SystemTime::now();
+    let start = Instant::now();
+    for (i, frame) in frames.iter().enumerate() {
+        let ts = t0 + interval * i as u32;
+        if !burst {
+            let due = start + interval * i as u32;
+            let now = Instant::now();
+            if due > now {
+                std::thread::sleep(due - now);
+            }
+        }
+        recorder.submit(frame, width, height, ts);
+    }
+
+    let stats = recorder.stop()?;
+    println!(
+        "写入 {} 帧，丢帧 {}，{:.2} MB，用时 {} ms，吞吐 {:.2} MB/s",
+        stats.frames_written,
+        stats.frames_dropped,
+        stats.bytes_written as f64 / 1_048_576.0,
+        stats.elapsed_ms,
+        stats.write_bytes_per_sec / 1_048_576.0
+    );
+    println!("输出: {}", output.display());
+    Ok(())
+}
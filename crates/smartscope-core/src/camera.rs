@@ -9,13 +9,15 @@ use std::thread;
 use std::sync::atomic::{AtomicBool, Ordering};
 use std::sync::mpsc;
 use crate::error::{SmartScopeError, Result};
-use crate::config::SmartScopeConfig;
+use crate::config::{CameraSource, SmartScopeConfig};
+use crate::recorder::VideoRecorder;
+use crate::replay::{DumpStream, FrameDumper, ReplaySource};
 use linuxvideo::{Device as LvDevice, BufType as LvBufType};
 use linuxvideo::format::{PixelFormat as LvPixFmt, FrameSizes, FrameIntervals};
 
 // 重新导出USB相机相关类型
 pub use usb_camera::{
-    CameraStreamReader, CameraConfig, VideoFrame,
+    CameraStreamReader, CameraConfig, VideoFrame, FrameSignal,
     V4L2DeviceManager, CameraResult, CameraError,
     CameraControl, CameraProperty, ParameterRange,
 };
@@ -68,6 +70,14 @@ pub struct CameraManager {
     cached_connection_status: Arc<Mutex<(bool, bool, Instant)>>, // (left, right, last_check_time)
     /// 模式变化通知接收端
     mode_change_rx: Option<mpsc::Receiver<CameraMode>>,
+    /// 新帧通知（挂在显示用的左相机/单相机读取器上，跨模式切换保持不变）
+    frame_signal: Arc<FrameSignal>,
+    /// 录制输出（显示用的左相机/单相机帧在读取时直接送入）
+    record_sink: Arc<Mutex<Option<Arc<VideoRecorder>>>>,
+    /// 帧转储输出（左右/单目原始帧，用于回放测试）
+    dump_sink: Arc<Mutex<Option<Arc<FrameDumper>>>>,
+    /// 磁盘回放源（camera.source = "replay" 时替代 V4L2 读取器）
+    replay: Option<ReplaySource>,
 }
 
 impl CameraManager {
@@ -91,6 +101,10 @@ impl CameraManager {
             // 初始状态：未连接，时间设为很久以前以触发首次检测
             cached_connection_status: Arc::new(Mutex::new((false, false, Instant::now() - Duration::from_secs(10)))),
             mode_change_rx: None,
+            frame_signal: Arc::new(FrameSignal::new()),
+            record_sink: Arc::new(Mutex::new(None)),
+            dump_sink: Arc::new(Mutex::new(None)),
+            replay: None,
         }
     }
 
@@ -201,6 +215,10 @@ impl CameraManager {
     pub fn initialize(&mut self) -> Result<()> {
         tracing::info!("初始化相机管理器");
 
+        if self.config.camera.source == CameraSource::Replay {
+            return self.initialize_replay();
+        }
+
         // 首先检测可用的相机设备
         let detected_cameras = self.detect_cameras()?;
 
@@ -280,11 +298,12 @@ impl CameraManager {
                     if camera.is_left {
                         tracing::info!("创建左相机流读取器: {}", camera.device_path);
                         let (w,h,fps,pf) = pick_best(&camera.device_path);
-                        let reader = CameraStreamReader::new(
+                        let mut reader = CameraStreamReader::new(
                             &camera.device_path,
                             &camera.name,
                             CameraConfig{ width:w, height:h, framerate:fps, pixel_format: pf.clone(), parameters: std::collections::HashMap::new() },
                         );
+                        reader.set_frame_signal(Arc::clone(&self.frame_signal));
                         self.left_reader = Some(reader);
 
                         // 创建左相机参数控制
@@ -313,11 +332,12 @@ impl CameraManager {
                 if let Some(camera) = detected_cameras.first() {
                     tracing::info!("创建单相机流读取器: {}", camera.device_path);
                     let (w,h,fps,pf) = pick_best(&camera.device_path);
-                    let reader = CameraStreamReader::new(
+                    let mut reader = CameraStreamReader::new(
                         &camera.device_path,
                         &camera.name,
                         CameraConfig{ width:w, height:h, framerate:fps, pixel_format: pf.clone(), parameters: std::collections::HashMap::new() },
                     );
+                    reader.set_frame_signal(Arc::clone(&self.frame_signal));
                     self.single_reader = Some(reader);
 
                     // 创建单相机参数控制
@@ -335,6 +355,18 @@ impl CameraManager {
         Ok(())
     }
 
+    /// 初始化磁盘回放源（不访问 V4L2 设备）
+    fn initialize_replay(&mut self) -> Result<()> {
+        let replay = ReplaySource::open(&self.config.camera.replay, self.config.camera.fps)?;
+        let mode = replay.mode();
+        tracing::info!("相机回放模式: {} -> {:?}", self.config.camera.replay.path, mode);
+        if let Ok(mut current_mode) = self.current_mode.lock() {
+            *current_mode = mode;
+        }
+        self.replay = Some(replay);
+        Ok(())
+    }
+
     /// 根据检测到的相机确定相机模式
     fn determine_camera_mode(&self, cameras: &[DetectedCamera]) -> CameraMode {
         let left_count = cameras.iter().filter(|c| c.is_left).count();
@@ -358,12 +390,22 @@ impl CameraManager {
         tracing::info!("启动相机系统");
 
         // 如果没有初始化，先初始化
-        if self.left_reader.is_none() && self.right_reader.is_none() && self.single_reader.is_none() {
+        if self.left_reader.is_none() && self.right_reader.is_none() && self.single_reader.is_none()
+            && self.replay.is_none()
+        {
             self.initialize()?;
         }
 
         let mode = *self.current_mode.lock().unwrap();
 
+        // 回放源：不启动设备读取器与热插拔监测
+        if let Some(ref mut replay) = self.replay {
+            replay.start(Arc::clone(&self.frame_signal))?;
+            self.running = true;
+            tracing::info!("相机回放启动成功，当前模式: {:?}", mode);
+            return Ok(());
+        }
+
         match mode {
             CameraMode::StereoCamera => {
                 // 启动左相机
@@ -506,6 +548,11 @@ impl CameraManager {
             })?;
         }
 
+        // 停止回放源
+        if let Some(ref mut replay) = self.replay {
+            replay.stop();
+        }
+
         // 清理帧缓存
         if let Ok(mut left) = self.left_frame.lock() {
             *left = None;
@@ -536,6 +583,22 @@ impl CameraManager {
 
         let mode = *self.current_mode.lock().unwrap();
 
+        // 回放源：从回放槽取帧，其余路径与实时相机一致
+        if let Some(ref replay) = self.replay {
+            match mode {
+                CameraMode::StereoCamera => {
+                    let (left, right) = replay.take_stereo_pair();
+                    self.store_stereo_frames(left, right);
+                }
+                CameraMode::SingleCamera => {
+                    let single = replay.take_single();
+                    self.store_single_frame(single);
+                }
+                CameraMode::NoCamera => {}
+            }
+            return;
+        }
+
         match mode {
             CameraMode::StereoCamera => {
                 // 并行读取左右相机帧（使用rayon或者手动spawn）
@@ -551,27 +614,14 @@ impl CameraManager {
                     .flatten();
 
                 // 批量更新帧缓存，减少锁竞争
-                if let Some(frame) = left_frame_opt {
-                    if let Ok(mut left) = self.left_frame.lock() {
-                        *left = Some(frame);
-                    }
-                }
-
-                if let Some(frame) = right_frame_opt {
-                    if let Ok(mut right) = self.right_frame.lock() {
-                        *right = Some(frame);
-                    }
-                }
+                self.store_stereo_frames(left_frame_opt, right_frame_opt);
             }
             CameraMode::SingleCamera => {
                 // 从单相机读取帧
-                if let Some(ref mut reader) = self.single_reader {
-                    if let Ok(Some(frame)) = reader.read_frame() {
-                        if let Ok(mut single) = self.single_frame.lock() {
-                            *single = Some(frame);
-                        }
-                    }
-                }
+                let frame_opt = self.single_reader.as_mut()
+                    .and_then(|reader| reader.read_frame().ok())
+                    .flatten();
+                self.store_single_frame(frame_opt);
             }
             CameraMode::NoCamera => {
                 // 无相机模式，不读取帧
@@ -579,6 +629,76 @@ impl CameraManager {
         }
     }
 
+    /// 更新双目帧缓存（同时送入录制与转储）
+    ///
+    /// 转储中右帧先于左帧写入：回放在左帧（显示帧）到达时通知，此时同一对已齐备。
+    pub(crate) fn store_stereo_frames(&self, left_frame: Option<VideoFrame>, right_frame: Option<VideoFrame>) {
+        if let Some(ref frame) = right_frame {
+            self.dump_frame(DumpStream::Right, frame);
+        }
+
+        if let Some(frame) = left_frame {
+            self.record_frame(&frame);
+            self.dump_frame(DumpStream::Left, &frame);
+            if let Ok(mut left) = self.left_frame.lock() {
+                *left = Some(frame);
+            }
+        }
+
+        if let Some(frame) = right_frame {
+            if let Ok(mut right) = self.right_frame.lock() {
+                *right = Some(frame);
+            }
+        }
+    }
+
+    /// 更新单相机帧缓存（同时送入录制与转储）
+    fn store_single_frame(&self, frame: Option<VideoFrame>) {
+        if let Some(frame) = frame {
+            self.record_frame(&frame);
+            self.dump_frame(DumpStream::Single, &frame);
+            if let Ok(mut single) = self.single_frame.lock() {
+                *single = Some(frame);
+            }
+        }
+    }
+
+    /// 设置帧转储输出；传入 None 停止送帧
+    pub fn set_dump_sink(&self, dumper: Option<Arc<FrameDumper>>) {
+        if let Ok(mut sink) = self.dump_sink.lock() {
+            *sink = dumper;
+        }
+    }
+
+    fn dump_frame(&self, stream: DumpStream, frame: &VideoFrame) {
+        if let Ok(sink) = self.dump_sink.lock() {
+            if let Some(ref dumper) = *sink {
+                dumper.submit(stream, frame);
+            }
+        }
+    }
+
+    /// 是否为磁盘回放源
+    pub fn is_replay(&self) -> bool {
+        self.replay.is_some()
+    }
+
+    /// 设置录制输出；传入 None 停止送帧
+    pub fn set_record_sink(&self, recorder: Option<Arc<VideoRecorder>>) {
+        if let Ok(mut sink) = self.record_sink.lock() {
+            *sink = recorder;
+        }
+    }
+
+    /// 把压缩帧送入录制队列（只复制 MJPEG 数据，不解码）
+    fn record_frame(&self, frame: &VideoFrame) {
+        if let Ok(sink) = self.record_sink.lock() {
+            if let Some(ref recorder) = *sink {
+                recorder.submit_frame(frame);
+            }
+        }
+    }
+
     /// 针对新模式重新初始化相机
     fn reinitialize_for_mode(&mut self, new_mode: CameraMode) -> Result<()> {
         tracing::info!("相机模式切换: {:?}，重新初始化中...", new_mode);
@@ -641,6 +761,7 @@ impl CameraManager {
                             &camera.name,
                             camera_config.clone(),
                         );
+                        reader.set_frame_signal(Arc::clone(&self.frame_signal));
                         reader.start().map_err(|e| {
                             SmartScopeError::Unknown(format!("启动左相机失败: {}", e))
                         })?;
@@ -678,6 +799,7 @@ impl CameraManager {
                         &camera.name,
                         camera_config.clone(),
                     );
+                    reader.set_frame_signal(Arc::clone(&self.frame_signal));
                     reader.start().map_err(|e| {
                         SmartScopeError::Unknown(format!("启动单相机失败: {}", e))
                     })?;
@@ -727,6 +849,11 @@ impl CameraManager {
         self.single_frame.lock().ok()?.take()
     }
 
+    /// 新帧通知（显示路径：双目为左相机，单目为单相机）
+    pub fn frame_signal(&self) -> Arc<FrameSignal> {
+        Arc::clone(&self.frame_signal)
+    }
+
     /// 获取当前相机模式
     pub fn get_camera_mode(&self) -> CameraMode {
         *self.current_mode.lock().unwrap()
@@ -759,6 +886,15 @@ impl CameraManager {
     fn check_camera_connections(&self) -> (bool, bool) {
         const CACHE_DURATION: Duration = Duration::from_secs(1);
 
+        // 回放源：按回放模式报告"连接"状态
+        if let Some(ref replay) = self.replay {
+            return match replay.mode() {
+                CameraMode::StereoCamera => (true, true),
+                CameraMode::SingleCamera => (true, false),
+                CameraMode::NoCamera => (false, false),
+            };
+        }
+
         if let Ok(mut cache) = self.cached_connection_status.lock() {
             let (left, right, last_check) = *cache;
 
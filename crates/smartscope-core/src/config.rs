@@ -13,6 +13,8 @@ pub struct SmartScopeConfig {
     pub camera: CameraConfig,
     #[serde(default)]
     pub storage: StorageConfig,
+    #[serde(default)]
+    pub ai: AiConfig,
 }
 
 impl Default for SmartScopeConfig {
@@ -20,6 +22,60 @@ impl Default for SmartScopeConfig {
         Self {
             camera: CameraConfig::default(),
             storage: StorageConfig::default(),
+            ai: AiConfig::default(),
+        }
+    }
+}
+
+/// AI 检测后处理配置（缺省字段取默认值）
+/// smartscope_ai_init 未传入配置时使用；类别数由模型输出形状决定
+#[derive(Debug, Clone, Serialize, Deserialize)]
+#[serde(default)]
+pub struct AiConfig {
+    /// 置信度阈值
+    pub conf_threshold: f32,
+    /// NMS IoU 阈值
+    pub nms_threshold: f32,
+    /// 每帧最多输出的检测数（上限 128）
+    pub max_detections: u32,
+    /// 只保留的类别号，空表示全部类别
+    pub classes: Vec<u32>,
+    /// 推理流水线使用的 NPU 核心数（RK3588 为 3），每个模型实例固定到一个核心；0 为不绑定、交给驱动调度
+    pub npu_cores: u32,
+    /// 检测方式：整幅 / 分块 / 自适应（上一帧有低置信度检测时分块）
+    pub detection_mode: AiDetectionMode,
+    /// 分块时相邻图块的重叠比例
+    pub tile_overlap: f32,
+    /// 自适应分块：上一帧出现低于此置信度的检测时下一帧分块
+    pub tile_low_confidence: f32,
+    /// 自适应分块：最多连续分块的帧数
+    pub tile_max_consecutive: u32,
+}
+
+/// AI 检测方式
+#[derive(Debug, Clone, Copy, Serialize, Deserialize, PartialEq, Eq)]
+pub enum AiDetectionMode {
+    #[serde(rename = "full")] Full,
+    #[serde(rename = "tiled")] Tiled,
+    #[serde(rename = "adaptive")] Adaptive,
+}
+
+impl Default for AiDetectionMode {
+    fn default() -> Self { AiDetectionMode::Full }
+}
+
+impl Default for AiConfig {
+    fn default() -> Self {
+        Self {
+            conf_threshold: 0.25,
+            nms_threshold: 0.45,
+            max_detections: 128,
+            classes: Vec::new(),
+            npu_cores: 3,
+            detection_mode: AiDetectionMode::Full,
+            tile_overlap: 0.2,
+            tile_low_confidence: 0.5,
+            tile_max_consecutive: 4,
         }
     }
 }
@@ -92,6 +148,45 @@ pub struct CameraConfig {
     pub left: CameraDevice,
     pub right: CameraDevice,
     pub control: CameraControlConfig,
+    /// 帧来源（v4l2 实时相机 / replay 磁盘回放）
+    #[serde(default)]
+    pub source: CameraSource,
+    /// 回放源配置（source = "replay" 时使用）
+    #[serde(default)]
+    pub replay: ReplayConfig,
+}
+
+/// 相机帧来源
+#[derive(Debug, Clone, Copy, Serialize, Deserialize, PartialEq, Eq)]
+pub enum CameraSource {
+    #[serde(rename = "v4l2")] V4l2,
+    #[serde(rename = "replay")] Replay,
+}
+
+impl Default for CameraSource {
+    fn default() -> Self { CameraSource::V4l2 }
+}
+
+/// 回放源配置（缺省字段取默认值）
+#[derive(Debug, Clone, Serialize, Deserialize)]
+#[serde(default)]
+pub struct ReplayConfig {
+    /// 回放文件（.ssdump 帧转储，或拼接的 .mjpeg 单目流）
+    pub path: String,
+    /// true 按原始时间戳节奏回放；false 尽快回放（等待消费者取帧，不丢帧）
+    pub realtime: bool,
+    /// 播放结束后从头循环
+    pub loop_playback: bool,
+}
+
+impl Default for ReplayConfig {
+    fn default() -> Self {
+        Self {
+            path: "recordings/camera.ssdump".to_string(),
+            realtime: true,
+            loop_playback: true,
+        }
+    }
 }
 
 #[derive(Debug, Clone, Serialize, Deserialize)]
@@ -137,6 +232,8 @@ impl Default for CameraConfig {
                 contrast: 0,
                 saturation: 0,
             },
+            source: CameraSource::V4l2,
+            replay: ReplayConfig::default(),
         }
     }
 }
@@ -393,7 +490,7 @@ impl SmartScopeConfig {
         Ok(())
     }
 
-    /// 验证配置有效性（精简，仅校验相机基础参数）
+    /// 验证配置有效性（精简，仅校验相机基础参数与 AI 阈值）
     pub fn validate(&self) -> Result<()> {
         if self.camera.width == 0 || self.camera.height == 0 {
             return Err(SmartScopeError::Config("相机分辨率不能为0".to_string()));
@@ -401,6 +498,15 @@ impl SmartScopeConfig {
         if self.camera.fps == 0 || self.camera.fps > 120 {
             return Err(SmartScopeError::Config("相机帧率应在1-120之间".to_string()));
         }
+        if !(0.0..=1.0).contains(&self.ai.conf_threshold) || !(0.0..=1.0).contains(&self.ai.nms_threshold) {
+            return Err(SmartScopeError::Config("AI 阈值应在0-1之间".to_string()));
+        }
+        if self.ai.npu_cores > 3 {
+            return Err(SmartScopeError::Config("NPU 核心数应在0-3之间".to_string()));
+        }
+        if !(0.0..0.9).contains(&self.ai.tile_overlap) || !(0.0..=1.0).contains(&self.ai.tile_low_confidence) {
+            return Err(SmartScopeError::Config("分块重叠比例应在0-0.9之间，低置信度阈值应在0-1之间".to_string()));
+        }
         Ok(())
     }
 
@@ -427,6 +533,9 @@ impl SmartScopeConfig {
         if let Some(storage) = partial.storage {
             self.storage = storage;
         }
+        if let Some(ai) = partial.ai {
+            self.ai = ai;
+        }
         self.validate()?;
         Ok(())
     }
@@ -437,6 +546,8 @@ impl SmartScopeConfig {
 pub struct PartialConfig {
     pub camera: Option<CameraConfig>,
     pub storage: Option<StorageConfig>,
+    #[serde(default)]
+    pub ai: Option<AiConfig>,
 }
 
 // 旧版AppConfig读取接口已不再需要
@@ -0,0 +1,334 @@
+//! 共享帧环（零拷贝帧交付）
+//!
+//! Rust 侧持有固定数量的帧槽（slot），每个槽带引用计数：
+//! - 生产者通过 [`FrameRing::publish`] 把处理好的帧缓冲区 *移动* 进一个空闲槽（不做 memcpy）
+//! - 消费者（C++ 前端）通过 [`FrameRing::acquire_latest`] 借用最新槽，
+//!   用完后调用 [`FrameRing::release`] 归还
+//!
+//! 被借用中的槽不会被覆盖；若所有槽都被占用，新帧会被丢弃并计数。
+
+use std::cell::UnsafeCell;
+use std::sync::atomic::{AtomicU32, AtomicU64, AtomicUsize, Ordering};
+use std::sync::Mutex;
+use std::time::SystemTime;
+
+/// 默认槽数量：前端显示 + QML 持有 + 生产者写入，留有余量
+pub const DEFAULT_FRAME_RING_SLOTS: usize = 6;
+
+/// 写入中标记（引用计数的特殊值）
+const SLOT_WRITING: u32 = u32::MAX;
+/// 无最新帧
+const NO_SLOT: usize = usize::MAX;
+
+/// 槽内帧数据
+#[derive(Debug)]
+pub struct SlotFrame {
+    pub data: Vec<u8>,
+    pub width: u32,
+    pub height: u32,
+    pub format: u32,
+    pub timestamp: SystemTime,
+    pub frame_id: u64,
+}
+
+impl Default for SlotFrame {
+    fn default() -> Self {
+        Self {
+            data: Vec::new(),
+            width: 0,
+            height: 0,
+            format: 0,
+            timestamp: SystemTime::UNIX_EPOCH,
+            frame_id: 0,
+        }
+    }
+}
+
+/// 帧槽
+pub struct FrameSlot {
+    /// 0 = 空闲，SLOT_WRITING = 写入中，其余 = 借用数
+    refs: AtomicU32,
+    /// 槽内帧的发布序号（从 1 开始）
+    sequence: AtomicU64,
+    frame: UnsafeCell<SlotFrame>,
+}
+
+// 槽内数据只在 refs == SLOT_WRITING 时被生产者修改，借用期间只读
+unsafe impl Sync for FrameSlot {}
+unsafe impl Send for FrameSlot {}
+
+impl FrameSlot {
+    fn new() -> Self {
+        Self {
+            refs: AtomicU32::new(0),
+            sequence: AtomicU64::new(0),
+            frame: UnsafeCell::new(SlotFrame::default()),
+        }
+    }
+
+    /// 借用中读取帧数据
+    ///
+    /// # Safety
+    /// 调用方必须持有该槽的一个引用（acquire 与 release 之间）
+    pub unsafe fn frame(&self) -> &SlotFrame {
+        &*self.frame.get()
+    }
+
+    /// 槽内帧的发布序号
+    pub fn sequence(&self) -> u64 {
+        self.sequence.load(Ordering::Acquire)
+    }
+
+    /// 当前借用数
+    pub fn ref_count(&self) -> u32 {
+        match self.refs.load(Ordering::Acquire) {
+            SLOT_WRITING => 0,
+            n => n,
+        }
+    }
+
+    /// 尝试增加引用（写入中则失败）
+    fn try_retain(&self) -> bool {
+        let mut cur = self.refs.load(Ordering::Acquire);
+        loop {
+            if cur == SLOT_WRITING || cur == SLOT_WRITING - 1 {
+                return false;
+            }
+            match self.refs.compare_exchange_weak(
+                cur,
+                cur + 1,
+                Ordering::AcqRel,
+                Ordering::Acquire,
+            ) {
+                Ok(_) => return true,
+                Err(actual) => cur = actual,
+            }
+        }
+    }
+}
+
+/// 共享帧环统计
+#[derive(Debug, Clone, Copy, Default)]
+pub struct FrameRingStats {
+    pub published: u64,
+    pub dropped: u64,
+    pub in_use: u32,
+}
+
+/// 引用计数的固定大小帧环
+pub struct FrameRing {
+    slots: Box<[FrameSlot]>,
+    latest: AtomicUsize,
+    next_sequence: AtomicU64,
+    dropped: AtomicU64,
+    /// 串行化生产者（允许多线程 publish）
+    writer: Mutex<()>,
+}
+
+impl FrameRing {
+    /// 创建指定槽数量的帧环（至少 2 个槽）
+    pub fn new(slot_count: usize) -> Self {
+        let slot_count = slot_count.max(2);
+        let slots: Vec<FrameSlot> = (0..slot_count).map(|_| FrameSlot::new()).collect();
+        Self {
+            slots: slots.into_boxed_slice(),
+            latest: AtomicUsize::new(NO_SLOT),
+            next_sequence: AtomicU64::new(1),
+            dropped: AtomicU64::new(0),
+            writer: Mutex::new(()),
+        }
+    }
+
+    /// 槽数量
+    pub fn capacity(&self) -> usize {
+        self.slots.len()
+    }
+
+    /// 发布一帧：把缓冲区移动进空闲槽并设为最新帧
+    ///
+    /// 槽内原有的旧缓冲区随之释放；
+    /// 若没有空闲槽（全部被借用），返回 `Err(frame)` 并计入丢帧。
+    pub fn publish(&self, mut frame: SlotFrame) -> std::result::Result<u64, SlotFrame> {
+        let _guard = self.writer.lock().unwrap_or_else(|e| e.into_inner());
+        let latest = self.latest.load(Ordering::Acquire);
+
+        for (idx, slot) in self.slots.iter().enumerate() {
+            if idx == latest {
+                continue;
+            }
+            if slot
+                .refs
+                .compare_exchange(0, SLOT_WRITING, Ordering::AcqRel, Ordering::Acquire)
+                .is_err()
+            {
+                continue;
+            }
+
+            let seq = self.next_sequence.fetch_add(1, Ordering::Relaxed);
+            // SAFETY: refs == SLOT_WRITING，读者无法借用此槽
+            unsafe {
+                std::mem::swap(&mut *slot.frame.get(), &mut frame);
+            }
+            slot.sequence.store(seq, Ordering::Release);
+            slot.refs.store(0, Ordering::Release);
+            self.latest.store(idx, Ordering::Release);
+            return Ok(seq);
+        }
+
+        self.dropped.fetch_add(1, Ordering::Relaxed);
+        Err(frame)
+    }
+
+    /// 借用最新帧槽；没有已发布的帧时返回 None
+    ///
+    /// 成功后必须调用 [`FrameRing::release`] 归还。
+    pub fn acquire_latest(&self) -> Option<&FrameSlot> {
+        loop {
+            let idx = self.latest.load(Ordering::Acquire);
+            if idx == NO_SLOT {
+                return None;
+            }
+            let slot = &self.slots[idx];
+            if slot.try_retain() {
+                // 借用期间槽内容可能已被新帧替换为更新的帧，同样有效
+                return Some(slot);
+            }
+            // 槽正在被改写（latest 已前移），重试读取新的 latest
+            std::hint::spin_loop();
+        }
+    }
+
+    /// 归还一个借用的槽
+    pub fn release(&self, slot: &FrameSlot) {
+        let prev = slot.refs.fetch_sub(1, Ordering::AcqRel);
+        debug_assert!(prev != 0 && prev != SLOT_WRITING, "FrameRing: 重复释放帧槽");
+    }
+
+    /// 判断槽指针是否属于此帧环
+    pub fn owns(&self, slot: *const FrameSlot) -> bool {
+        let start = self.slots.as_ptr();
+        let end = unsafe { start.add(self.slots.len()) };
+        slot >= start && slot < end
+    }
+
+    /// 当前统计
+    pub fn stats(&self) -> FrameRingStats {
+        FrameRingStats {
+            published: self.next_sequence.load(Ordering::Relaxed) - 1,
+            dropped: self.dropped.load(Ordering::Relaxed),
+            in_use: self.slots.iter().map(|s| s.ref_count()).sum(),
+        }
+    }
+}
+
+impl Default for FrameRing {
+    fn default() -> Self {
+        Self::new(DEFAULT_FRAME_RING_SLOTS)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn frame(fill: u8) -> SlotFrame {
+        SlotFrame {
+            data: vec![fill; 12],
+            width: 2,
+            height: 2,
+            format: 0,
+            ..Default::default()
+        }
+    }
+
+    #[test]
+    fn test_acquire_empty_ring() {
+        let ring = FrameRing::new(3);
+        assert!(ring.acquire_latest().is_none());
+    }
+
+    #[test]
+    fn test_publish_moves_buffer_without_copy() {
+        let ring = FrameRing::new(3);
+        let f = frame(7);
+        let ptr = f.data.as_ptr();
+        ring.publish(f).unwrap();
+
+        let slot = ring.acquire_latest().unwrap();
+        let data = unsafe { &slot.frame().data };
+        assert_eq!(data.as_ptr(), ptr);
+        assert_eq!(data[0], 7);
+        ring.release(slot);
+    }
+
+    #[test]
+    fn test_borrowed_slot_is_not_overwritten() {
+        let ring = FrameRing::new(3);
+        ring.publish(frame(1)).unwrap();
+        let held = ring.acquire_latest().unwrap();
+
+        // 被借用的槽不参与轮转，新帧在其余两个槽间交替
+        ring.publish(frame(2)).unwrap();
+        ring.publish(frame(3)).unwrap();
+        assert_eq!(unsafe { held.frame().data[0] }, 1);
+
+        let latest = ring.acquire_latest().unwrap();
+        assert_eq!(unsafe { latest.frame().data[0] }, 3);
+        ring.release(latest);
+        ring.release(held);
+    }
+
+    #[test]
+    fn test_publish_drops_when_all_slots_borrowed() {
+        let ring = FrameRing::new(2);
+        ring.publish(frame(1)).unwrap();
+        let a = ring.acquire_latest().unwrap();
+        ring.publish(frame(2)).unwrap();
+        let b = ring.acquire_latest().unwrap();
+
+        assert!(ring.publish(frame(3)).is_err());
+        assert_eq!(ring.stats().dropped, 1);
+        assert_eq!(ring.stats().in_use, 2);
+
+        ring.release(a);
+        ring.release(b);
+        assert!(ring.publish(frame(4)).is_ok());
+        assert_eq!(ring.stats().in_use, 0);
+    }
+
+    #[test]
+    fn test_sequence_increases() {
+        let ring = FrameRing::new(3);
+        let s1 = ring.publish(frame(1)).unwrap();
+        let s2 = ring.publish(frame(2)).unwrap();
+        assert!(s2 > s1);
+        let slot = ring.acquire_latest().unwrap();
+        assert_eq!(slot.sequence(), s2);
+        assert!(ring.owns(slot as *const FrameSlot));
+        ring.release(slot);
+    }
+
+    #[test]
+    fn test_concurrent_publish_and_acquire() {
+        use std::sync::Arc;
+        let ring = Arc::new(FrameRing::new(4));
+        let producer = {
+            let ring = ring.clone();
+            std::thread::spawn(move || {
+                for i in 0..2000u32 {
+                    let _ = ring.publish(frame((i % 251) as u8));
+                }
+            })
+        };
+        for _ in 0..2000 {
+            if let Some(slot) = ring.acquire_latest() {
+                let f = unsafe { slot.frame() };
+                // 同一帧内所有字节一致，说明借用期间未被改写
+                assert!(f.data.iter().all(|&b| b == f.data[0]));
+                ring.release(slot);
+            }
+        }
+        producer.join().unwrap();
+        assert_eq!(ring.stats().in_use, 0);
+    }
+}
@@ -0,0 +1,460 @@
+//! 逐帧流水线追踪
+//!
+//! 以帧号（`VideoFrame::frame_id`）为线索，记录一帧从采集到上屏、
+//! 以及送入 AI 推理各阶段的起止时间：
+//!
+//! ```text
+//! Capture → Decode → Undistort → Transform → FfiCopy → QImage → Paint
+//!                                    └──────→ AiSubmit → AiResult
+//! ```
+//!
+//! 事件写入固定容量的无锁环形缓冲（每槽一个序列锁），写端只有几次原子存储，
+//! 可在采集/显示热路径上常开。读端按阶段统计滚动窗口内的 p50/p95/p99，
+//! 或导出 Chrome Trace JSON（chrome://tracing、Perfetto 可直接打开）。
+//!
+//! 时间基准为进程内单调时钟（[`now_ns`]），C++ 侧通过 FFI 取同一时钟打点。
+
+use std::cell::Cell;
+use std::io::Write;
+use std::path::Path;
+use std::sync::atomic::{fence, AtomicBool, AtomicU32, AtomicU64, Ordering};
+use std::sync::OnceLock;
+use std::time::{Instant, SystemTime};
+
+use serde_json::json;
+
+/// 环形缓冲容量（事件数），约为 30fps 下 20 秒的全部阶段事件
+pub const TRACE_RING_CAPACITY: usize = 8192;
+
+/// 追踪阶段
+#[repr(u8)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum TraceStage {
+    /// 驱动交付 → 开始处理（排队等待）
+    Capture = 0,
+    /// MJPEG 解码
+    Decode = 1,
+    /// 畸变校正
+    Undistort = 2,
+    /// RGA 视频变换
+    Transform = 3,
+    /// 帧跨 FFI 交给前端（发布进帧环并借出）
+    FfiCopy = 4,
+    /// 前端构造/转换 QImage
+    QImage = 5,
+    /// 显示项绘制
+    Paint = 6,
+    /// AI 预处理并提交推理
+    AiSubmit = 7,
+    /// 提交推理 → 取到结果
+    AiResult = 8,
+    /// 驱动交付 → 上屏
+    EndToEnd = 9,
+}
+
+impl TraceStage {
+    /// 全部阶段（按流水线顺序）
+    pub const ALL: [TraceStage; 10] = [
+        TraceStage::Capture,
+        TraceStage::Decode,
+        TraceStage::Undistort,
+        TraceStage::Transform,
+        TraceStage::FfiCopy,
+        TraceStage::QImage,
+        TraceStage::Paint,
+        TraceStage::AiSubmit,
+        TraceStage::AiResult,
+        TraceStage::EndToEnd,
+    ];
+
+    pub fn from_u8(value: u8) -> Option<Self> {
+        Self::ALL.get(value as usize).copied()
+    }
+
+    pub fn name(self) -> &'static str {
+        match self {
+            TraceStage::Capture => "capture",
+            TraceStage::Decode => "decode",
+            TraceStage::Undistort => "undistort",
+            TraceStage::Transform => "transform",
+            TraceStage::FfiCopy => "ffi_copy",
+            TraceStage::QImage => "qimage",
+            TraceStage::Paint => "paint",
+            TraceStage::AiSubmit => "ai_submit",
+            TraceStage::AiResult => "ai_result",
+            TraceStage::EndToEnd => "end_to_end",
+        }
+    }
+}
+
+/// 一条追踪事件
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct TraceEvent {
+    pub frame_id: u64,
+    pub stage: TraceStage,
+    pub start_ns: u64,
+    pub end_ns: u64,
+    pub thread: u32,
+}
+
+impl TraceEvent {
+    pub fn duration_ns(&self) -> u64 {
+        self.end_ns.saturating_sub(self.start_ns)
+    }
+}
+
+/// 单阶段滚动统计（毫秒）
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct StageStats {
+    pub stage: TraceStage,
+    pub count: u32,
+    pub p50_ms: f64,
+    pub p95_ms: f64,
+    pub p99_ms: f64,
+    pub max_ms: f64,
+}
+
+/// 环形缓冲槽；`seq` 为奇数表示正在写入，偶数（非 0）表示内容完整
+struct TraceSlot {
+    seq: AtomicU64,
+    frame_id: AtomicU64,
+    start_ns: AtomicU64,
+    end_ns: AtomicU64,
+    /// 低 8 位为阶段，高 32 位为线程号
+    meta: AtomicU64,
+}
+
+impl TraceSlot {
+    fn new() -> Self {
+        Self {
+            seq: AtomicU64::new(0),
+            frame_id: AtomicU64::new(0),
+            start_ns: AtomicU64::new(0),
+            end_ns: AtomicU64::new(0),
+            meta: AtomicU64::new(0),
+        }
+    }
+}
+
+/// 无锁追踪缓冲（多写多读）
+pub struct FrameTracer {
+    slots: Box<[TraceSlot]>,
+    head: AtomicU64,
+    lost: AtomicU64,
+    enabled: AtomicBool,
+}
+
+impl FrameTracer {
+    pub fn new(capacity: usize) -> Self {
+        let capacity = capacity.max(1);
+        Self {
+            slots: (0..capacity).map(|_| TraceSlot::new()).collect(),
+            head: AtomicU64::new(0),
+            lost: AtomicU64::new(0),
+            enabled: AtomicBool::new(true),
+        }
+    }
+
+    pub fn set_enabled(&self, enabled: bool) {
+        self.enabled.store(enabled, Ordering::Relaxed);
+    }
+
+    pub fn is_enabled(&self) -> bool {
+        self.enabled.load(Ordering::Relaxed)
+    }
+
+    /// 记录一段 [start_ns, end_ns] 的阶段耗时
+    pub fn record(&self, frame_id: u64, stage: TraceStage, start_ns: u64, end_ns: u64) {
+        if !self.is_enabled() {
+            return;
+        }
+        let index = self.head.fetch_add(1, Ordering::Relaxed);
+        let slot = &self.slots[(index % self.slots.len() as u64) as usize];
+
+        // 独占槽位：环绕后若另一写端仍在写同一槽，放弃本条而不是交错写入
+        let current = slot.seq.load(Ordering::Relaxed);
+        if current % 2 == 1
+            || slot
+                .seq
+                .compare_exchange(current, current + 1, Ordering::Relaxed, Ordering::Relaxed)
+                .is_err()
+        {
+            self.lost.fetch_add(1, Ordering::Relaxed);
+            return;
+        }
+        fence(Ordering::Release);
+        slot.frame_id.store(frame_id, Ordering::Relaxed);
+        slot.start_ns.store(start_ns, Ordering::Relaxed);
+        slot.end_ns.store(end_ns, Ordering::Relaxed);
+        slot.meta
+            .store(((thread_tag() as u64) << 32) | stage as u64, Ordering::Relaxed);
+        slot.seq.store(current + 2, Ordering::Release);
+    }
+
+    /// 已记录的事件总数（含被覆盖的）
+    pub fn total_recorded(&self) -> u64 {
+        self.head.load(Ordering::Relaxed)
+    }
+
+    /// 因槽位争用而放弃的事件数
+    pub fn lost(&self) -> u64 {
+        self.lost.load(Ordering::Relaxed)
+    }
+
+    /// 读取缓冲中全部完整事件（按开始时间排序）；写到一半的槽被跳过
+    pub fn snapshot(&self) -> Vec<TraceEvent> {
+        let mut events = Vec::with_capacity(self.slots.len());
+        for slot in self.slots.iter() {
+            let before = slot.seq.load(Ordering::Acquire);
+            if before == 0 || before % 2 == 1 {
+                continue;
+            }
+            let frame_id = slot.frame_id.load(Ordering::Relaxed);
+            let start_ns = slot.start_ns.load(Ordering::Relaxed);
+            let end_ns = slot.end_ns.load(Ordering::Relaxed);
+            let meta = slot.meta.load(Ordering::Relaxed);
+            fence(Ordering::Acquire);
+            if slot.seq.load(Ordering::Relaxed) != before {
+                continue;
+            }
+            if let Some(stage) = TraceStage::from_u8((meta & 0xff) as u8) {
+                events.push(TraceEvent {
+                    frame_id,
+                    stage,
+                    start_ns,
+                    end_ns,
+                    thread: (meta >> 32) as u32,
+                });
+            }
+        }
+        events.sort_by_key(|e| e.start_ns);
+        events
+    }
+
+    /// 按阶段统计滚动窗口内的分位数；无样本的阶段不返回
+    pub fn stage_stats(&self) -> Vec<StageStats> {
+        let events = self.snapshot();
+        let mut per_stage: Vec<Vec<u64>> = vec![Vec::new(); TraceStage::ALL.len()];
+        for event in &events {
+            per_stage[event.stage as usize].push(event.duration_ns());
+        }
+
+        TraceStage::ALL
+            .iter()
+            .zip(per_stage.iter_mut())
+            .filter(|(_, durations)| !durations.is_empty())
+            .map(|(&stage, durations)| {
+                durations.sort_unstable();
+                StageStats {
+                    stage,
+                    count: durations.len() as u32,
+                    p50_ms: percentile_ms(durations, 0.50),
+                    p95_ms: percentile_ms(durations, 0.95),
+                    p99_ms: percentile_ms(durations, 0.99),
+                    max_ms: *durations.last().unwrap() as f64 / 1e6,
+                }
+            })
+            .collect()
+    }
+
+    /// 把缓冲内容写成 Chrome Trace JSON（Complete 事件，单位微秒）
+    pub fn export_chrome_trace<P: AsRef<Path>>(&self, path: P) -> std::io::Result<usize> {
+        let events = self.snapshot();
+        let trace_events: Vec<serde_json::Value> = events
+            .iter()
+            .map(|e| {
+                json!({
+                    "name": e.stage.name(),
+                    "cat": "frame",
+                    "ph": "X",
+                    "ts": e.start_ns as f64 / 1e3,
+                    "dur": e.duration_ns() as f64 / 1e3,
+                    "pid": std::process::id(),
+                    "tid": e.thread,
+                    "args": { "frame_id": e.frame_id },
+                })
+            })
+            .collect();
+        let document = json!({
+            "traceEvents": trace_events,
+            "displayTimeUnit": "ms",
+        });
+
+        let file = std::fs::File::create(path.as_ref())?;
+        let mut writer = std::io::BufWriter::new(file);
+        serde_json::to_writer(&mut writer, &document)?;
+        writer.flush()?;
+        Ok(events.len())
+    }
+}
+
+/// 最近秩分位数（输入已升序）
+fn percentile_ms(sorted_ns: &[u64], p: f64) -> f64 {
+    let rank = ((p * sorted_ns.len() as f64).ceil() as usize).clamp(1, sorted_ns.len());
+    sorted_ns[rank - 1] as f64 / 1e6
+}
+
+/// 进程内线程编号（首次打点时分配，从 1 开始）
+fn thread_tag() -> u32 {
+    static NEXT: AtomicU32 = AtomicU32::new(1);
+    thread_local! {
+        static TAG: Cell<u32> = const { Cell::new(0) };
+    }
+    TAG.with(|tag| {
+        if tag.get() == 0 {
+            tag.set(NEXT.fetch_add(1, Ordering::Relaxed));
+        }
+        tag.get()
+    })
+}
+
+fn epoch() -> &'static Instant {
+    static EPOCH: OnceLock<Instant> = OnceLock::new();
+    EPOCH.get_or_init(Instant::now)
+}
+
+/// 追踪时钟：进程内单调纳秒
+pub fn now_ns() -> u64 {
+    epoch().elapsed().as_nanos() as u64
+}
+
+/// 把墙钟时间（如相机采集时间戳）换算到追踪时钟；早于进程起点时返回 0
+pub fn system_time_to_ns(time: SystemTime) -> u64 {
+    let now = now_ns();
+    match SystemTime::now().duration_since(time) {
+        Ok(age) => now.saturating_sub(age.as_nanos() as u64),
+        Err(_) => now,
+    }
+}
+
+/// 全局追踪器
+pub fn tracer() -> &'static FrameTracer {
+    static TRACER: OnceLock<FrameTracer> = OnceLock::new();
+    TRACER.get_or_init(|| FrameTracer::new(TRACE_RING_CAPACITY))
+}
+
+/// 向全局追踪器记录一段阶段耗时
+pub fn record(frame_id: u64, stage: TraceStage, start_ns: u64, end_ns: u64) {
+    tracer().record(frame_id, stage, start_ns, end_ns);
+}
+
+/// 记录采集等待：从驱动交付（采集时间戳）到现在
+pub fn record_capture(frame_id: u64, captured_at: SystemTime) {
+    let tracer = tracer();
+    if tracer.is_enabled() {
+        let end = now_ns();
+        tracer.record(frame_id, TraceStage::Capture, system_time_to_ns(captured_at), end);
+    }
+}
+
+/// 作用域打点：离开作用域时记录 [创建, 析构] 区间
+pub struct TraceSpan {
+    frame_id: u64,
+    stage: TraceStage,
+    start_ns: u64,
+}
+
+impl TraceSpan {
+    pub fn new(frame_id: u64, stage: TraceStage) -> Self {
+        Self {
+            frame_id,
+            stage,
+            start_ns: now_ns(),
+        }
+    }
+}
+
+impl Drop for TraceSpan {
+    fn drop(&mut self) {
+        record(self.frame_id, self.stage, self.start_ns, now_ns());
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn ring_keeps_latest_events() {
+        let tracer = FrameTracer::new(4);
+        for i in 0..10u64 {
+            tracer.record(i, TraceStage::Decode, i * 100, i * 100 + 10);
+        }
+        let events = tracer.snapshot();
+        assert_eq!(events.len(), 4);
+        assert_eq!(events.iter().map(|e| e.frame_id).collect::<Vec<_>>(), vec![6, 7, 8, 9]);
+        assert_eq!(tracer.total_recorded(), 10);
+
+        tracer.set_enabled(false);
+        tracer.record(99, TraceStage::Decode, 0, 1);
+        assert_eq!(tracer.total_recorded(), 10);
+    }
+
+    #[test]
+    fn stage_percentiles() {
+        let tracer = FrameTracer::new(256);
+        // decode: 1..=100 ms
+        for i in 1..=100u64 {
+            tracer.record(i, TraceStage::Decode, 0, i * 1_000_000);
+        }
+        tracer.record(1, TraceStage::Paint, 0, 2_000_000);
+
+        let stats = tracer.stage_stats();
+        assert_eq!(stats.len(), 2);
+        let decode = stats.iter().find(|s| s.stage == TraceStage::Decode).unwrap();
+        assert_eq!(decode.count, 100);
+        assert_eq!(decode.p50_ms, 50.0);
+        assert_eq!(decode.p95_ms, 95.0);
+        assert_eq!(decode.p99_ms, 99.0);
+        assert_eq!(decode.max_ms, 100.0);
+        let paint = stats.iter().find(|s| s.stage == TraceStage::Paint).unwrap();
+        assert_eq!((paint.count, paint.p99_ms), (1, 2.0));
+    }
+
+    #[test]
+    fn concurrent_writers_never_yield_torn_events() {
+        let tracer = std::sync::Arc::new(FrameTracer::new(64));
+        let writers: Vec<_> = (0..4u64)
+            .map(|t| {
+                let tracer = std::sync::Arc::clone(&tracer);
+                std::thread::spawn(move || {
+                    for i in 0..20_000u64 {
+                        // 每个事件的字段彼此一致，读端可校验
+                        let id = t * 1_000_000 + i;
+                        tracer.record(id, TraceStage::Transform, id, id + t);
+                    }
+                })
+            })
+            .collect();
+        for _ in 0..200 {
+            for e in tracer.snapshot() {
+                assert_eq!(e.end_ns - e.start_ns, e.frame_id / 1_000_000);
+                assert_eq!(e.start_ns, e.frame_id);
+            }
+        }
+        for w in writers {
+            w.join().unwrap();
+        }
+    }
+
+    #[test]
+    fn chrome_trace_export() {
+        let tracer = FrameTracer::new(16);
+        tracer.record(7, TraceStage::Decode, 1_000, 5_000);
+        tracer.record(7, TraceStage::Paint, 6_000, 9_000);
+
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("trace.json");
+        assert_eq!(tracer.export_chrome_trace(&path).unwrap(), 2);
+
+        let doc: serde_json::Value =
+            serde_json::from_str(&std::fs::read_to_string(&path).unwrap()).unwrap();
+        let events = doc["traceEvents"].as_array().unwrap();
+        assert_eq!(events.len(), 2);
+        assert_eq!(events[0]["name"], "decode");
+        assert_eq!(events[0]["ph"], "X");
+        assert_eq!(events[0]["ts"], 1.0);
+        assert_eq!(events[0]["dur"], 4.0);
+        assert_eq!(events[1]["args"]["frame_id"], 7);
+    }
+}
@@ -4,9 +4,15 @@
 //! 1. MJPEG 解码 (turbojpeg) → RGB
 //! 2. 畸变校正 (camera-correction + opencv) - 最优先
 //! 3. RGA 变换 (旋转、翻转、反色)
+//!
+//! 可选的帧旁路（[`FrameTap`]）在反色之前拿到左相机的 RGB 帧，
+//! 供 AI 推理等在核心内部直接取用，无需经由前端显示帧回传。
+//!
+//! 各步骤按帧号记录到 [`crate::frame_trace`]。
 
 use crate::error::{Result, SmartScopeError};
-use crate::video_transform::VideoTransformProcessor;
+use crate::frame_trace::{TraceSpan, TraceStage};
+use crate::video_transform::{VideoTransform, VideoTransformProcessor};
 use camera_correction::{CameraParameters, DistortionCorrector, StereoRectifier};
 use opencv::{core::Mat, prelude::*};
 use rockchip_rga::RgaFormat;
@@ -14,6 +20,12 @@ use std::sync::{Arc, RwLock};
 use tracing::{debug, info, warn};
 use turbojpeg::{Decompressor, Image, PixelFormat};
 
+/// 帧旁路回调：参数为 RGB888 数据（借用）、宽、高、帧号
+///
+/// 数据已完成畸变校正与几何变换（与显示画面方向一致），但未反色。
+/// 回调在管道线程上同步执行，应只做拷贝/投递等轻量操作。
+pub type FrameTap = Arc<dyn Fn(&[u8], u32, u32, u64) + Send + Sync>;
+
 /// 图像处理管道
 pub struct ImagePipeline {
     /// MJPEG 解码器
@@ -32,6 +44,8 @@ pub struct ImagePipeline {
     /// 缓冲池，用于减少内存分配
     #[allow(dead_code)]
     buffer_pool: Arc<std::sync::Mutex<Vec<Vec<u8>>>>,
+    /// 帧旁路（仅左相机/显示主路）
+    frame_tap: Option<FrameTap>,
 }
 
 impl ImagePipeline {
@@ -104,9 +118,19 @@ impl ImagePipeline {
             video_transform,
             distortion_correction_enabled: true,
             buffer_pool: Arc::new(std::sync::Mutex::new(Vec::new())),
+            frame_tap: None,
         })
     }
 
+    /// 设置/清除帧旁路
+    pub fn set_frame_tap(&mut self, tap: Option<FrameTap>) {
+        self.frame_tap = tap;
+        debug!(
+            "Frame tap: {}",
+            if self.frame_tap.is_some() { "installed" } else { "removed" }
+        );
+    }
+
     /// 启用/禁用畸变校正
     pub fn set_distortion_correction_enabled(&mut self, enabled: bool) {
         self.distortion_correction_enabled = enabled;
@@ -150,17 +174,24 @@ impl ImagePipeline {
     /// 处理 MJPEG 帧（完整流程）
     ///
     /// 流程：MJPEG解码 → 畸变校正（如果启用） → RGA变换 → 返回RGB数据
+    ///
+    /// `frame_id` 为相机帧号，用于逐帧追踪与帧旁路
     pub fn process_mjpeg_frame(
         &mut self,
         mjpeg_data: &[u8],
         is_left_camera: bool,
+        frame_id: u64,
     ) -> Result<(Vec<u8>, u32, u32)> {
         // 1. 解码 MJPEG 到 RGB
-        let (rgb_data, mut width, mut height) = self.decode_mjpeg(mjpeg_data)?;
+        let (rgb_data, mut width, mut height) = {
+            let _span = TraceSpan::new(frame_id, TraceStage::Decode);
+            self.decode_mjpeg(mjpeg_data)?
+        };
 
         // 2. 应用畸变校正（如果启用且可用）
         // 注意：畸变校正包含旋转补偿，但最终会旋转回来，所以宽高不变
         let corrected_data = if self.distortion_correction_enabled {
+            let _span = TraceSpan::new(frame_id, TraceStage::Undistort);
             self.apply_distortion_correction(&rgb_data, width, height, is_left_camera)?
         } else {
             rgb_data
@@ -174,7 +205,15 @@ impl ImagePipeline {
         }; // 锁自动释放
 
         // 传递所有权，避免不必要的复制
-        let final_data = self.apply_video_transforms(corrected_data, width, height)?;
+        let final_data = {
+            let _span = TraceSpan::new(frame_id, TraceStage::Transform);
+            self.apply_video_transforms(
+                corrected_data,
+                width,
+                height,
+                is_left_camera.then_some(frame_id),
+            )?
+        };
 
         // 如果用户旋转了90度或270度，需要交换宽高
         if rotation == 90 || rotation == 270 {
@@ -271,33 +310,89 @@ impl ImagePipeline {
     }
 
     /// 应用视频变换（旋转、翻转、反色）- 优化版本
+    ///
+    /// `tap_frame_id` 为 `Some(帧号)` 且设置了帧旁路时，在反色之前把几何变换后的帧交给旁路
     fn apply_video_transforms(
         &self,
         rgb_data: Vec<u8>, // 接收所有权，避免不必要的复制
         width: u32,
         height: u32,
+        tap_frame_id: Option<u64>,
     ) -> Result<Vec<u8>> {
+        let tap = tap_frame_id.and_then(|id| self.frame_tap.as_ref().map(|tap| (tap, id)));
         let video_transform = self.video_transform.read().unwrap();
-        let transforms = video_transform.get_config().get_transforms();
+        let config = video_transform.get_config();
+        let transforms = config.get_transforms();
 
         // 如果没有变换，直接返回原数据（零复制）
         if transforms.is_empty() {
+            if let Some((tap, frame_id)) = tap {
+                tap(&rgb_data, width, height, frame_id);
+            }
             return Ok(rgb_data);
         }
 
-        // 使用 RGA 硬件加速（如果可用）
-        if video_transform.is_rga_available() {
-            video_transform.apply_transforms(
+        // RGA 不可用，返回原始数据（零复制）
+        if !video_transform.is_rga_available() {
+            warn!("RGA not available, video transforms skipped");
+            if let Some((tap, frame_id)) = tap {
+                tap(&rgb_data, width, height, frame_id);
+            }
+            return Ok(rgb_data);
+        }
+
+        let (out_w, out_h) = match config.rotation_degrees {
+            90 | 270 => (height, width),
+            _ => (width, height),
+        };
+
+        // 使用 RGA 硬件加速
+        match tap {
+            Some((tap, frame_id)) if config.invert_colors => {
+                // 反色放在最后：先做几何变换交给旁路，再单独反色，旁路看到的是未反色画面
+                let geometric: Vec<VideoTransform> = transforms
+                    .iter()
+                    .copied()
+                    .filter(|t| *t != VideoTransform::Invert)
+                    .collect();
+                let geometric_data = if geometric.is_empty() {
+                    rgb_data
+                } else {
+                    video_transform.apply_transforms(
+                        &rgb_data,
+                        width,
+                        height,
+                        RgaFormat::Rgb888,
+                        &geometric,
+                    )?
+                };
+                tap(&geometric_data, out_w, out_h, frame_id);
+                video_transform.apply_transforms(
+                    &geometric_data,
+                    out_w,
+                    out_h,
+                    RgaFormat::Rgb888,
+                    &[VideoTransform::Invert],
+                )
+            }
+            Some((tap, frame_id)) => {
+                let data = video_transform.apply_transforms(
+                    &rgb_data,
+                    width,
+                    height,
+                    RgaFormat::Rgb888,
+                    &transforms,
+                )?;
+                tap(&data, out_w, out_h, frame_id);
+                Ok(data)
+            }
+            None => video_transform.apply_transforms(
                 &rgb_data,
                 width,
                 height,
                 RgaFormat::Rgb888,
                 &transforms,
-            )
-        } else {
-            // RGA 不可用，返回原始数据（零复制）
-            warn!("RGA not available, video transforms skipped");
-            Ok(rgb_data)
+            ),
         }
     }
 
@@ -329,10 +424,13 @@ impl ImagePipeline {
     }
 
     /// 带性能监控的处理函数
+    ///
+    /// `frame_id` 与 [`Self::process_mjpeg_frame`] 相同，为相机帧号，交给帧旁路
     pub fn process_mjpeg_frame_with_timing(
         &mut self,
         mjpeg_data: &[u8],
         is_left_camera: bool,
+        frame_id: u64,
     ) -> Result<(Vec<u8>, u32, u32)> {
         use std::time::Instant;
 
@@ -359,7 +457,12 @@ impl ImagePipeline {
             video_transform.get_config().rotation_degrees
         };
 
-        let final_data = self.apply_video_transforms(corrected_data, width, height)?;
+        let final_data = self.apply_video_transforms(
+            corrected_data,
+            width,
+            height,
+            is_left_camera.then_some(frame_id),
+        )?;
         let transform_time = transform_start.elapsed();
 
         // 如果用户旋转了90度或270度，需要交换宽高
@@ -475,7 +578,7 @@ impl ImagePipeline {
 #[cfg(test)]
 mod tests {
     use super::*;
-    use crate::video_transform::VideoTransformProcessor;
+    use crate::video_transform::{VideoTransform, VideoTransformProcessor};
 
     #[test]
     fn test_pipeline_creation_without_params() {
@@ -493,4 +596,28 @@ mod tests {
         let pipeline = result.unwrap();
         assert!(!pipeline.is_distortion_correction_available());
     }
+
+    #[test]
+    fn test_frame_tap_sees_left_frames_only() {
+        use std::sync::atomic::{AtomicUsize, Ordering};
+
+        let processor = Arc::new(RwLock::new(VideoTransformProcessor::new()));
+        let mut pipeline = ImagePipeline::new(None, processor).unwrap();
+        let hits = Arc::new(AtomicUsize::new(0));
+        let hits_clone = Arc::clone(&hits);
+        pipeline.set_frame_tap(Some(Arc::new(move |data: &[u8], w: u32, h: u32, id: u64| {
+            assert_eq!(data.len(), (w * h * 3) as usize);
+            assert_eq!(id, 42);
+            hits_clone.fetch_add(1, Ordering::Relaxed);
+        })));
+
+        // 无变换时旁路直接借用原缓冲区
+        let frame = vec![7u8; 4 * 2 * 3];
+        let out = pipeline.apply_video_transforms(frame.clone(), 4, 2, Some(42)).unwrap();
+        assert_eq!(out, frame);
+        assert_eq!(hits.load(Ordering::Relaxed), 1);
+
+        pipeline.apply_video_transforms(frame, 4, 2, None).unwrap();
+        assert_eq!(hits.load(Ordering::Relaxed), 1);
+    }
 }
@@ -9,6 +9,10 @@ pub mod logger;
 pub mod camera;
 pub mod video_transform;
 pub mod image_pipeline;
+pub mod frame_ring;
+pub mod recorder;
+pub mod replay;
+pub mod frame_trace;
 
 // Re-export core types
 pub use config::AppConfig;
@@ -20,4 +24,10 @@ pub use logger::{
 };
 pub use camera::{CameraManager, CameraStatus, CameraMode, VideoFrame};
 pub use video_transform::{VideoTransform, VideoTransformConfig, apply_transform, apply_transforms};
-pub use image_pipeline::ImagePipeline;
\ No newline at end of file
+pub use image_pipeline::{FrameTap, ImagePipeline};
+pub use frame_ring::{FrameRing, FrameSlot, SlotFrame, FrameRingStats};
+pub use recorder::{
+    VideoRecorder, RecorderConfig, RecorderStats, RecordingCodec, RecordingContainer
+};
+pub use replay::{ReplaySource, FrameDumper, FrameDumpStats, DumpReader, DumpWriter, DumpStream};
+pub use frame_trace::{FrameTracer, TraceStage, TraceEvent, TraceSpan, StageStats};
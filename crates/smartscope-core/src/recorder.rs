@@ -0,0 +1,907 @@
+//! 相机视频录制引擎
+//!
+//! 直接由相机帧流驱动（不再抓取整个桌面）：
+//! - 相机线程调用 [`VideoRecorder::submit`] 把 MJPEG 帧放入有界队列，队列满时丢帧计数，不阻塞取帧
+//! - 独立的编码线程把帧写入容器
+//! - 默认 MJPEG 直通（不重新编码）写入 MKV/AVI；可选软件 H.264（外部 ffmpeg/libx264）
+//!
+//! 录制统计（写入帧数、丢帧数、写入字节与吞吐）通过 [`VideoRecorder::stats`] 获取。
+
+use crate::camera::VideoFrame;
+use crate::error::{Result, SmartScopeError};
+use std::fs::File;
+use std::io::{BufWriter, Seek, SeekFrom, Write};
+use std::path::{Path, PathBuf};
+use std::process::{Child, ChildStdin, Command, Stdio};
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
+use std::sync::mpsc::{self, Receiver, SyncSender, TrySendError};
+use std::sync::{Arc, Mutex};
+use std::thread::{self, JoinHandle};
+use std::time::{Duration, Instant, SystemTime};
+use tracing::{error, info, warn};
+
+/// 默认编码队列长度（约 0.25 秒 @30fps）
+pub const DEFAULT_RECORD_QUEUE_CAPACITY: usize = 8;
+
+/// 录制容器格式
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum RecordingContainer {
+    /// Matroska（推荐，无文件大小限制，按帧时间戳）
+    Mkv,
+    /// AVI 1.0（兼容性最好，单文件上限约 1GB）
+    Avi,
+}
+
+impl RecordingContainer {
+    /// 根据文件扩展名推断容器（.avi → AVI，其余 → MKV）
+    pub fn from_path(path: &Path) -> Self {
+        match path.extension().and_then(|e| e.to_str()) {
+            Some(ext) if ext.eq_ignore_ascii_case("avi") => RecordingContainer::Avi,
+            _ => RecordingContainer::Mkv,
+        }
+    }
+}
+
+/// 录制编码方式
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum RecordingCodec {
+    /// MJPEG 直通：相机压缩帧原样写入容器
+    MjpegPassthrough,
+    /// 软件 H.264：帧送入外部 ffmpeg（libx264）重新编码
+    H264Software,
+}
+
+/// 录制配置
+#[derive(Debug, Clone)]
+pub struct RecorderConfig {
+    /// 输出文件路径
+    pub path: PathBuf,
+    /// 容器格式
+    pub container: RecordingContainer,
+    /// 编码方式
+    pub codec: RecordingCodec,
+    /// 标称帧率（AVI 头部与 H.264 输入帧率；AVI 结束时按实测帧率修正）
+    pub fps: u32,
+    /// 编码队列长度
+    pub queue_capacity: usize,
+}
+
+impl RecorderConfig {
+    /// 按路径推断容器，MJPEG 直通
+    pub fn new<P: AsRef<Path>>(path: P, fps: u32) -> Self {
+        let path = path.as_ref().to_path_buf();
+        Self {
+            container: RecordingContainer::from_path(&path),
+            path,
+            codec: RecordingCodec::MjpegPassthrough,
+            fps: fps.max(1),
+            queue_capacity: DEFAULT_RECORD_QUEUE_CAPACITY,
+        }
+    }
+}
+
+/// 送入录制队列的一帧（MJPEG 压缩数据）
+pub struct RecordFrame {
+    pub data: Vec<u8>,
+    pub width: u32,
+    pub height: u32,
+    pub timestamp: SystemTime,
+}
+
+/// 录制统计
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct RecorderStats {
+    /// 已写入帧数
+    pub frames_written: u64,
+    /// 丢弃帧数（队列满或写入失败）
+    pub frames_dropped: u64,
+    /// 已写入字节数（H.264 模式为送入编码器的字节数）
+    pub bytes_written: u64,
+    /// 当前队列深度
+    pub queue_depth: usize,
+    /// 已录制时长（毫秒）
+    pub elapsed_ms: u64,
+    /// 平均写入吞吐（字节/秒）
+    pub write_bytes_per_sec: f64,
+}
+
+#[derive(Default)]
+struct SharedStats {
+    frames_written: AtomicU64,
+    frames_dropped: AtomicU64,
+    bytes_written: AtomicU64,
+    queue_depth: AtomicUsize,
+}
+
+/// 录制引擎：有界队列 + 独立编码线程
+pub struct VideoRecorder {
+    config: RecorderConfig,
+    sender: Mutex<Option<SyncSender<RecordFrame>>>,
+    worker: Mutex<Option<JoinHandle<Result<()>>>>,
+    stats: Arc<SharedStats>,
+    accepting: AtomicBool,
+    started_at: Instant,
+    stopped_elapsed: Mutex<Option<Duration>>,
+}
+
+impl VideoRecorder {
+    /// 创建输出文件并启动编码线程
+    pub fn start(config: RecorderConfig) -> Result<Self> {
+        if let Some(parent) = config.path.parent() {
+            if !parent.as_os_str().is_empty() {
+                std::fs::create_dir_all(parent)?;
+            }
+        }
+
+        let (tx, rx) = mpsc::sync_channel::<RecordFrame>(config.queue_capacity.max(1));
+        let stats = Arc::new(SharedStats::default());
+        // 容器在收到首帧（得知分辨率）后创建；这里先确认路径可写
+        File::create(&config.path)?;
+
+        let worker_config = config.clone();
+        let worker_stats = Arc::clone(&stats);
+        let worker = thread::Builder::new()
+            .name("video-recorder".to_string())
+            .spawn(move || encoder_loop(worker_config, rx, worker_stats))
+            .map_err(SmartScopeError::Io)?;
+
+        info!(
+            "录制开始: {} ({:?}, {:?})",
+            config.path.display(),
+            config.container,
+            config.codec
+        );
+        Ok(Self {
+            config,
+            sender: Mutex::new(Some(tx)),
+            worker: Mutex::new(Some(worker)),
+            stats,
+            accepting: AtomicBool::new(true),
+            started_at: Instant::now(),
+            stopped_elapsed: Mutex::new(None),
+        })
+    }
+
+    /// 输出文件路径
+    pub fn path(&self) -> &Path {
+        &self.config.path
+    }
+
+    /// 是否仍在接收帧
+    pub fn is_recording(&self) -> bool {
+        self.accepting.load(Ordering::Relaxed)
+    }
+
+    /// 提交一帧（复制压缩数据，不阻塞）；队列满时丢帧并返回 false
+    pub fn submit(&self, data: &[u8], width: u32, height: u32, timestamp: SystemTime) -> bool {
+        if !self.accepting.load(Ordering::Relaxed) {
+            return false;
+        }
+        let guard = self.sender.lock().unwrap();
+        let sender = match guard.as_ref() {
+            Some(s) => s,
+            None => return false,
+        };
+        let frame = RecordFrame {
+            data: data.to_vec(),
+            width,
+            height,
+            timestamp,
+        };
+        // 先计数再发送，保证编码线程取帧时计数不会下溢
+        self.stats.queue_depth.fetch_add(1, Ordering::Relaxed);
+        match sender.try_send(frame) {
+            Ok(()) => true,
+            Err(TrySendError::Full(_)) | Err(TrySendError::Disconnected(_)) => {
+                self.stats.queue_depth.fetch_sub(1, Ordering::Relaxed);
+                self.stats.frames_dropped.fetch_add(1, Ordering::Relaxed);
+                false
+            }
+        }
+    }
+
+    /// 提交一帧相机原始帧（仅接受 MJPEG）
+    pub fn submit_frame(&self, frame: &VideoFrame) -> bool {
+        if frame.format != usb_camera::V4L2_PIX_FMT_MJPEG {
+            self.stats.frames_dropped.fetch_add(1, Ordering::Relaxed);
+            return false;
+        }
+        self.submit(&frame.data, frame.width, frame.height, frame.timestamp)
+    }
+
+    /// 当前统计
+    pub fn stats(&self) -> RecorderStats {
+        let elapsed = self
+            .stopped_elapsed
+            .lock()
+            .unwrap()
+            .unwrap_or_else(|| self.started_at.elapsed());
+        let bytes = self.stats.bytes_written.load(Ordering::Relaxed);
+        let secs = elapsed.as_secs_f64();
+        RecorderStats {
+            frames_written: self.stats.frames_written.load(Ordering::Relaxed),
+            frames_dropped: self.stats.frames_dropped.load(Ordering::Relaxed),
+            bytes_written: bytes,
+            queue_depth: self.stats.queue_depth.load(Ordering::Relaxed),
+            elapsed_ms: elapsed.as_millis() as u64,
+            write_bytes_per_sec: if secs > 0.0 { bytes as f64 / secs } else { 0.0 },
+        }
+    }
+
+    /// 停止录制：排空队列、完成容器并等待编码线程退出
+    pub fn stop(&self) -> Result<RecorderStats> {
+        self.accepting.store(false, Ordering::Relaxed);
+        // 关闭发送端，编码线程写完剩余帧后退出
+        self.sender.lock().unwrap().take();
+        let handle = self.worker.lock().unwrap().take();
+        let result = match handle {
+            Some(h) => h
+                .join()
+                .unwrap_or_else(|_| Err(SmartScopeError::Unknown("录制线程异常退出".to_string()))),
+            None => Ok(()),
+        };
+        {
+            let mut stopped = self.stopped_elapsed.lock().unwrap();
+            if stopped.is_none() {
+                *stopped = Some(self.started_at.elapsed());
+            }
+        }
+        let stats = self.stats();
+        match result {
+            Ok(()) => {
+                info!(
+                    "录制结束: {} 帧, 丢帧 {}, {:.1} MB, {:.2} MB/s",
+                    stats.frames_written,
+                    stats.frames_dropped,
+                    stats.bytes_written as f64 / 1_048_576.0,
+                    stats.write_bytes_per_sec / 1_048_576.0
+                );
+                Ok(stats)
+            }
+            Err(e) => {
+                error!("录制结束时出错: {}", e);
+                Err(e)
+            }
+        }
+    }
+}
+
+impl Drop for VideoRecorder {
+    fn drop(&mut self) {
+        if self.worker.lock().map(|w| w.is_some()).unwrap_or(false) {
+            let _ = self.stop();
+        }
+    }
+}
+
+/// 容器写入器
+trait FrameSink: Send {
+    /// 写入一帧，返回实际写入的字节数
+    fn write_frame(&mut self, data: &[u8], pts: Duration) -> Result<u64>;
+    /// 完成文件（回填头部等）
+    fn finish(self: Box<Self>, frames: u64, duration: Duration) -> Result<()>;
+}
+
+fn open_sink(config: &RecorderConfig, width: u32, height: u32) -> Result<Box<dyn FrameSink>> {
+    match config.codec {
+        RecordingCodec::MjpegPassthrough => {
+            let file = BufWriter::with_capacity(1 << 20, File::create(&config.path)?);
+            match config.container {
+                RecordingContainer::Avi => {
+                    Ok(Box::new(AviMjpegWriter::new(file, width, height, config.fps)?))
+                }
+                RecordingContainer::Mkv => Ok(Box::new(MkvMjpegWriter::new(file, width, height)?)),
+            }
+        }
+        RecordingCodec::H264Software => Ok(Box::new(FfmpegH264Writer::spawn(config)?)),
+    }
+}
+
+fn encoder_loop(config: RecorderConfig, rx: Receiver<RecordFrame>, stats: Arc<SharedStats>) -> Result<()> {
+    let mut sink: Option<Box<dyn FrameSink>> = None;
+    let mut first_ts: Option<SystemTime> = None;
+    let mut last_pts = Duration::ZERO;
+    let mut frames = 0u64;
+    let mut failed = false;
+
+    while let Ok(frame) = rx.recv() {
+        stats.queue_depth.fetch_sub(1, Ordering::Relaxed);
+        if failed {
+            stats.frames_dropped.fetch_add(1, Ordering::Relaxed);
+            continue;
+        }
+        if sink.is_none() {
+            match open_sink(&config, frame.width, frame.height) {
+                Ok(s) => sink = Some(s),
+                Err(e) => {
+                    error!("创建录制输出失败: {}", e);
+                    failed = true;
+                    stats.frames_dropped.fetch_add(1, Ordering::Relaxed);
+                    continue;
+                }
+            }
+        }
+
+        let base = *first_ts.get_or_insert(frame.timestamp);
+        // 相机时间戳回退时保持单调
+        let pts = frame
+            .timestamp
+            .duration_since(base)
+            .unwrap_or(last_pts)
+            .max(last_pts);
+        last_pts = pts;
+
+        match sink.as_mut().unwrap().write_frame(&frame.data, pts) {
+            Ok(n) => {
+                frames += 1;
+                stats.frames_written.fetch_add(1, Ordering::Relaxed);
+                stats.bytes_written.fetch_add(n, Ordering::Relaxed);
+            }
+            Err(e) => {
+                // 写入失败（磁盘满、AVI 超限等）：停止写入，后续帧计为丢帧
+                error!("录制写入失败，停止写入: {}", e);
+                failed = true;
+                stats.frames_dropped.fetch_add(1, Ordering::Relaxed);
+            }
+        }
+    }
+
+    match sink {
+        Some(sink) => sink.finish(frames, last_pts),
+        None => {
+            warn!("录制期间未收到任何帧: {}", config.path.display());
+            Ok(())
+        }
+    }
+}
+
+// =========================
+// AVI (RIFF) MJPEG 写入器
+// =========================
+
+/// AVI 1.0 的 RIFF 块大小上限（保守取 1GB，超过后停止写入）
+const AVI_MAX_MOVI_BYTES: u64 = 1 << 30;
+const AVIF_HASINDEX: u32 = 0x10;
+const AVIIF_KEYFRAME: u32 = 0x10;
+
+struct AviMjpegWriter<W: Write + Seek + Send> {
+    out: W,
+    width: u32,
+    height: u32,
+    fps: u32,
+    /// 'movi' 四字符码所在位置（idx1 偏移的基准）
+    movi_fourcc_pos: u64,
+    movi_bytes: u64,
+    max_frame_bytes: u32,
+    /// (相对 movi 偏移, 大小)
+    index: Vec<(u32, u32)>,
+}
+
+// 需要回填的头部字段位置
+const AVI_RIFF_SIZE_POS: u64 = 4;
+const AVI_AVIH_USEC_PER_FRAME_POS: u64 = 32;
+const AVI_AVIH_MAX_BYTES_PER_SEC_POS: u64 = 36;
+const AVI_AVIH_TOTAL_FRAMES_POS: u64 = 48;
+const AVI_AVIH_SUGGESTED_BUFFER_POS: u64 = 60;
+const AVI_STRH_SCALE_POS: u64 = 128;
+const AVI_STRH_RATE_POS: u64 = 132;
+const AVI_STRH_LENGTH_POS: u64 = 140;
+const AVI_STRH_SUGGESTED_BUFFER_POS: u64 = 144;
+const AVI_MOVI_LIST_SIZE_POS: u64 = 216;
+
+impl<W: Write + Seek + Send> AviMjpegWriter<W> {
+    fn new(mut out: W, width: u32, height: u32, fps: u32) -> Result<Self> {
+        let fps = fps.max(1);
+        let mut h: Vec<u8> = Vec::with_capacity(224);
+        h.extend_from_slice(b"RIFF");
+        h.extend_from_slice(&0u32.to_le_bytes()); // RIFF 大小（回填）
+        h.extend_from_slice(b"AVI ");
+
+        // LIST hdrl = 4 + (8+56) + (8 + 4 + (8+56) + (8+40))
+        h.extend_from_slice(b"LIST");
+        h.extend_from_slice(&192u32.to_le_bytes());
+        h.extend_from_slice(b"hdrl");
+
+        h.extend_from_slice(b"avih");
+        h.extend_from_slice(&56u32.to_le_bytes());
+        h.extend_from_slice(&(1_000_000 / fps).to_le_bytes()); // dwMicroSecPerFrame
+        h.extend_from_slice(&0u32.to_le_bytes()); // dwMaxBytesPerSec
+        h.extend_from_slice(&0u32.to_le_bytes()); // dwPaddingGranularity
+        h.extend_from_slice(&AVIF_HASINDEX.to_le_bytes()); // dwFlags
+        h.extend_from_slice(&0u32.to_le_bytes()); // dwTotalFrames
+        h.extend_from_slice(&0u32.to_le_bytes()); // dwInitialFrames
+        h.extend_from_slice(&1u32.to_le_bytes()); // dwStreams
+        h.extend_from_slice(&0u32.to_le_bytes()); // dwSuggestedBufferSize
+        h.extend_from_slice(&width.to_le_bytes());
+        h.extend_from_slice(&height.to_le_bytes());
+        h.extend_from_slice(&[0u8; 16]); // dwReserved[4]
+
+        h.extend_from_slice(b"LIST");
+        h.extend_from_slice(&116u32.to_le_bytes());
+        h.extend_from_slice(b"strl");
+
+        h.extend_from_slice(b"strh");
+        h.extend_from_slice(&56u32.to_le_bytes());
+        h.extend_from_slice(b"vids");
+        h.extend_from_slice(b"MJPG");
+        h.extend_from_slice(&0u32.to_le_bytes()); // dwFlags
+        h.extend_from_slice(&0u16.to_le_bytes()); // wPriority
+        h.extend_from_slice(&0u16.to_le_bytes()); // wLanguage
+        h.extend_from_slice(&0u32.to_le_bytes()); // dwInitialFrames
+        h.extend_from_slice(&1u32.to_le_bytes()); // dwScale
+        h.extend_from_slice(&fps.to_le_bytes()); // dwRate
+        h.extend_from_slice(&0u32.to_le_bytes()); // dwStart
+        h.extend_from_slice(&0u32.to_le_bytes()); // dwLength
+        h.extend_from_slice(&0u32.to_le_bytes()); // dwSuggestedBufferSize
+        h.extend_from_slice(&u32::MAX.to_le_bytes()); // dwQuality (-1)
+        h.extend_from_slice(&0u32.to_le_bytes()); // dwSampleSize
+        h.extend_from_slice(&0u16.to_le_bytes()); // rcFrame
+        h.extend_from_slice(&0u16.to_le_bytes());
+        h.extend_from_slice(&(width.min(u16::MAX as u32) as u16).to_le_bytes());
+        h.extend_from_slice(&(height.min(u16::MAX as u32) as u16).to_le_bytes());
+
+        h.extend_from_slice(b"strf");
+        h.extend_from_slice(&40u32.to_le_bytes());
+        h.extend_from_slice(&40u32.to_le_bytes()); // biSize
+        h.extend_from_slice(&(width as i32).to_le_bytes());
+        h.extend_from_slice(&(height as i32).to_le_bytes());
+        h.extend_from_slice(&1u16.to_le_bytes()); // biPlanes
+        h.extend_from_slice(&24u16.to_le_bytes()); // biBitCount
+        h.extend_from_slice(b"MJPG"); // biCompression
+        h.extend_from_slice(&(width * height * 3).to_le_bytes()); // biSizeImage
+        h.extend_from_slice(&[0u8; 16]); // XPels, YPels, ClrUsed, ClrImportant
+
+        h.extend_from_slice(b"LIST");
+        h.extend_from_slice(&0u32.to_le_bytes()); // movi 大小（回填）
+        let movi_fourcc_pos = h.len() as u64;
+        h.extend_from_slice(b"movi");
+        debug_assert_eq!(movi_fourcc_pos, AVI_MOVI_LIST_SIZE_POS + 4);
+
+        out.write_all(&h)?;
+        Ok(Self {
+            out,
+            width,
+            height,
+            fps,
+            movi_fourcc_pos,
+            movi_bytes: 4,
+            max_frame_bytes: 0,
+            index: Vec::new(),
+        })
+    }
+
+    fn patch_u32(&mut self, pos: u64, value: u32) -> Result<()> {
+        self.out.seek(SeekFrom::Start(pos))?;
+        self.out.write_all(&value.to_le_bytes())?;
+        Ok(())
+    }
+}
+
+impl<W: Write + Seek + Send> FrameSink for AviMjpegWriter<W> {
+    fn write_frame(&mut self, data: &[u8], _pts: Duration) -> Result<u64> {
+        let padded = data.len() as u64 + (data.len() as u64 & 1);
+        if self.movi_bytes + 8 + padded > AVI_MAX_MOVI_BYTES {
+            return Err(SmartScopeError::VideoProcessingError(format!(
+                "AVI 文件达到 {}MB 上限（{}x{}），请使用 MKV 录制长视频",
+                AVI_MAX_MOVI_BYTES >> 20,
+                self.width,
+                self.height
+            )));
+        }
+        let offset = (self.movi_bytes) as u32;
+        self.out.write_all(b"00dc")?;
+        self.out.write_all(&(data.len() as u32).to_le_bytes())?;
+        self.out.write_all(data)?;
+        if data.len() & 1 == 1 {
+            self.out.write_all(&[0u8])?;
+        }
+        self.index.push((offset, data.len() as u32));
+        self.movi_bytes += 8 + padded;
+        self.max_frame_bytes = self.max_frame_bytes.max(data.len() as u32);
+        Ok(8 + padded)
+    }
+
+    fn finish(mut self: Box<Self>, frames: u64, duration: Duration) -> Result<()> {
+        // idx1 索引
+        let mut idx = Vec::with_capacity(8 + self.index.len() * 16);
+        idx.extend_from_slice(b"idx1");
+        idx.extend_from_slice(&((self.index.len() * 16) as u32).to_le_bytes());
+        for &(offset, size) in &self.index {
+            idx.extend_from_slice(b"00dc");
+            idx.extend_from_slice(&AVIIF_KEYFRAME.to_le_bytes());
+            idx.extend_from_slice(&offset.to_le_bytes());
+            idx.extend_from_slice(&size.to_le_bytes());
+        }
+        self.out.write_all(&idx)?;
+        let end = self.out.stream_position()?;
+
+        // 按实测帧率回填（相机实际帧率常低于标称值）
+        let frames32 = frames.min(u32::MAX as u64) as u32;
+        let (scale, rate, usec_per_frame) = if frames > 1 && duration > Duration::ZERO {
+            let usec = (duration.as_micros() as u64 / (frames - 1)).max(1);
+            (usec as u32, 1_000_000u32, usec as u32)
+        } else {
+            (1, self.fps, 1_000_000 / self.fps)
+        };
+        let bytes_per_sec = if usec_per_frame > 0 {
+            (self.movi_bytes * 1_000_000 / usec_per_frame as u64 / frames.max(1)).min(u32::MAX as u64) as u32
+        } else {
+            0
+        };
+
+        self.patch_u32(AVI_RIFF_SIZE_POS, (end - 8) as u32)?;
+        self.patch_u32(AVI_AVIH_USEC_PER_FRAME_POS, usec_per_frame)?;
+        self.patch_u32(AVI_AVIH_MAX_BYTES_PER_SEC_POS, bytes_per_sec)?;
+        self.patch_u32(AVI_AVIH_TOTAL_FRAMES_POS, frames32)?;
+        let max_frame = self.max_frame_bytes;
+        self.patch_u32(AVI_AVIH_SUGGESTED_BUFFER_POS, max_frame)?;
+        self.patch_u32(AVI_STRH_SCALE_POS, scale)?;
+        self.patch_u32(AVI_STRH_RATE_POS, rate)?;
+        self.patch_u32(AVI_STRH_LENGTH_POS, frames32)?;
+        self.patch_u32(AVI_STRH_SUGGESTED_BUFFER_POS, max_frame)?;
+        let movi_size = self.movi_bytes as u32;
+        self.patch_u32(self.movi_fourcc_pos - 4, movi_size)?;
+        self.out.seek(SeekFrom::Start(end))?;
+        self.out.flush()?;
+        Ok(())
+    }
+}
+
+// =========================
+// Matroska MJPEG 写入器
+// =========================
+
+const MKV_TIMESTAMP_SCALE_NS: u64 = 1_000_000; // 时间单位：毫秒
+/// 簇最长时长（SimpleBlock 相对时间戳为 i16）
+const MKV_CLUSTER_MAX_MS: u64 = 5_000;
+/// 8 字节的"未知大小"，用于稍后回填
+const MKV_UNKNOWN_SIZE: [u8; 8] = [0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF];
+
+fn ebml_id(buf: &mut Vec<u8>, id: u32) {
+    let bytes = id.to_be_bytes();
+    let skip = bytes.iter().take_while(|b| **b == 0).count();
+    buf.extend_from_slice(&bytes[skip..]);
+}
+
+/// EBML 变长大小编码（最短形式）
+fn ebml_size(buf: &mut Vec<u8>, size: u64) {
+    let mut len = 1;
+    while len < 8 && size >= (1u64 << (7 * len)) - 1 {
+        len += 1;
+    }
+    let marked = size | (1u64 << (7 * len));
+    buf.extend_from_slice(&marked.to_be_bytes()[8 - len..]);
+}
+
+/// 固定 8 字节的 EBML 大小（用于回填）
+fn ebml_size8(size: u64) -> [u8; 8] {
+    (size | (1u64 << 56)).to_be_bytes()
+}
+
+fn ebml_uint(buf: &mut Vec<u8>, id: u32, value: u64) {
+    ebml_id(buf, id);
+    let bytes = value.to_be_bytes();
+    let skip = bytes.iter().take_while(|b| **b == 0).count().min(7);
+    ebml_size(buf, (8 - skip) as u64);
+    buf.extend_from_slice(&bytes[skip..]);
+}
+
+fn ebml_string(buf: &mut Vec<u8>, id: u32, value: &str) {
+    ebml_id(buf, id);
+    ebml_size(buf, value.len() as u64);
+    buf.extend_from_slice(value.as_bytes());
+}
+
+fn ebml_master(buf: &mut Vec<u8>, id: u32, body: &[u8]) {
+    ebml_id(buf, id);
+    ebml_size(buf, body.len() as u64);
+    buf.extend_from_slice(body);
+}
+
+struct MkvMjpegWriter<W: Write + Seek + Send> {
+    out: W,
+    /// Segment 数据起点（Segment 大小字段之后）
+    segment_data_pos: u64,
+    /// Duration 浮点值所在位置
+    duration_pos: u64,
+    /// 当前簇：(大小字段位置, 数据起点, 簇时间戳ms)
+    cluster: Option<(u64, u64, u64)>,
+}
+
+impl<W: Write + Seek + Send> MkvMjpegWriter<W> {
+    fn new(mut out: W, width: u32, height: u32) -> Result<Self> {
+        let mut h = Vec::with_capacity(256);
+
+        let mut ebml = Vec::new();
+        ebml_uint(&mut ebml, 0x4286, 1); // EBMLVersion
+        ebml_uint(&mut ebml, 0x42F7, 1); // EBMLReadVersion
+        ebml_uint(&mut ebml, 0x42F2, 4); // EBMLMaxIDLength
+        ebml_uint(&mut ebml, 0x42F3, 8); // EBMLMaxSizeLength
+        ebml_string(&mut ebml, 0x4282, "matroska"); // DocType
+        ebml_uint(&mut ebml, 0x4287, 4); // DocTypeVersion
+        ebml_uint(&mut ebml, 0x4285, 2); // DocTypeReadVersion
+        ebml_master(&mut h, 0x1A45_DFA3, &ebml);
+
+        ebml_id(&mut h, 0x1853_8067); // Segment
+        h.extend_from_slice(&MKV_UNKNOWN_SIZE);
+        let segment_data_pos = h.len() as u64;
+
+        // Info
+        let mut info = Vec::new();
+        ebml_uint(&mut info, 0x2A_D7B1, MKV_TIMESTAMP_SCALE_NS);
+        ebml_string(&mut info, 0x4D80, "RustSmartScope");
+        ebml_string(&mut info, 0x5741, "RustSmartScope");
+        ebml_id(&mut info, 0x4489); // Duration（float64，回填）
+        ebml_size(&mut info, 8);
+        let duration_offset_in_info = info.len();
+        info.extend_from_slice(&0f64.to_be_bytes());
+        ebml_id(&mut h, 0x1549_A966);
+        ebml_size(&mut h, info.len() as u64);
+        let duration_pos = (h.len() + duration_offset_in_info) as u64;
+        h.extend_from_slice(&info);
+
+        // Tracks
+        let mut video = Vec::new();
+        ebml_uint(&mut video, 0xB0, width as u64);
+        ebml_uint(&mut video, 0xBA, height as u64);
+        let mut track = Vec::new();
+        ebml_uint(&mut track, 0xD7, 1); // TrackNumber
+        ebml_uint(&mut track, 0x73C5, 1); // TrackUID
+        ebml_uint(&mut track, 0x83, 1); // TrackType: video
+        ebml_uint(&mut track, 0x9C, 0); // FlagLacing
+        ebml_string(&mut track, 0x86, "V_MJPEG");
+        ebml_master(&mut track, 0xE0, &video);
+        let mut tracks = Vec::new();
+        ebml_master(&mut tracks, 0xAE, &track);
+        ebml_master(&mut h, 0x1654_AE6B, &tracks);
+
+        out.write_all(&h)?;
+        Ok(Self {
+            out,
+            segment_data_pos,
+            duration_pos,
+            cluster: None,
+        })
+    }
+
+    fn close_cluster(&mut self) -> Result<()> {
+        if let Some((size_pos, data_pos, _)) = self.cluster.take() {
+            let end = self.out.stream_position()?;
+            self.out.seek(SeekFrom::Start(size_pos))?;
+            self.out.write_all(&ebml_size8(end - data_pos))?;
+            self.out.seek(SeekFrom::Start(end))?;
+        }
+        Ok(())
+    }
+
+    fn open_cluster(&mut self, timestamp_ms: u64) -> Result<u64> {
+        let mut h = Vec::with_capacity(24);
+        ebml_id(&mut h, 0x1F43_B675);
+        let pos = self.out.stream_position()?;
+        let size_pos = pos + h.len() as u64;
+        h.extend_from_slice(&MKV_UNKNOWN_SIZE);
+        let data_pos = pos + h.len() as u64;
+        ebml_uint(&mut h, 0xE7, timestamp_ms); // Cluster Timestamp
+        self.out.write_all(&h)?;
+        self.cluster = Some((size_pos, data_pos, timestamp_ms));
+        Ok(h.len() as u64)
+    }
+}
+
+impl<W: Write + Seek + Send> FrameSink for MkvMjpegWriter<W> {
+    fn write_frame(&mut self, data: &[u8], pts: Duration) -> Result<u64> {
+        let ts = pts.as_millis() as u64;
+        let mut written = 0;
+        let need_new = match self.cluster {
+            Some((_, _, start)) => ts - start > MKV_CLUSTER_MAX_MS,
+            None => true,
+        };
+        if need_new {
+            self.close_cluster()?;
+            written += self.open_cluster(ts)?;
+        }
+        let cluster_ts = self.cluster.map(|c| c.2).unwrap_or(ts);
+
+        // SimpleBlock: 轨道号(vint) + 相对时间戳(i16) + 标志(关键帧) + 数据
+        let mut h = Vec::with_capacity(16);
+        ebml_id(&mut h, 0xA3);
+        ebml_size(&mut h, data.len() as u64 + 4);
+        h.push(0x81);
+        h.extend_from_slice(&((ts - cluster_ts) as i16).to_be_bytes());
+        h.push(0x80);
+        self.out.write_all(&h)?;
+        self.out.write_all(data)?;
+        Ok(written + h.len() as u64 + data.len() as u64)
+    }
+
+    fn finish(mut self: Box<Self>, _frames: u64, duration: Duration) -> Result<()> {
+        self.close_cluster()?;
+        let end = self.out.stream_position()?;
+        let segment_size_pos = self.segment_data_pos - 8;
+        self.out.seek(SeekFrom::Start(segment_size_pos))?;
+        self.out.write_all(&ebml_size8(end - self.segment_data_pos))?;
+        let duration_pos = self.duration_pos;
+        self.out.seek(SeekFrom::Start(duration_pos))?;
+        self.out.write_all(&(duration.as_secs_f64() * 1000.0).to_be_bytes())?;
+        self.out.seek(SeekFrom::Start(end))?;
+        self.out.flush()?;
+        Ok(())
+    }
+}
+
+// =========================
+// 软件 H.264（外部 ffmpeg）
+// =========================
+
+struct FfmpegH264Writer {
+    child: Child,
+    stdin: Option<ChildStdin>,
+}
+
+impl FfmpegH264Writer {
+    fn spawn(config: &RecorderConfig) -> Result<Self> {
+        let mut child = Command::new("ffmpeg")
+            .args(["-hide_banner", "-loglevel", "error", "-y"])
+            .args(["-f", "mjpeg", "-framerate", &config.fps.to_string(), "-i", "pipe:0"])
+            .args(["-c:v", "libx264", "-preset", "ultrafast", "-tune", "zerolatency"])
+            .args(["-pix_fmt", "yuv420p"])
+            .arg(&config.path)
+            .stdin(Stdio::piped())
+            .stdout(Stdio::null())
+            .stderr(Stdio::inherit())
+            .spawn()
+            .map_err(|e| {
+                SmartScopeError::VideoProcessingError(format!("无法启动 ffmpeg (libx264): {}", e))
+            })?;
+        let stdin = child.stdin.take();
+        Ok(Self { child, stdin })
+    }
+}
+
+impl FrameSink for FfmpegH264Writer {
+    fn write_frame(&mut self, data: &[u8], _pts: Duration) -> Result<u64> {
+        match self.stdin.as_mut() {
+            Some(stdin) => {
+                stdin.write_all(data)?;
+                Ok(data.len() as u64)
+            }
+            None => Err(SmartScopeError::VideoProcessingError("ffmpeg 输入已关闭".to_string())),
+        }
+    }
+
+    fn finish(mut self: Box<Self>, _frames: u64, _duration: Duration) -> Result<()> {
+        // 关闭 stdin 让 ffmpeg 写完尾部
+        drop(self.stdin.take());
+        let status = self.child.wait()?;
+        if status.success() {
+            Ok(())
+        } else {
+            Err(SmartScopeError::VideoProcessingError(format!(
+                "ffmpeg 退出状态异常: {}",
+                status
+            )))
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::io::Cursor;
+
+    fn fake_jpeg(len: usize, seed: u8) -> Vec<u8> {
+        let mut v = vec![seed; len];
+        v[0] = 0xFF;
+        v[1] = 0xD8;
+        v
+    }
+
+    fn u32_at(buf: &[u8], pos: usize) -> u32 {
+        u32::from_le_bytes(buf[pos..pos + 4].try_into().unwrap())
+    }
+
+    #[test]
+    fn test_container_from_extension() {
+        assert_eq!(RecordingContainer::from_path(Path::new("a.AVI")), RecordingContainer::Avi);
+        assert_eq!(RecordingContainer::from_path(Path::new("a.mkv")), RecordingContainer::Mkv);
+        assert_eq!(RecordingContainer::from_path(Path::new("a")), RecordingContainer::Mkv);
+    }
+
+    #[test]
+    fn test_avi_layout() {
+        let mut buf = Cursor::new(Vec::new());
+        {
+            let mut writer = AviMjpegWriter::new(&mut buf, 640, 480, 30).unwrap();
+            for i in 0..3u8 {
+                writer.write_frame(&fake_jpeg(101 + i as usize, i), Duration::ZERO).unwrap();
+            }
+            Box::new(writer).finish(3, Duration::from_millis(100)).unwrap();
+        }
+        let data = buf.into_inner();
+        assert_eq!(&data[0..4], b"RIFF");
+        assert_eq!(u32_at(&data, 4) as usize, data.len() - 8);
+        assert_eq!(&data[8..12], b"AVI ");
+        assert_eq!(u32_at(&data, AVI_AVIH_TOTAL_FRAMES_POS as usize), 3);
+        assert_eq!(u32_at(&data, AVI_STRH_LENGTH_POS as usize), 3);
+        // 实测帧间隔 50ms
+        assert_eq!(u32_at(&data, AVI_AVIH_USEC_PER_FRAME_POS as usize), 50_000);
+        assert_eq!(&data[AVI_MOVI_LIST_SIZE_POS as usize + 4..AVI_MOVI_LIST_SIZE_POS as usize + 8], b"movi");
+
+        // idx1 紧跟 movi 列表之后
+        let movi_size = u32_at(&data, AVI_MOVI_LIST_SIZE_POS as usize) as usize;
+        let idx_pos = AVI_MOVI_LIST_SIZE_POS as usize + 4 + movi_size;
+        assert_eq!(&data[idx_pos..idx_pos + 4], b"idx1");
+        assert_eq!(u32_at(&data, idx_pos + 4), 3 * 16);
+        // 第二个索引项指向第二帧的 '00dc'
+        let movi_fourcc = AVI_MOVI_LIST_SIZE_POS as usize + 4;
+        let second_off = u32_at(&data, idx_pos + 8 + 16 + 8) as usize;
+        assert_eq!(&data[movi_fourcc + second_off..movi_fourcc + second_off + 4], b"00dc");
+        assert_eq!(u32_at(&data, idx_pos + 8 + 16 + 12), 102);
+    }
+
+    #[test]
+    fn test_ebml_size_encoding() {
+        let mut b = Vec::new();
+        ebml_size(&mut b, 5);
+        assert_eq!(b, vec![0x85]);
+        b.clear();
+        // 127 是 1 字节形式的保留值，必须使用 2 字节
+        ebml_size(&mut b, 127);
+        assert_eq!(b, vec![0x40, 0x7F]);
+        b.clear();
+        ebml_size(&mut b, 1000);
+        assert_eq!(b, vec![0x43, 0xE8]);
+        assert_eq!(ebml_size8(3), [0x01, 0, 0, 0, 0, 0, 0, 3]);
+    }
+
+    #[test]
+    fn test_mkv_segment_size_and_clusters() {
+        let mut buf = Cursor::new(Vec::new());
+        {
+            let mut writer = MkvMjpegWriter::new(&mut buf, 1280, 720).unwrap();
+            for i in 0..4u64 {
+                // 跨越一个簇边界
+                let pts = Duration::from_millis(i * 2_000);
+                writer.write_frame(&fake_jpeg(64, i as u8), pts).unwrap();
+            }
+            Box::new(writer).finish(4, Duration::from_millis(6_000)).unwrap();
+        }
+        let data = buf.into_inner();
+        assert_eq!(&data[0..4], &[0x1A, 0x45, 0xDF, 0xA3]);
+
+        let seg = data
+            .windows(4)
+            .position(|w| w == [0x18, 0x53, 0x80, 0x67])
+            .unwrap();
+        let size_bytes: [u8; 8] = data[seg + 4..seg + 12].try_into().unwrap();
+        let size = u64::from_be_bytes(size_bytes) & !(1u64 << 56);
+        assert_eq!(size as usize, data.len() - (seg + 12));
+
+        let clusters = data
+            .windows(4)
+            .filter(|w| *w == [0x1F, 0x43, 0xB6, 0x75])
+            .count();
+        assert_eq!(clusters, 2);
+    }
+
+    #[test]
+    fn test_recorder_end_to_end_and_stop() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("rec.mkv");
+        let recorder = VideoRecorder::start(RecorderConfig::new(&path, 30)).unwrap();
+        let t0 = SystemTime::now();
+        let mut accepted = 0;
+        for i in 0..20u64 {
+            if recorder.submit(&fake_jpeg(256, i as u8), 640, 480, t0 + Duration::from_millis(i * 33)) {
+                accepted += 1;
+            }
+        }
+        let stats = recorder.stop().unwrap();
+        assert_eq!(stats.frames_written + stats.frames_dropped, 20);
+        assert_eq!(stats.frames_written, accepted);
+        assert_eq!(stats.queue_depth, 0);
+        assert!(stats.bytes_written >= accepted * 256);
+        assert!(!recorder.submit(&fake_jpeg(16, 0), 640, 480, t0));
+        assert!(std::fs::metadata(&path).unwrap().len() > 0);
+    }
+}
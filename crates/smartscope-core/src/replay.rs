@@ -0,0 +1,722 @@
+//! 相机帧回放源与帧转储
+//!
+//! 回放源（`[camera] source = "replay"`）从磁盘读取录制的帧，替代 V4L2 读取器，
+//! 在 CameraManager 内部走与实时相机相同的帧缓存/新帧通知路径，
+//! 因此 C++ 侧仍通过相同的 CCameraFrame / CCameraStatus FFI 取帧。
+//!
+//! 支持两种输入：
+//! - 帧转储文件（`.ssdump`，由 [`FrameDumper`] 在真实硬件上录制），保留原始格式（MJPEG/YUYV 等）、
+//!   原始时间戳与左右相机配对
+//! - 拼接的 MJPEG 流（`.mjpeg`），按单目回放，时间戳由配置帧率生成
+//!
+//! 帧转储格式（小端）：
+//! ```text
+//! 文件头: b"SSDUMP" 0x00 0x01
+//! 每帧:   u8 流(0=左,1=右,2=单目) | u8[3] 保留 | u32 fourcc | u32 宽 | u32 高
+//!         | u64 采集时间(UNIX ns) | u32 长度 | 数据
+//! ```
+
+use crate::camera::{CameraMode, FrameSignal, VideoFrame};
+use crate::config::ReplayConfig;
+use crate::error::{Result, SmartScopeError};
+use std::fs::File;
+use std::io::{BufReader, BufWriter, ErrorKind, Read, Write};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::mpsc::{self, SyncSender, TrySendError};
+use std::sync::{Arc, Condvar, Mutex};
+use std::thread::{self, JoinHandle};
+use std::time::{Duration, Instant, SystemTime, UNIX_EPOCH};
+
+const DUMP_MAGIC: &[u8; 8] = b"SSDUMP\x00\x01";
+const DUMP_RECORD_HEADER_LEN: usize = 28;
+/// 单帧数据上限（防止损坏文件导致超大分配）
+const DUMP_MAX_FRAME_BYTES: usize = 64 << 20;
+/// 尽快回放模式下等待消费者取走上一帧的最长时间
+const FAST_REPLAY_WAIT: Duration = Duration::from_millis(500);
+
+/// 转储中的相机流
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum DumpStream {
+    Left = 0,
+    Right = 1,
+    Single = 2,
+}
+
+impl DumpStream {
+    fn from_u8(v: u8) -> Option<Self> {
+        match v {
+            0 => Some(DumpStream::Left),
+            1 => Some(DumpStream::Right),
+            2 => Some(DumpStream::Single),
+            _ => None,
+        }
+    }
+
+    fn camera_name(self) -> &'static str {
+        match self {
+            DumpStream::Left => "replay-left",
+            DumpStream::Right => "replay-right",
+            DumpStream::Single => "replay-single",
+        }
+    }
+}
+
+fn system_time_ns(t: SystemTime) -> u64 {
+    t.duration_since(UNIX_EPOCH).map(|d| d.as_nanos() as u64).unwrap_or(0)
+}
+
+/// 帧转储写入器
+pub struct DumpWriter<W: Write> {
+    out: W,
+}
+
+impl<W: Write> DumpWriter<W> {
+    pub fn new(mut out: W) -> Result<Self> {
+        out.write_all(DUMP_MAGIC)?;
+        Ok(Self { out })
+    }
+
+    /// 写入一帧，返回写入的字节数
+    pub fn write(&mut self, stream: DumpStream, frame: &VideoFrame) -> Result<u64> {
+        let mut h = [0u8; DUMP_RECORD_HEADER_LEN];
+        h[0] = stream as u8;
+        h[4..8].copy_from_slice(&frame.format.to_le_bytes());
+        h[8..12].copy_from_slice(&frame.width.to_le_bytes());
+        h[12..16].copy_from_slice(&frame.height.to_le_bytes());
+        h[16..24].copy_from_slice(&system_time_ns(frame.timestamp).to_le_bytes());
+        h[24..28].copy_from_slice(&(frame.data.len() as u32).to_le_bytes());
+        self.out.write_all(&h)?;
+        self.out.write_all(&frame.data)?;
+        Ok((DUMP_RECORD_HEADER_LEN + frame.data.len()) as u64)
+    }
+
+    pub fn flush(&mut self) -> Result<()> {
+        self.out.flush()?;
+        Ok(())
+    }
+}
+
+/// 帧转储读取器
+pub struct DumpReader<R: Read> {
+    input: R,
+    next_id: u64,
+}
+
+impl DumpReader<BufReader<File>> {
+    pub fn open<P: AsRef<Path>>(path: P) -> Result<Self> {
+        Self::new(BufReader::with_capacity(1 << 20, File::open(path)?))
+    }
+}
+
+impl<R: Read> DumpReader<R> {
+    pub fn new(mut input: R) -> Result<Self> {
+        let mut magic = [0u8; 8];
+        input.read_exact(&mut magic)?;
+        if &magic != DUMP_MAGIC {
+            return Err(SmartScopeError::VideoProcessingError("不是有效的帧转储文件".to_string()));
+        }
+        Ok(Self { input, next_id: 0 })
+    }
+
+    /// 读取下一帧；文件结束返回 None（末尾不完整的帧视为结束）
+    pub fn next_frame(&mut self) -> Result<Option<(DumpStream, VideoFrame)>> {
+        let mut h = [0u8; DUMP_RECORD_HEADER_LEN];
+        match self.input.read_exact(&mut h) {
+            Ok(()) => {}
+            Err(e) if e.kind() == ErrorKind::UnexpectedEof => return Ok(None),
+            Err(e) => return Err(e.into()),
+        }
+        let u32_at = |i: usize| u32::from_le_bytes(h[i..i + 4].try_into().unwrap());
+        let stream = DumpStream::from_u8(h[0])
+            .ok_or_else(|| SmartScopeError::VideoProcessingError(format!("未知的转储流: {}", h[0])))?;
+        let ts_ns = u64::from_le_bytes(h[16..24].try_into().unwrap());
+        let len = u32_at(24) as usize;
+        if len > DUMP_MAX_FRAME_BYTES {
+            return Err(SmartScopeError::VideoProcessingError(format!("转储帧过大: {} 字节", len)));
+        }
+        let mut data = vec![0u8; len];
+        match self.input.read_exact(&mut data) {
+            Ok(()) => {}
+            Err(e) if e.kind() == ErrorKind::UnexpectedEof => return Ok(None),
+            Err(e) => return Err(e.into()),
+        }
+        let frame = VideoFrame {
+            data,
+            width: u32_at(8),
+            height: u32_at(12),
+            format: u32_at(4),
+            timestamp: UNIX_EPOCH + Duration::from_nanos(ts_ns),
+            camera_name: stream.camera_name().to_string(),
+            frame_id: self.next_id,
+        };
+        self.next_id += 1;
+        Ok(Some((stream, frame)))
+    }
+}
+
+/// 读取 JPEG 宽高（SOF0/SOF1/SOF2 段）
+pub fn jpeg_dimensions(data: &[u8]) -> Option<(u32, u32)> {
+    let mut i = 2;
+    while i + 9 < data.len() {
+        if data[i] != 0xFF {
+            i += 1;
+            continue;
+        }
+        let marker = data[i + 1];
+        let len = u16::from_be_bytes([data[i + 2], data[i + 3]]) as usize;
+        if matches!(marker, 0xC0 | 0xC1 | 0xC2) {
+            let h = u16::from_be_bytes([data[i + 5], data[i + 6]]) as u32;
+            let w = u16::from_be_bytes([data[i + 7], data[i + 8]]) as u32;
+            return Some((w, h));
+        }
+        i += 2 + len;
+    }
+    None
+}
+
+/// 按 SOI/EOI 标记切分拼接的 MJPEG 流
+pub fn split_mjpeg(data: &[u8]) -> Vec<Vec<u8>> {
+    let mut frames = Vec::new();
+    let mut start = None;
+    let mut i = 0;
+    while i + 1 < data.len() {
+        if data[i] == 0xFF {
+            match data[i + 1] {
+                0xD8 if start.is_none() => start = Some(i),
+                0xD9 => {
+                    if let Some(s) = start.take() {
+                        frames.push(data[s..i + 2].to_vec());
+                    }
+                }
+                _ => {}
+            }
+        }
+        i += 1;
+    }
+    frames
+}
+
+// =========================
+// 转储录制（真实硬件 → .ssdump）
+// =========================
+
+/// 转储录制统计
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct FrameDumpStats {
+    pub frames_written: u64,
+    pub frames_dropped: u64,
+    pub bytes_written: u64,
+}
+
+/// 后台帧转储录制器：取帧线程只复制数据入队，写盘在独立线程完成
+pub struct FrameDumper {
+    path: PathBuf,
+    sender: Mutex<Option<SyncSender<(DumpStream, VideoFrame)>>>,
+    worker: Mutex<Option<JoinHandle<Result<()>>>>,
+    frames_written: Arc<AtomicU64>,
+    frames_dropped: AtomicU64,
+    bytes_written: Arc<AtomicU64>,
+}
+
+impl FrameDumper {
+    pub fn start<P: AsRef<Path>>(path: P, queue_capacity: usize) -> Result<Self> {
+        let path = path.as_ref().to_path_buf();
+        if let Some(parent) = path.parent() {
+            if !parent.as_os_str().is_empty() {
+                std::fs::create_dir_all(parent)?;
+            }
+        }
+        let mut writer = DumpWriter::new(BufWriter::with_capacity(1 << 20, File::create(&path)?))?;
+        let (tx, rx) = mpsc::sync_channel::<(DumpStream, VideoFrame)>(queue_capacity.max(2));
+        let frames_written = Arc::new(AtomicU64::new(0));
+        let bytes_written = Arc::new(AtomicU64::new(0));
+        let (fw, bw) = (Arc::clone(&frames_written), Arc::clone(&bytes_written));
+
+        let worker = thread::Builder::new()
+            .name("frame-dumper".to_string())
+            .spawn(move || {
+                while let Ok((stream, frame)) = rx.recv() {
+                    let n = writer.write(stream, &frame)?;
+                    fw.fetch_add(1, Ordering::Relaxed);
+                    bw.fetch_add(n, Ordering::Relaxed);
+                }
+                writer.flush()
+            })
+            .map_err(SmartScopeError::Io)?;
+
+        tracing::info!("帧转储开始: {}", path.display());
+        Ok(Self {
+            path,
+            sender: Mutex::new(Some(tx)),
+            worker: Mutex::new(Some(worker)),
+            frames_written,
+            frames_dropped: AtomicU64::new(0),
+            bytes_written,
+        })
+    }
+
+    pub fn path(&self) -> &Path {
+        &self.path
+    }
+
+    /// 提交一帧（复制数据，不阻塞）；队列满时丢帧
+    pub fn submit(&self, stream: DumpStream, frame: &VideoFrame) -> bool {
+        let guard = self.sender.lock().unwrap();
+        let sent = match guard.as_ref() {
+            Some(tx) => match tx.try_send((stream, frame.clone())) {
+                Ok(()) => true,
+                Err(TrySendError::Full(_)) | Err(TrySendError::Disconnected(_)) => false,
+            },
+            None => return false,
+        };
+        if !sent {
+            self.frames_dropped.fetch_add(1, Ordering::Relaxed);
+        }
+        sent
+    }
+
+    pub fn stats(&self) -> FrameDumpStats {
+        FrameDumpStats {
+            frames_written: self.frames_written.load(Ordering::Relaxed),
+            frames_dropped: self.frames_dropped.load(Ordering::Relaxed),
+            bytes_written: self.bytes_written.load(Ordering::Relaxed),
+        }
+    }
+
+    /// 停止录制并等待写盘完成
+    pub fn stop(&self) -> Result<FrameDumpStats> {
+        self.sender.lock().unwrap().take();
+        let handle = match self.worker.lock().unwrap().take() {
+            Some(h) => h,
+            None => return Ok(self.stats()),
+        };
+        handle
+            .join()
+            .unwrap_or_else(|_| Err(SmartScopeError::Unknown("转储线程异常退出".to_string())))?;
+        let stats = self.stats();
+        tracing::info!(
+            "帧转储结束: {} ({} 帧, 丢帧 {})",
+            self.path.display(),
+            stats.frames_written,
+            stats.frames_dropped
+        );
+        Ok(stats)
+    }
+}
+
+impl Drop for FrameDumper {
+    fn drop(&mut self) {
+        let _ = self.stop();
+    }
+}
+
+// =========================
+// 回放源
+// =========================
+
+#[derive(Clone)]
+enum ReplayInput {
+    Dump(PathBuf),
+    /// 拼接的 MJPEG 帧（宽, 高, 帧数据）
+    Mjpeg(u32, u32, Arc<Vec<Vec<u8>>>),
+}
+
+#[derive(Default)]
+struct ReplaySlots {
+    left: Option<VideoFrame>,
+    right: Option<VideoFrame>,
+    single: Option<VideoFrame>,
+}
+
+struct ReplayShared {
+    slots: Mutex<ReplaySlots>,
+    /// 显示帧被取走时通知（尽快回放模式的背压）
+    taken: Condvar,
+    running: AtomicBool,
+    frames_played: AtomicU64,
+}
+
+/// 回放源：后台线程按原始时间戳（或尽快）把帧放入左/右/单目槽，CameraManager 在 process_frames 中取走
+pub struct ReplaySource {
+    input: ReplayInput,
+    realtime: bool,
+    loop_playback: bool,
+    fps: u32,
+    mode: CameraMode,
+    shared: Arc<ReplayShared>,
+    thread: Option<JoinHandle<()>>,
+}
+
+impl ReplaySource {
+    /// 打开回放文件并确定相机模式（转储中同时有左右流则为双目）
+    pub fn open(config: &ReplayConfig, fps: u32) -> Result<Self> {
+        let path = PathBuf::from(&config.path);
+        let is_dump = {
+            let mut magic = [0u8; 8];
+            File::open(&path)?.read_exact(&mut magic).is_ok() && &magic == DUMP_MAGIC
+        };
+
+        let (input, mode) = if is_dump {
+            let mut reader = DumpReader::open(&path)?;
+            let (mut has_left, mut has_right, mut has_single) = (false, false, false);
+            // 只探测开头若干帧
+            for _ in 0..16 {
+                match reader.next_frame()? {
+                    Some((DumpStream::Left, _)) => has_left = true,
+                    Some((DumpStream::Right, _)) => has_right = true,
+                    Some((DumpStream::Single, _)) => has_single = true,
+                    None => break,
+                }
+            }
+            let mode = if has_left && has_right {
+                CameraMode::StereoCamera
+            } else if has_left || has_single {
+                CameraMode::SingleCamera
+            } else {
+                CameraMode::NoCamera
+            };
+            (ReplayInput::Dump(path), mode)
+        } else {
+            let frames = split_mjpeg(&std::fs::read(&path)?);
+            let (w, h) = frames
+                .first()
+                .and_then(|f| jpeg_dimensions(f))
+                .ok_or_else(|| SmartScopeError::VideoProcessingError("回放文件中没有可用的 JPEG 帧".to_string()))?;
+            (ReplayInput::Mjpeg(w, h, Arc::new(frames)), CameraMode::SingleCamera)
+        };
+
+        tracing::info!(
+            "回放源: {} ({:?}, {})",
+            config.path,
+            mode,
+            if config.realtime { "按原始时间戳" } else { "尽快回放" }
+        );
+        Ok(Self {
+            input,
+            realtime: config.realtime,
+            loop_playback: config.loop_playback,
+            fps: fps.max(1),
+            mode,
+            shared: Arc::new(ReplayShared {
+                slots: Mutex::new(ReplaySlots::default()),
+                taken: Condvar::new(),
+                running: AtomicBool::new(false),
+                frames_played: AtomicU64::new(0),
+            }),
+            thread: None,
+        })
+    }
+
+    pub fn mode(&self) -> CameraMode {
+        self.mode
+    }
+
+    pub fn is_running(&self) -> bool {
+        self.shared.running.load(Ordering::Relaxed)
+    }
+
+    /// 已回放的帧数（含右相机帧）
+    pub fn frames_played(&self) -> u64 {
+        self.shared.frames_played.load(Ordering::Relaxed)
+    }
+
+    /// 启动回放线程；显示帧（左/单目）到达时通知 `signal`
+    pub fn start(&mut self, signal: Arc<FrameSignal>) -> Result<()> {
+        if self.thread.is_some() {
+            return Ok(());
+        }
+        self.shared.running.store(true, Ordering::Relaxed);
+        let shared = Arc::clone(&self.shared);
+        let player = Player {
+            shared: Arc::clone(&shared),
+            signal,
+            realtime: self.realtime,
+            mode: self.mode,
+        };
+        let loop_playback = self.loop_playback;
+        let fps = self.fps;
+        let input = self.input.clone();
+
+        let handle = thread::Builder::new()
+            .name("camera-replay".to_string())
+            .spawn(move || {
+                loop {
+                    let result = match &input {
+                        ReplayInput::Dump(path) => player.play_dump(path),
+                        ReplayInput::Mjpeg(w, h, frames) => player.play_mjpeg(*w, *h, frames, fps),
+                    };
+                    if let Err(e) = result {
+                        tracing::error!("回放失败: {}", e);
+                        break;
+                    }
+                    if !loop_playback || !shared.running.load(Ordering::Relaxed) {
+                        break;
+                    }
+                }
+                tracing::info!("回放结束，共 {} 帧", shared.frames_played.load(Ordering::Relaxed));
+                shared.running.store(false, Ordering::Relaxed);
+            })
+            .map_err(SmartScopeError::Io)?;
+        self.thread = Some(handle);
+        Ok(())
+    }
+
+    /// 停止回放线程并清空帧槽
+    pub fn stop(&mut self) {
+        self.shared.running.store(false, Ordering::Relaxed);
+        self.shared.taken.notify_all();
+        if let Some(handle) = self.thread.take() {
+            let _ = handle.join();
+        }
+        if let Ok(mut slots) = self.shared.slots.lock() {
+            *slots = ReplaySlots::default();
+        }
+    }
+
+    /// 取走双目帧对（左, 右）；在同一把锁内取出，保证左右来自同一对
+    pub fn take_stereo_pair(&self) -> (Option<VideoFrame>, Option<VideoFrame>) {
+        let pair = match self.shared.slots.lock() {
+            Ok(mut slots) => (slots.left.take(), slots.right.take()),
+            Err(_) => return (None, None),
+        };
+        if pair.0.is_some() {
+            self.shared.taken.notify_all();
+        }
+        pair
+    }
+
+    /// 取走单目帧
+    pub fn take_single(&self) -> Option<VideoFrame> {
+        let frame = self.shared.slots.lock().ok()?.single.take();
+        if frame.is_some() {
+            self.shared.taken.notify_all();
+        }
+        frame
+    }
+}
+
+impl Drop for ReplaySource {
+    fn drop(&mut self) {
+        self.stop();
+    }
+}
+
+/// 回放线程状态
+struct Player {
+    shared: Arc<ReplayShared>,
+    signal: Arc<FrameSignal>,
+    realtime: bool,
+    mode: CameraMode,
+}
+
+impl Player {
+    fn running(&self) -> bool {
+        self.shared.running.load(Ordering::Relaxed)
+    }
+
+    /// 按原始时间间隔等待（realtime），返回 false 表示已停止
+    fn pace(&self, clock: &mut Option<(Instant, u64)>, ts_ns: u64) -> bool {
+        if !self.realtime {
+            return self.running();
+        }
+        let (start, first_ns) = *clock.get_or_insert((Instant::now(), ts_ns));
+        let due = start + Duration::from_nanos(ts_ns.saturating_sub(first_ns));
+        loop {
+            if !self.running() {
+                return false;
+            }
+            let now = Instant::now();
+            if now >= due {
+                return true;
+            }
+            // 分段睡眠，保证 stop 能及时生效
+            thread::sleep((due - now).min(Duration::from_millis(50)));
+        }
+    }
+
+    /// 放入一帧；尽快模式下先等待消费者取走上一个显示帧（背压，不丢帧）
+    fn publish(&self, stream: DumpStream, mut frame: VideoFrame) {
+        let display = match (self.mode, stream) {
+            (CameraMode::StereoCamera, DumpStream::Left) => true,
+            (CameraMode::StereoCamera, _) => false,
+            // 单目模式：左流或单目流都作为单目帧
+            (_, DumpStream::Right) => return,
+            _ => true,
+        };
+        // 与实时相机一致，时间戳为交付时刻（用于延迟统计）
+        frame.timestamp = SystemTime::now();
+        let delivered_at = frame.timestamp;
+
+        let mut slots = match self.shared.slots.lock() {
+            Ok(s) => s,
+            Err(_) => return,
+        };
+        if !self.realtime {
+            let deadline = Instant::now() + FAST_REPLAY_WAIT;
+            while self.running() && Self::display_slot(&mut slots, self.mode).is_some() {
+                let now = Instant::now();
+                if now >= deadline {
+                    break;
+                }
+                slots = match self.shared.taken.wait_timeout(slots, deadline - now) {
+                    Ok((s, _)) => s,
+                    Err(_) => return,
+                };
+            }
+        }
+        match (self.mode, stream) {
+            (CameraMode::StereoCamera, DumpStream::Right) => slots.right = Some(frame),
+            (CameraMode::StereoCamera, _) => slots.left = Some(frame),
+            _ => slots.single = Some(frame),
+        }
+        drop(slots);
+
+        self.shared.frames_played.fetch_add(1, Ordering::Relaxed);
+        if display {
+            self.signal.notify(delivered_at);
+        }
+    }
+
+    fn display_slot(slots: &mut ReplaySlots, mode: CameraMode) -> &mut Option<VideoFrame> {
+        if mode == CameraMode::StereoCamera {
+            &mut slots.left
+        } else {
+            &mut slots.single
+        }
+    }
+
+    fn play_dump(&self, path: &Path) -> Result<()> {
+        let mut reader = DumpReader::open(path)?;
+        let mut clock = None;
+        while let Some((stream, frame)) = reader.next_frame()? {
+            if !self.pace(&mut clock, system_time_ns(frame.timestamp)) {
+                break;
+            }
+            // 双目转储中右帧先于左帧写入（见 CameraManager::store_stereo_frames），显示帧通知时同一对已齐备
+            self.publish(stream, frame);
+        }
+        Ok(())
+    }
+
+    fn play_mjpeg(&self, width: u32, height: u32, frames: &[Vec<u8>], fps: u32) -> Result<()> {
+        let mut clock = None;
+        let interval_ns = 1_000_000_000u64 / fps as u64;
+        for (i, data) in frames.iter().enumerate() {
+            if !self.pace(&mut clock, i as u64 * interval_ns) {
+                break;
+            }
+            let frame = VideoFrame {
+                data: data.clone(),
+                width,
+                height,
+                format: usb_camera::V4L2_PIX_FMT_MJPEG,
+                timestamp: SystemTime::now(),
+                camera_name: DumpStream::Single.camera_name().to_string(),
+                frame_id: i as u64,
+            };
+            self.publish(DumpStream::Single, frame);
+        }
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::camera::CameraManager;
+    use crate::config::SmartScopeConfig;
+    use std::io::Cursor;
+
+    fn frame(stream: DumpStream, id: u64, ts_ms: u64) -> VideoFrame {
+        VideoFrame {
+            data: vec![0xFF, 0xD8, id as u8, 0xFF, 0xD9],
+            width: 640,
+            height: 480,
+            format: usb_camera::V4L2_PIX_FMT_MJPEG,
+            timestamp: UNIX_EPOCH + Duration::from_millis(ts_ms),
+            camera_name: stream.camera_name().to_string(),
+            frame_id: id,
+        }
+    }
+
+    /// 按实时取帧的路径生成双目转储：CameraManager 送帧 → FrameDumper 写盘
+    fn write_stereo_dump(path: &Path, pairs: u64) {
+        let dumper = Arc::new(FrameDumper::start(path, pairs as usize * 2).unwrap());
+        let manager = CameraManager::new(SmartScopeConfig::default());
+        manager.set_dump_sink(Some(Arc::clone(&dumper)));
+        for i in 0..pairs {
+            manager.store_stereo_frames(
+                Some(frame(DumpStream::Left, i, i * 10)),
+                Some(frame(DumpStream::Right, i, i * 10)),
+            );
+        }
+        manager.set_dump_sink(None);
+        let stats = dumper.stop().unwrap();
+        assert_eq!((stats.frames_written, stats.frames_dropped), (pairs * 2, 0));
+    }
+
+    #[test]
+    fn test_dump_roundtrip() {
+        let mut buf = Vec::new();
+        {
+            let mut w = DumpWriter::new(&mut buf).unwrap();
+            w.write(DumpStream::Left, &frame(DumpStream::Left, 1, 1000)).unwrap();
+            w.write(DumpStream::Right, &frame(DumpStream::Right, 2, 1001)).unwrap();
+        }
+        // 末尾截断的帧视为文件结束
+        buf.extend_from_slice(&[2, 0, 0]);
+
+        let mut r = DumpReader::new(Cursor::new(buf)).unwrap();
+        let (s, f) = r.next_frame().unwrap().unwrap();
+        assert_eq!(s, DumpStream::Left);
+        assert_eq!((f.width, f.height, f.data[2]), (640, 480, 1));
+        assert_eq!(f.timestamp, UNIX_EPOCH + Duration::from_millis(1000));
+        let (s, _) = r.next_frame().unwrap().unwrap();
+        assert_eq!(s, DumpStream::Right);
+        assert!(r.next_frame().unwrap().is_none());
+    }
+
+    #[test]
+    fn test_split_mjpeg() {
+        let data = [0x00, 0xFF, 0xD8, 1, 2, 0xFF, 0xD9, 0xFF, 0xD8, 3, 0xFF, 0xD9, 0xFF];
+        let frames = split_mjpeg(&data);
+        assert_eq!(frames.len(), 2);
+        assert_eq!(frames[0], vec![0xFF, 0xD8, 1, 2, 0xFF, 0xD9]);
+    }
+
+    #[test]
+    fn test_fast_replay_delivers_every_stereo_pair() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("stereo.ssdump");
+        write_stereo_dump(&path, 20);
+
+        let config = ReplayConfig {
+            path: path.to_string_lossy().to_string(),
+            realtime: false,
+            loop_playback: false,
+        };
+        let mut source = ReplaySource::open(&config, 30).unwrap();
+        assert_eq!(source.mode(), CameraMode::StereoCamera);
+
+        let signal = Arc::new(FrameSignal::new());
+        source.start(Arc::clone(&signal)).unwrap();
+        let mut seq = 0;
+        let mut lefts = Vec::new();
+        while lefts.len() < 20 {
+            match signal.wait_newer(seq, Duration::from_secs(2)) {
+                Some((s, _)) => seq = s,
+                None => break,
+            }
+            let (left, right) = source.take_stereo_pair();
+            if let Some(left) = left {
+                assert_eq!(right.map(|r| r.data[2]), Some(left.data[2]));
+                lefts.push(left.data[2]);
+            }
+        }
+        source.stop();
+        // 背压保证尽快回放不丢显示帧
+        assert_eq!(lefts, (0..20u8).collect::<Vec<_>>());
+        assert_eq!(source.frames_played(), 40);
+    }
+}
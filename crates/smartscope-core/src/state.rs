@@ -5,6 +5,8 @@
 use crate::camera::CameraManager;
 use crate::config::{PartialConfig, SmartScopeConfig};
 use crate::image_pipeline::ImagePipeline;
+use crate::recorder::{RecorderConfig, RecorderStats, RecordingCodec, VideoRecorder};
+use crate::replay::{FrameDumpStats, FrameDumper};
 use crate::video_transform::VideoTransformProcessor;
 use notify::{Event, RecommendedWatcher, RecursiveMode, Watcher};
 use std::path::Path;
@@ -31,6 +33,10 @@ pub struct AppState {
     pub storage_monitor_stop: Option<Arc<AtomicBool>>,
     /// 外置存储监控线程句柄
     pub storage_monitor_handle: Option<JoinHandle<()>>,
+    /// 当前视频录制（未录制时为 None）
+    pub recorder: Option<Arc<VideoRecorder>>,
+    /// 当前帧转储（未转储时为 None）
+    pub frame_dumper: Option<Arc<FrameDumper>>,
 }
 
 impl Clone for AppState {
@@ -46,6 +52,8 @@ impl Clone for AppState {
             image_pipeline: self.image_pipeline.as_ref().map(Arc::clone),
             storage_monitor_stop: None,
             storage_monitor_handle: None,
+            recorder: self.recorder.as_ref().map(Arc::clone),
+            frame_dumper: self.frame_dumper.as_ref().map(Arc::clone),
         }
     }
 }
@@ -63,6 +71,8 @@ impl AppState {
             image_pipeline: None,
             storage_monitor_stop: None,
             storage_monitor_handle: None,
+            recorder: None,
+            frame_dumper: None,
         }
     }
 
@@ -111,6 +121,10 @@ impl AppState {
     }
 
     pub fn shutdown(&mut self) {
+        // 先结束录制，保证容器完整写入
+        let _ = self.stop_recording();
+        let _ = self.stop_frame_dump();
+
         // 停止相机管理器
         if let Some(mut camera_manager) = self.camera_manager.take() {
             let _ = camera_manager.stop();
@@ -391,12 +405,104 @@ impl AppState {
 
     /// 获取单相机最新帧
     pub fn get_single_camera_frame(&self) -> Option<crate::camera::VideoFrame> {
-        self.camera_manager.as_ref()?.get_single_frame()
+        let frame = self.camera_manager.as_ref()?.get_single_frame()?;
+        crate::frame_trace::record_capture(frame.frame_id, frame.timestamp);
+        Some(frame)
+    }
+
+    /// 新帧通知（相机管理器未创建时返回 None）
+    pub fn frame_signal(&self) -> Option<Arc<crate::camera::FrameSignal>> {
+        self.camera_manager.as_ref().map(|cm| cm.frame_signal())
+    }
+
+    /// 设置图像管道的帧旁路（AI 推理直接从核心管道取帧）
+    ///
+    /// 图像管道不可用时返回 false
+    pub fn set_frame_tap(&self, tap: Option<crate::image_pipeline::FrameTap>) -> bool {
+        match self.image_pipeline {
+            Some(ref pipeline) => match pipeline.lock() {
+                Ok(mut pipeline) => {
+                    pipeline.set_frame_tap(tap);
+                    true
+                }
+                Err(_) => false,
+            },
+            None => false,
+        }
+    }
+
+    /// 开始录制相机视频（MJPEG 直通或软件 H.264），容器由扩展名决定
+    pub fn start_recording(&mut self, path: &str, codec: RecordingCodec) -> crate::Result<()> {
+        if self.recorder.is_some() {
+            return Err(crate::SmartScopeError::VideoProcessingError("录制已在进行中".to_string()));
+        }
+        let camera_manager = self.camera_manager.as_ref().ok_or_else(|| {
+            crate::SmartScopeError::CameraError("相机管理器未初始化".to_string())
+        })?;
+
+        let fps = self.config.read().unwrap().camera.fps;
+        let mut config = RecorderConfig::new(path, fps);
+        config.codec = codec;
+        let recorder = Arc::new(VideoRecorder::start(config)?);
+        camera_manager.set_record_sink(Some(Arc::clone(&recorder)));
+        self.recorder = Some(recorder);
+        Ok(())
+    }
+
+    /// 停止录制并返回最终统计（未在录制时返回 None）
+    pub fn stop_recording(&mut self) -> crate::Result<Option<RecorderStats>> {
+        let recorder = match self.recorder.take() {
+            Some(r) => r,
+            None => return Ok(None),
+        };
+        if let Some(ref camera_manager) = self.camera_manager {
+            camera_manager.set_record_sink(None);
+        }
+        recorder.stop().map(Some)
+    }
+
+    /// 是否正在录制
+    pub fn is_recording(&self) -> bool {
+        self.recorder.as_ref().map(|r| r.is_recording()).unwrap_or(false)
+    }
+
+    /// 当前录制统计
+    pub fn recorder_stats(&self) -> Option<RecorderStats> {
+        self.recorder.as_ref().map(|r| r.stats())
+    }
+
+    /// 开始把原始相机帧转储到文件（供 camera.source = "replay" 回放）
+    pub fn start_frame_dump(&mut self, path: &str) -> crate::Result<()> {
+        if self.frame_dumper.is_some() {
+            return Err(crate::SmartScopeError::VideoProcessingError("帧转储已在进行中".to_string()));
+        }
+        let camera_manager = self.camera_manager.as_ref().ok_or_else(|| {
+            crate::SmartScopeError::CameraError("相机管理器未初始化".to_string())
+        })?;
+
+        // 约 1 秒的双目帧缓冲
+        let dumper = Arc::new(FrameDumper::start(path, 64)?);
+        camera_manager.set_dump_sink(Some(Arc::clone(&dumper)));
+        self.frame_dumper = Some(dumper);
+        Ok(())
+    }
+
+    /// 停止帧转储并返回最终统计（未在转储时返回 None）
+    pub fn stop_frame_dump(&mut self) -> crate::Result<Option<FrameDumpStats>> {
+        let dumper = match self.frame_dumper.take() {
+            Some(d) => d,
+            None => return Ok(None),
+        };
+        if let Some(ref camera_manager) = self.camera_manager {
+            camera_manager.set_dump_sink(None);
+        }
+        dumper.stop().map(Some)
     }
 
     /// 获取处理后的左相机帧（应用畸变校正和视频变换）
     pub fn get_processed_left_frame(&self) -> Option<crate::camera::VideoFrame> {
         let raw_frame = self.camera_manager.as_ref()?.get_left_frame()?;
+        crate::frame_trace::record_capture(raw_frame.frame_id, raw_frame.timestamp);
 
         // 如果有 ImagePipeline，使用它处理
         if let Some(ref pipeline) = self.image_pipeline {
@@ -406,7 +512,7 @@ impl AppState {
                 pipeline.set_distortion_correction_enabled(distortion_enabled);
 
                 // 处理帧数据
-                match pipeline.process_mjpeg_frame(&raw_frame.data, true) {
+                match pipeline.process_mjpeg_frame(&raw_frame.data, true, raw_frame.frame_id) {
                     Ok((rgb_data, width, height)) => {
                         // 返回处理后的帧（RGB格式）
                         return Some(crate::camera::VideoFrame {
@@ -442,7 +548,7 @@ impl AppState {
                 pipeline.set_distortion_correction_enabled(distortion_enabled);
 
                 // 处理帧数据
-                match pipeline.process_mjpeg_frame(&raw_frame.data, false) {
+                match pipeline.process_mjpeg_frame(&raw_frame.data, false, raw_frame.frame_id) {
                     Ok((rgb_data, width, height)) => {
                         // 返回处理后的帧（RGB格式）
                         return Some(crate::camera::VideoFrame {
@@ -9,9 +9,9 @@
 use std::collections::VecDeque;
 use std::path::Path;
 use std::sync::atomic::{AtomicBool, Ordering};
-use std::sync::{Arc, Mutex};
+use std::sync::{Arc, Condvar, Mutex};
 use std::thread;
-use std::time::{Duration, Instant};
+use std::time::{Duration, Instant, SystemTime};
 
 use crossbeam_channel::{Receiver, Sender};
 use log::{debug, error, info, warn};
@@ -46,6 +46,59 @@ pub struct VideoFrame {
     pub frame_id: u64,
 }
 
+/// New-frame notification shared between capture threads and consumers
+///
+/// The capture thread bumps a sequence number every time a frame is handed
+/// to the reader channel; consumers block in [`FrameSignal::wait_newer`]
+/// instead of polling on a timer.
+#[derive(Debug, Default)]
+pub struct FrameSignal {
+    /// (sequence, capture timestamp in ns since UNIX epoch)
+    state: Mutex<(u64, u64)>,
+    cond: Condvar,
+}
+
+impl FrameSignal {
+    /// Create a new signal with sequence 0 (no frame yet)
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Publish a new frame captured at `capture_time`
+    pub fn notify(&self, capture_time: SystemTime) {
+        let ns = capture_time
+            .duration_since(std::time::UNIX_EPOCH)
+            .map(|d| d.as_nanos() as u64)
+            .unwrap_or(0);
+        if let Ok(mut state) = self.state.lock() {
+            state.0 = state.0.wrapping_add(1);
+            state.1 = ns;
+        }
+        self.cond.notify_all();
+    }
+
+    /// Latest (sequence, capture_ns)
+    pub fn latest(&self) -> (u64, u64) {
+        self.state.lock().map(|s| *s).unwrap_or((0, 0))
+    }
+
+    /// Block until the sequence differs from `last_seq` or `timeout` elapses
+    ///
+    /// Returns the new (sequence, capture_ns), or None on timeout.
+    pub fn wait_newer(&self, last_seq: u64, timeout: Duration) -> Option<(u64, u64)> {
+        let guard = self.state.lock().ok()?;
+        let (guard, _) = self
+            .cond
+            .wait_timeout_while(guard, timeout, |s| s.0 == last_seq)
+            .ok()?;
+        if guard.0 != last_seq {
+            Some(*guard)
+        } else {
+            None
+        }
+    }
+}
+
 /// High-performance camera stream reader
 pub struct CameraStreamReader {
     /// Camera name
@@ -62,6 +115,8 @@ pub struct CameraStreamReader {
     read_thread: Option<thread::JoinHandle<()>>,
     /// Frame receiver
     frame_receiver: Option<mpsc::Receiver<VideoFrame>>,
+    /// Optional new-frame notification
+    frame_signal: Option<Arc<FrameSignal>>,
 }
 
 impl CameraStreamReader {
@@ -75,9 +130,15 @@ impl CameraStreamReader {
             frame_buffer: Arc::new(Mutex::new(VecDeque::new())),
             read_thread: None,
             frame_receiver: None,
+            frame_signal: None,
         }
     }
 
+    /// Attach a new-frame notification (must be called before `start`)
+    pub fn set_frame_signal(&mut self, signal: Arc<FrameSignal>) {
+        self.frame_signal = Some(signal);
+    }
+
     /// Start the stream reader
     pub fn start(&mut self) -> CameraResult<()> {
         if self.running.load(Ordering::Relaxed) {
@@ -97,6 +158,7 @@ impl CameraStreamReader {
         let config = self.config.clone();
         let running = self.running.clone();
         let frame_buffer = self.frame_buffer.clone();
+        let frame_signal = self.frame_signal.clone();
 
         // Start reading thread
         let handle = thread::spawn(move || {
@@ -107,6 +169,7 @@ impl CameraStreamReader {
                 running,
                 frame_buffer,
                 Some(tx),
+                frame_signal,
             );
         });
 
@@ -268,6 +331,7 @@ impl CameraStreamReader {
         running: Arc<AtomicBool>,
         frame_buffer: Arc<Mutex<VecDeque<VideoFrame>>>,
         frame_sender: Option<mpsc::Sender<VideoFrame>>,
+        frame_signal: Option<Arc<FrameSignal>>,
     ) {
         info!("Starting continuous capture thread for {}", camera_name);
 
@@ -310,7 +374,10 @@ impl CameraStreamReader {
                 // 在帧捕获开始时立即记录时间戳，而不是处理完成后
                 let frame_timestamp = std::time::SystemTime::now();
 
+                // 驱动交付缓冲区的时刻，用于端到端延迟统计
+                let mut delivered_at = frame_timestamp;
                 let capture_result = stream.dequeue(|buf| {
+                    delivered_at = std::time::SystemTime::now();
                     if buf.is_error() {
                         warn!("Buffer error flag set for {}", camera_name);
                     }
@@ -336,7 +403,11 @@ impl CameraStreamReader {
                             // 为了最小化延迟，如果通道满了就丢弃旧帧，只保留最新帧
                             if let Some(ref sender) = frame_sender {
                                 match sender.try_send(frame) {
-                                    Ok(()) => {}
+                                    Ok(()) => {
+                                        if let Some(ref signal) = frame_signal {
+                                            signal.notify(delivered_at);
+                                        }
+                                    }
                                     Err(mpsc::error::TrySendError::Full(_old_frame)) => {
                                         // 通道满了，丢弃旧帧（已经在通道里的），这个新帧也暂时丢弃
                                         // 这样可以确保下一帧能进入通道，保持最新画面
@@ -352,6 +423,9 @@ impl CameraStreamReader {
                                     buffer.clear(); // 清空旧帧
                                     buffer.push_back(frame); // 只保留最新帧
                                 }
+                                if let Some(ref signal) = frame_signal {
+                                    signal.notify(delivered_at);
+                                }
                             }
                         }
                     }
@@ -158,13 +158,30 @@ typedef struct {
     int32_t class_id;
 } smartscope_CDetection;
 
-/** 初始化AI推理服务（在程序启动时调用） */
-int smartscope_ai_init(const char* model_path, int num_workers);
+/** YOLOv8 后处理配置 */
+typedef struct {
+    float conf_threshold;    // 置信度阈值 [0, 1]
+    float nms_threshold;     // NMS IoU 阈值 [0, 1]
+    int32_t max_detections;  // 每帧最多检测数，<= 0 或超过 128 时取 128
+    uint64_t class_mask[4];  // 允许类别位图：类别 c 对应 class_mask[c / 64] 的第 c % 64 位；全 0 表示不过滤
+} smartscope_CAiPostprocessConfig;
+
+/** 填充默认后处理配置（conf 0.25、NMS 0.45、最多 128 个、不过滤类别） */
+int smartscope_ai_default_postprocess_config(smartscope_CAiPostprocessConfig* config_out);
+
+/**
+ * 初始化AI推理服务（在程序启动时调用）
+ * 预处理池 → NPU（每个模型实例固定到一个核心）→ 后处理池三级流水；
+ * num_workers 为模型实例总数，平均分到 [ai] npu_cores 个 NPU 核心上。
+ * config 为 NULL 时使用 smartscope.toml 的 [ai] 段（缺省为默认配置）；
+ * 阈值越界或类别号超出 0..255 时初始化失败
+ */
+int smartscope_ai_init(const char* model_path, int num_workers, const smartscope_CAiPostprocessConfig* config);
 
 /** 关闭AI推理服务（程序退出时调用） */
 void smartscope_ai_shutdown(void);
 
-/** 启用/禁用AI检测 */
+/** 启用/禁用AI检测（启用后双目左相机帧由核心图像管道直接送入推理） */
 void smartscope_ai_set_enabled(bool enabled);
 
 /** 查询AI检测是否启用 */
@@ -176,11 +193,117 @@ int smartscope_ai_submit_rgb888(int width, int height, const uint8_t* data, size
 /** 尝试获取最新推理结果；返回检测数量（>=0），错误返回-1 */
 int smartscope_ai_try_get_latest_result(smartscope_CDetection* results_out, int max_results);
 
+/** AI 推理阶段（smartscope_CAiStats.stages 的下标） */
+typedef enum {
+    SMARTSCOPE_AI_STAGE_PREPROCESS = 0, /**< 缩放 / letterbox 到模型输入 */
+    SMARTSCOPE_AI_STAGE_RUN = 1,        /**< 拷贝输入 + rknn_run */
+    SMARTSCOPE_AI_STAGE_OUTPUTS = 2,    /**< 取输出（rknn_outputs_get） */
+    SMARTSCOPE_AI_STAGE_DECODE = 3,     /**< 解码候选框 */
+    SMARTSCOPE_AI_STAGE_NMS = 4,        /**< NMS 与结果换算 */
+} smartscope_AiStage;
+
+typedef struct {
+    uint64_t count;
+    double mean_ms;
+    double p50_ms;   /* 按 2 的幂直方图桶上界估计 */
+    double p95_ms;
+    double max_ms;
+    double last_ms;
+} smartscope_CAiStageStats;
+
+/** AI 推理统计（所有模型实例汇总） */
+typedef struct {
+    smartscope_CAiStageStats stages[5]; /* 下标见 smartscope_AiStage */
+    uint64_t frames;                    /* 完成后处理的帧数 */
+    uint64_t errors;
+    double candidates_mean;             /* 每帧解码候选数（NMS 之前） */
+    uint64_t candidates_max;
+    uint64_t candidates_last;
+    uint64_t candidates_dropped;        /* 超出候选缓冲容量被丢弃的累计数 */
+    double detections_mean;             /* 每帧 NMS 后的检测数 */
+    uint64_t detections_last;
+    uint64_t submitted;                 /* 流水线计数 */
+    uint64_t dropped;
+    uint64_t completed;
+    uint64_t failed;
+    uint64_t in_flight;
+    uint32_t contexts;
+    uint32_t cores;
+} smartscope_CAiStats;
+
+/** 获取 AI 推理统计（返回0成功；服务未初始化返回错误码） */
+int smartscope_ai_get_stats(smartscope_CAiStats* stats_out);
+
+/** 清零 AI 推理统计的阶段耗时与候选数（返回0成功） */
+int smartscope_ai_reset_stats(void);
+
+/** AI 检测方式 */
+typedef enum {
+    SMARTSCOPE_AI_MODE_FULL = 0,     /**< 整个区域缩放到模型输入 */
+    SMARTSCOPE_AI_MODE_TILED = 1,    /**< 每帧切成重叠图块，按原分辨率检测后跨块合并 */
+    SMARTSCOPE_AI_MODE_ADAPTIVE = 2, /**< 上一帧有低置信度检测时分块，连续分块帧数有上限 */
+} smartscope_AiDetectionMode;
+
+/** 设置检测方式（smartscope_AiDetectionMode，返回0成功） */
+int smartscope_ai_set_detection_mode(int mode);
+
+/** 当前检测方式；服务未初始化返回-1 */
+int smartscope_ai_get_detection_mode(void);
+
+/** 设置检测区域（源帧像素，如放大时的可见区域）；width/height <= 0 恢复整帧。检测框坐标系不变 */
+int smartscope_ai_set_roi(int x, int y, int width, int height);
+
 // ---- Active push of AI results ----
 typedef void (*smartscope_ai_result_cb)(void* ctx, const char* json);
 void smartscope_ai_register_result_callback(void* ctx, smartscope_ai_result_cb cb, int max_fps);
 void smartscope_ai_unregister_result_callback(void* ctx);
 
+// =========================
+// Frame Trace (per-frame pipeline timing)
+// =========================
+
+/** 追踪阶段（与 Rust 侧 TraceStage 一致） */
+typedef enum {
+    SMARTSCOPE_TRACE_CAPTURE = 0,    /**< 驱动交付 → 开始处理 */
+    SMARTSCOPE_TRACE_DECODE = 1,     /**< MJPEG 解码 */
+    SMARTSCOPE_TRACE_UNDISTORT = 2,  /**< 畸变校正 */
+    SMARTSCOPE_TRACE_TRANSFORM = 3,  /**< RGA 视频变换 */
+    SMARTSCOPE_TRACE_FFI_COPY = 4,   /**< 发布进帧环并借出 */
+    SMARTSCOPE_TRACE_QIMAGE = 5,     /**< 前端构造/转换 QImage */
+    SMARTSCOPE_TRACE_PAINT = 6,      /**< 交给显示项 → 纹理上传完成 */
+    SMARTSCOPE_TRACE_AI_SUBMIT = 7,  /**< AI 预处理并提交 */
+    SMARTSCOPE_TRACE_AI_RESULT = 8,  /**< 提交 → 取到结果 */
+    SMARTSCOPE_TRACE_END_TO_END = 9, /**< 驱动交付 → 上屏 */
+} smartscope_TraceStage;
+
+typedef struct {
+    uint32_t stage;   /* smartscope_TraceStage */
+    uint32_t count;
+    double p50_ms;
+    double p95_ms;
+    double p99_ms;
+    double max_ms;
+} smartscope_CTraceStageStats;
+
+/** 启用/停用逐帧追踪（默认启用） */
+void smartscope_trace_set_enabled(bool enabled);
+bool smartscope_trace_is_enabled(void);
+
+/** 追踪时钟（进程内单调纳秒）；前端打点必须使用此时钟 */
+uint64_t smartscope_trace_now_ns(void);
+
+/** 把 Unix 纪元纳秒（帧采集时间戳）换算到追踪时钟 */
+uint64_t smartscope_trace_from_unix_ns(uint64_t unix_ns);
+
+/** 记录一段阶段耗时（返回0成功） */
+int smartscope_trace_record(uint64_t frame_id, uint32_t stage, uint64_t start_ns, uint64_t end_ns);
+
+/** 获取各阶段滚动 p50/p95/p99；返回写入项数，错误返回-1 */
+int smartscope_trace_get_stage_stats(smartscope_CTraceStageStats* stats_out, int max_stages);
+
+/** 导出 Chrome Trace JSON；返回事件数，错误返回-1 */
+int smartscope_trace_export_chrome(const char* output_path);
+
 // =========================
 // Capture (Save to Directory)
 // =========================
@@ -28,6 +28,8 @@ Window {
 
     // 录制状态
     property bool recording: false
+    // 录制状态文字（相机录制时显示时长/丢帧，由外部绑定）
+    property string statusText: ""
     signal recordingToggled(bool recording)
 
     // 内容（按钮 + 停止收尾时的指示）
@@ -107,6 +109,17 @@ Window {
             }
         }
 
+        Text {
+            anchors.horizontalCenter: parent.horizontalCenter
+            anchors.bottom: parent.bottom
+            visible: recordTool.recording && recordTool.statusText.length > 0
+            text: recordTool.statusText
+            color: "#FFFFFF"
+            font.pixelSize: 12
+            style: Text.Outline
+            styleColor: "#80000000"
+        }
+
         // BusyIndicator已移除(C++端没有finalizing属性)
         // 硬件编码菜单已移除：固定软件编码 720p
     }
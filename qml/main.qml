@@ -759,16 +759,33 @@ ApplicationWindow {
     // 全局录制工具栏（独立置顶窗口）
     RecordingToolWindow {
         id: recordingTool
+        // 相机录制：显示时长与丢帧数
+        statusText: CameraManager.recording
+                    ? Math.floor(CameraManager.recordElapsedMs / 60000) + ":"
+                      + ("0" + Math.floor(CameraManager.recordElapsedMs / 1000) % 60).slice(-2)
+                      + (CameraManager.recordDroppedFrames > 0 ? "  -" + CameraManager.recordDroppedFrames : "")
+                    : ""
         // 可在此连接录制开始/停止与后端桥接
         onRecordingToggled: function(on) {
             Logger.info(on ? "开始录制" : "停止录制")
             if (on) {
+                // 相机运行时直接录制相机码流（MJPEG 直通），否则回退到屏幕录制
+                if (CameraManager.cameraRunning) {
+                    var videoDir = StorageManager.resolveVideoSessionPath(CameraManager.cameraMode === 2 ? "stereo" : "single")
+                    if (!CameraManager.startVideoRecording(videoDir)) {
+                        Logger.error("启动相机录制失败")
+                        recordingTool.recording = false
+                    }
+                    return
+                }
                 var dir = StorageManager.resolveVideoSessionPath("screen")
                 // C++端会自动生成时间戳文件名和处理所有参数
                 if (!ScreenRecorderManager.startScreenRecording(dir)) {
                     Logger.error("启动屏幕录制失败")
                     recordingTool.recording = false
                 }
+            } else if (CameraManager.recording) {
+                CameraManager.stopVideoRecording()
             } else {
                 ScreenRecorderManager.stopScreenRecording()
             }
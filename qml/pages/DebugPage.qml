@@ -9,6 +9,29 @@ Page {
 
     signal backRequested()
 
+    // 逐帧流水线分位数（CameraManager.frameTraceStats，每秒刷新）
+    property var traceStats: []
+
+    Timer {
+        interval: 1000
+        repeat: true
+        running: debugPage.visible && CameraManager.frameTraceEnabled
+        triggeredOnStart: true
+        onTriggered: debugPage.traceStats = CameraManager.frameTraceStats()
+    }
+
+    // AI 推理统计（AiDetectionManager.inferenceStats，每秒刷新；服务未初始化时为空表）
+    property var aiStats: ({})
+    readonly property bool aiStatsValid: aiStats.stages !== undefined
+
+    Timer {
+        interval: 1000
+        repeat: true
+        running: debugPage.visible && typeof AiDetectionManager !== 'undefined' && AiDetectionManager !== null
+        triggeredOnStart: true
+        onTriggered: debugPage.aiStats = AiDetectionManager.inferenceStats()
+    }
+
     background: Rectangle {
         color: "#1E1E1E"
     }
@@ -123,12 +146,95 @@ Page {
 
                         ColumnLayout {
                             anchors.fill: parent
-                            spacing: 8
+                            spacing: 4
+
+                            StatusItem {
+                                label: "模型:"
+                                value: debugPage.aiStatsValid
+                                       ? debugPage.aiStats.contexts + " 实例 / " + debugPage.aiStats.cores + " 核"
+                                       : "未加载"
+                                status: debugPage.aiStatsValid ? "good" : "warning"
+                            }
+                            StatusItem {
+                                label: "帧 (完成/丢弃/失败):"
+                                visible: debugPage.aiStatsValid
+                                value: debugPage.aiStatsValid
+                                       ? debugPage.aiStats.frames + " / " + debugPage.aiStats.dropped
+                                         + " / " + (debugPage.aiStats.failed + debugPage.aiStats.errors)
+                                       : ""
+                                status: debugPage.aiStatsValid && debugPage.aiStats.errors > 0 ? "warning" : "good"
+                            }
+                            StatusItem {
+                                label: "候选/检测 (均值):"
+                                visible: debugPage.aiStatsValid
+                                value: debugPage.aiStatsValid
+                                       ? debugPage.aiStats.candidatesMean.toFixed(1) + " / "
+                                         + debugPage.aiStats.detectionsMean.toFixed(1)
+                                       : ""
+                                status: debugPage.aiStatsValid && debugPage.aiStats.candidatesDropped > 0 ? "warning" : "good"
+                            }
+
+                            Text {
+                                visible: debugPage.aiStatsValid
+                                text: "阶段 mean / p95 / max (ms)"
+                                color: "#D8DEE9"
+                                font.pixelSize: 11
+                            }
+
+                            Repeater {
+                                model: debugPage.aiStatsValid ? debugPage.aiStats.stages : []
+
+                                StatusItem {
+                                    label: modelData.stage
+                                    value: modelData.mean.toFixed(2) + " / " + modelData.p95.toFixed(2)
+                                           + " / " + modelData.max.toFixed(2)
+                                    status: modelData.p95 > 33.3 ? "warning" : "good"
+                                }
+                            }
+
+                            Button {
+                                visible: debugPage.aiStatsValid
+                                text: "清零统计"
+                                onClicked: {
+                                    AiDetectionManager.resetInferenceStats()
+                                    debugPage.aiStats = AiDetectionManager.inferenceStats()
+                                }
+                            }
+                        }
+                    }
+
+                    // 帧流水线耗时
+                    GroupBox {
+                        Layout.fillWidth: true
+                        title: "帧流水线 p50/p95/p99 (ms)"
 
-                            StatusItem { label: "模型:"; value: "未加载"; status: "warning" }
-                            StatusItem { label: "推理时间:"; value: "N/A"; status: "warning" }
-                            StatusItem { label: "GPU使用:"; value: "0%"; status: "warning" }
-                            StatusItem { label: "检测数:"; value: "0"; status: "warning" }
+                        background: Rectangle {
+                            color: "#3B4252"
+                            border.color: "#4C566A"
+                            radius: 5
+                        }
+
+                        ColumnLayout {
+                            anchors.fill: parent
+                            spacing: 4
+
+                            Text {
+                                visible: debugPage.traceStats.length === 0
+                                text: CameraManager.frameTraceEnabled ? "暂无数据" : "追踪已关闭"
+                                color: "#D8DEE9"
+                                font.pixelSize: 11
+                            }
+
+                            Repeater {
+                                model: debugPage.traceStats
+
+                                StatusItem {
+                                    label: modelData.stage
+                                    value: modelData.p50.toFixed(1) + " / " + modelData.p95.toFixed(1)
+                                           + " / " + modelData.p99.toFixed(1)
+                                    status: modelData.p95 > 33.3 ? "warning" : "good"
+                                }
+                            }
                         }
                     }
                 }
@@ -346,10 +452,39 @@ Page {
                                 Layout.fillWidth: true
                                 text: "📊 性能统计"
                                 onClicked: {
-                                    addLog("INFO", "平均处理时间: 23.5ms")
+                                    var stats = CameraManager.frameTraceStats()
+                                    if (stats.length === 0) {
+                                        addLog("WARNING", "暂无帧追踪数据")
+                                    }
+                                    for (var i = 0; i < stats.length; i++) {
+                                        var s = stats[i]
+                                        addLog("INFO", s.stage + ": p50 " + s.p50.toFixed(2) + "ms, p95 "
+                                               + s.p95.toFixed(2) + "ms, p99 " + s.p99.toFixed(2)
+                                               + "ms (n=" + s.count + ")")
+                                    }
+                                }
+                            }
+
+                            Button {
+                                Layout.fillWidth: true
+                                text: "⏱️ 导出帧追踪"
+                                onClicked: {
+                                    var dir = StorageManager.resolveScreenshotSessionPath("trace")
+                                    var path = CameraManager.exportFrameTrace(dir !== "" ? dir : ".")
+                                    if (path !== "") {
+                                        addLog("INFO", "帧追踪已导出: " + path)
+                                    } else {
+                                        addLog("ERROR", "帧追踪导出失败")
+                                    }
                                 }
                             }
 
+                            CheckBox {
+                                text: "逐帧追踪"
+                                checked: CameraManager.frameTraceEnabled
+                                onToggled: CameraManager.frameTraceEnabled = checked
+                            }
+
                             Button {
                                 Layout.fillWidth: true
                                 text: "⚠️ 故障诊断"
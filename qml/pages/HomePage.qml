@@ -2,6 +2,7 @@ import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
 import "../components"
+import "../i18n" 1.0 as I18n
 import RustSmartScope.Logger 1.0
 import RustSmartScope.Video 1.0
 
@@ -23,17 +24,10 @@ Rectangle {
         anchors.fill: parent
         transformOrigin: Item.Center
 
-        // 轻量级AI检测覆盖层作为子项，随视频缩放同步缩放
-        DetectionsOverlay {
-            id: detectionsOverlay
-            anchors.fill: parent
-            videoItem: videoDisplay
-            z: 1
-            modelInputSize: videoDisplay.modelInputSize
-            // 提高叠加层刷新上限，视频与叠加层帧率解耦
-            maxFps: 60
-            clip: true
-        }
+        // AI检测框由 VideoDisplay 在场景图中直接绘制（随视频缩放同步缩放），
+        // 检测结果直接来自类型化模型，不经过 QVariantList
+        detectionModel: AiDetectionManager ? AiDetectionManager.detectionModel : null
+        englishLabels: I18n.I18n.language === 'en'
     }
 
     // 捏合缩放（双指触控）；桌面可配合左侧+/-按钮
@@ -100,6 +94,11 @@ Rectangle {
             var vx = (fw - vw) / 2
             var vy = (fh - vh) / 2
             pipDisplay.viewWindow = Qt.rect(vx, vy, vw, vh)
+            // 放大时只检测可见区域，小缺陷按更高分辨率送入模型
+            if (typeof AiDetectionManager !== 'undefined') {
+                if (s > 1.0) AiDetectionManager.setRoi(pipDisplay.viewWindow)
+                else AiDetectionManager.clearRoi()
+            }
         }
     }
 
@@ -206,14 +205,6 @@ Rectangle {
         function onFrameSizeChanged() { pipContainer.updatePipViewWindow() }
     }
 
-    // 连接AI检测结果，用于绘制覆盖层（分层）
-    Connections {
-        target: AiDetectionManager
-        function onDetectionsUpdated(detections) {
-            detectionsOverlay.detections = detections
-        }
-    }
-
     function updateVideoSource() {
         if (!CameraManager) return
 
@@ -13,6 +13,8 @@ StereoDepthInference::StereoDepthInference(const std::string& camera_param_dir,
         // 创建处理器
         processor_ = std::make_unique<stereo_depth::ComprehensiveDepthProcessor>(
             camera_param_dir, mono_model_path);
+        // 按初始模式（BALANCED）配置融合滤波器，与之后 setPerformanceMode 的效果一致
+        updateOptionsForMode(current_mode_);
             
         std::cout << "StereoDepthInference 初始化成功" << std::endl;
         
@@ -71,25 +73,36 @@ StereoDepthInference::PerformanceMode StereoDepthInference::getPerformanceMode()
 }
 
 void StereoDepthInference::updateOptionsForMode(PerformanceMode mode) {
-    // 性能模式设置 - 暂时使用默认配置
-    // 后续可以通过 processor_ 的接口来调整参数
+    if (!processor_) {
+        return;
+    }
+    // 目前按模式只切换融合的保边滤波器（选择依据见 benchmarks/fusion_filter_bench），其余沿用默认配置；
+    // 融合在 inference() 所用的 processAlreadyRectifiedImages 中执行（fusion_mode = MonoSmoothStereo）
+    stereo_depth::ComprehensiveDepthOptions options = processor_->getOptions();
     switch (mode) {
         case HIGH_QUALITY:
-            // 高质量模式配置
+            // 高质量模式：双边滤波（原实现）
+            options.fusion_filter = stereo_depth::EdgeAwareFilterType::Bilateral;
             break;
             
         case BALANCED:
-            // 平衡模式配置
+            // 平衡模式：引导滤波，盒式滤波实现，代价与核大小无关
+            options.fusion_filter = stereo_depth::EdgeAwareFilterType::Guided;
             break;
             
         case FAST:
-            // 快速模式配置
+            // 快速模式：域变换递归滤波
+            options.fusion_filter = stereo_depth::EdgeAwareFilterType::DomainTransform;
+            options.fusion_filter_iterations = 3;
             break;
             
         case ULTRA_FAST:
-            // 极速模式配置
+            // 极速模式：域变换递归滤波，减少迭代
+            options.fusion_filter = stereo_depth::EdgeAwareFilterType::DomainTransform;
+            options.fusion_filter_iterations = 1;
             break;
     }
+    processor_->updateOptions(options);
 }
 
 void StereoDepthInference::saveDisparity(const cv::Mat& disparity, const std::string& filename) {
@@ -6,6 +6,10 @@
 #include <vector>
 #include <tuple>
 #include "stereo_depth/enhanced_postprocessing.h"
+#include "stereo_depth/fusion_filter_graph.hpp"
+#include "stereo_depth/sgbm_matcher_cache.hpp"
+#include "stereo_depth/pyramid_sgbm.hpp"
+#include "stereo_depth/strip_sgbm_engine.hpp"
 
 // 前向声明
 namespace depth_anything {
@@ -44,6 +48,18 @@ struct ComprehensiveDepthOptions {
     int prefilter_cap = 63;
     int disp12_max_diff = 1;
     
+    // SGBM并行：按行切成重叠条带在线程池上计算
+    // MODE_SGBM_3WAY 内部已按 cv::getNumThreads() 分条并行，外层 parallel_for_ 嵌套时内部并行被关闭，
+    // 条带结果又只是近似，因此默认整帧计算；条带模式需经 strip_sgbm_bench 在目标板上实测确有收益再开启
+    int sgbm_strips = 1;          // 条带数：1 整帧单次计算（默认，逐像素精确），0 按 OpenCV 线程数，>1 指定条带数
+    int sgbm_path_margin = 32;    // 条带上下额外计算的行数（另加 block_size/2），越大越接近整帧结果
+    
+    // 由粗到细视差搜索：先在低分辨率完整搜索，再按块收窄全分辨率的视差范围（大 num_disparities 时收益明显）
+    bool enable_pyramid_disparity = false;
+    int pyramid_levels = 1;               // 粗层缩小 2^levels 倍（1 为 1/2，2 为 1/4）
+    int pyramid_tile_size = 128;          // 全分辨率分块边长
+    int pyramid_disparity_margin = 8;     // 每块范围两侧放宽的视差（像素）
+    
     // 深度校准参数
     int min_samples = 1000;
     int ransac_max_iterations = 50;
@@ -56,10 +72,12 @@ struct ComprehensiveDepthOptions {
     // 融合与修复（新策略）
     FusionMode fusion_mode = FusionMode::MonoSmoothStereo;
     float fusion_confidence_gamma = 1.0f;    // α = conf^gamma
-    float fusion_confidence_thresh = 0.3f;   // τc：注入Hstereo的置信度阈值
+    float fusion_confidence_thresh = 0.3f;   // τc：注入Hstereo的置信度阈值（置信度目前只有 0/1，高频在所有像素注入，暂未使用）
     int fusion_bilateral_d = 5;              // 双边核
     double fusion_bilateral_sigma_s = 7.0;   // 空间sigma
     double fusion_bilateral_sigma_r = 50.0;  // 颜色/值sigma（以mm尺度）
+    EdgeAwareFilterType fusion_filter = EdgeAwareFilterType::Bilateral; // 低频提取的保边滤波器（共用上面三项参数）
+    int fusion_filter_iterations = 3;        // 域变换滤波的迭代次数
     float fusion_edge_grad_thresh = 0.02f;   // 边缘梯度阈值（归一化或按mm梯度）
     
     // 新增：平面检测参数
@@ -203,6 +221,8 @@ public:
     
     /**
      * @brief 处理已经校正过的图像（跳过立体校正步骤）
+     *
+     * fusion_mode 为 MonoSmoothStereo 时同时输出 final_fused_depth（优先使用校准后的单目深度）。
      * @param left_rectified 已经校正的左图
      * @param right_rectified 已经校正的右图
      * @param Q_matrix 重投影矩阵（用于视差到深度的转换）
@@ -232,6 +252,17 @@ public:
     cv::Mat computeDisparityOnly(const cv::Mat& left_rectified,
                                 const cv::Mat& right_rectified);
     
+    /**
+     * @brief 只计算 ROI 内的视差（如测量区域），其余像素为无效视差
+     * @param left_rectified 校正后的左图
+     * @param right_rectified 校正后的右图
+     * @param roi 原图坐标下的区域（按 options.scale 换算到处理尺寸）
+     * @return 与 computeDisparityOnly 同尺寸的视差图，ROI 外为 min_disparity - 1
+     */
+    cv::Mat computeDisparityInRoi(const cv::Mat& left_rectified,
+                                  const cv::Mat& right_rectified,
+                                  const cv::Rect& roi);
+    
     /**
      * @brief 仅计算双目深度图
      * @param left_rectified 校正后的左图
@@ -296,6 +327,11 @@ public:
      * @param options 新的配置选项
      */
     void updateOptions(const ComprehensiveDepthOptions& options);
+    
+    /**
+     * @brief 获取当前配置选项
+     */
+    const ComprehensiveDepthOptions& getOptions() const { return options_; }
 
     // 新增：外部注入Q矩阵（用于已校正图路径）
     void setQMatrix(const cv::Mat& Q_matrix);
@@ -485,6 +521,13 @@ private:
     // 图像预处理
     void preprocessImage(const cv::Mat& src, cv::Mat& dst);
     
+    // 灰度图计算视差（由粗到细、条带并行或整帧）
+    void computeDisparity(const cv::Mat& grayL, const cv::Mat& grayR, cv::Mat& disp32F,
+                          cv::Mat* disp16S = nullptr);
+    StripSgbmOptions stripOptions() const;
+    PyramidSgbmOptions pyramidOptions() const;
+    FusionGraphOptions fusionGraphOptions() const;
+    
     // 置信度权重计算
     float calculateConfidenceWeight(float disparity, float depth, float gradient = 0.0f) const;
     
@@ -514,8 +557,14 @@ private:
     cv::Rect roi1_, roi2_;
     cv::Mat map1x_, map1y_, map2x_, map2y_;
     
-    // SGBM
-    cv::Ptr<cv::StereoSGBM> sgbm_;
+    // SGBM：按参数缓存的匹配器（与增强后处理器共用），updateOptions 只在SGBM参数变化时切换
+    std::shared_ptr<SgbmMatcherCache> matcher_cache_;
+    SgbmMatcherKey sgbm_key_;
+    std::unique_ptr<StripSgbmEngine> strip_engine_;
+    std::unique_ptr<PyramidSgbm> pyramid_;
+    
+    // MonoSmoothStereo 融合：中间结果按帧缓存的滤波图
+    FusionFilterGraph fusion_graph_;
     
     // 单目深度模型
     std::shared_ptr<depth_anything::InferenceEngine> mono_engine_;
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+namespace stereo_depth {
+
+/**
+ * @brief 视差转深度选项
+ */
+struct DisparityToDepthOptions {
+    bool handle_missing_values = true; // 等于整幅最小视差的像素视为缺失（同 reprojectImageTo3D）
+    float missing_depth = 10000.0f;    // 缺失像素的深度，即 reprojectImageTo3D 的 bigZ
+    bool zero_invalid = false;         // 非有限或 <= 0 的深度置 0（等价于 patchNaNs + setTo(0, depth <= 0)）
+};
+
+/**
+ * @brief 按 Q 矩阵把视差直接转成深度（Z 通道），可选同时输出 XYZ 点云
+ *
+ * 结果与 cv::reprojectImageTo3D(disparity, xyz, Q, handle_missing_values, CV_32F) 后取 Z 通道一致
+ * （逐像素按 Q 的完整 4x4 形式计算，单精度，与 OpenCV 的双精度结果相差在浮点舍入以内），
+ * 但单遍完成：不分配 CV_32FC3 中间结果、不 split/clone。行间在 OpenCV 线程池上并行，行内用
+ * OpenCV 通用 SIMD（NEON/SSE）向量化。
+ *
+ * @param disparity32F 视差（CV_32F，像素）
+ * @param Q 4x4 重投影矩阵（CV_32F 或 CV_64F）
+ * @param depth 输出深度（CV_32F，单位与 Q 的基线一致，本模块为 mm）
+ * @param options 缺失值与无效值处理
+ * @param points3D 可选，非空时同一遍输出 XYZ（CV_32FC3），仅点云需要时传入
+ */
+void disparityToDepth(const cv::Mat& disparity32F,
+                      const cv::Mat& Q,
+                      cv::Mat& depth,
+                      const DisparityToDepthOptions& options = DisparityToDepthOptions{},
+                      cv::Mat* points3D = nullptr);
+
+} // namespace stereo_depth
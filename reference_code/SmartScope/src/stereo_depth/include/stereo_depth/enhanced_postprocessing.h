@@ -1,6 +1,8 @@
 #pragma once
 
 #include <opencv2/opencv.hpp>
+#include <memory>
+#include "stereo_depth/sgbm_matcher_cache.hpp"
 
 namespace stereo_depth {
 
@@ -45,6 +47,10 @@ struct EnhancedPostProcessingOptions {
 class EnhancedPostProcessor {
 public:
     EnhancedPostProcessor();
+    /**
+     * @brief 使用共享的匹配器缓存（右视图匹配器跨帧复用）
+     */
+    explicit EnhancedPostProcessor(std::shared_ptr<SgbmMatcherCache> matcher_cache);
     ~EnhancedPostProcessor() = default;
     
     /**
@@ -117,6 +123,7 @@ private:
 
 private:
     EnhancedPostProcessingOptions options_;
+    std::shared_ptr<SgbmMatcherCache> matcher_cache_;
 };
 
 } // namespace stereo_depth
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace stereo_depth {
+
+/**
+ * @brief 保边平滑滤波器类型
+ */
+enum class EdgeAwareFilterType {
+    Bilateral = 0,       // cv::bilateralFilter，代价随核直径平方增长（原实现）
+    Guided = 1,          // 自引导的引导滤波（He et al.），全部由盒式滤波组成，每像素 O(1)
+    DomainTransform = 2  // 域变换递归滤波（Gastal & Oliveira, RF），每像素 O(iterations)
+};
+
+/**
+ * @brief 保边平滑参数（三种滤波器共用一组参数，便于直接切换）
+ */
+struct EdgeAwareFilterParams {
+    EdgeAwareFilterType type = EdgeAwareFilterType::Bilateral;
+    int diameter = 5;           // 双边核直径；引导滤波半径取 diameter/2（<= 0 时按 sigma_space 推算）
+    double sigma_space = 7.0;   // 空间 sigma（像素），域变换的平滑尺度
+    double sigma_range = 50.0;  // 值域 sigma（mm），引导滤波的 eps = sigma_range^2
+    int iterations = 3;         // 域变换的迭代次数
+};
+
+const char* edgeAwareFilterName(EdgeAwareFilterType type);
+
+/**
+ * @brief 单通道 CV_32F 保边平滑（以自身为引导）
+ */
+void applyEdgeAwareFilter(const cv::Mat& src, cv::Mat& dst, const EdgeAwareFilterParams& params);
+
+/**
+ * @brief MonoSmoothStereo 融合参数
+ */
+struct FusionGraphOptions {
+    EdgeAwareFilterParams filter;
+    float confidence_gamma = 1.0f; // α = conf^gamma
+};
+
+/**
+ * @brief MonoSmoothStereo 融合的小型滤波图，中间结果按帧缓存
+ *
+ * 节点：Alpha（双目置信度 α）、MonoLow（单目低频）、StereoLow（双目低频 Zbase）、Fused。
+ * 每个节点一帧内只计算一次：Fused = α·Zbase + (1−α)·Lmono + (Zstereo − Zbase)，
+ * 其中 Zbase 同时用于低频融合和高频 Hstereo，不再对同一输入重复滤波。
+ * setInputs / setOptions 使缓存失效；节点缓冲跨帧复用，尺寸不变时不重新分配。
+ *
+ * 非线程安全，每个处理器持有一个实例。
+ */
+class FusionFilterGraph {
+public:
+    enum Node {
+        Alpha = 0,
+        MonoLow,
+        StereoLow,
+        Fused,
+        NodeCount
+    };
+
+    explicit FusionFilterGraph(const FusionGraphOptions& options = FusionGraphOptions{});
+
+    void setOptions(const FusionGraphOptions& options);
+    const FusionGraphOptions& getOptions() const { return options_; }
+
+    /**
+     * @brief 设置本帧输入（浅引用，计算期间调用方需保持输入不变）
+     *
+     * 含非有限值（inf/NaN）的输入先拷贝一份并把这些像素置 0，即按无效深度处理，
+     * 避免它们经滤波扩散到邻域（引导滤波的整幅偏移会使整帧变成 NaN）。
+     * @param stereo_depth_mm 双目深度（CV_32F，mm）
+     * @param mono_depth 单目深度（CV_32F，与双目同尺寸）
+     */
+    void setInputs(const cv::Mat& stereo_depth_mm, const cv::Mat& mono_depth);
+
+    /**
+     * @brief 取节点结果，未计算时按依赖计算并缓存；返回的引用在下一次 setInputs 前有效
+     */
+    const cv::Mat& get(Node node);
+
+    /**
+     * @brief 最近一帧各节点的计算耗时（毫秒，未计算为 0）
+     */
+    double nodeMs(Node node) const { return node_ms_[node]; }
+
+private:
+    void compute(Node node);
+
+    FusionGraphOptions options_;
+    cv::Mat stereo_, mono_;
+    cv::Mat stereo_finite_, mono_finite_; // 输入含非有限值时的置 0 副本
+    cv::Mat conf_mask_, conf_;
+    std::array<cv::Mat, NodeCount> values_;
+    std::array<bool, NodeCount> valid_{};
+    std::array<double, NodeCount> node_ms_{};
+};
+
+/**
+ * @brief 一种滤波器的质量/耗时评估结果
+ */
+struct FusionFilterReport {
+    EdgeAwareFilterParams filter;
+    double fuse_ms = 0.0;      // 整个融合的平均耗时
+    double filter_ms = 0.0;    // 其中两次保边平滑（MonoLow + StereoLow）的平均耗时
+    double rmse_mm = 0.0;      // 与参考结果的均方根误差（两边都有限的像素）
+    double mean_abs_mm = 0.0;  // 与参考结果的平均绝对误差
+    double max_abs_mm = 0.0;   // 与参考结果的最大绝对误差
+};
+
+/**
+ * @brief 质量/耗时对比：对同一帧输入依次用各候选滤波器跑完整融合
+ *
+ * 第一个候选作为质量参考（通常为 Bilateral，即原实现），其误差为 0。
+ * 用于为不同性能模式挑选滤波器。
+ */
+std::vector<FusionFilterReport> compareFusionFilters(const cv::Mat& stereo_depth_mm,
+                                                     const cv::Mat& mono_depth,
+                                                     const FusionGraphOptions& options,
+                                                     const std::vector<EdgeAwareFilterParams>& candidates,
+                                                     int iterations = 5);
+
+} // namespace stereo_depth
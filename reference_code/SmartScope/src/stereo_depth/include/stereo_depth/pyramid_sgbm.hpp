@@ -0,0 +1,93 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <mutex>
+#include <vector>
+#include "stereo_depth/sgbm_matcher_cache.hpp"
+
+namespace stereo_depth {
+
+/**
+ * @brief 由粗到细视差搜索选项
+ */
+struct PyramidSgbmOptions {
+    int levels = 1;                   // 粗层缩小 2^levels 倍（1 为 1/2，2 为 1/4）
+    int tile_width = 256;             // 全分辨率下每块的宽高
+    int tile_height = 128;
+    int disparity_margin = 8;         // 粗层范围换算到全分辨率后两侧再放宽的视差（像素）
+    int path_margin = 16;             // 每块四周额外计算的像素（另加 block_size/2）
+    float min_valid_fraction = 0.05f; // 粗层有效视差占比低于该值的块退回完整搜索范围
+};
+
+/**
+ * @brief 由粗到细的 SGBM 视差计算
+ *
+ * 先在 1/2^levels 尺度上用同样参数（视差范围按比例缩小）做一次完整搜索，
+ * 再把图像分块：每块取粗层视差的最小/最大值换算回全分辨率并放宽 disparity_margin，
+ * 只在这个范围内做全分辨率匹配（范围对齐到 16 的倍数，不超出原 min/num 范围）。
+ * 各块在 OpenCV 线程池上并行，每块的匹配器和缓冲跨帧复用；
+ * 斑点滤除在拼接后对整幅统一做一次。输出与整帧搜索同尺寸、同无效值（min_disparity - 1）。
+ *
+ * 粗层没有可靠视差的块（弱纹理、遮挡）退回完整范围，结果与整帧搜索在这些块上接近一致。
+ */
+class PyramidSgbm {
+public:
+    /**
+     * @brief 一块的全分辨率搜索范围（供评估统计）
+     */
+    struct TileRange {
+        cv::Rect tile;
+        int min_disparity = 0;
+        int num_disparities = 0;
+        bool full_range = false;
+    };
+
+    explicit PyramidSgbm(const PyramidSgbmOptions& options = PyramidSgbmOptions{});
+
+    void setOptions(const PyramidSgbmOptions& options);
+    PyramidSgbmOptions getOptions() const;
+
+    /**
+     * @brief 计算视差
+     * @param key 全分辨率完整搜索的参数
+     * @param left 左图（灰度）
+     * @param right 右图（灰度）
+     * @param disparity32F 输出视差（CV_32F，像素）
+     * @param disparity16S 可选，输出原始 16 位定点视差
+     */
+    void compute(const SgbmMatcherKey& key,
+                 const cv::Mat& left,
+                 const cv::Mat& right,
+                 cv::Mat& disparity32F,
+                 cv::Mat* disparity16S = nullptr);
+
+    /**
+     * @brief 最近一次计算各块的搜索范围
+     */
+    std::vector<TileRange> lastTiles() const;
+
+    /**
+     * @brief 粗层匹配参数：视差范围、斑点窗口与范围按缩放比例缩小
+     */
+    static SgbmMatcherKey coarseKey(const SgbmMatcherKey& key, int levels);
+
+private:
+    struct Slot {
+        SgbmMatcherKey key;
+        cv::Ptr<cv::StereoSGBM> matcher;
+        cv::Mat disparity16S;
+    };
+
+    void planTiles(const SgbmMatcherKey& key, const cv::Size& size, float coarse_invalid);
+
+    PyramidSgbmOptions options_;
+    SgbmMatcherCache coarse_cache_{1};
+    std::vector<Slot> slots_;
+    std::vector<TileRange> tiles_;
+    cv::Mat coarse_left_, coarse_right_, coarse_disparity_;
+    cv::Mat disparity16S_;
+    cv::Mat speckle_buffer_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace stereo_depth
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace stereo_depth {
+
+struct ComprehensiveDepthOptions;
+
+/**
+ * @brief SGBM 匹配器的全部参数（缓存键）
+ *
+ * 默认值与 cv::StereoSGBM::create 的默认参数一致。
+ */
+struct SgbmMatcherKey {
+    int min_disparity = 0;
+    int num_disparities = 16;
+    int block_size = 3;
+    int p1 = 0;
+    int p2 = 0;
+    int disp12_max_diff = 0;
+    int prefilter_cap = 0;
+    int uniqueness_ratio = 0;
+    int speckle_window = 0;
+    int speckle_range = 0;
+    int mode = cv::StereoSGBM::MODE_SGBM;
+
+    /**
+     * @brief 取 ComprehensiveDepthOptions 中与 SGBM 相关的字段（灰度输入，P1/P2 按 8/32*block^2，3WAY 模式）
+     */
+    static SgbmMatcherKey fromOptions(const ComprehensiveDepthOptions& options);
+
+    /**
+     * @brief 按本组参数新建匹配器
+     */
+    cv::Ptr<cv::StereoSGBM> createMatcher() const;
+
+    bool operator==(const SgbmMatcherKey& other) const;
+    bool operator!=(const SgbmMatcherKey& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief 按参数复用的 SGBM 匹配器注册表
+ *
+ * 每组参数只创建一次匹配器，连同它的 16 位视差输出缓冲一起跨帧复用，
+ * 参数变化时才新建；超出容量时淘汰最久未用的一组。
+ * 计算在内部锁下进行，同一实例可以被多个处理器共享。
+ */
+class SgbmMatcherCache {
+public:
+    explicit SgbmMatcherCache(size_t capacity = 4);
+
+    /**
+     * @brief 确保 key 对应的匹配器已创建（可在参数更新时提前构建，避免下一帧承担创建开销）
+     */
+    void prepare(const SgbmMatcherKey& key);
+
+    /**
+     * @brief 用 key 对应的匹配器计算视差
+     * @param left 左图（灰度）
+     * @param right 右图（灰度）
+     * @param disparity32F 输出视差（CV_32F，像素）
+     * @param disparity16S 可选，输出原始 16 位定点视差的拷贝
+     */
+    void computeDisparity(const SgbmMatcherKey& key,
+                          const cv::Mat& left,
+                          const cv::Mat& right,
+                          cv::Mat& disparity32F,
+                          cv::Mat* disparity16S = nullptr);
+
+    void clear();
+    size_t size() const;
+
+    /**
+     * @brief 累计创建的匹配器个数（用于确认没有逐帧重建）
+     */
+    uint64_t createdCount() const;
+
+private:
+    struct Entry {
+        SgbmMatcherKey key;
+        cv::Ptr<cv::StereoSGBM> matcher;
+        cv::Mat disparity16S;
+        uint64_t last_used = 0;
+    };
+
+    Entry& entryFor(const SgbmMatcherKey& key);
+
+    size_t capacity_;
+    std::vector<Entry> entries_;
+    uint64_t tick_ = 0;
+    uint64_t created_ = 0;
+    mutable std::mutex mutex_;
+};
+
+} // namespace stereo_depth
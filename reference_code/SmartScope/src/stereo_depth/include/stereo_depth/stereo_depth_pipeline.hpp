@@ -2,6 +2,7 @@
 
 #include <opencv2/opencv.hpp>
 #include <string>
+#include "stereo_depth/pyramid_sgbm.hpp"
 
 namespace stereo_depth {
 
@@ -19,6 +20,11 @@ public:
         int speckle_range = 32;
         int prefilter_cap = 63;
         int disp12_max_diff = 1;
+        // 由粗到细视差搜索（见 PyramidSgbm），关闭时为整帧完整搜索
+        bool hierarchical = false;
+        int pyramid_levels = 1;          // 粗层缩小 2^levels 倍
+        int pyramid_tile_size = 128;     // 全分辨率分块边长
+        int pyramid_disparity_margin = 8;
     };
 
     explicit StereoDepthPipeline(const std::string &camera_param_dir);
@@ -54,6 +60,8 @@ private:
     cv::Rect roi1_, roi2_;
     cv::Mat map1x_, map1y_, map2x_, map2y_;
     cv::Ptr<cv::StereoSGBM> sgbm_;
+    SgbmMatcherKey sgbm_key_;
+    PyramidSgbm pyramid_;
 
     bool initialized_ = false;
     cv::Size image_size_;
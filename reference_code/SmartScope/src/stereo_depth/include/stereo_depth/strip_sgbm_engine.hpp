@@ -0,0 +1,102 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <mutex>
+#include <vector>
+#include "stereo_depth/sgbm_matcher_cache.hpp"
+
+namespace stereo_depth {
+
+/**
+ * @brief 条带并行 SGBM 选项
+ */
+struct StripSgbmOptions {
+    int strips = 0;          // 条带数：0 按 cv::getNumThreads()，1 不切分
+    int path_margin = 32;    // 条带上下（以及 ROI 左右）额外计算的像素，覆盖代价聚合路径的影响范围
+    int min_strip_rows = 32; // 每条带至少的输出行数，避免小图切得过碎
+};
+
+/**
+ * @brief 条带并行、可限定 ROI 的 SGBM 视差计算
+ *
+ * 把输出区域按行切成若干条带，每条带上下各多算 block_size/2 + path_margin 行，
+ * 在 OpenCV 线程池（cv::parallel_for_）上并行匹配，只拷回条带本身的行。
+ * 每个条带有自己的匹配器和输出缓冲，跨帧复用，参数变化时才重建。
+ * 斑点滤除（speckle）在条带拼接后对整个输出区域统一做一次，与整帧计算的处理顺序一致。
+ *
+ * ROI 模式只匹配请求的矩形：左侧额外带上 min_disparity + num_disparities 的搜索跨度，
+ * 四周再加 block_size/2 + path_margin。输出与输入同尺寸，ROI 之外为无效视差（min_disparity - 1）。
+ *
+ * 条带/ROI 边界附近的结果与整帧计算不保证逐像素一致（聚合路径被截断），
+ * 差异随 path_margin 增大而减小；strips = 1 且不限 ROI 时与整帧计算完全一致。
+ *
+ * 注意：MODE_SGBM_3WAY 自身已在 cv::parallel_for_ 上按 cv::getNumThreads() 分条计算，
+ * 条带在外层 parallel_for_ 中运行时 OpenCV 会把内层并行退化为串行，
+ * 所以多条带只是把并行从内层移到外层，并不一定更快，需以 strip_sgbm_bench 实测为准。
+ */
+class StripSgbmEngine {
+public:
+    explicit StripSgbmEngine(const StripSgbmOptions& options = StripSgbmOptions{});
+
+    void setOptions(const StripSgbmOptions& options);
+    StripSgbmOptions getOptions() const;
+
+    /**
+     * @brief 整帧视差
+     * @param left 左图（灰度）
+     * @param right 右图（灰度）
+     * @param disparity32F 输出视差（CV_32F，像素）
+     * @param disparity16S 可选，输出原始 16 位定点视差
+     */
+    void compute(const SgbmMatcherKey& key,
+                 const cv::Mat& left,
+                 const cv::Mat& right,
+                 cv::Mat& disparity32F,
+                 cv::Mat* disparity16S = nullptr);
+
+    /**
+     * @brief 只计算 roi 内的视差（roi 会被裁剪到图像范围内；为空时等同整帧）
+     */
+    void computeRoi(const SgbmMatcherKey& key,
+                    const cv::Mat& left,
+                    const cv::Mat& right,
+                    const cv::Rect& roi,
+                    cv::Mat& disparity32F,
+                    cv::Mat* disparity16S = nullptr);
+
+    /**
+     * @brief 计算 region 这块输出时需要参与匹配的输入窗口
+     */
+    static cv::Rect matchingWindow(const SgbmMatcherKey& key,
+                                   const cv::Rect& region,
+                                   const cv::Size& image_size,
+                                   int path_margin);
+
+    /**
+     * @brief 本次计算实际使用的条带数
+     */
+    int stripCount(int rows) const;
+
+private:
+    struct Slot {
+        SgbmMatcherKey key;
+        cv::Ptr<cv::StereoSGBM> matcher;
+        cv::Mat disparity16S;
+    };
+
+    void computeRegion(const SgbmMatcherKey& key,
+                       const cv::Mat& left,
+                       const cv::Mat& right,
+                       const cv::Rect& region,
+                       cv::Mat& disparity32F,
+                       cv::Mat* disparity16S);
+    Slot& slotFor(int index, const SgbmMatcherKey& key);
+
+    StripSgbmOptions options_;
+    std::vector<Slot> slots_;
+    cv::Mat disparity16S_;
+    cv::Mat speckle_buffer_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace stereo_depth
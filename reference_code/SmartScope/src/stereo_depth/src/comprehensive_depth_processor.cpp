@@ -1,4 +1,5 @@
 #include "stereo_depth/comprehensive_depth_processor.hpp"
+#include "stereo_depth/disparity_to_depth.hpp"
 #include "stereo_depth/improved_depth_calibration.h"
 #include <glog/logging.h>
 #include "depth_anything_inference.hpp"
@@ -7,6 +8,7 @@
 #include <sstream>
 #include <random>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace stereo_depth {
@@ -28,9 +30,15 @@ static bool readMatrix3x3(std::istream& in, Mat& M) {
 ComprehensiveDepthProcessor::ComprehensiveDepthProcessor(const std::string& camera_param_dir,
                                                        const std::string& mono_model_path,
                                                        const ComprehensiveDepthOptions& options)
-    : camera_param_dir_(camera_param_dir), mono_model_path_(mono_model_path), options_(options) {
-    // 初始化增强后处理器
-    enhanced_postprocessor_ = std::make_unique<EnhancedPostProcessor>();
+    : camera_param_dir_(camera_param_dir), mono_model_path_(mono_model_path), options_(options),
+      matcher_cache_(std::make_shared<SgbmMatcherCache>()),
+      sgbm_key_(SgbmMatcherKey::fromOptions(options)) {
+    matcher_cache_->prepare(sgbm_key_);
+    strip_engine_ = std::make_unique<StripSgbmEngine>(stripOptions());
+    pyramid_ = std::make_unique<PyramidSgbm>(pyramidOptions());
+    fusion_graph_.setOptions(fusionGraphOptions());
+    // 初始化增强后处理器（与本处理器共用匹配器缓存）
+    enhanced_postprocessor_ = std::make_unique<EnhancedPostProcessor>(matcher_cache_);
     initialize();
 }
 
@@ -153,6 +161,44 @@ void ComprehensiveDepthProcessor::initialize() {
     initialized_ = true;
 }
 
+StripSgbmOptions ComprehensiveDepthProcessor::stripOptions() const {
+    StripSgbmOptions opts;
+    opts.strips = options_.sgbm_strips;
+    opts.path_margin = options_.sgbm_path_margin;
+    return opts;
+}
+
+PyramidSgbmOptions ComprehensiveDepthProcessor::pyramidOptions() const {
+    PyramidSgbmOptions opts;
+    opts.levels = std::max(1, options_.pyramid_levels);
+    opts.tile_width = options_.pyramid_tile_size;
+    opts.tile_height = options_.pyramid_tile_size;
+    opts.disparity_margin = options_.pyramid_disparity_margin;
+    return opts;
+}
+
+FusionGraphOptions ComprehensiveDepthProcessor::fusionGraphOptions() const {
+    FusionGraphOptions opts;
+    opts.filter.type = options_.fusion_filter;
+    opts.filter.diameter = options_.fusion_bilateral_d;
+    opts.filter.sigma_space = options_.fusion_bilateral_sigma_s;
+    opts.filter.sigma_range = options_.fusion_bilateral_sigma_r;
+    opts.filter.iterations = options_.fusion_filter_iterations;
+    opts.confidence_gamma = options_.fusion_confidence_gamma;
+    return opts;
+}
+
+void ComprehensiveDepthProcessor::computeDisparity(const cv::Mat& grayL, const cv::Mat& grayR,
+                                                   cv::Mat& disp32F, cv::Mat* disp16S) {
+    if (options_.enable_pyramid_disparity) {
+        pyramid_->compute(sgbm_key_, grayL, grayR, disp32F, disp16S);
+    } else if (options_.sgbm_strips == 1) {
+        matcher_cache_->computeDisparity(sgbm_key_, grayL, grayR, disp32F, disp16S);
+    } else {
+        strip_engine_->compute(sgbm_key_, grayL, grayR, disp32F, disp16S);
+    }
+}
+
 void ComprehensiveDepthProcessor::preprocessImage(const cv::Mat& src, cv::Mat& dst) {
     if (src.empty()) {
         dst.release();
@@ -856,17 +902,6 @@ ComprehensiveDepthResult ComprehensiveDepthProcessor::processRectifiedImages(con
         // 立体校正
         cv::stereoRectify(K0_, D0_, K1_, D1_, image_size_, R_, T_, R1_, R2_, P1_, P2_, Q_,
                          cv::CALIB_ZERO_DISPARITY, -1.0, image_size_, &roi1_, &roi2_);
-        
-        // 初始化SGBM
-        sgbm_ = cv::StereoSGBM::create(options_.min_disparity, options_.num_disparities, options_.block_size);
-        sgbm_->setP1(8 * options_.block_size * options_.block_size);
-        sgbm_->setP2(32 * options_.block_size * options_.block_size);
-        sgbm_->setDisp12MaxDiff(options_.disp12_max_diff);
-        sgbm_->setUniquenessRatio(options_.uniqueness_ratio);
-        sgbm_->setSpeckleWindowSize(options_.speckle_window);
-        sgbm_->setSpeckleRange(options_.speckle_range);
-        sgbm_->setPreFilterCap(options_.prefilter_cap);
-        sgbm_->setMode(cv::StereoSGBM::MODE_SGBM_3WAY);
     }
     
     // 预处理
@@ -879,21 +914,12 @@ ComprehensiveDepthResult ComprehensiveDepthProcessor::processRectifiedImages(con
     cv::cvtColor(procL, grayL, cv::COLOR_BGR2GRAY);
     cv::cvtColor(procR, grayR, cv::COLOR_BGR2GRAY);
     
-    cv::Mat disp16S;
-    sgbm_->compute(grayL, grayR, disp16S);
     cv::Mat disp32F;
-    disp16S.convertTo(disp32F, CV_32F, 1.0 / 16.0);
+    computeDisparity(grayL, grayR, disp32F);
     result.disparity = disp32F.clone();
     
-    // 计算双目深度
-    cv::Mat points3D;
-    cv::reprojectImageTo3D(disp32F, points3D, Q_, true, CV_32F);
-    std::vector<cv::Mat> xyz;
-    cv::split(points3D, xyz);
-    cv::Mat depthZ = xyz[2];
-    
-    // 移除深度后处理，保持原始深度值
-    depthZ.convertTo(result.stereo_depth_mm, CV_32F, 1.0); // 转换为毫米
+    // 计算双目深度（单遍只算 Z，保持原始深度值，单位毫米）
+    disparityToDepth(disp32F, Q_, result.stereo_depth_mm);
     
     // 单目深度推理
     if (mono_model_) {
@@ -902,43 +928,10 @@ ComprehensiveDepthResult ComprehensiveDepthProcessor::processRectifiedImages(con
 
     // 新融合策略：MonoSmoothStereo（以双目为基准、单目补洞+低频）
     if (options_.fusion_mode == FusionMode::MonoSmoothStereo && !result.mono_depth_raw.empty()) {
-        // 1) 置信度/掩码（使用简单启发式：有效即 conf=1，否则0；可替换为代价/一致性映射）
-        cv::Mat stereo_conf = (result.stereo_depth_mm > 0);
-        stereo_conf.convertTo(stereo_conf, CV_32F, 1.0/255.0);
-
-        // 2) 单目低频 Lmono
-        cv::Mat Lmono;
-        cv::bilateralFilter(result.mono_depth_raw, Lmono,
-                            options_.fusion_bilateral_d,
-                            options_.fusion_bilateral_sigma_r,
-                            options_.fusion_bilateral_sigma_s);
-
-        // 3) 双目低频 Zbase 与高频 Hstereo
-        cv::Mat Zbase;
-        cv::bilateralFilter(result.stereo_depth_mm, Zbase,
-                            options_.fusion_bilateral_d,
-                            options_.fusion_bilateral_sigma_r,
-                            options_.fusion_bilateral_sigma_s);
-        cv::Mat Zbase2;
-        cv::bilateralFilter(result.stereo_depth_mm, Zbase2,
-                            options_.fusion_bilateral_d,
-                            options_.fusion_bilateral_sigma_r,
-                            options_.fusion_bilateral_sigma_s);
-        cv::Mat Hstereo = result.stereo_depth_mm - Zbase2;
-
-        // 4) 置信度映射 α=conf^gamma
-        cv::Mat alpha;
-        cv::pow(stereo_conf, options_.fusion_confidence_gamma, alpha);
-        // 高频仅在 conf>阈值 时注入
-        cv::Mat highMask = stereo_conf > options_.fusion_confidence_thresh;
-
-        // 5) 融合 Z = α·Zbase + (1−α)·Lmono + Hstereo·mask
-        cv::Mat oneMinusAlpha = 1.0 - alpha;
-        cv::Mat fused = alpha.mul(Zbase) + oneMinusAlpha.mul(Lmono);
-        Hstereo.copyTo(Hstereo, highMask);
-        fused = fused + Hstereo;
-
-        result.final_fused_depth = fused;
+        // 置信度 α、单目低频 Lmono、双目低频 Zbase 各算一次，Zbase 同时用于高频 Hstereo = Z − Zbase
+        // Z = α·Zbase + (1−α)·Lmono + Hstereo
+        fusion_graph_.setInputs(result.stereo_depth_mm, result.mono_depth_raw);
+        result.final_fused_depth = fusion_graph_.get(FusionFilterGraph::Fused).clone();
         last_final_fused_depth_ = result.final_fused_depth.clone();
     }
     
@@ -988,17 +981,6 @@ ComprehensiveDepthResult ComprehensiveDepthProcessor::processAlreadyRectifiedIma
         // 设置ROI为整个图像
         roi1_ = cv::Rect(0, 0, image_size_.width, image_size_.height);
         roi2_ = cv::Rect(0, 0, image_size_.width, image_size_.height);
-        
-        // 初始化SGBM
-        sgbm_ = cv::StereoSGBM::create(options_.min_disparity, options_.num_disparities, options_.block_size);
-        sgbm_->setP1(8 * options_.block_size * options_.block_size);
-        sgbm_->setP2(32 * options_.block_size * options_.block_size);
-        sgbm_->setDisp12MaxDiff(options_.disp12_max_diff);
-        sgbm_->setUniquenessRatio(options_.uniqueness_ratio);
-        sgbm_->setSpeckleWindowSize(options_.speckle_window);
-        sgbm_->setSpeckleRange(options_.speckle_range);
-        sgbm_->setPreFilterCap(options_.prefilter_cap);
-        sgbm_->setMode(cv::StereoSGBM::MODE_SGBM_3WAY);
     }
     
     // 预处理
@@ -1011,21 +993,12 @@ ComprehensiveDepthResult ComprehensiveDepthProcessor::processAlreadyRectifiedIma
     cv::cvtColor(procL, grayL, cv::COLOR_BGR2GRAY);
     cv::cvtColor(procR, grayR, cv::COLOR_BGR2GRAY);
     
-    cv::Mat disp16S;
-    sgbm_->compute(grayL, grayR, disp16S);
     cv::Mat disp32F;
-    disp16S.convertTo(disp32F, CV_32F, 1.0 / 16.0);
+    computeDisparity(grayL, grayR, disp32F);
     result.disparity = disp32F.clone();
     
-    // 计算双目深度
-    cv::Mat points3D;
-    cv::reprojectImageTo3D(disp32F, points3D, Q_, true, CV_32F);
-    std::vector<cv::Mat> xyz;
-    cv::split(points3D, xyz);
-    cv::Mat depthZ = xyz[2];
-    
-    // 移除深度后处理，保持原始深度值
-    depthZ.convertTo(result.stereo_depth_mm, CV_32F, 1.0); // 转换为毫米
+    // 计算双目深度（单遍只算 Z，保持原始深度值，单位毫米）
+    disparityToDepth(disp32F, Q_, result.stereo_depth_mm);
     
     // 单目深度推理
     if (mono_model_) {
@@ -1048,6 +1021,15 @@ ComprehensiveDepthResult ComprehensiveDepthProcessor::processAlreadyRectifiedIma
         }
     }
     
+    // MonoSmoothStereo 融合（同 processRectifiedImages）；校准成功时用毫米尺度的单目深度，与双目及滤波参数的量纲一致
+    if (options_.fusion_mode == FusionMode::MonoSmoothStereo && !result.mono_depth_raw.empty()) {
+        const cv::Mat& mono = result.mono_depth_calibrated_mm.empty() ? result.mono_depth_raw
+                                                                      : result.mono_depth_calibrated_mm;
+        fusion_graph_.setInputs(result.stereo_depth_mm, mono);
+        result.final_fused_depth = fusion_graph_.get(FusionFilterGraph::Fused).clone();
+        last_final_fused_depth_ = result.final_fused_depth.clone();
+    }
+    
     // 生成置信度图
     result.confidence_map = cv::Mat::zeros(disp32F.size(), CV_32F);
     for (int y = 0; y < disp32F.rows; ++y) {
@@ -1112,35 +1094,25 @@ ComprehensiveDepthResult ComprehensiveDepthProcessor::processRectifiedImagesFine
     }
     
     // 3. 计算视差
-    cv::Mat disp16S;
-    sgbm_->compute(result.left_gray, result.right_gray, disp16S);
+    cv::Mat disp32F;
+    computeDisparity(result.left_gray, result.right_gray, disp32F,
+                     fine_options.save_raw_disparity ? &result.disparity_raw : nullptr);
     
     if (fine_options.save_raw_disparity) {
-        result.disparity_raw = disp16S.clone();
         last_disparity_raw_ = result.disparity_raw.clone();
     }
     
-    cv::Mat disp32F;
-    disp16S.convertTo(disp32F, CV_32F, 1.0 / 16.0);
     result.disparity = disp32F.clone();
     last_disparity_ = result.disparity.clone();
     
-    // 4. 计算双目深度
-    cv::Mat points3D;
-    cv::reprojectImageTo3D(disp32F, points3D, Q_, true, CV_32F);
+    // 4. 计算双目深度（保持原始深度值，单位毫米；只有需要保存点云时才同一遍输出 XYZ）
+    disparityToDepth(disp32F, Q_, result.stereo_depth_mm, DisparityToDepthOptions{},
+                     fine_options.save_3d_points ? &result.points_3d : nullptr);
     
     if (fine_options.save_3d_points) {
-        result.points_3d = points3D.clone();
         last_points_3d_ = result.points_3d.clone();
     }
     
-    std::vector<cv::Mat> xyz;
-    cv::split(points3D, xyz);
-    cv::Mat depthZ = xyz[2];
-    
-    // 移除深度后处理，保持原始深度值
-    depthZ.convertTo(result.stereo_depth_mm, CV_32F, 1.0); // 转换为毫米
-    
     if (fine_options.save_valid_mask) {
         result.valid_mask = cv::Mat();
         last_valid_mask_ = result.valid_mask.clone();
@@ -1244,19 +1216,6 @@ cv::Mat ComprehensiveDepthProcessor::computeDisparityOnly(const cv::Mat& left_re
         image_size_ = left_rectified.size();
         initialize();
     }
-    // 确保SGBM已创建
-    if (sgbm_.empty()) {
-        sgbm_ = cv::StereoSGBM::create(options_.min_disparity, options_.num_disparities, options_.block_size);
-        sgbm_->setP1(8 * options_.block_size * options_.block_size);
-        sgbm_->setP2(32 * options_.block_size * options_.block_size);
-        sgbm_->setDisp12MaxDiff(options_.disp12_max_diff);
-        sgbm_->setUniquenessRatio(options_.uniqueness_ratio);
-        sgbm_->setSpeckleWindowSize(options_.speckle_window);
-        sgbm_->setSpeckleRange(options_.speckle_range);
-        sgbm_->setPreFilterCap(options_.prefilter_cap);
-        sgbm_->setMode(cv::StereoSGBM::MODE_SGBM_3WAY);
-    }
-    
     // 预处理
     cv::Mat procL, procR;
     preprocessImage(left_rectified, procL);
@@ -1268,10 +1227,8 @@ cv::Mat ComprehensiveDepthProcessor::computeDisparityOnly(const cv::Mat& left_re
     cv::cvtColor(procR, grayR, cv::COLOR_BGR2GRAY);
     
     // 计算视差
-    cv::Mat disp16S;
-    sgbm_->compute(grayL, grayR, disp16S);
     cv::Mat disp32F;
-    disp16S.convertTo(disp32F, CV_32F, 1.0 / 16.0);
+    computeDisparity(grayL, grayR, disp32F);
  
     // 保存中间结果
     last_disparity_ = disp32F.clone();
@@ -1281,20 +1238,43 @@ cv::Mat ComprehensiveDepthProcessor::computeDisparityOnly(const cv::Mat& left_re
     return disp32F;
 }
 
+cv::Mat ComprehensiveDepthProcessor::computeDisparityInRoi(const cv::Mat& left_rectified,
+                                                         const cv::Mat& right_rectified,
+                                                         const cv::Rect& roi) {
+    if (!initialized_) {
+        image_size_ = left_rectified.size();
+        initialize();
+    }
+    
+    cv::Mat procL, procR;
+    preprocessImage(left_rectified, procL);
+    preprocessImage(right_rectified, procR);
+    
+    cv::Mat grayL, grayR;
+    cv::cvtColor(procL, grayL, cv::COLOR_BGR2GRAY);
+    cv::cvtColor(procR, grayR, cv::COLOR_BGR2GRAY);
+    
+    // ROI 换算到预处理后的尺寸，向外取整保证覆盖
+    const double sx = static_cast<double>(grayL.cols) / std::max(1, left_rectified.cols);
+    const double sy = static_cast<double>(grayL.rows) / std::max(1, left_rectified.rows);
+    const int x0 = static_cast<int>(std::floor(roi.x * sx));
+    const int y0 = static_cast<int>(std::floor(roi.y * sy));
+    const int x1 = static_cast<int>(std::ceil((roi.x + roi.width) * sx));
+    const int y1 = static_cast<int>(std::ceil((roi.y + roi.height) * sy));
+    
+    cv::Mat disp32F;
+    strip_engine_->computeRoi(sgbm_key_, grayL, grayR, cv::Rect(x0, y0, x1 - x0, y1 - y0), disp32F);
+    last_disparity_ = disp32F.clone();
+    return disp32F;
+}
+
 cv::Mat ComprehensiveDepthProcessor::computeStereoDepthOnly(const cv::Mat& left_rectified,
                                                           const cv::Mat& right_rectified) {
     cv::Mat disparity = computeDisparityOnly(left_rectified, right_rectified);
     
-    // 计算深度
-    cv::Mat points3D;
-    cv::reprojectImageTo3D(disparity, points3D, Q_, true, CV_32F);
-    std::vector<cv::Mat> xyz;
-    cv::split(points3D, xyz);
-    cv::Mat depthZ = xyz[2];
-    
-    // 移除深度后处理，保持原始深度值
-    depthZ.convertTo(depthZ, CV_32F, 1.0); // 转换为毫米
-    
+    // 计算深度（保持原始深度值，单位毫米）
+    cv::Mat depthZ;
+    disparityToDepth(disparity, Q_, depthZ);
     return depthZ;
 }
 
@@ -1326,11 +1306,9 @@ cv::Mat ComprehensiveDepthProcessor::depthFromDisparity(const cv::Mat& disparity
     if (disparity32F.empty()) return cv::Mat();
     cv::Mat Quse = !Q_matrix.empty() ? Q_matrix : Q_;
     if (Quse.empty()) return cv::Mat();
-    cv::Mat points3D;
-    cv::reprojectImageTo3D(disparity32F, points3D, Quse, true, CV_32F);
-    std::vector<cv::Mat> xyz;
-    cv::split(points3D, xyz);
-    return xyz[2];
+    cv::Mat depthZ;
+    disparityToDepth(disparity32F, Quse, depthZ);
+    return depthZ;
 }
 
 cv::Mat ComprehensiveDepthProcessor::filterDepth(const cv::Mat& depth_mm, const cv::Mat& valid_mask) {
@@ -1715,18 +1693,15 @@ std::pair<cv::Rect, cv::Rect> ComprehensiveDepthProcessor::getROI() const {
 void ComprehensiveDepthProcessor::updateOptions(const ComprehensiveDepthOptions& options) {
     options_ = options;
     
-    // 重新初始化SGBM
-    if (initialized_) {
-        sgbm_ = cv::StereoSGBM::create(options_.min_disparity, options_.num_disparities, options_.block_size);
-        sgbm_->setP1(8 * options_.block_size * options_.block_size);
-        sgbm_->setP2(32 * options_.block_size * options_.block_size);
-        sgbm_->setDisp12MaxDiff(options_.disp12_max_diff);
-        sgbm_->setUniquenessRatio(options_.uniqueness_ratio);
-        sgbm_->setSpeckleWindowSize(options_.speckle_window);
-        sgbm_->setSpeckleRange(options_.speckle_range);
-        sgbm_->setPreFilterCap(options_.prefilter_cap);
-        sgbm_->setMode(cv::StereoSGBM::MODE_SGBM_3WAY);
+    // 只有SGBM相关参数变化时才切换匹配器，并提前构建，避免下一帧承担创建开销
+    const SgbmMatcherKey key = SgbmMatcherKey::fromOptions(options_);
+    if (key != sgbm_key_) {
+        sgbm_key_ = key;
+        matcher_cache_->prepare(sgbm_key_);
     }
+    strip_engine_->setOptions(stripOptions());
+    pyramid_->setOptions(pyramidOptions());
+    fusion_graph_.setOptions(fusionGraphOptions());
 }
 
 cv::Mat ComprehensiveDepthProcessor::refineStereoWithMonoLocalFit(const cv::Mat& stereo_depth_mm,
@@ -0,0 +1,132 @@
+#include "stereo_depth/disparity_to_depth.hpp"
+#include <opencv2/core/hal/intrin.hpp>
+#include <cfloat>
+#include <cmath>
+
+namespace stereo_depth {
+
+namespace {
+
+// Q 的行：X = q[0]·(x, y, d, 1)，Y = q[1]·…，Z = q[2]·…，W = q[3]·…
+struct RowKernel {
+    float q[4][4];
+    float min_disparity;
+    bool handle_missing;
+    float missing_depth;
+    bool zero_invalid;
+
+    // 计算一行；points 为空时只写深度
+    void run(int y, const float* disp, float* depth, float* points, int cols) const {
+        // 与行号相关的常数项
+        const float cx = q[0][1] * y + q[0][3];
+        const float cy = q[1][1] * y + q[1][3];
+        const float cz = q[2][1] * y + q[2][3];
+        const float cw = q[3][1] * y + q[3][3];
+        int x = 0;
+#if CV_SIMD128
+        const cv::v_float32x4 vstep = cv::v_setall_f32(4.0f);
+        const cv::v_float32x4 vmin = cv::v_setall_f32(min_disparity);
+        const cv::v_float32x4 veps = cv::v_setall_f32(FLT_EPSILON);
+        const cv::v_float32x4 vmissing = cv::v_setall_f32(missing_depth);
+        const cv::v_float32x4 vzero = cv::v_setzero_f32();
+        const cv::v_float32x4 vone = cv::v_setall_f32(1.0f);
+        const cv::v_float32x4 vcz = cv::v_setall_f32(cz), vcw = cv::v_setall_f32(cw);
+        const cv::v_float32x4 vq20 = cv::v_setall_f32(q[2][0]), vq22 = cv::v_setall_f32(q[2][2]);
+        const cv::v_float32x4 vq30 = cv::v_setall_f32(q[3][0]), vq32 = cv::v_setall_f32(q[3][2]);
+        cv::v_float32x4 vx(0.0f, 1.0f, 2.0f, 3.0f);
+        for (; x <= cols - 4; x += 4, vx = vx + vstep) {
+            const cv::v_float32x4 d = cv::v_load(disp + x);
+            const cv::v_float32x4 iw = vone / cv::v_muladd(vq32, d, cv::v_muladd(vq30, vx, vcw));
+            cv::v_float32x4 z = cv::v_muladd(vq22, d, cv::v_muladd(vq20, vx, vcz)) * iw;
+            if (handle_missing) {
+                z = cv::v_select(cv::v_abs(d - vmin) <= veps, vmissing, z);
+            }
+            if (points) {
+                const cv::v_float32x4 px = cv::v_muladd(cv::v_setall_f32(q[0][2]), d,
+                                                        cv::v_muladd(cv::v_setall_f32(q[0][0]), vx,
+                                                                     cv::v_setall_f32(cx))) * iw;
+                const cv::v_float32x4 py = cv::v_muladd(cv::v_setall_f32(q[1][2]), d,
+                                                        cv::v_muladd(cv::v_setall_f32(q[1][0]), vx,
+                                                                     cv::v_setall_f32(cy))) * iw;
+                cv::v_store_interleave(points + x * 3, px, py, z);
+            }
+            if (zero_invalid) {
+                // NaN 与任何数比较都为假，一并置 0
+                z = cv::v_select(z > vzero, z, vzero);
+            }
+            cv::v_store(depth + x, z);
+        }
+#endif
+        for (; x < cols; ++x) {
+            const float d = disp[x];
+            const float iw = 1.0f / (q[3][0] * x + q[3][2] * d + cw);
+            float z = (q[2][0] * x + q[2][2] * d + cz) * iw;
+            if (handle_missing && std::fabs(d - min_disparity) <= FLT_EPSILON) {
+                z = missing_depth;
+            }
+            if (points) {
+                float* p = points + x * 3;
+                p[0] = (q[0][0] * x + q[0][2] * d + cx) * iw;
+                p[1] = (q[1][0] * x + q[1][2] * d + cy) * iw;
+                p[2] = z;
+            }
+            if (zero_invalid && !(z > 0.0f)) {
+                z = 0.0f;
+            }
+            depth[x] = z;
+        }
+    }
+};
+
+} // namespace
+
+void disparityToDepth(const cv::Mat& disparity32F,
+                      const cv::Mat& Q,
+                      cv::Mat& depth,
+                      const DisparityToDepthOptions& options,
+                      cv::Mat* points3D) {
+    if (disparity32F.empty()) {
+        depth.release();
+        if (points3D) {
+            points3D->release();
+        }
+        return;
+    }
+    CV_Assert(disparity32F.type() == CV_32F);
+    CV_Assert(Q.rows == 4 && Q.cols == 4);
+
+    cv::Mat Q64;
+    Q.convertTo(Q64, CV_64F);
+    RowKernel kernel;
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            kernel.q[r][c] = static_cast<float>(Q64.at<double>(r, c));
+        }
+    }
+    kernel.handle_missing = options.handle_missing_values;
+    kernel.missing_depth = options.missing_depth;
+    kernel.zero_invalid = options.zero_invalid;
+    kernel.min_disparity = FLT_MAX;
+    if (options.handle_missing_values) {
+        double min_value = 0.0;
+        cv::minMaxIdx(disparity32F, &min_value, nullptr);
+        kernel.min_disparity = static_cast<float>(min_value);
+    }
+
+    // 输出可能与输入共用内存（原地调用），先把输入保存下来
+    const cv::Mat disparity = disparity32F.data == depth.data ? disparity32F.clone() : disparity32F;
+    depth.create(disparity.size(), CV_32F);
+    if (points3D) {
+        points3D->create(disparity.size(), CV_32FC3);
+    }
+
+    const int cols = disparity.cols;
+    cv::parallel_for_(cv::Range(0, disparity.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; ++y) {
+            kernel.run(y, disparity.ptr<float>(y), depth.ptr<float>(y),
+                       points3D ? points3D->ptr<float>(y) : nullptr, cols);
+        }
+    });
+}
+
+} // namespace stereo_depth
@@ -5,7 +5,28 @@
 
 namespace stereo_depth {
 
-EnhancedPostProcessor::EnhancedPostProcessor() {
+namespace {
+
+// 一致性检查用的右视图匹配器参数（0..128 视差，5x5 块，3WAY）
+SgbmMatcherKey rightViewMatcherKey() {
+    SgbmMatcherKey key;
+    key.min_disparity = 0;
+    key.num_disparities = 128;
+    key.block_size = 5;
+    key.p1 = 8 * 5 * 5;
+    key.p2 = 32 * 5 * 5;
+    key.mode = cv::StereoSGBM::MODE_SGBM_3WAY;
+    return key;
+}
+
+} // namespace
+
+EnhancedPostProcessor::EnhancedPostProcessor()
+    : EnhancedPostProcessor(std::make_shared<SgbmMatcherCache>(1)) {
+}
+
+EnhancedPostProcessor::EnhancedPostProcessor(std::shared_ptr<SgbmMatcherCache> matcher_cache)
+    : matcher_cache_(matcher_cache ? std::move(matcher_cache) : std::make_shared<SgbmMatcherCache>(1)) {
     // 初始化默认参数
     options_.enable_disparity_refinement = true;
     options_.enable_depth_validation = true;
@@ -90,16 +111,10 @@ cv::Mat EnhancedPostProcessor::refineDisparity(const cv::Mat& disparity,
         right_gray_8u = right_gray;
     }
     
-    // 计算右到左的视差
-    cv::Ptr<cv::StereoSGBM> sgbm_right = cv::StereoSGBM::create(0, 128, 5);
-    sgbm_right->setP1(8 * 5 * 5);
-    sgbm_right->setP2(32 * 5 * 5);
-    sgbm_right->setMode(cv::StereoSGBM::MODE_SGBM_3WAY);
-    
-    cv::Mat disp16S_right;
-    sgbm_right->compute(right_gray_8u, left_gray_8u, disp16S_right);
+    // 计算右到左的视差（匹配器来自缓存，不再逐次创建）
+    static const SgbmMatcherKey kRightViewKey = rightViewMatcherKey();
     cv::Mat disp32F_right;
-    disp16S_right.convertTo(disp32F_right, CV_32F, 1.0 / 16.0);
+    matcher_cache_->computeDisparity(kRightViewKey, right_gray_8u, left_gray_8u, disp32F_right);
     
     // 左右一致性检查
     cv::Mat consistency_mask = cv::Mat::ones(disparity.size(), CV_8U);
@@ -0,0 +1,311 @@
+#include "stereo_depth/fusion_filter_graph.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace stereo_depth {
+
+namespace {
+
+double elapsedMs(int64 start) {
+    return (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+}
+
+// 有限值掩码（NaN 与 ±inf 处为 0；NaN 的比较结果恒为假）
+cv::Mat finiteMask(const cv::Mat& src) {
+    cv::Mat mask;
+    cv::compare(cv::abs(src), FLT_MAX, mask, cv::CMP_LE);
+    return mask;
+}
+
+// 非有限值置 0（与无效深度同样处理）；全部有限时直接返回 src，不拷贝
+const cv::Mat& finiteOrZero(const cv::Mat& src, cv::Mat& buffer) {
+    if (cv::checkRange(src)) {
+        return src;
+    }
+    src.copyTo(buffer);
+    buffer.setTo(0, ~finiteMask(src));
+    return buffer;
+}
+
+// 自引导的引导滤波：q = mean(a)·I + mean(b)，a = var/(var+eps)，b = mean(I)·(1−a)
+void guidedFilter(const cv::Mat& src, cv::Mat& dst, const EdgeAwareFilterParams& params) {
+    const int r = params.diameter > 0 ? std::max(1, params.diameter / 2)
+                                      : std::max(1, cvRound(params.sigma_space));
+    const double eps = params.sigma_range * params.sigma_range;
+    const cv::Size ksize(2 * r + 1, 2 * r + 1);
+
+    // 减去整幅均值再算方差，避免 mm 量级的深度平方后单精度抵消误差过大（滤波对平移不变）。
+    // 含 inf/NaN 时均值只统计有限像素，非有限像素按均值（I = 0）参与滤波：
+    // 否则偏移本身变成 NaN，盒式滤波的滑动求和也会把它带到整行/整列，整帧输出都是 NaN
+    const bool all_finite = cv::checkRange(src);
+    const cv::Mat finite = all_finite ? cv::Mat() : finiteMask(src);
+    const double offset = cv::mean(src, finite)[0];
+    cv::Mat I;
+    src.convertTo(I, CV_32F, 1.0, -offset);
+    if (!all_finite) {
+        I.setTo(0, ~finite);
+    }
+
+    cv::Mat mean_I, corr_I;
+    cv::boxFilter(I, mean_I, CV_32F, ksize, cv::Point(-1, -1), true, cv::BORDER_REFLECT);
+    cv::boxFilter(I.mul(I), corr_I, CV_32F, ksize, cv::Point(-1, -1), true, cv::BORDER_REFLECT);
+
+    cv::Mat var = corr_I - mean_I.mul(mean_I);
+    cv::Mat a = var / (var + eps);
+    cv::Mat b = mean_I - a.mul(mean_I);
+
+    cv::Mat mean_a, mean_b;
+    cv::boxFilter(a, mean_a, CV_32F, ksize, cv::Point(-1, -1), true, cv::BORDER_REFLECT);
+    cv::boxFilter(b, mean_b, CV_32F, ksize, cv::Point(-1, -1), true, cv::BORDER_REFLECT);
+    dst = mean_a.mul(I) + mean_b + offset;
+}
+
+// 域变换递归滤波（RF）：先横向左右各递归一遍，再纵向上下各一遍，迭代时逐步缩小 sigma
+void domainTransformFilter(const cv::Mat& src, cv::Mat& dst, const EdgeAwareFilterParams& params) {
+    const int rows = src.rows;
+    const int cols = src.cols;
+    const int iterations = std::max(1, params.iterations);
+    const float ratio = static_cast<float>(params.sigma_space / std::max(1e-6, params.sigma_range));
+
+    // 域变换导数 1 + σs/σr·|ΔI|，第 0 列/行不使用
+    cv::Mat dH(rows, cols, CV_32F), dV(rows, cols, CV_32F);
+    cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; ++y) {
+            const float* I = src.ptr<float>(y);
+            const float* up = src.ptr<float>(std::max(0, y - 1));
+            float* h = dH.ptr<float>(y);
+            float* v = dV.ptr<float>(y);
+            h[0] = 1.0f;
+            for (int x = 1; x < cols; ++x) {
+                h[x] = 1.0f + ratio * std::fabs(I[x] - I[x - 1]);
+            }
+            for (int x = 0; x < cols; ++x) {
+                v[x] = 1.0f + ratio * std::fabs(I[x] - up[x]);
+            }
+        }
+    });
+
+    src.copyTo(dst);
+    cv::Mat wH, wV;
+    const int column_block = 64;
+    const int column_blocks = (cols + column_block - 1) / column_block;
+    for (int i = 0; i < iterations; ++i) {
+        const double sigma_i = params.sigma_space * std::sqrt(3.0) * std::pow(2.0, iterations - i - 1) /
+                               std::sqrt(std::pow(4.0, iterations) - 1.0);
+        const double log_a = -std::sqrt(2.0) / sigma_i;
+        // 反馈系数 a^d
+        cv::exp(dH * log_a, wH);
+        cv::exp(dV * log_a, wV);
+
+        cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range& range) {
+            for (int y = range.start; y < range.end; ++y) {
+                float* J = dst.ptr<float>(y);
+                const float* w = wH.ptr<float>(y);
+                for (int x = 1; x < cols; ++x) {
+                    J[x] += w[x] * (J[x - 1] - J[x]);
+                }
+                for (int x = cols - 2; x >= 0; --x) {
+                    J[x] += w[x + 1] * (J[x + 1] - J[x]);
+                }
+            }
+        });
+
+        // 纵向按列块并行，块内逐行推进，访问保持连续
+        cv::parallel_for_(cv::Range(0, column_blocks), [&](const cv::Range& range) {
+            for (int blk = range.start; blk < range.end; ++blk) {
+                const int x0 = blk * column_block;
+                const int x1 = std::min(cols, x0 + column_block);
+                for (int y = 1; y < rows; ++y) {
+                    float* J = dst.ptr<float>(y);
+                    const float* prev = dst.ptr<float>(y - 1);
+                    const float* w = wV.ptr<float>(y);
+                    for (int x = x0; x < x1; ++x) {
+                        J[x] += w[x] * (prev[x] - J[x]);
+                    }
+                }
+                for (int y = rows - 2; y >= 0; --y) {
+                    float* J = dst.ptr<float>(y);
+                    const float* next = dst.ptr<float>(y + 1);
+                    const float* w = wV.ptr<float>(y + 1);
+                    for (int x = x0; x < x1; ++x) {
+                        J[x] += w[x] * (next[x] - J[x]);
+                    }
+                }
+            }
+        });
+    }
+}
+
+} // namespace
+
+const char* edgeAwareFilterName(EdgeAwareFilterType type) {
+    switch (type) {
+        case EdgeAwareFilterType::Bilateral: return "bilateral";
+        case EdgeAwareFilterType::Guided: return "guided";
+        case EdgeAwareFilterType::DomainTransform: return "domain_transform";
+    }
+    return "unknown";
+}
+
+void applyEdgeAwareFilter(const cv::Mat& src, cv::Mat& dst, const EdgeAwareFilterParams& params) {
+    CV_Assert(src.type() == CV_32F);
+    CV_Assert(src.data != dst.data);
+    switch (params.type) {
+        case EdgeAwareFilterType::Guided:
+            guidedFilter(src, dst, params);
+            break;
+        case EdgeAwareFilterType::DomainTransform:
+            domainTransformFilter(src, dst, params);
+            break;
+        case EdgeAwareFilterType::Bilateral:
+        default:
+            cv::bilateralFilter(src, dst, params.diameter, params.sigma_range, params.sigma_space);
+            break;
+    }
+}
+
+FusionFilterGraph::FusionFilterGraph(const FusionGraphOptions& options)
+    : options_(options) {
+}
+
+void FusionFilterGraph::setOptions(const FusionGraphOptions& options) {
+    options_ = options;
+    valid_.fill(false);
+}
+
+void FusionFilterGraph::setInputs(const cv::Mat& stereo_depth_mm, const cv::Mat& mono_depth) {
+    CV_Assert(stereo_depth_mm.type() == CV_32F && mono_depth.type() == CV_32F);
+    CV_Assert(stereo_depth_mm.size() == mono_depth.size());
+    stereo_ = finiteOrZero(stereo_depth_mm, stereo_finite_);
+    mono_ = finiteOrZero(mono_depth, mono_finite_);
+    valid_.fill(false);
+    node_ms_.fill(0.0);
+}
+
+const cv::Mat& FusionFilterGraph::get(Node node) {
+    CV_Assert(node >= 0 && node < NodeCount);
+    if (!valid_[node]) {
+        compute(node);
+        valid_[node] = true;
+    }
+    return values_[node];
+}
+
+void FusionFilterGraph::compute(Node node) {
+    switch (node) {
+        case Alpha: {
+            const int64 start = cv::getTickCount();
+            // 置信度：有效即 1，否则 0（可替换为代价/一致性映射）
+            cv::compare(stereo_, 0, conf_mask_, cv::CMP_GT);
+            conf_mask_.convertTo(conf_, CV_32F, 1.0 / 255.0);
+            cv::pow(conf_, options_.confidence_gamma, values_[Alpha]);
+            node_ms_[Alpha] = elapsedMs(start);
+            break;
+        }
+        case MonoLow: {
+            const int64 start = cv::getTickCount();
+            applyEdgeAwareFilter(mono_, values_[MonoLow], options_.filter);
+            node_ms_[MonoLow] = elapsedMs(start);
+            break;
+        }
+        case StereoLow: {
+            const int64 start = cv::getTickCount();
+            applyEdgeAwareFilter(stereo_, values_[StereoLow], options_.filter);
+            node_ms_[StereoLow] = elapsedMs(start);
+            break;
+        }
+        case Fused: {
+            const cv::Mat& alpha = get(Alpha);
+            const cv::Mat& mono_low = get(MonoLow);
+            const cv::Mat& stereo_low = get(StereoLow);
+            const int64 start = cv::getTickCount();
+            cv::Mat& fused = values_[Fused];
+            fused.create(stereo_.size(), CV_32F);
+            const int cols = stereo_.cols;
+            // Z = α·Zbase + (1−α)·Lmono + (Zstereo − Zbase)，运算顺序与原逐矩阵实现一致
+            cv::parallel_for_(cv::Range(0, stereo_.rows), [&](const cv::Range& range) {
+                for (int y = range.start; y < range.end; ++y) {
+                    const float* a = alpha.ptr<float>(y);
+                    const float* lm = mono_low.ptr<float>(y);
+                    const float* zb = stereo_low.ptr<float>(y);
+                    const float* zs = stereo_.ptr<float>(y);
+                    float* out = fused.ptr<float>(y);
+                    for (int x = 0; x < cols; ++x) {
+                        const float low = a[x] * zb[x] + (1.0f - a[x]) * lm[x];
+                        out[x] = low + (zs[x] - zb[x]);
+                    }
+                }
+            });
+            node_ms_[Fused] = elapsedMs(start);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+std::vector<FusionFilterReport> compareFusionFilters(const cv::Mat& stereo_depth_mm,
+                                                     const cv::Mat& mono_depth,
+                                                     const FusionGraphOptions& options,
+                                                     const std::vector<EdgeAwareFilterParams>& candidates,
+                                                     int iterations) {
+    std::vector<FusionFilterReport> reports;
+    if (stereo_depth_mm.empty() || mono_depth.empty() || candidates.empty()) {
+        return reports;
+    }
+    iterations = std::max(1, iterations);
+
+    cv::Mat reference;
+    for (const EdgeAwareFilterParams& filter : candidates) {
+        FusionGraphOptions graph_options = options;
+        graph_options.filter = filter;
+        FusionFilterGraph graph(graph_options);
+
+        FusionFilterReport report;
+        report.filter = filter;
+        // 预热一次（分配节点缓冲），不计入耗时
+        graph.setInputs(stereo_depth_mm, mono_depth);
+        graph.get(FusionFilterGraph::Fused);
+        for (int i = 0; i < iterations; ++i) {
+            const int64 start = cv::getTickCount();
+            graph.setInputs(stereo_depth_mm, mono_depth);
+            graph.get(FusionFilterGraph::Fused);
+            report.fuse_ms += elapsedMs(start);
+            report.filter_ms += graph.nodeMs(FusionFilterGraph::MonoLow) + graph.nodeMs(FusionFilterGraph::StereoLow);
+        }
+        report.fuse_ms /= iterations;
+        report.filter_ms /= iterations;
+
+        const cv::Mat& fused = graph.get(FusionFilterGraph::Fused);
+        if (reference.empty()) {
+            reference = fused.clone();
+        } else {
+            double sum_sq = 0.0;
+            double sum_abs = 0.0;
+            long count = 0;
+            for (int y = 0; y < fused.rows; ++y) {
+                const float* r = reference.ptr<float>(y);
+                const float* f = fused.ptr<float>(y);
+                for (int x = 0; x < fused.cols; ++x) {
+                    if (!std::isfinite(r[x]) || !std::isfinite(f[x])) {
+                        continue;
+                    }
+                    const double diff = std::fabs(static_cast<double>(f[x]) - r[x]);
+                    sum_sq += diff * diff;
+                    sum_abs += diff;
+                    report.max_abs_mm = std::max(report.max_abs_mm, diff);
+                    ++count;
+                }
+            }
+            if (count > 0) {
+                report.rmse_mm = std::sqrt(sum_sq / count);
+                report.mean_abs_mm = sum_abs / count;
+            }
+        }
+        reports.push_back(report);
+    }
+    return reports;
+}
+
+} // namespace stereo_depth
@@ -0,0 +1,176 @@
+#include "stereo_depth/pyramid_sgbm.hpp"
+#include "stereo_depth/strip_sgbm_engine.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace stereo_depth {
+
+namespace {
+
+int alignUp16(int v) {
+    return std::max(16, (v + 15) / 16 * 16);
+}
+
+} // namespace
+
+PyramidSgbm::PyramidSgbm(const PyramidSgbmOptions& options)
+    : options_(options) {
+}
+
+void PyramidSgbm::setOptions(const PyramidSgbmOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = options;
+}
+
+PyramidSgbmOptions PyramidSgbm::getOptions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_;
+}
+
+std::vector<PyramidSgbm::TileRange> PyramidSgbm::lastTiles() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tiles_;
+}
+
+SgbmMatcherKey PyramidSgbm::coarseKey(const SgbmMatcherKey& key, int levels) {
+    const int scale = 1 << std::max(0, levels);
+    SgbmMatcherKey coarse = key;
+    coarse.min_disparity = static_cast<int>(std::floor(static_cast<double>(key.min_disparity) / scale));
+    coarse.num_disparities = alignUp16((key.num_disparities + scale - 1) / scale);
+    coarse.speckle_window = key.speckle_window / (scale * scale);
+    coarse.speckle_range = key.speckle_range > 0 ? std::max(1, key.speckle_range / scale) : 0;
+    return coarse;
+}
+
+void PyramidSgbm::planTiles(const SgbmMatcherKey& key, const cv::Size& size, float coarse_invalid) {
+    tiles_.clear();
+    const int tw = std::max(16, options_.tile_width);
+    const int th = std::max(16, options_.tile_height);
+    const double rx = static_cast<double>(coarse_disparity_.cols) / size.width;
+    const double ry = static_cast<double>(coarse_disparity_.rows) / size.height;
+    // 粗层视差单位是粗层像素，换算回全分辨率
+    const double to_full = static_cast<double>(size.width) / coarse_disparity_.cols;
+    const int full_min = key.min_disparity;
+    const int full_max = key.min_disparity + key.num_disparities - 1;
+
+    for (int y = 0; y < size.height; y += th) {
+        for (int x = 0; x < size.width; x += tw) {
+            TileRange range;
+            range.tile = cv::Rect(x, y, std::min(tw, size.width - x), std::min(th, size.height - y));
+
+            // 对应的粗层区域向外扩一个像素，减少块边缘的漏检
+            const int cx0 = std::max(0, static_cast<int>(std::floor(x * rx)) - 1);
+            const int cy0 = std::max(0, static_cast<int>(std::floor(y * ry)) - 1);
+            const int cx1 = std::min(coarse_disparity_.cols,
+                                     static_cast<int>(std::ceil((x + range.tile.width) * rx)) + 1);
+            const int cy1 = std::min(coarse_disparity_.rows,
+                                     static_cast<int>(std::ceil((y + range.tile.height) * ry)) + 1);
+
+            float lo = std::numeric_limits<float>::max();
+            float hi = std::numeric_limits<float>::lowest();
+            int valid = 0;
+            for (int cy = cy0; cy < cy1; ++cy) {
+                const float* row = coarse_disparity_.ptr<float>(cy);
+                for (int cx = cx0; cx < cx1; ++cx) {
+                    if (row[cx] > coarse_invalid) {
+                        lo = std::min(lo, row[cx]);
+                        hi = std::max(hi, row[cx]);
+                        ++valid;
+                    }
+                }
+            }
+
+            const int area = std::max(1, (cx1 - cx0) * (cy1 - cy0));
+            if (valid == 0 || valid < options_.min_valid_fraction * area) {
+                range.min_disparity = key.min_disparity;
+                range.num_disparities = key.num_disparities;
+                range.full_range = true;
+            } else {
+                int dmin = static_cast<int>(std::floor(lo * to_full)) - options_.disparity_margin;
+                int dmax = static_cast<int>(std::ceil(hi * to_full)) + options_.disparity_margin;
+                dmin = std::max(full_min, dmin);
+                dmax = std::min(full_max, std::max(dmin, dmax));
+                int num = std::min(key.num_disparities, alignUp16(dmax - dmin + 1));
+                // 对齐后超出原范围时整体左移
+                dmin = std::max(full_min, std::min(dmin, full_max + 1 - num));
+                range.min_disparity = dmin;
+                range.num_disparities = num;
+                range.full_range = num >= key.num_disparities;
+            }
+            tiles_.push_back(range);
+        }
+    }
+}
+
+void PyramidSgbm::compute(const SgbmMatcherKey& key,
+                          const cv::Mat& left,
+                          const cv::Mat& right,
+                          cv::Mat& disparity32F,
+                          cv::Mat* disparity16S) {
+    CV_Assert(!left.empty() && left.size() == right.size() && left.type() == right.type());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const cv::Size size = left.size();
+    const int scale = 1 << std::max(0, options_.levels);
+    const int invalid = (key.min_disparity - 1) * cv::StereoMatcher::DISP_SCALE;
+
+    // 1. 粗层完整搜索
+    const SgbmMatcherKey coarse_key = coarseKey(key, options_.levels);
+    const cv::Size coarse_size(std::max(1, size.width / scale), std::max(1, size.height / scale));
+    cv::resize(left, coarse_left_, coarse_size, 0, 0, cv::INTER_AREA);
+    cv::resize(right, coarse_right_, coarse_size, 0, 0, cv::INTER_AREA);
+    coarse_cache_.computeDisparity(coarse_key, coarse_left_, coarse_right_, coarse_disparity_);
+
+    // 2. 按块确定全分辨率搜索范围
+    planTiles(key, size, static_cast<float>(coarse_key.min_disparity - 1));
+
+    // 3. 各块在收窄的范围内做全分辨率匹配（块内不做斑点滤除）
+    const int tiles = static_cast<int>(tiles_.size());
+    if (static_cast<int>(slots_.size()) < tiles) {
+        slots_.resize(tiles);
+    }
+    for (int i = 0; i < tiles; ++i) {
+        SgbmMatcherKey tile_key = key;
+        tile_key.min_disparity = tiles_[i].min_disparity;
+        tile_key.num_disparities = tiles_[i].num_disparities;
+        tile_key.speckle_window = 0;
+        tile_key.speckle_range = 0;
+        Slot& slot = slots_[i];
+        if (slot.matcher.empty() || slot.key != tile_key) {
+            slot.key = tile_key;
+            slot.matcher = tile_key.createMatcher();
+        }
+    }
+
+    disparity16S_.create(size, CV_16S);
+    const int margin = options_.path_margin;
+    cv::parallel_for_(cv::Range(0, tiles), [&](const cv::Range& r) {
+        for (int i = r.start; i < r.end; ++i) {
+            const cv::Rect tile = tiles_[i].tile;
+            Slot& slot = slots_[i];
+            const cv::Rect window = StripSgbmEngine::matchingWindow(slot.key, tile, size, margin);
+            slot.matcher->compute(left(window), right(window), slot.disparity16S);
+
+            const cv::Rect inner(tile.x - window.x, tile.y - window.y, tile.width, tile.height);
+            cv::Mat src = slot.disparity16S(inner);
+            cv::Mat dst = disparity16S_(tile);
+            src.copyTo(dst);
+            // 块内的无效值是 (块 min - 1) * 16，统一成整幅的无效值
+            dst.setTo(cv::Scalar::all(invalid), src < slot.key.min_disparity * cv::StereoMatcher::DISP_SCALE);
+        }
+    });
+
+    // 4. 拼接后统一做斑点滤除
+    if (key.speckle_window > 0) {
+        cv::filterSpeckles(disparity16S_, invalid, key.speckle_window,
+                           cv::StereoMatcher::DISP_SCALE * key.speckle_range, speckle_buffer_);
+    }
+
+    if (disparity16S) {
+        disparity16S_.copyTo(*disparity16S);
+    }
+    disparity16S_.convertTo(disparity32F, CV_32F, 1.0 / cv::StereoMatcher::DISP_SCALE);
+}
+
+} // namespace stereo_depth
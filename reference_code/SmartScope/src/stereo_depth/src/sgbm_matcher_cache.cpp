@@ -0,0 +1,107 @@
+#include "stereo_depth/sgbm_matcher_cache.hpp"
+#include "stereo_depth/comprehensive_depth_processor.hpp"
+#include <algorithm>
+#include <tuple>
+
+namespace stereo_depth {
+
+namespace {
+
+auto keyTuple(const SgbmMatcherKey& k) {
+    return std::tie(k.min_disparity, k.num_disparities, k.block_size, k.p1, k.p2, k.disp12_max_diff,
+                    k.prefilter_cap, k.uniqueness_ratio, k.speckle_window, k.speckle_range, k.mode);
+}
+
+} // namespace
+
+SgbmMatcherKey SgbmMatcherKey::fromOptions(const ComprehensiveDepthOptions& options) {
+    SgbmMatcherKey key;
+    key.min_disparity = options.min_disparity;
+    key.num_disparities = options.num_disparities;
+    key.block_size = options.block_size;
+    key.p1 = 8 * options.block_size * options.block_size;
+    key.p2 = 32 * options.block_size * options.block_size;
+    key.disp12_max_diff = options.disp12_max_diff;
+    key.prefilter_cap = options.prefilter_cap;
+    key.uniqueness_ratio = options.uniqueness_ratio;
+    key.speckle_window = options.speckle_window;
+    key.speckle_range = options.speckle_range;
+    key.mode = cv::StereoSGBM::MODE_SGBM_3WAY;
+    return key;
+}
+
+cv::Ptr<cv::StereoSGBM> SgbmMatcherKey::createMatcher() const {
+    return cv::StereoSGBM::create(min_disparity, num_disparities, block_size, p1, p2,
+                                  disp12_max_diff, prefilter_cap, uniqueness_ratio,
+                                  speckle_window, speckle_range, mode);
+}
+
+bool SgbmMatcherKey::operator==(const SgbmMatcherKey& other) const {
+    return keyTuple(*this) == keyTuple(other);
+}
+
+SgbmMatcherCache::SgbmMatcherCache(size_t capacity)
+    : capacity_(std::max<size_t>(1, capacity)) {
+    entries_.reserve(capacity_);
+}
+
+SgbmMatcherCache::Entry& SgbmMatcherCache::entryFor(const SgbmMatcherKey& key) {
+    ++tick_;
+    for (Entry& e : entries_) {
+        if (e.key == key) {
+            e.last_used = tick_;
+            return e;
+        }
+    }
+
+    if (entries_.size() >= capacity_) {
+        auto oldest = std::min_element(entries_.begin(), entries_.end(),
+                                       [](const Entry& a, const Entry& b) { return a.last_used < b.last_used; });
+        entries_.erase(oldest);
+    }
+
+    Entry e;
+    e.key = key;
+    e.matcher = key.createMatcher();
+    e.last_used = tick_;
+    ++created_;
+    entries_.push_back(std::move(e));
+    return entries_.back();
+}
+
+void SgbmMatcherCache::prepare(const SgbmMatcherKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entryFor(key);
+}
+
+void SgbmMatcherCache::computeDisparity(const SgbmMatcherKey& key,
+                                        const cv::Mat& left,
+                                        const cv::Mat& right,
+                                        cv::Mat& disparity32F,
+                                        cv::Mat* disparity16S) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& e = entryFor(key);
+    // 输出缓冲尺寸不变时 compute 原地写入，不再逐帧分配
+    e.matcher->compute(left, right, e.disparity16S);
+    if (disparity16S) {
+        e.disparity16S.copyTo(*disparity16S);
+    }
+    e.disparity16S.convertTo(disparity32F, CV_32F, 1.0 / 16.0);
+}
+
+void SgbmMatcherCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+size_t SgbmMatcherCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+uint64_t SgbmMatcherCache::createdCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return created_;
+}
+
+} // namespace stereo_depth
@@ -1,6 +1,8 @@
 #include "stereo_depth/stereo_depth_pipeline.hpp"
+#include "stereo_depth/disparity_to_depth.hpp"
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
 namespace stereo_depth {
 
@@ -69,13 +71,24 @@ void StereoDepthPipeline::ensureInitialized(const Size &input_size) {
     cv::initUndistortRectifyMap(K0_, D0_, R1_, P1_, rotated, CV_32FC1, map1x_, map1y_);
     cv::initUndistortRectifyMap(K1_, D1_, R2_, P2_, rotated, CV_32FC1, map2x_, map2y_);
 
-    sgbm_ = cv::StereoSGBM::create(opts_.min_disparity, opts_.num_disparities, opts_.block_size);
-    sgbm_->setUniquenessRatio(opts_.uniqueness_ratio);
-    sgbm_->setSpeckleWindowSize(opts_.speckle_window);
-    sgbm_->setSpeckleRange(opts_.speckle_range);
-    sgbm_->setPreFilterCap(opts_.prefilter_cap);
-    sgbm_->setDisp12MaxDiff(opts_.disp12_max_diff);
-    sgbm_->setMode(cv::StereoSGBM::MODE_SGBM_3WAY);
+    // P1/P2 未设置，沿用 OpenCV 默认
+    sgbm_key_.min_disparity = opts_.min_disparity;
+    sgbm_key_.num_disparities = opts_.num_disparities;
+    sgbm_key_.block_size = opts_.block_size;
+    sgbm_key_.uniqueness_ratio = opts_.uniqueness_ratio;
+    sgbm_key_.speckle_window = opts_.speckle_window;
+    sgbm_key_.speckle_range = opts_.speckle_range;
+    sgbm_key_.prefilter_cap = opts_.prefilter_cap;
+    sgbm_key_.disp12_max_diff = opts_.disp12_max_diff;
+    sgbm_key_.mode = cv::StereoSGBM::MODE_SGBM_3WAY;
+    sgbm_ = sgbm_key_.createMatcher();
+
+    PyramidSgbmOptions pyramid;
+    pyramid.levels = std::max(1, opts_.pyramid_levels);
+    pyramid.tile_width = opts_.pyramid_tile_size;
+    pyramid.tile_height = opts_.pyramid_tile_size;
+    pyramid.disparity_margin = opts_.pyramid_disparity_margin;
+    pyramid_.setOptions(pyramid);
 
     image_size_ = rotated;
     initialized_ = true;
@@ -98,21 +111,22 @@ cv::Mat StereoDepthPipeline::computeDisparity(const Mat &left_raw, const Mat &ri
     cv::remap(left_r, left_rect, map1x_, map1y_, cv::INTER_LINEAR);
     cv::remap(right_r, right_rect, map2x_, map2y_, cv::INTER_LINEAR);
     Mat grayL, grayR; cv::cvtColor(left_rect, grayL, cv::COLOR_BGR2GRAY); cv::cvtColor(right_rect, grayR, cv::COLOR_BGR2GRAY);
+    Mat disp32F;
+    if (opts_.hierarchical) {
+        pyramid_.compute(sgbm_key_, grayL, grayR, disp32F);
+        return disp32F;
+    }
     Mat disp16S; sgbm_->compute(grayL, grayR, disp16S);
-    Mat disp32F; disp16S.convertTo(disp32F, CV_32F, 1.0/16.0);
+    disp16S.convertTo(disp32F, CV_32F, 1.0/16.0);
     return disp32F;
 }
 
 bool StereoDepthPipeline::disparityToDepthMm(const Mat &disparity, Mat &depthMm) const {
     if (disparity.empty() || Q_.empty()) return false;
     CV_Assert(disparity.type() == CV_32F);
-    Mat xyz;
-    cv::reprojectImageTo3D(disparity, xyz, Q_, /*handleMissingValues=*/true);
-    std::vector<Mat> ch; cv::split(xyz, ch);
-    if (ch.size() < 3) return false;
-    depthMm = ch[2].clone();
-    cv::patchNaNs(depthMm, 0.0);
-    depthMm.setTo(0, depthMm <= 0);
+    DisparityToDepthOptions opts;
+    opts.zero_invalid = true; // NaN 与 <= 0 的深度置 0
+    disparityToDepth(disparity, Q_, depthMm, opts);
     return true;
 }
 
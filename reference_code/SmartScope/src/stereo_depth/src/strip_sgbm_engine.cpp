@@ -0,0 +1,138 @@
+#include "stereo_depth/strip_sgbm_engine.hpp"
+#include <algorithm>
+
+namespace stereo_depth {
+
+StripSgbmEngine::StripSgbmEngine(const StripSgbmOptions& options)
+    : options_(options) {
+}
+
+void StripSgbmEngine::setOptions(const StripSgbmOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = options;
+}
+
+StripSgbmOptions StripSgbmEngine::getOptions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_;
+}
+
+cv::Rect StripSgbmEngine::matchingWindow(const SgbmMatcherKey& key,
+                                         const cv::Rect& region,
+                                         const cv::Size& image_size,
+                                         int path_margin) {
+    const int half = key.block_size / 2;
+    const int margin = half + std::max(0, path_margin);
+    // 左图 x 处的匹配要用到右图 [x - min_disparity - num_disparities + 1, x - min_disparity]，
+    // OpenCV 也会把窗口最左边这段搜索跨度标成无效，所以左侧要整段带上
+    const int span = std::max(0, key.min_disparity + key.num_disparities);
+
+    const int x0 = std::max(0, region.x - span - margin);
+    const int y0 = std::max(0, region.y - margin);
+    const int x1 = std::min(image_size.width, region.x + region.width + margin);
+    const int y1 = std::min(image_size.height, region.y + region.height + margin);
+    return cv::Rect(x0, y0, std::max(0, x1 - x0), std::max(0, y1 - y0));
+}
+
+int StripSgbmEngine::stripCount(int rows) const {
+    int n = options_.strips > 0 ? options_.strips : std::max(1, cv::getNumThreads());
+    const int min_rows = std::max(1, options_.min_strip_rows);
+    n = std::min(n, std::max(1, rows / min_rows));
+    return std::max(1, n);
+}
+
+StripSgbmEngine::Slot& StripSgbmEngine::slotFor(int index, const SgbmMatcherKey& key) {
+    if (static_cast<int>(slots_.size()) <= index) {
+        slots_.resize(index + 1);
+    }
+    Slot& slot = slots_[index];
+    if (slot.matcher.empty() || slot.key != key) {
+        slot.key = key;
+        slot.matcher = key.createMatcher();
+    }
+    return slot;
+}
+
+void StripSgbmEngine::compute(const SgbmMatcherKey& key,
+                              const cv::Mat& left,
+                              const cv::Mat& right,
+                              cv::Mat& disparity32F,
+                              cv::Mat* disparity16S) {
+    computeRegion(key, left, right, cv::Rect(0, 0, left.cols, left.rows), disparity32F, disparity16S);
+}
+
+void StripSgbmEngine::computeRoi(const SgbmMatcherKey& key,
+                                 const cv::Mat& left,
+                                 const cv::Mat& right,
+                                 const cv::Rect& roi,
+                                 cv::Mat& disparity32F,
+                                 cv::Mat* disparity16S) {
+    const cv::Rect full(0, 0, left.cols, left.rows);
+    cv::Rect region = roi & full;
+    if (region.empty()) {
+        region = full;
+    }
+    computeRegion(key, left, right, region, disparity32F, disparity16S);
+}
+
+void StripSgbmEngine::computeRegion(const SgbmMatcherKey& key,
+                                    const cv::Mat& left,
+                                    const cv::Mat& right,
+                                    const cv::Rect& region,
+                                    cv::Mat& disparity32F,
+                                    cv::Mat* disparity16S) {
+    CV_Assert(!left.empty() && left.size() == right.size() && left.type() == right.type());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const cv::Size size = left.size();
+    const bool full_frame = region == cv::Rect(0, 0, size.width, size.height);
+    const int strips = stripCount(region.height);
+    const int invalid = (key.min_disparity - 1) * cv::StereoMatcher::DISP_SCALE;
+
+    if (full_frame && strips == 1) {
+        // 不切分：与直接调用匹配器完全相同（含斑点滤除）
+        Slot& slot = slotFor(0, key);
+        slot.matcher->compute(left, right, disparity16S_);
+    } else {
+        disparity16S_.create(size, CV_16S);
+        if (!full_frame) {
+            disparity16S_.setTo(cv::Scalar::all(invalid));
+        }
+
+        // 斑点区域可能跨条带，条带内不做，拼接后统一处理
+        SgbmMatcherKey strip_key = key;
+        strip_key.speckle_window = 0;
+        strip_key.speckle_range = 0;
+        for (int i = 0; i < strips; ++i) {
+            slotFor(i, strip_key);
+        }
+
+        const int margin = options_.path_margin;
+        cv::parallel_for_(cv::Range(0, strips), [&](const cv::Range& range) {
+            for (int i = range.start; i < range.end; ++i) {
+                const int y0 = region.y + region.height * i / strips;
+                const int y1 = region.y + region.height * (i + 1) / strips;
+                const cv::Rect strip(region.x, y0, region.width, y1 - y0);
+                const cv::Rect window = matchingWindow(key, strip, size, margin);
+
+                Slot& slot = slots_[i];
+                slot.matcher->compute(left(window), right(window), slot.disparity16S);
+                const cv::Rect inner(strip.x - window.x, strip.y - window.y, strip.width, strip.height);
+                slot.disparity16S(inner).copyTo(disparity16S_(strip));
+            }
+        });
+
+        if (key.speckle_window > 0) {
+            cv::Mat out = disparity16S_(region);
+            cv::filterSpeckles(out, invalid, key.speckle_window,
+                               cv::StereoMatcher::DISP_SCALE * key.speckle_range, speckle_buffer_);
+        }
+    }
+
+    if (disparity16S) {
+        disparity16S_.copyTo(*disparity16S);
+    }
+    disparity16S_.convertTo(disparity32F, CV_32F, 1.0 / cv::StereoMatcher::DISP_SCALE);
+}
+
+} // namespace stereo_depth
@@ -2,7 +2,6 @@
 #include "logger.h"
 #include <QImage>
 #include <QFile>
-#include <QVariantMap>
 #include <QVector>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -21,32 +20,22 @@ extern "C" {
     void smartscope_ai_unregister_result_callback_raw(void* ctx);
 }
 
-// Forward trampoline: convert C array to QVariantList and dispatch to UI thread
+// Forward trampoline: copy the C array into a DetectionList (one allocation per batch)
+// and dispatch it to the UI thread
 extern "C" void ai_result_raw_trampoline(void* ctx, const smartscope_CDetection* dets, int count) {
     AiDetectionManager* self = reinterpret_cast<AiDetectionManager*>(ctx);
     if (!self) return;
-    QVariantList list;
-    if (dets && count > 0) {
-        list.reserve(count);
-        for (int i = 0; i < count; ++i) {
-            const smartscope_CDetection& d = dets[i];
-            QVariantMap m;
-            m.insert("left", d.left);
-            m.insert("top", d.top);
-            m.insert("right", d.right);
-            m.insert("bottom", d.bottom);
-            m.insert("confidence", d.confidence);
-            m.insert("class_id", d.class_id);
-            list.push_back(m);
-        }
-    }
+    DetectionList list(dets, count);
     QMetaObject::invokeMethod(self, "onAiResultRaw", Qt::QueuedConnection,
-                              Q_ARG(QVariantList, list));
+                              Q_ARG(DetectionList, list));
 }
 
 AiDetectionManager::AiDetectionManager(QObject* parent)
     : QObject(parent)
 {
+    // 排队连接与 invokeMethod(Q_ARG) 需要运行时注册的类型
+    qRegisterMetaType<DetectionList>("DetectionList");
+
     // 轮询接口保留兼容（默认不启用）；改用Rust主动推送结果
     m_pollTimer.setInterval(30);
 
@@ -71,7 +60,8 @@ AiDetectionManager::~AiDetectionManager() {
 
 bool AiDetectionManager::initialize(const QString& modelPath, int numWorkers) {
     QByteArray pathBytes = modelPath.toUtf8();
-    int rc = smartscope_ai_init(pathBytes.constData(), numWorkers);
+    // 后处理阈值/类别过滤取 smartscope.toml 的 [ai] 段
+    int rc = smartscope_ai_init(pathBytes.constData(), numWorkers, nullptr);
     if (rc != SMARTSCOPE_ERROR_SUCCESS) {
         LOG_ERROR("AiDetectionManager", "AI service init failed: ", smartscope_get_error_string(rc));
         return false;
@@ -96,6 +86,7 @@ bool AiDetectionManager::initialize(const QString& modelPath, int numWorkers) {
             }
         }
     }
+    m_detectionModel.setLabels(m_labels, m_labelsZh);
     return true;
 }
 
@@ -118,16 +109,12 @@ void AiDetectionManager::setEnabled(bool en) {
         m_pollTimer.stop();
         m_aliveTimer.stop();
         // 清空覆盖层
-        emit detectionsUpdated(QVariantList{});
+        m_detectionModel.setDetections(DetectionList());
+        emit detectionsUpdated(DetectionList());
     }
     emit enabledChanged();
 }
 
-void AiDetectionManager::onLeftPixmap(const QPixmap& pixmap) {
-    if (!m_enabled) return;
-    submitPixmap(pixmap);
-}
-
 void AiDetectionManager::onSinglePixmap(const QPixmap& pixmap) {
     if (!m_enabled) return;
     submitPixmap(pixmap);
@@ -162,42 +149,20 @@ void AiDetectionManager::pollResults() {
 
     smartscope_CDetection dets[128];
     int n = smartscope_ai_try_get_latest_result(dets, 128);
-    if (n <= 0) {
-        // 明确地推送空结果以清除上一次的绘制
-        emit detectionsUpdated(QVariantList{});
-        return;
-    }
-
-    QVariantList list;
-    list.reserve(n);
-    for (int i = 0; i < n; ++i) {
-        const auto& d = dets[i];
-        QVariantMap m;
-        m.insert("left", d.left);
-        m.insert("top", d.top);
-        m.insert("right", d.right);
-        m.insert("bottom", d.bottom);
-        m.insert("confidence", d.confidence);
-        m.insert("class_id", d.class_id);
-        QString zh = classNameZh(d.class_id);
-        QString en = classNameEn(d.class_id);
-        if (!zh.isEmpty()) m.insert("label_zh", zh);
-        if (!en.isEmpty()) m.insert("label_en", en);
-        m.insert("label", !zh.isEmpty() ? zh : (!en.isEmpty() ? en : QString("class_%1").arg(d.class_id)));
-        list.push_back(m);
-    }
+    // n <= 0 时明确地推送空结果以清除上一次的绘制
+    publishDetections(DetectionList(dets, n));
+}
 
-    emit detectionsUpdated(list);
+void AiDetectionManager::onAiResultRaw(const DetectionList& list) {
+    if (!m_enabled) return;
+    publishDetections(list);
 }
 
 void AiDetectionManager::onAiResultJson(const QString& json) {
     if (!m_enabled) return;
     if (json.isEmpty()) {
         // 不绘制：清空覆盖层
-        emit detectionsUpdated(QVariantList{});
-        m_lastDetectionsCount = 0;
-        m_lastDetectionsMs = QDateTime::currentMSecsSinceEpoch();
-        emit statsChanged();
+        publishDetections(DetectionList());
         return;
     }
     QJsonParseError err{};
@@ -205,33 +170,93 @@ void AiDetectionManager::onAiResultJson(const QString& json) {
     if (err.error != QJsonParseError::NoError || !doc.isArray()) {
         return;
     }
-    QVariantList list;
-    auto arr = doc.array();
-    list.reserve(arr.size());
+    const QJsonArray arr = doc.array();
+    QVector<smartscope_CDetection> dets;
+    dets.reserve(arr.size());
     for (const auto& v : arr) {
-        QJsonObject o = v.toObject();
-        QVariantMap m;
-        m.insert("left", o.value("left").toInt());
-        m.insert("top", o.value("top").toInt());
-        m.insert("right", o.value("right").toInt());
-        m.insert("bottom", o.value("bottom").toInt());
-        m.insert("confidence", o.value("confidence").toDouble());
-        int cid = o.value("class_id").toInt();
-        m.insert("class_id", cid);
-        // 同时下发中英文标签，前端根据语言选择
-        QString zh = classNameZh(cid);
-        QString en = classNameEn(cid);
-        if (!zh.isEmpty()) m.insert("label_zh", zh);
-        if (!en.isEmpty()) m.insert("label_en", en);
-        // 兼容旧逻辑的默认label（中文优先）
-        m.insert("label", !zh.isEmpty() ? zh : (!en.isEmpty() ? en : QString("class_%1").arg(cid)));
-        list.push_back(m);
+        const QJsonObject o = v.toObject();
+        smartscope_CDetection d{};
+        d.left = o.value("left").toInt();
+        d.top = o.value("top").toInt();
+        d.right = o.value("right").toInt();
+        d.bottom = o.value("bottom").toInt();
+        d.confidence = static_cast<float>(o.value("confidence").toDouble());
+        d.class_id = o.value("class_id").toInt();
+        dets.push_back(d);
     }
+    publishDetections(DetectionList(std::move(dets)));
+}
+
+void AiDetectionManager::publishDetections(const DetectionList& list) {
+    m_detectionModel.setDetections(list);
     emit detectionsUpdated(list);
     m_lastDetectionsCount = list.size();
     m_lastDetectionsMs = QDateTime::currentMSecsSinceEpoch();
-    if (!m_aiPushAlive) { m_aiPushAlive = true; emit statsChanged(); }
-    else { emit statsChanged(); }
+    m_aiPushAlive = true;
+    emit statsChanged();
+}
+
+QVariantMap AiDetectionManager::inferenceStats() const {
+    static const char* const kStageNames[] = { "preprocess", "run", "outputs", "decode", "nms" };
+    constexpr int kStages = sizeof(kStageNames) / sizeof(kStageNames[0]);
+
+    smartscope_CAiStats stats;
+    QVariantMap result;
+    if (smartscope_ai_get_stats(&stats) != SMARTSCOPE_ERROR_SUCCESS) {
+        return result;
+    }
+    QVariantList stages;
+    for (int i = 0; i < kStages; ++i) {
+        const smartscope_CAiStageStats& s = stats.stages[i];
+        QVariantMap item;
+        item["stage"] = QString::fromLatin1(kStageNames[i]);
+        item["count"] = static_cast<qulonglong>(s.count);
+        item["mean"] = s.mean_ms;
+        item["p50"] = s.p50_ms;
+        item["p95"] = s.p95_ms;
+        item["max"] = s.max_ms;
+        stages.append(item);
+    }
+    result["stages"] = stages;
+    result["frames"] = static_cast<qulonglong>(stats.frames);
+    result["errors"] = static_cast<qulonglong>(stats.errors);
+    result["candidatesMean"] = stats.candidates_mean;
+    result["candidatesMax"] = static_cast<qulonglong>(stats.candidates_max);
+    result["candidatesDropped"] = static_cast<qulonglong>(stats.candidates_dropped);
+    result["detectionsMean"] = stats.detections_mean;
+    result["detectionsLast"] = static_cast<qulonglong>(stats.detections_last);
+    result["submitted"] = static_cast<qulonglong>(stats.submitted);
+    result["dropped"] = static_cast<qulonglong>(stats.dropped);
+    result["failed"] = static_cast<qulonglong>(stats.failed);
+    result["inFlight"] = static_cast<qulonglong>(stats.in_flight);
+    result["contexts"] = stats.contexts;
+    result["cores"] = stats.cores;
+    return result;
+}
+
+void AiDetectionManager::resetInferenceStats() {
+    smartscope_ai_reset_stats();
+}
+
+int AiDetectionManager::detectionMode() const {
+    return smartscope_ai_get_detection_mode();
+}
+
+bool AiDetectionManager::setDetectionMode(int mode) {
+    return smartscope_ai_set_detection_mode(mode) == SMARTSCOPE_ERROR_SUCCESS;
+}
+
+void AiDetectionManager::setRoi(const QRectF& rect) {
+    const QRect r = rect.toAlignedRect();
+    if (r.width() <= 0 || r.height() <= 0) {
+        clearRoi();
+        return;
+    }
+    smartscope_ai_set_roi(r.x(), r.y(), r.width(), r.height());
+}
+
+void AiDetectionManager::clearRoi() {
+    smartscope_ai_set_roi(0, 0, 0, 0);
 }
 
 QString AiDetectionManager::className(int classId) const {
@@ -6,11 +6,10 @@
 #include <QTimer>
 #include <QMutex>
 #include <QVariant>
+#include <QRectF>
 
-// FFI header
-extern "C" {
-    #include "smartscope.h"
-}
+#include "detection_list.h"
+#include "detection_list_model.h"
 
 class AiDetectionManager : public QObject {
     Q_OBJECT
@@ -18,6 +17,7 @@ class AiDetectionManager : public QObject {
     Q_PROPERTY(int lastDetectionsCount READ lastDetectionsCount NOTIFY statsChanged)
     Q_PROPERTY(qint64 lastDetectionsMs READ lastDetectionsMs NOTIFY statsChanged)
     Q_PROPERTY(bool aiPushAlive READ aiPushAlive NOTIFY statsChanged)
+    Q_PROPERTY(DetectionListModel* detectionModel READ detectionModel CONSTANT)
 public:
     explicit AiDetectionManager(QObject* parent = nullptr);
     ~AiDetectionManager();
@@ -29,22 +29,36 @@ public:
     bool enabled() const { return m_enabled; }
     Q_INVOKABLE void setEnabled(bool en);
     Q_INVOKABLE void onAiResultJson(const QString& json);
-    Q_INVOKABLE void onAiResultRaw(const QVariantList& list);
+    Q_INVOKABLE void onAiResultRaw(const DetectionList& list);
+
+    // 最新检测结果（供QML Repeater等使用）
+    DetectionListModel* detectionModel() { return &m_detectionModel; }
 
     // Stats for debugging overlay vs detection pipeline health
     int lastDetectionsCount() const { return m_lastDetectionsCount; }
     qint64 lastDetectionsMs() const { return m_lastDetectionsMs; }
     bool aiPushAlive() const { return m_aiPushAlive; }
 
+    // 推理统计（各阶段 mean/p50/p95/max 毫秒、候选数、流水线计数），服务未初始化时返回空表
+    Q_INVOKABLE QVariantMap inferenceStats() const;
+    Q_INVOKABLE void resetInferenceStats();
+
+    // 检测方式：0 整幅，1 分块，2 自适应（见 smartscope_AiDetectionMode），服务未初始化时返回-1
+    Q_INVOKABLE int detectionMode() const;
+    Q_INVOKABLE bool setDetectionMode(int mode);
+    // 检测区域（源帧像素，如放大后的可见区域）；clearRoi 恢复整帧
+    Q_INVOKABLE void setRoi(const QRectF& rect);
+    Q_INVOKABLE void clearRoi();
+
 public slots:
-    // 连接到 CameraManager 的 pixmap 信号
-    void onLeftPixmap(const QPixmap& pixmap);
+    // 单目模式：连接到 CameraManager 的 singlePixmapUpdated
+    // （双目左相机帧由 Rust 图像管道直接提交，无需经过前端）
     void onSinglePixmap(const QPixmap& pixmap);
 
 signals:
     void enabledChanged();
-    // 推理结果（QVariantList: list of { left, top, right, bottom, confidence, class_id })
-    void detectionsUpdated(const QVariantList& detections);
+    // 推理结果（模型输入坐标系的检测框，隐式共享，跨线程不复制）
+    void detectionsUpdated(const DetectionList& detections);
     void statsChanged();
 
 private slots:
@@ -52,6 +66,7 @@ private slots:
 
 private:
     void submitPixmap(const QPixmap& pixmap);
+    void publishDetections(const DetectionList& list);
     QString className(int classId) const;
     QString classNameZh(int classId) const;
     QString classNameEn(int classId) const;
@@ -62,6 +77,7 @@ private:
     QMutex m_submitMutex;
     QVector<QString> m_labels;
     QVector<QString> m_labelsZh;
+    DetectionListModel m_detectionModel;
 
     // Debugging / health stats
     QTimer m_aliveTimer;
@@ -1,12 +1,20 @@
 #include "camera_manager.h"
+#include "frame_processing_stage.h"
+#include "frame_trace.h"
 #include "logger.h"
+#include <QElapsedTimer>
 #include <QBuffer>
 #include <QImageReader>
 #include <QFile>
 #include <QIODevice>
 #include <QMutexLocker>
 #include <QTransform>
+#include <QVariantMap>
 #include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <chrono>
 #include <thread>
 
 // Rust FFI for video transforms
@@ -19,15 +27,12 @@ extern "C" {
     bool smartscope_video_get_invert();
 }
 
-// Camera video recorder FFI (NOT screen recorder - currently disabled)
-// TODO: Re-implement camera video recording using frame submission
-// extern "C" {
-//     int smartscope_recorder_init_simple(...);
-//     int smartscope_recorder_start();
-//     int smartscope_recorder_stop();
-//     int smartscope_recorder_is_recording();
-//     int smartscope_recorder_submit_rgb888(...);
-// }
+// Rust 新帧通知 → 唤醒取帧工作线程（在 Rust 线程中执行，保持轻量）
+extern "C" void camera_frame_ready_trampoline(void* ctx, uint64_t seq, uint64_t captureNs) {
+    CameraManager* self = reinterpret_cast<CameraManager*>(ctx);
+    if (!self) return;
+    self->notifyFrameReady(seq, captureNs);
+}
 
 CameraManager::CameraManager(QObject *parent)
     : QObject(parent)
@@ -36,10 +41,11 @@ CameraManager::CameraManager(QObject *parent)
     , m_leftConnected(false)
     , m_rightConnected(false)
     , m_cameraMode(NoCamera)
+    , m_processingStage(new FrameProcessingStage(2))
 {
-    // 设置定时器每33ms更新一次 (~30 FPS)
-    m_updateTimer->setInterval(33);
-    connect(m_updateTimer, &QTimer::timeout, this, &CameraManager::updateFrames);
+    // 帧由 Rust 推送驱动；定时器只负责低频刷新连接状态
+    m_updateTimer->setInterval(200);
+    connect(m_updateTimer, &QTimer::timeout, this, &CameraManager::updateStatus);
 
     LOG_INFO("CameraManager", "CameraManager initialized");
 }
@@ -47,6 +53,7 @@ CameraManager::CameraManager(QObject *parent)
 CameraManager::~CameraManager()
 {
     stopCamera();
+    stopFrameWorker();
 }
 
 bool CameraManager::startCamera()
@@ -57,6 +64,7 @@ bool CameraManager::startCamera()
     if (result == 0) { // Success
         m_cameraRunning = true;
         m_updateTimer->start();
+        startFrameWorker();
         emit cameraRunningChanged();
         LOG_INFO("CameraManager", "Camera system started successfully");
         return true;
@@ -70,7 +78,11 @@ bool CameraManager::stopCamera()
 {
     LOG_INFO("CameraManager", "Stopping camera system...");
 
+    // 录制依赖相机帧流，先完成文件写入
+    stopVideoRecording();
+
     m_updateTimer->stop();
+    stopFrameWorker();
 
     int result = smartscope_stop_camera();
     if (result == 0) { // Success
@@ -100,25 +112,159 @@ bool CameraManager::stopCamera()
     }
 }
 
-bool CameraManager::startVideoRecording(const QString& outputPath)
+bool CameraManager::startVideoRecording(const QString& outputPath, bool softwareH264)
 {
-    // TODO: Re-implement camera video recording using frame submission
-    LOG_WARN("CameraManager", "Camera video recording not yet implemented (use screen recorder instead)");
-    (void)outputPath;
-    return false;
+    if (m_recording) {
+        LOG_WARN("CameraManager", "Video recording already in progress: ", m_recordingPath.toStdString());
+        return false;
+    }
+    if (!m_cameraRunning) {
+        LOG_WARN("CameraManager", "Cannot start video recording: camera not running");
+        return false;
+    }
+
+    QString filePath = outputPath;
+    const QFileInfo info(outputPath);
+    if (outputPath.isEmpty() || info.isDir() || info.suffix().isEmpty()) {
+        const QString dir = outputPath.isEmpty()
+            ? QStandardPaths::writableLocation(QStandardPaths::MoviesLocation)
+            : outputPath;
+        QDir().mkpath(dir);
+        const QString ts = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+        filePath = QDir(dir).filePath(QString("camera_%1.mkv").arg(ts));
+    }
+
+    const QByteArray pathBytes = filePath.toUtf8();
+    int result = smartscope_recorder_start(pathBytes.constData(), softwareH264 ? 1 : 0);
+    if (result != 0) {
+        LOG_ERROR("CameraManager", "Failed to start video recording, error code: ", result);
+        return false;
+    }
+
+    m_recording = true;
+    m_recordingPath = filePath;
+    m_recordStats = CRecorderStats{};
+    emit recordingChanged();
+    emit recordStatsChanged();
+    LOG_INFO("CameraManager", "Video recording started: ", filePath.toStdString(),
+             softwareH264 ? " (H.264)" : " (MJPEG passthrough)");
+    return true;
 }
 
 bool CameraManager::stopVideoRecording()
 {
-    // TODO: Re-implement camera video recording
-    LOG_WARN("CameraManager", "Camera video recording not yet implemented");
-    return false;
+    if (!m_recording) {
+        return false;
+    }
+
+    // 先取最终统计，stop 之后 Rust 侧不再持有录制器
+    updateRecordStats();
+    int result = smartscope_recorder_stop();
+    m_recording = false;
+    emit recordingChanged();
+
+    if (result != 0) {
+        LOG_ERROR("CameraManager", "Video recording stopped with error, code: ", result);
+        return false;
+    }
+    LOG_INFO("CameraManager", "Video recording saved: ", m_recordingPath.toStdString(),
+             ", frames: ", m_recordStats.frames_written,
+             ", dropped: ", m_recordStats.frames_dropped);
+    return true;
 }
 
 bool CameraManager::isRecording() const
 {
-    // TODO: Re-implement camera video recording status
-    return false;
+    return m_recording;
+}
+
+bool CameraManager::startFrameDump(const QString& outputPath)
+{
+    QString filePath = outputPath;
+    if (QFileInfo(outputPath).isDir()) {
+        const QString ts = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+        filePath = QDir(outputPath).filePath(QString("camera_%1.ssdump").arg(ts));
+    }
+
+    const QByteArray pathBytes = filePath.toUtf8();
+    if (smartscope_camera_dump_start(pathBytes.constData()) != 0) {
+        LOG_ERROR("CameraManager", "Failed to start frame dump: ", filePath.toStdString());
+        return false;
+    }
+    LOG_INFO("CameraManager", "Frame dump started: ", filePath.toStdString());
+    return true;
+}
+
+bool CameraManager::stopFrameDump()
+{
+    return smartscope_camera_dump_stop() == 0;
+}
+
+bool CameraManager::frameTraceEnabled() const
+{
+    return smartscope_trace_is_enabled();
+}
+
+void CameraManager::setFrameTraceEnabled(bool enabled)
+{
+    if (enabled == frameTraceEnabled()) return;
+    smartscope_trace_set_enabled(enabled);
+    emit frameTraceEnabledChanged();
+}
+
+QVariantList CameraManager::frameTraceStats() const
+{
+    static const char* const kStageNames[] = {
+        "capture", "decode", "undistort", "transform", "ffi_copy",
+        "qimage", "paint", "ai_submit", "ai_result", "end_to_end"
+    };
+    constexpr int kMaxStages = sizeof(kStageNames) / sizeof(kStageNames[0]);
+
+    smartscope_CTraceStageStats stats[kMaxStages];
+    const int n = smartscope_trace_get_stage_stats(stats, kMaxStages);
+    QVariantList result;
+    for (int i = 0; i < n; ++i) {
+        if (stats[i].stage >= static_cast<uint32_t>(kMaxStages)) continue;
+        QVariantMap item;
+        item["stage"] = QString::fromLatin1(kStageNames[stats[i].stage]);
+        item["count"] = stats[i].count;
+        item["p50"] = stats[i].p50_ms;
+        item["p95"] = stats[i].p95_ms;
+        item["p99"] = stats[i].p99_ms;
+        item["max"] = stats[i].max_ms;
+        result.append(item);
+    }
+    return result;
+}
+
+QString CameraManager::exportFrameTrace(const QString& outputPath)
+{
+    QString filePath = outputPath;
+    if (QFileInfo(outputPath).isDir()) {
+        const QString ts = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+        filePath = QDir(outputPath).filePath(QString("frame_trace_%1.json").arg(ts));
+    }
+
+    const QByteArray pathBytes = filePath.toUtf8();
+    const int events = smartscope_trace_export_chrome(pathBytes.constData());
+    if (events < 0) {
+        LOG_ERROR("CameraManager", "Failed to export frame trace: ", filePath.toStdString());
+        return QString();
+    }
+    LOG_INFO("CameraManager", "Frame trace exported (", events, " events): ", filePath.toStdString());
+    return filePath;
+}
+
+void CameraManager::updateRecordStats()
+{
+    if (!m_recording) {
+        return;
+    }
+    CRecorderStats stats;
+    if (smartscope_recorder_get_stats(&stats) == 0) {
+        m_recordStats = stats;
+        emit recordStatsChanged();
+    }
 }
 
 QImage CameraManager::leftFrame() const
@@ -159,6 +305,16 @@ int CameraManager::cameraMode() const
     return m_cameraMode;
 }
 
+int CameraManager::queueDepth() const
+{
+    return m_processingStage->queueDepth();
+}
+
+qulonglong CameraManager::droppedFrames() const
+{
+    return m_processingStage->droppedFrames();
+}
+
 QPixmap CameraManager::getLeftPixmap() const
 {
     QMutexLocker locker(const_cast<QMutex*>(&m_frameMutex));
@@ -232,6 +388,9 @@ bool CameraManager::saveScreenshotSession(const QString& sessionDir)
     int saved = 0;
     uint32_t mode = smartscope_get_camera_mode();
 
+    // 拍照期间后端会直接读取相机帧，与取帧工作线程互斥
+    QMutexLocker pumpLocker(&m_pumpMutex);
+
     if (mode == StereoCamera) {
         // 由后端统一采集与处理并落盘，避免前端解码与失败边界
         QByteArray dir = sessionDir.toUtf8();
@@ -254,119 +413,161 @@ bool CameraManager::saveScreenshotSession(const QString& sessionDir)
     return saved > 0;
 }
 
-void CameraManager::updateFrames()
+void CameraManager::notifyFrameReady(uint64_t seq, uint64_t captureNs)
 {
-    // 处理相机帧数据
-    smartscope_process_camera_frames();
-
-    // 更新状态
-    updateStatus();
+    QMutexLocker locker(&m_signalMutex);
+    if (seq != 0) {
+        m_pendingSeq = seq;
+        m_pendingCaptureNs = captureNs;
+    }
+    m_pendingTick = true;
+    m_signalCond.wakeOne();
+}
 
-    bool frameUpdated = false;
-    uint32_t mode = smartscope_get_camera_mode();
+void CameraManager::startFrameWorker()
+{
+    if (m_frameWorker.joinable()) return;
+    {
+        QMutexLocker locker(&m_signalMutex);
+        m_workerStop = false;
+        m_pendingTick = false;
+    }
+    m_processingStage->start(
+        [this](ProcessedFrame&& frame) {
+            QMetaObject::invokeMethod(this, [this, frame = std::move(frame)]() mutable {
+                deliverFrame(std::move(frame));
+            }, Qt::QueuedConnection);
+        },
+        [this](const QImage& image) { return applyVideoTransforms(image); });
+    m_frameWorker = std::thread([this]() { frameWorkerLoop(); });
+    if (smartscope_register_frame_callback(this, camera_frame_ready_trampoline) != 0) {
+        LOG_ERROR("CameraManager", "Failed to register frame callback");
+    }
+}
 
-    // 根据相机模式获取对应的帧
-    if (mode == StereoCamera) {
-        // 双目模式：只处理左相机帧（当前只显示左相机）
-        // 右相机帧虽然在Rust侧读取了，但不在C++侧解码，避免浪费CPU
-        CCameraFrame leftFrame;
-        if (smartscope_get_left_frame(&leftFrame) == 0) {
-            QImage newLeftImage = processFrame(leftFrame);
-            if (!newLeftImage.isNull()) {
-                QPixmap newLeftPixmap = QPixmap::fromImage(newLeftImage);
-
-                {
-                    QMutexLocker locker(&m_frameMutex);
-                    m_leftFrame = newLeftImage;
-                    m_leftPixmap = newLeftPixmap;
-                    frameUpdated = true;
-                }
-
-                // 发送QPixmap信号给原生Widget（不需要锁，信号是异步的）
-                emit leftPixmapUpdated(newLeftPixmap);
+void CameraManager::stopFrameWorker()
+{
+    // 先停止 Rust 通知线程，确保之后不再有回调
+    smartscope_unregister_frame_callback(this);
+    {
+        QMutexLocker locker(&m_signalMutex);
+        m_workerStop = true;
+        m_signalCond.wakeAll();
+    }
+    if (m_frameWorker.joinable()) {
+        m_frameWorker.join();
+    }
+    m_processingStage->stop();
+}
 
+void CameraManager::frameWorkerLoop()
+{
+    quint64 handledSeq = 0;
+    for (;;) {
+        quint64 seq = 0;
+        quint64 captureNs = 0;
+        {
+            QMutexLocker locker(&m_signalMutex);
+            while (!m_workerStop && !m_pendingTick) {
+                m_signalCond.wait(&m_signalMutex);
             }
+            if (m_workerStop) break;
+            m_pendingTick = false;
+            seq = m_pendingSeq;
+            captureNs = m_pendingCaptureNs;
         }
 
-        // 不再主动丢弃右相机帧，保留以便拍照/立体处理使用
-
-        // 发出信号通知QML更新
-        if (frameUpdated) {
-            emit leftFrameChanged();
-        }
-    } else if (mode == SingleCamera) {
-        // 单目模式：获取单相机帧
-        CCameraFrame singleFrame;
-        if (smartscope_get_single_frame(&singleFrame) == 0) {
-            QImage newSingleImage = processFrame(singleFrame);
-            if (!newSingleImage.isNull()) {
-                QPixmap newSinglePixmap = QPixmap::fromImage(newSingleImage);
-
-                {
-                    QMutexLocker locker(&m_frameMutex);
-                    m_singleFrame = newSingleImage;
-                    m_singlePixmap = newSinglePixmap;
-                    frameUpdated = true;
-                }
-
-                // 发送QPixmap信号给原生Widget
-                emit singlePixmapUpdated(newSinglePixmap);
-
-                // PiP 缩略图改为前端直接缩放显示帧
+        FrameJob job;
+        {
+            QMutexLocker pumpLocker(&m_pumpMutex);
+            // 读取相机帧；无新帧的超时唤醒也需执行，以便处理模式切换
+            smartscope_process_camera_frames();
+            if (seq == 0 || seq == handledSeq) continue;
+            handledSeq = seq;
+
+            // 双目模式只显示左相机；右相机帧保留在 Rust 侧供拍照/立体处理使用
+            uint32_t mode = smartscope_get_camera_mode();
+            QElapsedTimer acquireTimer;
+            acquireTimer.start();
+            int rc = -1;
+            if (mode == StereoCamera) {
+                rc = smartscope_acquire_left_frame(&job.frame, &job.slotHandle);
+            } else if (mode == SingleCamera) {
+                rc = smartscope_acquire_single_frame(&job.frame, &job.slotHandle);
             }
+            if (rc != 0) continue;
+            job.mode = static_cast<int>(mode);
+            job.acquireMs = acquireTimer.nsecsElapsed() / 1e6;
         }
+        job.seq = seq;
+        job.captureNs = captureNs;
 
-        // 发出信号通知QML更新
-        if (frameUpdated) {
-            emit singleFrameChanged();
-        }
+        // 解码/变换交给处理阶段；队列满时丢弃最旧的帧，保证显示最新画面
+        m_processingStage->submit(job);
     }
-    // NoCamera模式：不获取帧数据
 }
 
-QImage CameraManager::processFrame(const CCameraFrame& frame)
+void CameraManager::deliverFrame(ProcessedFrame&& frame)
 {
-    if (frame.data == nullptr || frame.data_len == 0) {
-        return QImage();
-    }
-
-    // 检查帧格式：0 表示 RGB，其他值表示 MJPEG
-    if (frame.format == 0) {
-        // Rust端已经处理好的RGB数据（包含畸变校正和视频变换）
-        // 直接创建QImage，不需要解码或变换
-        QImage image(frame.data, frame.width, frame.height, frame.width * 3, QImage::Format_RGB888);
-
-        // 深拷贝数据（因为Rust的指针会失效）
-        return image.copy();
-    } else {
-        // 旧的MJPEG处理流程（降级模式）
-        QByteArray imageData(reinterpret_cast<const char*>(frame.data), static_cast<int>(frame.data_len));
-
-        QBuffer buffer(&imageData);
-        buffer.open(QIODevice::ReadOnly);
-
-        QImageReader reader(&buffer, "JPEG");
-        QImage image = reader.read();
-
-        if (image.isNull()) {
-            LOG_WARN("CameraManager", "Failed to decode MJPEG frame: ", reader.errorString().toStdString());
-            return QImage();
+    // 停止后到达的排队帧直接丢弃
+    if (!m_cameraRunning) return;
+
+    const int mode = frame.mode;
+    const quint64 seq = frame.seq;
+    const quint64 captureNs = frame.captureNs;
+    m_decodeMs = frame.decodeMs;
+    m_transformMs = frame.transformMs;
+
+    // QImage 直接保存（Rust 帧仍借用帧槽，不拷贝）；QPixmap 只能在 GUI 线程创建，
+    // fromImage 在格式不同时做唯一一次转换，格式相同时共享数据
+    QImage image = std::move(frame.image);
+    QPixmap pixmap = QPixmap::fromImage(image);
+    // 绘制阶段按 cacheKey 取回帧号，完成端到端打点
+    FrameTrace::tagPixmap(pixmap, frame.frameId, frame.captureTraceNs);
+
+    {
+        QMutexLocker locker(&m_frameMutex);
+        if (mode == StereoCamera) {
+            m_leftFrame = image;
+            m_leftPixmap = pixmap;
+        } else {
+            m_singleFrame = image;
+            m_singlePixmap = pixmap;
         }
+    }
 
-        // 确保图像格式适合显示
-        if (image.format() != QImage::Format_RGB888) {
-            image = image.convertToFormat(QImage::Format_RGB888);
+    // 驱动交付 → 信号发出的端到端延迟
+    if (captureNs != 0) {
+        const qint64 nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        m_frameLatencyMs = static_cast<double>(nowNs - static_cast<qint64>(captureNs)) / 1e6;
+        m_latencySumMs += m_frameLatencyMs;
+        if (m_frameLatencyMs > m_latencyMaxMs) m_latencyMaxMs = m_frameLatencyMs;
+        if (++m_latencySamples >= 300) {
+            LOG_INFO("CameraManager", "Frame latency (capture->signal) avg: ",
+                     m_latencySumMs / m_latencySamples, " ms, max: ", m_latencyMaxMs,
+                     " ms over ", m_latencySamples, " frames");
+            m_latencySumMs = 0.0;
+            m_latencyMaxMs = 0.0;
+            m_latencySamples = 0;
         }
+    }
+    m_frameSequence = seq;
 
-        // 应用视频变换（旋转、翻转、反色等）
-        image = applyVideoTransforms(image);
-
-        return image;
+    if (mode == StereoCamera) {
+        emit leftPixmapUpdated(pixmap);
+        emit leftFrameChanged();
+    } else {
+        emit singlePixmapUpdated(pixmap);
+        emit singleFrameChanged();
     }
+    emit frameStatsChanged();
 }
 
 void CameraManager::updateStatus()
 {
+    updateRecordStats();
+
     CCameraStatus status;
     if (smartscope_get_camera_status(&status) == 0) {
         bool wasRunning = m_cameraRunning;
@@ -477,6 +678,7 @@ void CameraManager::startCameraAsync()
             if (result == 0) {
                 m_cameraRunning = true;
                 m_updateTimer->start();
+                startFrameWorker();
                 emit cameraRunningChanged();
                 LOG_INFO("CameraManager", "Camera system started (async)");
             } else {
@@ -494,7 +696,10 @@ void CameraManager::stopCameraAsync()
     }
     m_stopping = true;
     LOG_INFO("CameraManager", "stopCameraAsync: spawning worker");
+    // 与同步路径一致：录制依赖相机帧流，先完成文件写入
+    stopVideoRecording();
     m_updateTimer->stop();
+    stopFrameWorker();
     std::thread([this]() {
         int result = smartscope_stop_camera();
         QMetaObject::invokeMethod(this, [this, result]() {
@@ -514,6 +719,7 @@ void CameraManager::stopCameraAsync()
                 LOG_INFO("CameraManager", "Camera system stopped (async)");
             } else {
                 m_updateTimer->start();
+                startFrameWorker();
                 LOG_ERROR("CameraManager", "Camera stop (async) failed, code: ", result);
             }
         });
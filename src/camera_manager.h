@@ -6,7 +6,13 @@
 #include <QPixmap>
 #include <QTimer>
 #include <QMutex>
+#include <QWaitCondition>
+#include <QVariantList>
 #include <memory>
+#include <thread>
+
+struct ProcessedFrame;
+class FrameProcessingStage;
 
 // C FFI declarations
 extern "C" {
@@ -24,6 +30,7 @@ extern "C" {
         uint32_t format;
         uint64_t timestamp_sec;
         uint32_t timestamp_nsec;
+        uint64_t frame_id;       // 相机帧号（逐帧追踪）
     };
 
     struct CCameraStatus {
@@ -47,6 +54,37 @@ extern "C" {
     int smartscope_stereo_snapshot(CCameraFrame* left_out, CCameraFrame* right_out);
     int smartscope_stereo_raw_snapshot(CCameraFrame* left_out, CCameraFrame* right_out);
 
+    // 零拷贝取帧：借用 Rust 共享帧环中的槽，用完调用 smartscope_release_frame 归还
+    int smartscope_acquire_left_frame(CCameraFrame* frame_out, void** handle_out);
+    int smartscope_acquire_right_frame(CCameraFrame* frame_out, void** handle_out);
+    int smartscope_acquire_single_frame(CCameraFrame* frame_out, void** handle_out);
+    void smartscope_release_frame(void* handle);
+    uint64_t smartscope_frame_ring_dropped_count();
+
+    // 新帧推送：Rust 通知线程在每个新帧（或 100ms 无帧超时，seq=0）时回调
+    typedef void (*smartscope_frame_cb)(void* ctx, uint64_t seq, uint64_t capture_ns);
+    int smartscope_register_frame_callback(void* ctx, smartscope_frame_cb cb);
+    void smartscope_unregister_frame_callback(void* ctx);
+
+    // 相机视频录制：压缩帧在 Rust 取帧时直接送入编码队列
+    struct CRecorderStats {
+        uint64_t frames_written;
+        uint64_t frames_dropped;
+        uint64_t bytes_written;
+        uint32_t queue_depth;
+        uint64_t elapsed_ms;
+        double write_bytes_per_sec;
+    };
+
+    int smartscope_recorder_start(const char* output_path, int codec); // codec: 0 MJPEG直通, 1 软件H.264
+    int smartscope_recorder_stop();
+    bool smartscope_recorder_is_recording();
+    int smartscope_recorder_get_stats(CRecorderStats* stats_out);
+
+    // 原始帧转储（.ssdump），供 [camera] source = "replay" 回放
+    int smartscope_camera_dump_start(const char* output_path);
+    int smartscope_camera_dump_stop();
+
 }
 
 class CameraManager : public QObject
@@ -59,6 +97,19 @@ class CameraManager : public QObject
     Q_PROPERTY(bool leftConnected READ leftConnected NOTIFY leftConnectedChanged)
     Q_PROPERTY(bool rightConnected READ rightConnected NOTIFY rightConnectedChanged)
     Q_PROPERTY(int cameraMode READ cameraMode NOTIFY cameraModeChanged)
+    Q_PROPERTY(double frameLatencyMs READ frameLatencyMs NOTIFY frameStatsChanged)
+    Q_PROPERTY(qulonglong frameSequence READ frameSequence NOTIFY frameStatsChanged)
+    Q_PROPERTY(double decodeMs READ decodeMs NOTIFY frameStatsChanged)
+    Q_PROPERTY(double transformMs READ transformMs NOTIFY frameStatsChanged)
+    Q_PROPERTY(int queueDepth READ queueDepth NOTIFY frameStatsChanged)
+    Q_PROPERTY(qulonglong droppedFrames READ droppedFrames NOTIFY frameStatsChanged)
+    Q_PROPERTY(bool recording READ isRecording NOTIFY recordingChanged)
+    Q_PROPERTY(QString recordingPath READ recordingPath NOTIFY recordingChanged)
+    Q_PROPERTY(qulonglong recordFramesWritten READ recordFramesWritten NOTIFY recordStatsChanged)
+    Q_PROPERTY(qulonglong recordDroppedFrames READ recordDroppedFrames NOTIFY recordStatsChanged)
+    Q_PROPERTY(double recordBytesPerSec READ recordBytesPerSec NOTIFY recordStatsChanged)
+    Q_PROPERTY(qulonglong recordElapsedMs READ recordElapsedMs NOTIFY recordStatsChanged)
+    Q_PROPERTY(bool frameTraceEnabled READ frameTraceEnabled WRITE setFrameTraceEnabled NOTIFY frameTraceEnabledChanged)
 
 public:
     explicit CameraManager(QObject *parent = nullptr);
@@ -69,10 +120,29 @@ public:
     Q_INVOKABLE void startCameraAsync();
     Q_INVOKABLE void stopCameraAsync();
 
-    // Video recording controls (Rust FFI-backed)
-    Q_INVOKABLE bool startVideoRecording(const QString& outputPath);
+    // 相机视频录制（Rust 录制引擎）
+    // outputPath 为目录时自动生成 camera_<时间戳>.mkv；.avi 后缀写 AVI
+    Q_INVOKABLE bool startVideoRecording(const QString& outputPath, bool softwareH264 = false);
     Q_INVOKABLE bool stopVideoRecording();
     Q_INVOKABLE bool isRecording() const;
+    QString recordingPath() const { return m_recordingPath; }
+    qulonglong recordFramesWritten() const { return m_recordStats.frames_written; }
+    qulonglong recordDroppedFrames() const { return m_recordStats.frames_dropped; }
+    double recordBytesPerSec() const { return m_recordStats.write_bytes_per_sec; }
+    qulonglong recordElapsedMs() const { return m_recordStats.elapsed_ms; }
+
+    // 原始帧转储（回放测试数据采集）
+    Q_INVOKABLE bool startFrameDump(const QString& outputPath);
+    Q_INVOKABLE bool stopFrameDump();
+
+    // 逐帧流水线追踪（采集 → 解码 → 校正 → 变换 → FFI → QImage → 绘制，及 AI 提交/结果）
+    bool frameTraceEnabled() const;
+    void setFrameTraceEnabled(bool enabled);
+    // 各阶段滚动分位数：[{stage, count, p50, p95, p99, max}]（毫秒）
+    Q_INVOKABLE QVariantList frameTraceStats() const;
+    // 导出 Chrome Trace JSON；outputPath 为目录时自动生成 frame_trace_<时间戳>.json
+    // 返回写入的文件路径，失败返回空字符串
+    Q_INVOKABLE QString exportFrameTrace(const QString& outputPath);
 
     QImage leftFrame() const;
     QImage rightFrame() const;
@@ -81,6 +151,15 @@ public:
     bool leftConnected() const;
     bool rightConnected() const;
     int cameraMode() const;
+    double frameLatencyMs() const { return m_frameLatencyMs; }
+    qulonglong frameSequence() const { return m_frameSequence; }
+    double decodeMs() const { return m_decodeMs; }
+    double transformMs() const { return m_transformMs; }
+    int queueDepth() const;
+    qulonglong droppedFrames() const;
+
+    // 由 Rust 帧通知线程调用（线程安全）：唤醒取帧工作线程
+    void notifyFrameReady(uint64_t seq, uint64_t captureNs);
 
     // 获取QPixmap用于原生Qt Widget显示
     QPixmap getLeftPixmap() const;
@@ -98,6 +177,10 @@ signals:
     void leftConnectedChanged();
     void rightConnectedChanged();
     void cameraModeChanged();
+    void frameStatsChanged();
+    void recordingChanged();
+    void recordStatsChanged();
+    void frameTraceEnabledChanged();
 
     // 新增：用于原生Qt Widget的QPixmap信号
     void leftPixmapUpdated(const QPixmap& pixmap);
@@ -106,17 +189,20 @@ signals:
     // Thumbnail signal removed; front-end reuses display frame
 
 private slots:
-    void updateFrames();
+    void updateStatus();
+    void updateRecordStats();
 
 private:
-    QImage processFrame(const CCameraFrame& frame);
+    void startFrameWorker();
+    void stopFrameWorker();
+    void frameWorkerLoop();
+    void deliverFrame(ProcessedFrame&& frame);
     QImage decodeRawFrame(const CCameraFrame& frame);
     bool saveRawFrameToFile(const CCameraFrame& frame, const QString& basePathNoExt);
     QImage applyVideoTransforms(const QImage& image);
     QImage recoverOriginalFromProcessed(const QImage& processed);
-    void updateStatus();
 
-    QTimer* m_updateTimer;
+    QTimer* m_updateTimer;   // 仅用于状态轮询，帧由推送驱动
     bool m_starting = false;
     bool m_stopping = false;
     QImage m_leftFrame;      // QImage用于QML
@@ -130,6 +216,31 @@ private:
     bool m_rightConnected;
     int m_cameraMode;
     QMutex m_frameMutex;
+
+    // 取帧工作线程（由 Rust 新帧回调唤醒）
+    std::thread m_frameWorker;
+    QMutex m_signalMutex;
+    QWaitCondition m_signalCond;
+    bool m_workerStop = false;
+    bool m_pendingTick = false;
+    quint64 m_pendingSeq = 0;
+    quint64 m_pendingCaptureNs = 0;
+    // 串行化对 Rust 相机读取器的访问（工作线程取帧 / GUI 线程拍照）
+    QMutex m_pumpMutex;
+    // 解码/变换阶段（取帧线程 → 处理线程 → GUI 线程）
+    std::unique_ptr<FrameProcessingStage> m_processingStage;
+    double m_decodeMs = 0.0;
+    double m_transformMs = 0.0;
+
+    double m_frameLatencyMs = 0.0;
+    quint64 m_frameSequence = 0;
+    double m_latencySumMs = 0.0;
+    double m_latencyMaxMs = 0.0;
+    int m_latencySamples = 0;
+
+    bool m_recording = false;
+    QString m_recordingPath;
+    CRecorderStats m_recordStats = {};
 };
 
 #endif // CAMERA_MANAGER_H
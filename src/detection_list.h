@@ -0,0 +1,46 @@
+#ifndef DETECTION_LIST_H
+#define DETECTION_LIST_H
+
+#include <QMetaType>
+#include <QVector>
+
+#include <algorithm>
+
+extern "C" {
+    #include "smartscope.h"
+}
+
+/**
+ * @brief 一次推理结果的检测框列表（值类型）
+ *
+ * 直接保存 Rust 侧的 smartscope_CDetection（POD），每批结果只有一次连续分配；
+ * 依赖 QVector 的隐式共享跨线程传递（排队信号、QML 属性）时不复制元素。
+ */
+class DetectionList
+{
+public:
+    DetectionList() = default;
+    DetectionList(const smartscope_CDetection* dets, int count)
+    {
+        if (dets && count > 0) {
+            m_items.resize(count);
+            std::copy(dets, dets + count, m_items.begin());
+        }
+    }
+    explicit DetectionList(QVector<smartscope_CDetection> items) : m_items(std::move(items)) {}
+
+    int size() const { return m_items.size(); }
+    bool isEmpty() const { return m_items.isEmpty(); }
+    const smartscope_CDetection& at(int i) const { return m_items.at(i); }
+    const smartscope_CDetection* constData() const { return m_items.constData(); }
+
+    QVector<smartscope_CDetection>::const_iterator begin() const { return m_items.constBegin(); }
+    QVector<smartscope_CDetection>::const_iterator end() const { return m_items.constEnd(); }
+
+private:
+    QVector<smartscope_CDetection> m_items;
+};
+
+Q_DECLARE_METATYPE(DetectionList)
+
+#endif // DETECTION_LIST_H
@@ -0,0 +1,105 @@
+#include "detection_list_model.h"
+
+DetectionListModel::DetectionListModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int DetectionListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_detections.size();
+}
+
+QVariant DetectionListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_detections.size()) {
+        return QVariant();
+    }
+    const smartscope_CDetection& d = m_detections.at(index.row());
+    const int cls = d.class_id;
+    switch (role) {
+    case LeftRole: return d.left;
+    case TopRole: return d.top;
+    case RightRole: return d.right;
+    case BottomRole: return d.bottom;
+    case ConfidenceRole: return d.confidence;
+    case ClassIdRole: return cls;
+    case LabelZhRole: return (cls >= 0 && cls < m_labelsZh.size()) ? m_labelsZh[cls] : QString();
+    case LabelEnRole: return (cls >= 0 && cls < m_labelsEn.size()) ? m_labelsEn[cls] : QString();
+    case LabelRole: return label(cls);
+    default:
+        return QVariant();
+    }
+}
+
+QString DetectionListModel::label(int cls) const
+{
+    // 中文优先，与旧 QVariantMap 的 label 字段一致
+    if (cls >= 0 && cls < m_labelsZh.size()) return m_labelsZh[cls];
+    if (cls >= 0 && cls < m_labelsEn.size()) return m_labelsEn[cls];
+    return QString("class_%1").arg(cls);
+}
+
+QString DetectionListModel::displayLabel(int classId, bool english) const
+{
+    const QVector<QString>& names = english ? m_labelsEn : m_labelsZh;
+    if (classId >= 0 && classId < names.size() && !names[classId].isEmpty()) {
+        return names[classId];
+    }
+    return label(classId);
+}
+
+QHash<int, QByteArray> DetectionListModel::roleNames() const
+{
+    return {
+        {LeftRole, "left"},
+        {TopRole, "top"},
+        {RightRole, "right"},
+        {BottomRole, "bottom"},
+        {ConfidenceRole, "confidence"},
+        {ClassIdRole, "classId"},
+        {LabelRole, "label"},
+        {LabelZhRole, "labelZh"},
+        {LabelEnRole, "labelEn"},
+    };
+}
+
+void DetectionListModel::setDetections(const DetectionList& detections)
+{
+    const int oldCount = m_detections.size();
+    const int newCount = detections.size();
+
+    if (oldCount == newCount) {
+        m_detections = detections;
+        if (newCount > 0) {
+            emit dataChanged(index(0), index(newCount - 1));
+        }
+        emit detectionsChanged();
+        return;
+    }
+
+    // 条数变化时只增删差额部分，保留已有行的委托
+    if (newCount > oldCount) {
+        beginInsertRows(QModelIndex(), oldCount, newCount - 1);
+        m_detections = detections;
+        endInsertRows();
+    } else {
+        beginRemoveRows(QModelIndex(), newCount, oldCount - 1);
+        m_detections = detections;
+        endRemoveRows();
+    }
+    if (oldCount > 0 && newCount > 0) {
+        emit dataChanged(index(0), index(qMin(oldCount, newCount) - 1));
+    }
+    emit countChanged();
+    emit detectionsChanged();
+}
+
+void DetectionListModel::setLabels(const QVector<QString>& labelsEn, const QVector<QString>& labelsZh)
+{
+    beginResetModel();
+    m_labelsEn = labelsEn;
+    m_labelsZh = labelsZh;
+    endResetModel();
+    emit labelsChanged();
+}
@@ -0,0 +1,64 @@
+#ifndef DETECTION_LIST_MODEL_H
+#define DETECTION_LIST_MODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QVector>
+
+#include "detection_list.h"
+
+/**
+ * @brief 向 QML 暴露最新检测结果的轻量列表模型
+ *
+ * 只持有一个 DetectionList（隐式共享），标签在 data() 中按类别ID查表返回，
+ * 不为每个检测框构造 QVariantMap。条数不变时只发 dataChanged，
+ * 让 Repeater 复用已有委托。
+ */
+class DetectionListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum Roles {
+        LeftRole = Qt::UserRole + 1,
+        TopRole,
+        RightRole,
+        BottomRole,
+        ConfidenceRole,
+        ClassIdRole,
+        LabelRole,
+        LabelZhRole,
+        LabelEnRole
+    };
+
+    explicit DetectionListModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void setDetections(const DetectionList& detections);
+    const DetectionList& detections() const { return m_detections; }
+
+    // 类别名称表（英文/中文，按类别ID索引）
+    void setLabels(const QVector<QString>& labelsEn, const QVector<QString>& labelsZh);
+
+    // 显示用标签：所选语言的名称，缺失时退回 label 角色（中文优先，再英文，再 class_N）
+    QString displayLabel(int classId, bool english) const;
+
+signals:
+    void countChanged();
+    // 每次 setDetections / setLabels 后发出，供不走 Repeater 的直接使用者（QmlVideoItem）整体同步
+    void detectionsChanged();
+    void labelsChanged();
+
+private:
+    QString label(int cls) const;
+
+    DetectionList m_detections;
+    QVector<QString> m_labelsEn;
+    QVector<QString> m_labelsZh;
+};
+
+#endif // DETECTION_LIST_MODEL_H
@@ -0,0 +1,208 @@
+#include "detection_overlay.h"
+#include <QFont>
+#include <QFontMetrics>
+#include <QPainter>
+#include <QQuickWindow>
+#include <QSGImageNode>
+#include <QSGRectangleNode>
+#include <QSGTexture>
+
+namespace {
+constexpr int kLabelPixelSize = 36;
+constexpr qreal kGlowWidth = 8.0;
+constexpr qreal kEdgeWidth = 3.0;
+constexpr int kPaletteSize = 10;
+
+/**
+ * @brief 单个检测框：外发光与描边各 4 条矩形边 + 标签图像
+ */
+class BoxNode : public QSGNode
+{
+public:
+    explicit BoxNode(QQuickWindow* win)
+    {
+        for (QSGRectangleNode*& n : glow) {
+            n = win->createRectangleNode();
+            appendChildNode(n);
+        }
+        for (QSGRectangleNode*& n : edge) {
+            n = win->createRectangleNode();
+            appendChildNode(n);
+        }
+        label = win->createImageNode();
+        label->setFiltering(QSGTexture::Linear);
+        appendChildNode(label);
+    }
+
+    void update(const QRectF& r, const QColor& color, QSGTexture* labelTexture)
+    {
+        QColor glowColor = color; glowColor.setAlpha(90);
+        QColor edgeColor = color; edgeColor.setAlpha(220);
+        QRectF rects[4];
+        DetectionOverlayRenderer::frameEdgeRects(r, kGlowWidth, rects);
+        for (int i = 0; i < 4; ++i) {
+            glow[i]->setRect(rects[i]);
+            glow[i]->setColor(glowColor);
+        }
+        DetectionOverlayRenderer::frameEdgeRects(r, kEdgeWidth, rects);
+        for (int i = 0; i < 4; ++i) {
+            edge[i]->setRect(rects[i]);
+            edge[i]->setColor(edgeColor);
+        }
+        if (label->texture() != labelTexture) {
+            label->setTexture(labelTexture);
+        }
+        const QSizeF ls(labelTexture->textureSize());
+        label->setSourceRect(QRectF(QPointF(0, 0), ls));
+        label->setRect(QRectF(r.topLeft() + QPointF(2, 2), ls));
+    }
+
+    QSGRectangleNode* glow[4];
+    QSGRectangleNode* edge[4];
+    QSGImageNode* label = nullptr;
+};
+}
+
+QColor DetectionOverlayRenderer::classColor(int classId)
+{
+    static const QColor colors[kPaletteSize] = {
+        QColor(255,59,48), QColor(52,199,89), QColor(0,122,255), QColor(255,149,0),
+        QColor(175,82,222), QColor(90,200,250), QColor(255,204,0), QColor(255,45,85),
+        QColor(48,209,88), QColor(100,210,255)
+    };
+    return colors[qAbs(classId) % kPaletteSize];
+}
+
+qreal DetectionOverlayRenderer::glowWidth()
+{
+    return kGlowWidth;
+}
+
+qreal DetectionOverlayRenderer::edgeWidth()
+{
+    return kEdgeWidth;
+}
+
+int DetectionOverlayRenderer::labelPixelSize()
+{
+    return kLabelPixelSize;
+}
+
+void DetectionOverlayRenderer::setClassLabel(int classId, const QString& label)
+{
+    auto it = m_classLabels.find(classId);
+    if (it != m_classLabels.end() && it.value() == label) return;
+    m_classLabels.insert(classId, label);
+    m_labelCache.remove(classId);
+}
+
+void DetectionOverlayRenderer::setFrameGeometry(const QSize& frameSize, int modelInputSize)
+{
+    m_frameSize = frameSize;
+    m_modelInputSize = modelInputSize;
+}
+
+const QString& DetectionOverlayRenderer::labelText(int classId)
+{
+    auto it = m_labelCache.constFind(classId);
+    if (it != m_labelCache.constEnd()) return it.value();
+
+    const QString name = m_classLabels.value(classId);
+    return m_labelCache.insert(classId, name.isEmpty() ? QString::number(classId) : name).value();
+}
+
+QRectF DetectionOverlayRenderer::displayRect(const OverlayBox& box, const QRectF& destRect) const
+{
+    // 将模型输入坐标系映射回原始帧大小，再映射到显示矩形
+    const qreal ow = m_frameSize.width();
+    const qreal oh = m_frameSize.height();
+    const qreal modelW = qMax(1, m_modelInputSize);
+    const qreal modelH = modelW; // 目前假设正方形 640x640
+    const qreal scale = qMin(modelW / ow, modelH / oh);
+    const qreal xOff = (modelW - ow * scale) / 2.0;
+    const qreal yOff = (modelH - oh * scale) / 2.0;
+
+    const qreal xl = qBound<qreal>(0.0, (box.left - xOff) / scale, ow);
+    const qreal xr = qBound<qreal>(0.0, (box.right - xOff) / scale, ow);
+    const qreal yt = qBound<qreal>(0.0, (box.top - yOff) / scale, oh);
+    const qreal yb = qBound<qreal>(0.0, (box.bottom - yOff) / scale, oh);
+
+    const qreal sx = destRect.width() / ow;
+    const qreal sy = destRect.height() / oh;
+    return QRectF(destRect.left() + xl * sx, destRect.top() + yt * sy,
+                  (xr - xl) * sx, (yb - yt) * sy);
+}
+
+void DetectionOverlayRenderer::frameEdgeRects(const QRectF& r, qreal width, QRectF (&edges)[4])
+{
+    const qreal h = width / 2.0;
+    edges[0] = QRectF(r.left() - h, r.top() - h, r.width() + width, width);      // 上
+    edges[1] = QRectF(r.left() - h, r.bottom() - h, r.width() + width, width);   // 下
+    edges[2] = QRectF(r.left() - h, r.top() + h, width, r.height() - width);     // 左
+    edges[3] = QRectF(r.right() - h, r.top() + h, width, r.height() - width);    // 右
+    for (QRectF& e : edges) {
+        if (e.width() <= 0 || e.height() <= 0) e = QRectF();
+    }
+}
+
+QImage DetectionOverlayRenderer::renderLabelImage(const QString& text, int pixelSize, const QColor& textColor,
+                                                  const QColor& background)
+{
+    QFont f;
+    f.setPixelSize(pixelSize);
+    f.setBold(true);
+    QFontMetrics fm(f);
+    const int tw = fm.horizontalAdvance(text) + 12;
+    const int th = fm.height() + 6;
+    QImage img(tw, th, QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::transparent);
+    QPainter p(&img);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setPen(Qt::NoPen);
+    p.setBrush(background);
+    p.drawRoundedRect(QRectF(0, 0, tw, th), 4, 4);
+    p.setFont(f);
+    p.setPen(textColor);
+    p.drawText(QRectF(6, 2, tw - 12, th - 4), Qt::AlignVCenter | Qt::AlignLeft, text);
+    p.end();
+    return img;
+}
+
+DetectionBoxesNode::~DetectionBoxesNode()
+{
+    qDeleteAll(m_labelTextures);
+}
+
+void DetectionBoxesNode::update(QQuickWindow* win, DetectionOverlayRenderer& overlay, const QRectF& destRect)
+{
+    const QVector<OverlayBox>& boxes = overlay.boxes();
+    const int count = destRect.isEmpty() ? 0 : boxes.size();
+
+    // 逐框复用节点：多余的删除，不足的补建；标签纹理只在新文本首次出现时生成
+    int existing = childCount();
+    while (existing > count) {
+        QSGNode* last = lastChild();
+        removeChildNode(last);
+        delete last;
+        --existing;
+    }
+    QSGNode* child = firstChild();
+    for (int i = 0; i < count; ++i) {
+        BoxNode* node = static_cast<BoxNode*>(child);
+        if (!node) {
+            node = new BoxNode(win);
+            appendChildNode(node);
+        }
+        child = node->nextSibling();
+
+        const OverlayBox& box = boxes[i];
+        const QString& text = overlay.labelText(box.classId);
+        QSGTexture*& labelTexture = m_labelTextures[text];
+        if (!labelTexture) {
+            labelTexture = win->createTextureFromImage(
+                renderLabelImage(text, kLabelPixelSize, Qt::white, QColor(0, 0, 0, 160)),
+                QQuickWindow::TextureHasAlphaChannel);
+        }
+        node->update(overlay.displayRect(box, destRect), classColor(box.classId), labelTexture);
+    }
+}
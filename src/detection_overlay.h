@@ -0,0 +1,95 @@
+#ifndef DETECTION_OVERLAY_H
+#define DETECTION_OVERLAY_H
+
+#include <QColor>
+#include <QHash>
+#include <QImage>
+#include <QRectF>
+#include <QSGNode>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+class QQuickWindow;
+class QSGTexture;
+
+// 单个检测框（模型输入坐标系，与 smartscope_CDetection 对应）
+struct OverlayBox {
+    float left = 0.f;
+    float top = 0.f;
+    float right = 0.f;
+    float bottom = 0.f;
+    float confidence = 0.f;
+    int classId = 0;
+};
+
+/**
+ * @brief 检测框叠加层的数据与几何
+ *
+ * - 检测框以类型化数组保存，由 QmlVideoItem 从 DetectionListModel 直接转换，不经过 QVariantMap
+ * - 负责模型坐标 -> 帧坐标 -> 显示矩形的映射，以及按类别ID缓存的标签文本
+ * - 描边样式与标签图像由 DetectionBoxesNode 使用
+ */
+class DetectionOverlayRenderer
+{
+public:
+    void setBoxes(const QVector<OverlayBox>& boxes) { m_boxes = boxes; }
+    const QVector<OverlayBox>& boxes() const { return m_boxes; }
+
+    // 设置类别显示名称（为空时显示类别ID）；名称变化会使该类别的缓存失效
+    void setClassLabel(int classId, const QString& label);
+
+    // 原始帧尺寸与模型输入尺寸（用于把模型坐标反映射到帧坐标）
+    void setFrameGeometry(const QSize& frameSize, int modelInputSize);
+
+    // 检测框在显示坐标系中的矩形（模型坐标 -> 帧坐标 -> destRect）
+    QRectF displayRect(const OverlayBox& box, const QRectF& destRect) const;
+
+    // 类别的标签文本（未设置名称时为类别ID）
+    const QString& labelText(int classId);
+
+    static QColor classColor(int classId);
+
+    // 描边样式
+    static qreal glowWidth();
+    static qreal edgeWidth();
+    static int labelPixelSize();
+
+    // 以 4 条矩形边表示空心框（线宽居中于边界）；过窄的边返回空矩形
+    static void frameEdgeRects(const QRectF& r, qreal width, QRectF (&edges)[4]);
+
+    // 圆角背景 + 粗体文字的标签图像（检测标签与占位文字共用）
+    static QImage renderLabelImage(const QString& text, int pixelSize, const QColor& textColor,
+                                   const QColor& background);
+
+private:
+    QVector<OverlayBox> m_boxes;
+    QHash<int, QString> m_classLabels;
+    QHash<int, QString> m_labelCache;
+    QSize m_frameSize;
+    int m_modelInputSize = 640;
+};
+
+/**
+ * @brief 检测框叠加层的场景图节点
+ *
+ * 每个检测框一个子节点（外发光与描边各 4 条矩形边 + 标签图像），跨检测更新复用：
+ * 框数变化时只增删差额，检测更新只修改矩形与颜色，不光栅化整幅图层。
+ * 标签纹理按文本缓存，数量受类别数限制。只使用后端无关的节点类型。
+ * 必须在场景图同步阶段（或场景图已初始化的 GUI 线程渲染循环中）更新。
+ */
+class DetectionBoxesNode : public QSGNode
+{
+public:
+    ~DetectionBoxesNode() override;
+
+    // 按 overlay 中的检测框重建子节点；destRect 为空时移除全部框
+    void update(QQuickWindow* win, DetectionOverlayRenderer& overlay, const QRectF& destRect);
+
+    int labelTextureCount() const { return m_labelTextures.size(); }
+
+private:
+    QHash<QString, QSGTexture*> m_labelTextures;
+};
+
+#endif // DETECTION_OVERLAY_H
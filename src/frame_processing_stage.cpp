@@ -0,0 +1,160 @@
+#include "frame_processing_stage.h"
+#include "frame_trace.h"
+#include "logger.h"
+#include <QBuffer>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QImageReader>
+
+namespace {
+
+// QImage 清理回调：借用的帧数据不再被任何 QImage 引用时归还帧槽
+void releaseFrameSlot(void* slotHandle)
+{
+    smartscope_release_frame(slotHandle);
+}
+
+} // namespace
+
+FrameProcessingStage::FrameProcessingStage(size_t capacity)
+    : m_capacity(capacity > 0 ? capacity : 1)
+{
+}
+
+FrameProcessingStage::~FrameProcessingStage()
+{
+    stop();
+}
+
+void FrameProcessingStage::start(Sink sink, Transform transform)
+{
+    if (m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = false;
+    }
+    m_sink = std::move(sink);
+    m_transform = std::move(transform);
+    m_thread = std::thread([this]() { run(); });
+}
+
+void FrameProcessingStage::stop()
+{
+    std::deque<FrameJob> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        pending.swap(m_queue);
+    }
+    m_cond.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    for (const FrameJob& job : pending) {
+        smartscope_release_frame(job.slotHandle);
+    }
+}
+
+void FrameProcessingStage::submit(const FrameJob& job)
+{
+    void* droppedHandle = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop) {
+            droppedHandle = job.slotHandle;
+        } else {
+            if (m_queue.size() >= m_capacity) {
+                droppedHandle = m_queue.front().slotHandle;
+                m_queue.pop_front();
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+            m_queue.push_back(job);
+        }
+    }
+    m_cond.notify_one();
+    // 在锁外归还，避免与 Rust 侧锁交叉
+    smartscope_release_frame(droppedHandle);
+}
+
+int FrameProcessingStage::queueDepth() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_queue.size());
+}
+
+void FrameProcessingStage::run()
+{
+    for (;;) {
+        FrameJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+            if (m_stop) break;
+            job = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        ProcessedFrame out = process(job);
+        if (!out.image.isNull() && m_sink) {
+            m_sink(std::move(out));
+        }
+    }
+}
+
+ProcessedFrame FrameProcessingStage::process(const FrameJob& job)
+{
+    ProcessedFrame out;
+    out.mode = job.mode;
+    out.seq = job.seq;
+    out.captureNs = job.captureNs;
+
+    const CCameraFrame& frame = job.frame;
+    if (frame.data == nullptr || frame.data_len == 0) {
+        smartscope_release_frame(job.slotHandle);
+        return out;
+    }
+    out.frameId = frame.frame_id;
+    out.captureTraceNs = smartscope_trace_from_unix_ns(
+        frame.timestamp_sec * 1000000000ULL + frame.timestamp_nsec);
+    const quint64 traceStartNs = FrameTrace::nowNs();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QImage image;
+    if (frame.format == 0) {
+        // Rust端已经处理好的RGB数据（包含畸变校正和视频变换），解码耗时即取帧耗时
+        // 直接借用帧槽、保持 RGB888 不做拷贝；最后一个共享该数据的 QImage 析构时归还帧槽
+        image = QImage(frame.data, frame.width, frame.height, frame.width * 3, QImage::Format_RGB888,
+                       releaseFrameSlot, job.slotHandle);
+        out.decodeMs = job.acquireMs;
+        out.transformMs = timer.nsecsElapsed() / 1e6;
+    } else {
+        // 旧的MJPEG处理流程（降级模式）
+        QByteArray imageData = QByteArray::fromRawData(reinterpret_cast<const char*>(frame.data),
+                                                       static_cast<int>(frame.data_len));
+        QBuffer buffer(&imageData);
+        buffer.open(QIODevice::ReadOnly);
+        QImageReader reader(&buffer, "JPEG");
+        image = reader.read();
+        buffer.close();
+        smartscope_release_frame(job.slotHandle);
+        out.decodeMs = job.acquireMs + timer.nsecsElapsed() / 1e6;
+
+        if (image.isNull()) {
+            LOG_WARN("FrameProcessingStage", "Failed to decode MJPEG frame: ", reader.errorString().toStdString());
+            return out;
+        }
+
+        timer.restart();
+        // 应用视频变换（旋转、翻转、反色等）
+        if (m_transform) {
+            image = m_transform(image);
+        }
+        out.transformMs = timer.nsecsElapsed() / 1e6;
+    }
+
+    FrameTrace::record(out.frameId, SMARTSCOPE_TRACE_QIMAGE, traceStartNs, FrameTrace::nowNs());
+    out.image = std::move(image);
+    return out;
+}
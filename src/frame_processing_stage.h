@@ -0,0 +1,71 @@
+#ifndef FRAME_PROCESSING_STAGE_H
+#define FRAME_PROCESSING_STAGE_H
+
+#include <QImage>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "camera_manager.h"
+
+// 待处理帧：借用自 Rust 帧环（slotHandle 由处理阶段负责归还）
+struct FrameJob {
+    CCameraFrame frame;
+    void* slotHandle = nullptr;
+    int mode = 0;               // CCameraMode
+    quint64 seq = 0;
+    quint64 captureNs = 0;
+    double acquireMs = 0.0;     // Rust 侧取帧耗时（MJPEG解码 + 畸变校正 + RGA）
+};
+
+// 处理完成、可直接显示的帧
+struct ProcessedFrame {
+    QImage image;               // 保持来源格式：Rust 帧为借用帧槽的 RGB888，MJPEG 为解码输出格式
+    int mode = 0;
+    quint64 seq = 0;
+    quint64 captureNs = 0;
+    quint64 frameId = 0;
+    quint64 captureTraceNs = 0; // 帧采集时间（追踪时钟）
+    double decodeMs = 0.0;
+    double transformMs = 0.0;
+};
+
+// 帧处理阶段：有界“保留最新”队列 + 独立工作线程
+// 负责 MJPEG 降级解码和视频变换，避免占用 GUI 线程；Rust 帧不做拷贝，帧槽随 QImage 释放而归还
+class FrameProcessingStage
+{
+public:
+    using Sink = std::function<void(ProcessedFrame&&)>;
+    using Transform = std::function<QImage(const QImage&)>;
+
+    explicit FrameProcessingStage(size_t capacity = 2);
+    ~FrameProcessingStage();
+
+    void start(Sink sink, Transform transform);
+    void stop();
+
+    // 入队；队列已满时丢弃最旧的帧（并归还其帧槽）
+    void submit(const FrameJob& job);
+
+    int queueDepth() const;
+    quint64 droppedFrames() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    ProcessedFrame process(const FrameJob& job);
+
+    const size_t m_capacity;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<FrameJob> m_queue;
+    bool m_stop = false;
+    std::thread m_thread;
+    Sink m_sink;
+    Transform m_transform;
+    std::atomic<quint64> m_dropped{0};
+};
+
+#endif // FRAME_PROCESSING_STAGE_H
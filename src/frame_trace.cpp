@@ -0,0 +1,48 @@
+#include "frame_trace.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace FrameTrace {
+
+namespace {
+
+struct PixmapTag {
+    qint64 cacheKey = 0;
+    quint64 frameId = 0;
+    quint64 captureNs = 0;
+};
+
+constexpr int kMaxTags = 8;
+
+QMutex g_tagMutex;
+PixmapTag g_tags[kMaxTags];
+int g_nextTag = 0;
+
+} // namespace
+
+void tagPixmap(const QPixmap& pixmap, quint64 frameId, quint64 captureNs)
+{
+    if (pixmap.isNull()) return;
+    QMutexLocker locker(&g_tagMutex);
+    g_tags[g_nextTag] = PixmapTag{pixmap.cacheKey(), frameId, captureNs};
+    g_nextTag = (g_nextTag + 1) % kMaxTags;
+}
+
+bool takePixmapTag(const QPixmap& pixmap, quint64* frameId, quint64* captureNs)
+{
+    if (pixmap.isNull()) return false;
+    const qint64 key = pixmap.cacheKey();
+    QMutexLocker locker(&g_tagMutex);
+    for (PixmapTag& tag : g_tags) {
+        if (tag.cacheKey == key) {
+            *frameId = tag.frameId;
+            *captureNs = tag.captureNs;
+            tag.cacheKey = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace FrameTrace
@@ -0,0 +1,42 @@
+#ifndef FRAME_TRACE_H
+#define FRAME_TRACE_H
+
+#include <QPixmap>
+#include <QtGlobal>
+
+extern "C" {
+    #include "smartscope.h"
+}
+
+/**
+ * @brief 前端逐帧追踪辅助
+ *
+ * 时间统一取自 Rust 追踪时钟（smartscope_trace_now_ns），
+ * 与核心内部的解码/校正/变换打点位于同一时间轴。
+ */
+namespace FrameTrace {
+
+inline quint64 nowNs() { return smartscope_trace_now_ns(); }
+
+inline void record(quint64 frameId, smartscope_TraceStage stage, quint64 startNs, quint64 endNs)
+{
+    smartscope_trace_record(frameId, static_cast<uint32_t>(stage), startNs, endNs);
+}
+
+/**
+ * @brief 交付显示的 QPixmap 登记帧号与采集时间（追踪时钟）
+ *
+ * 显示项只收到 QPixmap，借助 cacheKey 把帧号带到绘制阶段；
+ * 只保留最近几帧，未被取走的登记会被覆盖。
+ */
+void tagPixmap(const QPixmap& pixmap, quint64 frameId, quint64 captureNs);
+
+/**
+ * @brief 取走 QPixmap 的登记（每帧只有第一个显示项能取到）
+ * @return 未登记或已被取走时返回 false
+ */
+bool takePixmapTag(const QPixmap& pixmap, quint64* frameId, quint64* captureNs);
+
+} // namespace FrameTrace
+
+#endif // FRAME_TRACE_H
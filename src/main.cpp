@@ -107,9 +107,8 @@ int main(int argc, char *argv[])
         return -1;
     }
 
-    // 连接相机输出到AI检测（显示用的pixmap即用于推理）
-    QObject::connect(cameraManager, &CameraManager::leftPixmapUpdated,
-                     aiDetectionManager, &AiDetectionManager::onLeftPixmap);
+    // 双目模式下左相机帧由Rust图像管道直接送入AI推理；
+    // 单目模式的帧在前端解码，仍由显示用的pixmap提交
     QObject::connect(cameraManager, &CameraManager::singlePixmapUpdated,
                      aiDetectionManager, &AiDetectionManager::onSinglePixmap);
 
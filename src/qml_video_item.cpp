@@ -1,158 +1,369 @@
 #include "qml_video_item.h"
+#include "frame_trace.h"
 #include <QMutexLocker>
 #include <QDebug>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QQuickWindow>
+#include <QSGImageNode>
+#include <QSGRectangleNode>
+#include <QSGRendererInterface>
+#include <QSGTexture>
 
-QmlVideoItem::QmlVideoItem(QQuickItem *parent)
-    : QQuickPaintedItem(parent)
+#ifndef GL_BGRA
+#define GL_BGRA 0x80E1
+#endif
+
+namespace {
+
+/**
+ * @brief 可复用的视频帧纹理（OpenGL后端）
+ *
+ * 尺寸与格式不变时只做 glTexSubImage2D，不重新分配纹理存储。
+ * 32位帧在支持 BGRA 的驱动上直接上传，避免逐帧格式转换。
+ */
+class VideoFrameTexture : public QSGTexture, protected QOpenGLFunctions
 {
-    // 启用抗锯齿
-    setAntialiasing(true);
-    setRenderTarget(QQuickPaintedItem::FramebufferObject);
-}
+public:
+    ~VideoFrameTexture() override
+    {
+        if (m_id && QOpenGLContext::currentContext()) {
+            glDeleteTextures(1, &m_id);
+        }
+    }
 
-QmlVideoItem::~QmlVideoItem()
+    // 必须在渲染线程、GL上下文为当前时调用（updatePaintNode 中满足）
+    void upload(const QImage& src)
+    {
+        QOpenGLContext* ctx = QOpenGLContext::currentContext();
+        if (!ctx) return;
+        if (!m_glReady) {
+            initializeOpenGLFunctions();
+            m_bgraSupported = !ctx->isOpenGLES() || ctx->hasExtension("GL_EXT_texture_format_BGRA8888");
+            m_glReady = true;
+        }
+
+        QImage img = src;
+        GLenum format = GL_RGBA;
+        switch (img.format()) {
+        case QImage::Format_RGBX8888:
+        case QImage::Format_RGBA8888:
+            format = GL_RGBA;
+            break;
+        case QImage::Format_RGB32:
+        case QImage::Format_ARGB32:
+        case QImage::Format_ARGB32_Premultiplied:
+            if (m_bgraSupported) {
+                format = GL_BGRA;
+                break;
+            }
+            Q_FALLTHROUGH();
+        default:
+            img = img.convertToFormat(QImage::Format_RGBX8888);
+            format = GL_RGBA;
+            break;
+        }
+        // GLES 的 BGRA 扩展要求内部格式与数据格式一致
+        const GLint internalFormat = (format == GL_BGRA && ctx->isOpenGLES()) ? GL_BGRA : GL_RGBA;
+
+        if (!m_id) {
+            glGenTextures(1, &m_id);
+        }
+        glBindTexture(GL_TEXTURE_2D, m_id);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        if (img.size() == m_size && format == m_format && internalFormat == m_internalFormat) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, img.width(), img.height(),
+                            format, GL_UNSIGNED_BYTE, img.constBits());
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, img.width(), img.height(), 0,
+                         format, GL_UNSIGNED_BYTE, img.constBits());
+            m_size = img.size();
+            m_format = format;
+            m_internalFormat = internalFormat;
+            m_optionsDirty = true;
+        }
+    }
+
+    int textureId() const override { return static_cast<int>(m_id); }
+    QSize textureSize() const override { return m_size; }
+    bool hasAlphaChannel() const override { return false; }
+    bool hasMipmaps() const override { return false; }
+
+    void bind() override
+    {
+        glBindTexture(GL_TEXTURE_2D, m_id);
+        updateBindOptions(m_optionsDirty);
+        m_optionsDirty = false;
+    }
+
+private:
+    GLuint m_id = 0;
+    QSize m_size;
+    GLenum m_format = 0;
+    GLint m_internalFormat = 0;
+    bool m_glReady = false;
+    bool m_bgraSupported = false;
+    bool m_optionsDirty = true;
+};
+
+// 根节点：背景 / 视频 / 叠加层 / 占位文字
+class VideoRootNode : public QSGNode
 {
+public:
+    ~VideoRootNode() override
+    {
+        delete videoTexture;
+        delete placeholderTexture;
+    }
+
+    QSGRectangleNode* background = nullptr;
+    QSGImageNode* video = nullptr;
+    QSGNode* overlay = nullptr;                // 叠加层：检测框节点 + 视窗白框
+    DetectionBoxesNode* boxes = nullptr;       // 每个检测框一个子节点，跨检测更新复用
+    QSGNode* viewFrame = nullptr;
+    QSGImageNode* placeholder = nullptr;
+    QSGTexture* videoTexture = nullptr;        // 纹理由根节点持有，子节点不拥有
+    QSGTexture* placeholderTexture = nullptr;
+};
+
+void removeAllChildren(QSGNode* node)
+{
+    while (QSGNode* child = node->firstChild()) {
+        node->removeChildNode(child);
+        delete child;
+    }
 }
 
-void QmlVideoItem::paint(QPainter *painter)
+// 以 4 条矩形边绘制空心框（线宽居中于边界）；矩形节点在所有场景图后端均可用
+void appendFrameEdges(QSGNode* parent, QQuickWindow* win, const QRectF& r, qreal width, const QColor& color)
 {
-    QMutexLocker locker(&m_mutex);
+    QRectF edges[4];
+    DetectionOverlayRenderer::frameEdgeRects(r, width, edges);
+    for (const QRectF& e : edges) {
+        if (e.isEmpty()) continue;
+        QSGRectangleNode* n = win->createRectangleNode();
+        n->setRect(e);
+        n->setColor(color);
+        parent->appendChildNode(n);
+    }
+}
 
-    if (m_currentFrame.isNull()) {
-        // 绘制占位符 - 纯黑色背景
-        painter->fillRect(boundingRect(), QColor("#000000"));
+} // namespace
 
-        painter->setPen(QColor("#88C0D0"));
-        QFont font = painter->font();
-        font.setPixelSize(32);
-        painter->setFont(font);
-        painter->drawText(boundingRect(), Qt::AlignCenter, "相机未连接");
-        return;
-    }
+QmlVideoItem::QmlVideoItem(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+}
+
+QmlVideoItem::~QmlVideoItem()
+{
+}
 
+QRectF QmlVideoItem::frameDestRect() const
+{
     // 计算缩放后的矩形，保持宽高比
     QRectF targetRect = boundingRect();
-    QSizeF pixmapSize = m_currentFrame.size();
-    QSizeF scaledSize = pixmapSize.scaled(targetRect.size(), Qt::KeepAspectRatio);
+    QSizeF frameSize(m_frameWidth, m_frameHeight);
+    QSizeF scaledSize = frameSize.scaled(targetRect.size(), Qt::KeepAspectRatio);
 
     QRectF destRect;
     destRect.setSize(scaledSize);
     destRect.moveCenter(targetRect.center());
+    return destRect;
+}
+
+QSGNode *QmlVideoItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    QQuickWindow* win = window();
+    if (!win) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    VideoRootNode* root = static_cast<VideoRootNode*>(oldNode);
+    if (!root) {
+        root = new VideoRootNode;
+        root->background = win->createRectangleNode();
+        root->background->setColor(QColor("#000000"));
+        root->appendChildNode(root->background);
+        root->overlay = new QSGNode;
+        root->appendChildNode(root->overlay);
+        root->boxes = new DetectionBoxesNode;
+        root->overlay->appendChildNode(root->boxes);
+        root->viewFrame = new QSGNode;
+        root->overlay->appendChildNode(root->viewFrame);
+    }
+    root->background->setRect(boundingRect());
 
-    // 绘制QPixmap
-    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
-    painter->drawPixmap(destRect, m_currentFrame, m_currentFrame.rect());
-
-    // 绘制AI检测框（将模型输入坐标系映射回原始帧大小，再映射到显示矩形）
-    if (!m_detections.isEmpty()) {
-        auto classColor = [](int cls)->QColor{
-            static const QColor colors[] = {
-                QColor(255,59,48), QColor(52,199,89), QColor(0,122,255), QColor(255,149,0),
-                QColor(175,82,222), QColor(90,200,250), QColor(255,204,0), QColor(255,45,85),
-                QColor(48,209,88), QColor(100,210,255)
-            }; return colors[cls % (int)(sizeof(colors)/sizeof(colors[0]))];
-        };
-
-        const int ow = m_currentFrame.width();
-        const int oh = m_currentFrame.height();
-        const qreal modelW = qMax(1, m_modelInputSize);
-        const qreal modelH = modelW; // 目前假设正方形 640x640
-        const qreal scale = qMin(modelW / ow, modelH / oh);
-        const qreal newW = ow * scale;
-        const qreal newH = oh * scale;
-        const qreal xOff = (modelW - newW) / 2.0;
-        const qreal yOff = (modelH - newH) / 2.0;
-
-        // 显示缩放
-        const qreal dispScaleX = destRect.width() / ow;
-        const qreal dispScaleY = destRect.height() / oh;
-
-        painter->setRenderHint(QPainter::Antialiasing, true);
-
-        for (const QVariant& v : m_detections) {
-            const QVariantMap m = v.toMap();
-            const int cls = m.value("class_id").toInt();
-            const QString label = m.value("label").toString();
-
-            // 模型坐标
-            qreal ml = m.value("left").toReal();
-            qreal mt = m.value("top").toReal();
-            qreal mr = m.value("right").toReal();
-            qreal mb = m.value("bottom").toReal();
-
-            // 反映射到原始帧坐标
-            qreal xl = (ml - xOff) / scale; qreal yt = (mt - yOff) / scale;
-            qreal xr = (mr - xOff) / scale; qreal yb = (mb - yOff) / scale;
-
-            // 裁剪
-            xl = qBound(0.0, xl, (qreal)ow); xr = qBound(0.0, xr, (qreal)ow);
-            yt = qBound(0.0, yt, (qreal)oh); yb = qBound(0.0, yb, (qreal)oh);
-
-            // 转到显示坐标
-            QRectF r(destRect.left() + xl * dispScaleX,
-                     destRect.top() + yt * dispScaleY,
-                     (xr - xl) * dispScaleX,
-                     (yb - yt) * dispScaleY);
-
-            // 美化绘制：阴影 + 圆角框 + 半透明边
-            QColor base = classColor(cls);
-            QColor edge = base; edge.setAlpha(220);
-            QColor glow = base; glow.setAlpha(90);
-
-            QPen pen(edge, 3.0);
-            painter->setPen(pen);
-            painter->setBrush(Qt::NoBrush);
-            // 外层光晕
-            QPen glowPen(glow, 8.0);
-            painter->setPen(glowPen);
-            painter->drawRoundedRect(r, 6, 6);
-            // 主边框
-            painter->setPen(pen);
-            painter->drawRoundedRect(r, 6, 6);
-
-            // 标签绘制（框内显示，字号放大两倍，不显示置信度）
-            QString text = label.isEmpty() ? QString("%1").arg(cls) : label;
-            QFont f = painter->font(); f.setPixelSize(36); f.setBold(true); painter->setFont(f);
-            QFontMetrics fm(f);
-            int tw = fm.horizontalAdvance(text) + 12;
-            int th = fm.height() + 6;
-            QRectF tb(r.left() + 2, r.top() + 2, tw, th);
-            QColor bg(0,0,0,160);
-            painter->setPen(Qt::NoPen);
-            painter->setBrush(bg);
-            painter->drawRoundedRect(tb, 4, 4);
-            painter->setPen(QPen(Qt::white));
-            painter->drawText(tb.adjusted(6, 2, -6, -2), Qt::AlignVCenter|Qt::AlignLeft, text);
+    QImage frame;
+    bool frameDirty = false;
+    bool traceTagged = false;
+    quint64 traceFrameId = 0;
+    quint64 traceCaptureNs = 0;
+    quint64 traceHandoffNs = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        frame = m_currentFrame;
+        frameDirty = m_frameDirty;
+        m_frameDirty = false;
+        if (frameDirty && m_traceTagged) {
+            traceTagged = true;
+            traceFrameId = m_traceFrameId;
+            traceCaptureNs = m_traceCaptureNs;
+            traceHandoffNs = m_traceHandoffNs;
+            m_traceTagged = false;
         }
     }
 
-    // 绘制视窗白框（当前主画面可见区域）
-    if (m_frameWidth > 0 && m_frameHeight > 0 && m_viewWindow.width() > 0 && m_viewWindow.height() > 0) {
-        const qreal sx = destRect.width() / m_frameWidth;
-        const qreal sy = destRect.height() / m_frameHeight;
-        QRectF vr(destRect.left() + m_viewWindow.left() * sx,
-                  destRect.top() + m_viewWindow.top() * sy,
-                  m_viewWindow.width() * sx,
-                  m_viewWindow.height() * sy);
-        // 当视窗等同于显示区域（或非常接近）时，不绘制内部白框，避免与外层边框重叠产生双线
-        const qreal tol = 4.0; // 放宽容差
-        // 判定1：比较映射后矩形与显示矩形
-        bool nearFullDest = (qAbs(vr.left()   - destRect.left())   <= tol &&
-                             qAbs(vr.top()    - destRect.top())    <= tol &&
-                             qAbs(vr.right()  - destRect.right())  <= tol &&
-                             qAbs(vr.bottom() - destRect.bottom()) <= tol);
-        // 判定2：直接比较视窗（帧坐标系）是否覆盖完整帧
-        bool nearFullFrame = (qAbs(m_viewWindow.left())   <= 1.0 &&
-                              qAbs(m_viewWindow.top())    <= 1.0 &&
-                              qAbs(m_viewWindow.width()  - m_frameWidth)  <= 1.0 &&
-                              qAbs(m_viewWindow.height() - m_frameHeight) <= 1.0);
-        if (!(nearFullDest || nearFullFrame)) {
-            QPen pen(Qt::white, 3.0);
-            painter->setPen(pen);
-            painter->setBrush(Qt::NoBrush);
-            painter->drawRoundedRect(vr, 4, 4);
+    if (frame.isNull()) {
+        // 无帧：移除视频与叠加层，显示占位文字
+        if (root->video) {
+            root->removeChildNode(root->video);
+            delete root->video;
+            root->video = nullptr;
+        }
+        delete root->videoTexture;
+        root->videoTexture = nullptr;
+        removeAllChildren(root->boxes);
+        removeAllChildren(root->viewFrame);
+        m_boxesDirty = true;
+        m_viewDirty = true;
+
+        if (!root->placeholder) {
+            root->placeholderTexture = win->createTextureFromImage(
+                DetectionOverlayRenderer::renderLabelImage(QStringLiteral("相机未连接"), 32, QColor("#88C0D0"), Qt::transparent));
+            root->placeholder = win->createImageNode();
+            root->placeholder->setTexture(root->placeholderTexture);
+            root->appendChildNode(root->placeholder);
+        }
+        QRectF pr(QPointF(0, 0), QSizeF(root->placeholderTexture->textureSize()));
+        pr.moveCenter(boundingRect().center());
+        root->placeholder->setRect(pr);
+        return root;
+    }
+
+    if (root->placeholder) {
+        root->removeChildNode(root->placeholder);
+        delete root->placeholder;
+        root->placeholder = nullptr;
+        delete root->placeholderTexture;
+        root->placeholderTexture = nullptr;
+    }
+
+    if (!root->video) {
+        root->video = win->createImageNode();
+        root->video->setFiltering(QSGTexture::Linear);
+        root->insertChildNodeAfter(root->video, root->background);
+        frameDirty = true;
+    }
+
+    if (frameDirty || !root->videoTexture) {
+        QSGRendererInterface* rif = win->rendererInterface();
+        const bool openGl = rif && rif->graphicsApi() == QSGRendererInterface::OpenGL
+                            && QOpenGLContext::currentContext();
+        if (openGl) {
+            // OpenGL：复用同一纹理对象，尺寸不变时仅更新像素
+            VideoFrameTexture* tex = dynamic_cast<VideoFrameTexture*>(root->videoTexture);
+            if (!tex) {
+                tex = new VideoFrameTexture;
+                tex->upload(frame);
+                root->video->setTexture(tex);
+                delete root->videoTexture;
+                root->videoTexture = tex;
+            } else {
+                tex->upload(frame);
+                root->video->markDirty(QSGNode::DirtyMaterial);
+            }
+        } else {
+            // 软件后端：纹理只是对 QImage/QPixmap 的包装，没有 GPU 上传开销
+            QSGTexture* tex = win->createTextureFromImage(frame);
+            root->video->setTexture(tex);
+            delete root->videoTexture;
+            root->videoTexture = tex;
+        }
+        root->video->setSourceRect(QRectF(QPointF(0, 0), QSizeF(frame.size())));
+
+        if (traceTagged) {
+            const quint64 uploadedNs = FrameTrace::nowNs();
+            FrameTrace::record(traceFrameId, SMARTSCOPE_TRACE_PAINT, traceHandoffNs, uploadedNs);
+            if (traceCaptureNs != 0) {
+                FrameTrace::record(traceFrameId, SMARTSCOPE_TRACE_END_TO_END, traceCaptureNs, uploadedNs);
+            }
         }
     }
+
+    const QRectF destRect = frameDestRect();
+    if (root->video->rect() != destRect) {
+        root->video->setRect(destRect);
+        m_boxesDirty = true;
+        m_viewDirty = true;
+    }
+
+    // 叠加层与视频帧解耦：仅在检测框/几何变化时更新
+    if (m_boxesDirty) {
+        updateBoxesNode(root, destRect);
+        m_boxesDirty = false;
+    }
+    if (m_viewDirty) {
+        updateViewWindowNode(root, destRect);
+        m_viewDirty = false;
+    }
+    return root;
+}
+
+void QmlVideoItem::updateBoxesNode(QSGNode *rootNode, const QRectF& destRect)
+{
+    VideoRootNode* root = static_cast<VideoRootNode*>(rootNode);
+    const bool hasGeometry = m_frameWidth > 0 && m_frameHeight > 0;
+    m_overlay.setFrameGeometry(QSize(m_frameWidth, m_frameHeight), m_modelInputSize);
+    root->boxes->update(window(), m_overlay, hasGeometry ? destRect : QRectF());
+}
+
+void QmlVideoItem::updateViewWindowNode(QSGNode *rootNode, const QRectF& destRect)
+{
+    VideoRootNode* root = static_cast<VideoRootNode*>(rootNode);
+    removeAllChildren(root->viewFrame);
+
+    QQuickWindow* win = window();
+    const QRectF viewWindow = m_viewWindow;
+    if (m_frameWidth <= 0 || m_frameHeight <= 0 || viewWindow.width() <= 0 || viewWindow.height() <= 0) {
+        return;
+    }
+
+    // 绘制视窗白框（当前主画面可见区域）
+    const qreal sx = destRect.width() / m_frameWidth;
+    const qreal sy = destRect.height() / m_frameHeight;
+    QRectF vr(destRect.left() + viewWindow.left() * sx,
+              destRect.top() + viewWindow.top() * sy,
+              viewWindow.width() * sx,
+              viewWindow.height() * sy);
+    // 当视窗等同于显示区域（或非常接近）时，不绘制内部白框，避免与外层边框重叠产生双线
+    const qreal tol = 4.0; // 放宽容差
+    // 判定1：比较映射后矩形与显示矩形
+    bool nearFullDest = (qAbs(vr.left()   - destRect.left())   <= tol &&
+                         qAbs(vr.top()    - destRect.top())    <= tol &&
+                         qAbs(vr.right()  - destRect.right())  <= tol &&
+                         qAbs(vr.bottom() - destRect.bottom()) <= tol);
+    // 判定2：直接比较视窗（帧坐标系）是否覆盖完整帧
+    bool nearFullFrame = (qAbs(viewWindow.left())   <= 1.0 &&
+                          qAbs(viewWindow.top())    <= 1.0 &&
+                          qAbs(viewWindow.width()  - m_frameWidth)  <= 1.0 &&
+                          qAbs(viewWindow.height() - m_frameHeight) <= 1.0);
+    if (!(nearFullDest || nearFullFrame)) {
+        appendFrameEdges(root->viewFrame, win, vr, 3.0, Qt::white);
+    }
+}
+
+void QmlVideoItem::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        m_boxesDirty = true;
+        m_viewDirty = true;
+        update();
+    }
 }
 
 void QmlVideoItem::updateFrame(const QPixmap& pixmap)
@@ -161,47 +372,116 @@ void QmlVideoItem::updateFrame(const QPixmap& pixmap)
         return;
     }
 
+    quint64 traceFrameId = 0;
+    quint64 traceCaptureNs = 0;
+    const bool traceTagged = FrameTrace::takePixmapTag(pixmap, &traceFrameId, &traceCaptureNs);
+
+    bool hadFrame = false;
+    bool sizeChanged = false;
     {
         QMutexLocker locker(&m_mutex);
-        bool hadFrame = !m_currentFrame.isNull();
-        m_currentFrame = pixmap;
+        hadFrame = !m_currentFrame.isNull();
+        m_traceTagged = traceTagged;
+        if (traceTagged) {
+            m_traceFrameId = traceFrameId;
+            m_traceCaptureNs = traceCaptureNs;
+            m_traceHandoffNs = FrameTrace::nowNs();
+        }
+        // 光栅平台上 QPixmap::toImage 为浅拷贝；纹理上传在渲染线程的同步阶段完成
+        m_currentFrame = pixmap.toImage();
+        m_frameDirty = true;
+        sizeChanged = (m_frameWidth != m_currentFrame.width() || m_frameHeight != m_currentFrame.height());
         m_frameWidth = m_currentFrame.width();
         m_frameHeight = m_currentFrame.height();
-
-        if (!hadFrame) {
-            emit hasFrameChanged();
+        if (sizeChanged) {
+            m_boxesDirty = true;
+            m_viewDirty = true;
         }
     }
 
-    emit frameSizeChanged();
+    if (!hadFrame) {
+        emit hasFrameChanged();
+    }
+    if (sizeChanged) {
+        emit frameSizeChanged();
+    }
     // 触发重绘
     update();
 }
 
 void QmlVideoItem::clear()
 {
+    bool hadFrame = false;
     {
         QMutexLocker locker(&m_mutex);
-        bool hadFrame = !m_currentFrame.isNull();
-        m_currentFrame = QPixmap();
+        hadFrame = !m_currentFrame.isNull();
+        m_currentFrame = QImage();
         m_frameWidth = 0;
         m_frameHeight = 0;
-
-        if (hadFrame) {
-            emit hasFrameChanged();
-        }
+        m_frameDirty = true;
+        m_boxesDirty = true;
+        m_viewDirty = true;
     }
 
+    if (hadFrame) {
+        emit hasFrameChanged();
+    }
     emit frameSizeChanged();
     update();
 }
 
-void QmlVideoItem::setDetections(const QVariantList& dets)
+void QmlVideoItem::setDetectionModel(DetectionListModel* model)
+{
+    if (m_detectionModel == model) {
+        return;
+    }
+    if (m_detectionModel) {
+        disconnect(m_detectionModel, nullptr, this, nullptr);
+    }
+    m_detectionModel = model;
+    if (model) {
+        connect(model, &DetectionListModel::detectionsChanged, this, &QmlVideoItem::syncDetections);
+        connect(model, &DetectionListModel::labelsChanged, this, &QmlVideoItem::syncDetections);
+    }
+    syncDetections();
+    emit detectionModelChanged();
+}
+
+void QmlVideoItem::setEnglishLabels(bool english)
 {
+    if (m_englishLabels == english) {
+        return;
+    }
+    m_englishLabels = english;
+    syncDetections();
+    emit englishLabelsChanged();
+}
+
+void QmlVideoItem::syncDetections()
+{
+    // 检测结果到达时直接从类型化列表转换一次，标签按类别查表
+    QVector<OverlayBox> boxes;
+    if (m_detectionModel) {
+        const DetectionList& dets = m_detectionModel->detections();
+        boxes.reserve(dets.size());
+        for (int i = 0; i < dets.size(); ++i) {
+            const smartscope_CDetection& d = dets.at(i);
+            OverlayBox box;
+            box.left = d.left;
+            box.top = d.top;
+            box.right = d.right;
+            box.bottom = d.bottom;
+            box.confidence = d.confidence;
+            box.classId = d.class_id;
+            boxes.push_back(box);
+            m_overlay.setClassLabel(box.classId, m_detectionModel->displayLabel(box.classId, m_englishLabels));
+        }
+    }
+    m_overlay.setBoxes(boxes);
+
     {
         QMutexLocker locker(&m_mutex);
-        m_detections = dets;
+        m_boxesDirty = true;
     }
-    emit detectionsChanged();
     update();
 }
@@ -1,23 +1,33 @@
 #ifndef QML_VIDEO_ITEM_H
 #define QML_VIDEO_ITEM_H
 
-#include <QQuickPaintedItem>
+#include <QQuickItem>
+#include <QImage>
 #include <QPixmap>
-#include <QPainter>
 #include <QMutex>
+#include <QPointer>
 #include <QRectF>
 
+#include "detection_list_model.h"
+#include "detection_overlay.h"
+
+class QSGNode;
+
 /**
- * @brief QML中可用的视频显示Item，直接渲染QPixmap
+ * @brief QML中可用的视频显示Item，基于场景图直接渲染
  *
- * 这个类继承自QQuickPaintedItem，可以在QML中直接使用
- * 支持高性能的QPixmap渲染
+ * 通过 updatePaintNode 把视频帧上传为纹理（尺寸不变时复用同一纹理），
+ * 由场景图完成缩放；检测框与视窗框作为独立的叠加节点绘制。
+ * 检测框直接取自类型化的 DetectionListModel（detectionModel 属性），
+ * 每个框是跨检测更新复用的场景图节点（见 DetectionBoxesNode）。
+ * 仅使用后端无关的节点类型，软件渲染后端（无GPU/llvmpipe）下同样可用。
  */
-class QmlVideoItem : public QQuickPaintedItem
+class QmlVideoItem : public QQuickItem
 {
     Q_OBJECT
     Q_PROPERTY(bool hasFrame READ hasFrame NOTIFY hasFrameChanged)
-    Q_PROPERTY(QVariantList detections READ detections WRITE setDetections NOTIFY detectionsChanged)
+    Q_PROPERTY(DetectionListModel* detectionModel READ detectionModel WRITE setDetectionModel NOTIFY detectionModelChanged)
+    Q_PROPERTY(bool englishLabels READ englishLabels WRITE setEnglishLabels NOTIFY englishLabelsChanged)
     Q_PROPERTY(int modelInputSize READ modelInputSize WRITE setModelInputSize NOTIFY modelInputSizeChanged)
     Q_PROPERTY(int frameWidth READ frameWidth NOTIFY frameSizeChanged)
     Q_PROPERTY(int frameHeight READ frameHeight NOTIFY frameSizeChanged)
@@ -27,21 +37,23 @@ public:
     explicit QmlVideoItem(QQuickItem *parent = nullptr);
     ~QmlVideoItem();
 
-    void paint(QPainter *painter) override;
-
     bool hasFrame() const { return !m_currentFrame.isNull(); }
 
-    QVariantList detections() const { return m_detections; }
-    Q_INVOKABLE void setDetections(const QVariantList& dets);
+    DetectionListModel* detectionModel() const { return m_detectionModel; }
+    void setDetectionModel(DetectionListModel* model);
+
+    // 标签语言：true 为英文名称，false 为中文名称（缺失时互相退回）
+    bool englishLabels() const { return m_englishLabels; }
+    void setEnglishLabels(bool english);
 
     int modelInputSize() const { return m_modelInputSize; }
-    void setModelInputSize(int v) { if (m_modelInputSize != v) { m_modelInputSize = v; emit modelInputSizeChanged(); update(); } }
+    void setModelInputSize(int v) { if (m_modelInputSize != v) { m_modelInputSize = v; m_boxesDirty = true; emit modelInputSizeChanged(); update(); } }
 
     int frameWidth() const { return m_frameWidth; }
     int frameHeight() const { return m_frameHeight; }
 
     QRectF viewWindow() const { return m_viewWindow; }
-    void setViewWindow(const QRectF& r) { m_viewWindow = r; emit viewWindowChanged(); update(); }
+    void setViewWindow(const QRectF& r) { m_viewWindow = r; m_viewDirty = true; emit viewWindowChanged(); update(); }
 
 public slots:
     /**
@@ -57,15 +69,35 @@ public slots:
 
 signals:
     void hasFrameChanged();
-    void detectionsChanged();
+    void detectionModelChanged();
+    void englishLabelsChanged();
     void modelInputSizeChanged();
     void frameSizeChanged();
     void viewWindowChanged();
 
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
 private:
-    QPixmap m_currentFrame;
+    QRectF frameDestRect() const;
+    void syncDetections();
+    void updateBoxesNode(QSGNode *root, const QRectF& destRect);
+    void updateViewWindowNode(QSGNode *root, const QRectF& destRect);
+
+    QImage m_currentFrame;      // 由 updateFrame 写入（GUI线程），在同步阶段上传
+    bool m_frameDirty {false};
+    // 逐帧追踪：当前帧的帧号、采集时间与交给本项的时间（追踪时钟）
+    bool m_traceTagged {false};
+    quint64 m_traceFrameId {0};
+    quint64 m_traceCaptureNs {0};
+    quint64 m_traceHandoffNs {0};
+    bool m_boxesDirty {true};   // 检测框叠加层需要重建
+    bool m_viewDirty {true};    // 视窗白框需要更新
     QMutex m_mutex;
-    QVariantList m_detections;
+    QPointer<DetectionListModel> m_detectionModel;
+    bool m_englishLabels {false};
+    DetectionOverlayRenderer m_overlay;
     int m_modelInputSize {640};
     int m_frameWidth {0};
     int m_frameHeight {0};